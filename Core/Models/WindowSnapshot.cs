@@ -0,0 +1,254 @@
+﻿using System.Runtime.InteropServices;
+using Windows.Win32.Foundation;
+using Core.Utils;
+
+namespace Core.Models;
+
+/// <summary>
+///   A snapshot of windows taken in a single native pass. The snapshot is one block of memory made
+///   of a header, a record of fixed layout per window and a pool of UTF-16 strings the records
+///   point into, mirroring the layout of <c>window-snapshot.h</c> in Cpp.Core. Strings are only
+///   turned into managed strings when read, and fields that weren't gathered are looked up then.
+/// </summary>
+public sealed class WindowSnapshot {
+  private const uint magic   = 0x50534E57;
+  private const uint version = 1;
+
+  private const uint notGathered = 0xFFFFFFFF;
+
+  private readonly byte[] data;
+  private readonly int    recordsOffset;
+  private readonly int    poolOffset;
+  private readonly int    poolLength;
+
+  // Strings already read from the pool, by offset and length. Windows that share a string share the
+  // managed string too.
+  private readonly Dictionary<(uint, uint), string> strings = new();
+
+
+  /// <summary>
+  ///   Reads a snapshot laid out by the native snapshot builder.
+  /// </summary>
+  /// <param name="data"> The snapshot. </param>
+  /// <exception cref="InvalidDataException"> The snapshot is malformed. </exception>
+  public WindowSnapshot(byte[] data) {
+    ArgumentNullException.ThrowIfNull(data);
+
+    var headerSize = Marshal.SizeOf<Header>();
+    var recordSize = Marshal.SizeOf<Record>();
+
+    if (data.Length < headerSize) {
+      throw new InvalidDataException("The window snapshot is truncated.");
+    }
+
+    var header = MemoryMarshal.Read<Header>(data);
+    if (header.Magic != magic || header.Version != version || header.RecordSize != recordSize) {
+      throw new InvalidDataException("The window snapshot has an unsupported layout.");
+    }
+
+    var expectedLength = headerSize +
+                         (long)header.RecordCount * recordSize +
+                         (long)header.StringPoolLength * sizeof(char);
+    if (data.Length != expectedLength) {
+      throw new InvalidDataException("The window snapshot is truncated.");
+    }
+
+    this.data     = data;
+    recordsOffset = headerSize;
+    poolOffset    = headerSize + (int)header.RecordCount * recordSize;
+    poolLength    = (int)header.StringPoolLength;
+    Count         = (int)header.RecordCount;
+    Fields        = (WindowSnapshotFields)header.Fields;
+  }
+
+
+  /// <summary>
+  ///   The number of windows in the snapshot.
+  /// </summary>
+  public int Count { get; }
+
+  /// <summary>
+  ///   The fields that were gathered when the snapshot was taken.
+  /// </summary>
+  public WindowSnapshotFields Fields { get; }
+
+  private ReadOnlySpan<Record> Records =>
+    MemoryMarshal.Cast<byte, Record>(data.AsSpan(recordsOffset, poolOffset - recordsOffset));
+
+
+  /// <summary>
+  ///   Takes a snapshot of the windows on the desktop.
+  /// </summary>
+  /// <param name="fields">
+  ///   The fields to gather up front. Gather only what most windows will need, the rest is looked
+  ///   up for just the windows it's read from.
+  /// </param>
+  /// <param name="root">
+  ///   The window whose descendants to snapshot, or <c>null</c> for the top-level windows.
+  /// </param>
+  /// <param name="includeChildren">
+  ///   Whether to include the descendants of the top-level windows.
+  /// </param>
+  /// <returns> The snapshot. </returns>
+  public static WindowSnapshot Take(
+    WindowSnapshotFields fields = WindowSnapshotFields.All,
+    HWND? root = null,
+    bool includeChildren = false
+  ) {
+    return new WindowSnapshot(
+      Cpp.Core.WindowUtils.SnapshotWindows((uint)fields, root ?? nint.Zero, includeChildren)
+    );
+  }
+
+
+  /// <summary>
+  ///   Gets the class name of a window, looking it up if it wasn't gathered.
+  /// </summary>
+  /// <param name="index"> The index of the window in the snapshot. </param>
+  public string GetClassName(int index) {
+    return ReadString(Records[index].ClassName) ?? GetHwnd(index).GetClassName();
+  }
+
+
+  /// <summary>
+  ///   Gets how deeply a window is nested, where 0 is a top-level window, or a direct child of the
+  ///   window the snapshot was taken of.
+  /// </summary>
+  /// <param name="index"> The index of the window in the snapshot. </param>
+  public uint GetDepth(int index) {
+    return Records[index].Depth;
+  }
+
+
+  /// <summary>
+  ///   Gets the handle of a window.
+  /// </summary>
+  /// <param name="index"> The index of the window in the snapshot. </param>
+  public HWND GetHwnd(int index) {
+    return new HWND((nint)Records[index].Hwnd);
+  }
+
+
+  /// <summary>
+  ///   Gets the parent of a window.
+  /// </summary>
+  /// <param name="index"> The index of the window in the snapshot. </param>
+  /// <returns> The parent, or <c>null</c> for a top-level window. </returns>
+  public HWND? GetParent(int index) {
+    var parent = Records[index].Parent;
+    return parent == 0 ? null : new HWND((nint)parent);
+  }
+
+
+  /// <summary>
+  ///   Gets the ID of the process that created a window.
+  /// </summary>
+  /// <param name="index"> The index of the window in the snapshot. </param>
+  public uint GetProcessID(int index) {
+    return Records[index].ProcessID;
+  }
+
+
+  /// <summary>
+  ///   Gets the image path of the process that created a window, looking it up if it wasn't
+  ///   gathered.
+  /// </summary>
+  /// <param name="index"> The index of the window in the snapshot. </param>
+  public string GetProcessName(int index) {
+    return ReadString(Records[index].ProcessName) ?? GetHwnd(index).GetProcessName();
+  }
+
+
+  /// <summary>
+  ///   Gets the title of a window, looking it up if it wasn't gathered.
+  /// </summary>
+  /// <param name="index"> The index of the window in the snapshot. </param>
+  public string GetTitle(int index) {
+    return ReadString(Records[index].Title) ?? GetHwnd(index).GetWindowText();
+  }
+
+
+  /// <summary>
+  ///   Describes a window in the snapshot.
+  /// </summary>
+  /// <param name="index"> The index of the window in the snapshot. </param>
+  public Win32Window ToWin32Window(int index) {
+    return new Win32Window {
+      Hwnd        = GetHwnd(index),
+      Title       = GetTitle(index),
+      ClassName   = GetClassName(index),
+      ProcessName = GetProcessName(index),
+      ProcessID   = GetProcessID(index)
+    };
+  }
+
+
+  /// <summary>
+  ///   Describes every window in the snapshot.
+  /// </summary>
+  /// <returns> A <see cref="Win32Window" /> for each window, in snapshot order. </returns>
+  public List<Win32Window> ToWin32Windows() {
+    var result = new List<Win32Window>(Count);
+    for (var i = 0; i < Count; i++) {
+      result.Add(ToWin32Window(i));
+    }
+
+    return result;
+  }
+
+
+  /// <summary>
+  ///   Reads a string from the pool.
+  /// </summary>
+  /// <returns> The string, or <c>null</c> if its field wasn't gathered. </returns>
+  /// <exception cref="InvalidDataException"> The string lies outside of the pool. </exception>
+  private string? ReadString(StringRef reference) {
+    if (reference.Offset == notGathered) {
+      return null;
+    }
+
+    var key = (reference.Offset, reference.Length);
+    if (strings.TryGetValue(key, out var cached)) {
+      return cached;
+    }
+
+    if ((long)reference.Offset + reference.Length > poolLength) {
+      throw new InvalidDataException("The window snapshot has a string outside of its pool.");
+    }
+
+    var pool = MemoryMarshal.Cast<byte, char>(data.AsSpan(poolOffset));
+    var value = new string(pool.Slice((int)reference.Offset, (int)reference.Length));
+
+    strings.Add(key, value);
+    return value;
+  }
+
+
+  [StructLayout(LayoutKind.Sequential)]
+  private struct Header {
+    public uint   Magic;
+    public ushort Version;
+    public ushort RecordSize;
+    public uint   RecordCount;
+    public uint   Fields;
+    public uint   StringPoolLength;
+    public uint   Reserved;
+  }
+
+  [StructLayout(LayoutKind.Sequential)]
+  private struct StringRef {
+    public uint Offset;
+    public uint Length;
+  }
+
+  [StructLayout(LayoutKind.Sequential)]
+  private struct Record {
+    public ulong     Hwnd;
+    public ulong     Parent;
+    public uint      ProcessID;
+    public uint      Depth;
+    public StringRef Title;
+    public StringRef ClassName;
+    public StringRef ProcessName;
+  }
+}
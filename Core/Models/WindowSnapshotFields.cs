@@ -0,0 +1,34 @@
+﻿namespace Core.Models;
+
+/// <summary>
+///   The fields of each window that a <see cref="WindowSnapshot" /> gathers up front. The handle,
+///   parent, depth and process ID are always gathered. The other fields are looked up when first
+///   read.
+/// </summary>
+[Flags]
+public enum WindowSnapshotFields : uint {
+  /// <summary>
+  ///   Only the fields that are always gathered.
+  /// </summary>
+  None = 0,
+
+  /// <summary>
+  ///   The title of each window.
+  /// </summary>
+  Title = 1 << 0,
+
+  /// <summary>
+  ///   The class name of each window.
+  /// </summary>
+  ClassName = 1 << 1,
+
+  /// <summary>
+  ///   The image path of the process of each window.
+  /// </summary>
+  ProcessName = 1 << 2,
+
+  /// <summary>
+  ///   Every field.
+  /// </summary>
+  All = Title | ClassName | ProcessName
+}
@@ -0,0 +1,20 @@
+﻿namespace Core.Utils;
+
+/// <summary>
+///   Provides constants for the WinEvents raised by the Downscaler. The values are allocated from
+///   the range reserved for OEMs so they can't collide with the system events in
+///   <see cref="WinEvent" />, and they're raised on the window being scaled so that anything
+///   already watching that window, such as a GameLauncher script, can listen for them.
+/// </summary>
+public static class DownscalerWinEvent {
+  /// <summary>
+  ///   The scaled frames of the window have turned black, e.g. because a loading screen is being
+  ///   shown.
+  /// </summary>
+  public const uint EVENT_DOWNSCALER_BLACKSCREENSTART = WinEvent.EVENT_OEM_DEFINED_START + 0x7F;
+
+  /// <summary>
+  ///   The scaled frames of the window are no longer black.
+  /// </summary>
+  public const uint EVENT_DOWNSCALER_BLACKSCREENEND = WinEvent.EVENT_OEM_DEFINED_START + 0x80;
+}
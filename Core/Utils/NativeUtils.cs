@@ -156,14 +156,8 @@ public static class NativeUtils {
   ///   windows of the window with the given handle.
   /// </returns>
   public static IEnumerable<Win32Window> EnumerateChildWindows(HWND hwnd) {
-    var result = new List<Win32Window>();
-
-    // Call the native EnumWindows function, passing the results list to the callback function
-    // factory.
-    EnumChildWindows(hwnd, GetWndEnumProc(result), nint.Zero);
-
-    // Return the results.
-    return result;
+    // Gather every window and its details in a single native pass.
+    return WindowSnapshot.Take(root: hwnd).ToWin32Windows();
   }
 
 
@@ -219,14 +213,8 @@ public static class NativeUtils {
   ///   windows on the system at the time of the call.
   /// </returns>
   public static IEnumerable<Win32Window> EnumerateWindows() {
-    var result = new List<Win32Window>();
-
-    // Call the native EnumWindows function, passing the results list to the callback function
-    // factory.
-    EnumWindows(GetWndEnumProc(result), nint.Zero);
-
-    // Return the results.
-    return result;
+    // Gather every window and its details in a single native pass.
+    return WindowSnapshot.Take().ToWin32Windows();
   }
 
 
@@ -277,33 +265,4 @@ public static class NativeUtils {
       Marshal.FreeHGlobal(ptr);
     }
   }
-
-
-  /// <summary>
-  ///   Returns a <see cref="WNDENUMPROC" /> that can be used to enumerate windows and add them to
-  ///   a list given a list to store the results in.
-  /// </summary>
-  /// <param name="result"> The list to store the results in. </param>
-  /// <returns> A <see cref="WNDENUMPROC" /> that can be used to enumerate windows. </returns>
-  private static WNDENUMPROC GetWndEnumProc(ICollection<Win32Window> result) {
-    return (hwnd, lParam) => {
-      var title       = hwnd.GetWindowText();
-      var className   = hwnd.GetClassName();
-      var processName = hwnd.GetProcessName();
-      var processID   = hwnd.GetProcessID();
-
-      result.Add(
-        new Win32Window {
-          Hwnd        = hwnd,
-          Title       = title,
-          ClassName   = className,
-          ProcessName = processName,
-          ProcessID   = processID
-        }
-      );
-
-      // Continue the enumeration.
-      return true;
-    };
-  }
 }
@@ -1,51 +1,53 @@
 ﻿using Windows.Win32.Foundation;
-using Windows.Win32.UI.Accessibility;
-using Windows.Win32.UI.WindowsAndMessaging;
-using static Windows.Win32.PInvoke;
+using Cpp.Core;
 
 public delegate bool WindowCriteria(HWND hwnd);
 
 /// <summary>
-///   A utility class for awaiting window events using the Win32 API.
+///   A utility class for awaiting window events using the Win32 API. Only the events that are
+///   awaited are hooked, and they're filtered natively before reaching managed code.
 /// </summary>
 public static class WinEventAwaiter {
-  // Refers to the hwnd of the window that is the source of the event, but not any of its child objects.
-  private const int CHILDID_SELF = 0;
-  private const int OBJID_WINDOW = 0;
+  // The most events read from the dispatcher at once.
+  private const int readBatchSize = 256;
 
-  // Constants for the hook and message loop.
-  private const uint EVENT_MIN             = 0x00000001;
-  private const uint EVENT_MAX             = 0x7FFFFFFF;
-  private const uint WINEVENT_OUTOFCONTEXT = 0;
-  private const uint WM_QUIT               = 0x0012;
+  // Hooks the awaited events on a native thread and queues the ones about a window.
+  private static readonly WinEventDispatcher dispatcher = new();
 
-  // The hook handle.
-  private static HWINEVENTHOOK hook = HWINEVENTHOOK.Null;
-
-  // A dedicated thread for the hook message loop.
-  private static readonly Thread hookThread;
-
-  // The native thread ID for the hook thread.
-  private static uint hookThreadId;
+  // A dedicated thread that reads the queued events and completes the awaiters.
+  private static readonly Thread dispatchThread;
 
   // Lock for protecting the list of pending awaiters.
   private static readonly object @lock = new();
 
-  // The list of pending awaiters.
+  // The list of pending awaiters with criteria callbacks, which are checked against every event
+  // they wait for.
   private static readonly List<AwaiterEntry> awaiters = new();
 
-  // The static delegate that remains pinned.
-  private static readonly WINEVENTPROC winEventProc = WinEventProc;
+  // The pending awaiters with compiled criteria, which are indexed natively by event, process and
+  // class so that each event is only checked against the few that it could complete.
+  private static readonly WindowAwaiterIndex awaiterIndex = new();
+
+  // The awaiters in the index, by their identifiers in the index.
+  private static readonly Dictionary<uint, AwaiterEntry> indexedAwaiters = new();
+
+  // The awaiters the index matched for the current event. Only used on the dispatch thread.
+  private static readonly List<uint> matchedIDs = new();
+
+  // The watchers, which stay subscribed to their events until they're cancelled.
+  private static readonly List<WatcherEntry> watchers = new();
 
+  // The watchers that matched the current event, whose callbacks are invoked once the lock is
+  // released. Only used on the dispatch thread.
+  private static readonly List<WatcherEntry> matchedWatchers = new();
 
-  // In the static constructor we start the hook thread.
+
+  // In the static constructor we start the dispatch thread.
   static WinEventAwaiter() {
-    hookThread = new Thread(HookAndPumpMessages) {
+    dispatchThread = new Thread(DispatchEvents) {
       IsBackground = true
     };
-    // Set the thread to STA (required for many UI hook scenarios)
-    hookThread.SetApartmentState(ApartmentState.STA);
-    hookThread.Start();
+    dispatchThread.Start();
   }
 
 
@@ -71,6 +73,7 @@ public static class WinEventAwaiter {
   ///   A task that will complete with the HWND of the window that matches the criteria, or
   ///   <see langword="null" /> if the timeout elapsed.
   /// </returns>
+  /// <exception cref="InvalidOperationException"> The events couldn't be hooked. </exception>
   public static Task<HWND?> AwaitEvent(
     IEnumerable<uint> events,
     WindowCriteria criteria,
@@ -79,104 +82,296 @@ public static class WinEventAwaiter {
   ) {
     ArgumentNullException.ThrowIfNull(criteria);
 
-    var entry = new AwaiterEntry(criteria, events);
+    // Hook the events before the awaiter can be matched, since matching it releases its events.
+    var entry = new AwaiterEntry(criteria, events.ToArray());
+    dispatcher.Subscribe(entry.Events);
     lock (@lock) {
       awaiters.Add(entry);
     }
 
+    return Await(entry, timeout, cancellationToken);
+  }
+
+
+  /// <summary>
+  ///   Registers compiled criteria and returns a task that will complete with the HWND when an
+  ///   event matching the criteria occurs. If a timeout occurs, the task completes with null. Unlike
+  ///   a criteria callback, the criteria are checked natively and each window is only queried once
+  ///   for the fields that any of the pending awaiters compare.
+  /// </summary>
+  /// <param name="events">
+  ///   The list of events to wait for. If any event in this list occurs and matches the criteria,
+  ///   the task will complete. See: <see cref="Core.Utils.WinEvent" /> for possible values.
+  /// </param>
+  /// <param name="matcher">
+  ///   The criteria that the window from the event must match. The criteria are copied, so the
+  ///   matcher may be disposed once this returns.
+  /// </param>
+  /// <param name="timeout">
+  ///   The maximum time to wait for the event to occur. If <c> null </c>, the method waits
+  ///   indefinitely.
+  /// </param>
+  /// <param name="cancellationToken">
+  ///   A cancellation token that can be used to cancel the operation.
+  /// </param>
+  /// <returns>
+  ///   A task that will complete with the HWND of the window that matches the criteria, or
+  ///   <see langword="null" /> if the timeout elapsed.
+  /// </returns>
+  /// <exception cref="InvalidOperationException"> The events couldn't be hooked. </exception>
+  public static Task<HWND?> AwaitEvent(
+    IEnumerable<uint> events,
+    WindowMatcher matcher,
+    TimeSpan? timeout = null,
+    CancellationToken cancellationToken = default
+  ) {
+    ArgumentNullException.ThrowIfNull(matcher);
+
+    // Hook the events before the awaiter can be matched, since matching it releases its events.
+    var entry = new AwaiterEntry(null, events.ToArray());
+    dispatcher.Subscribe(entry.Events);
+    try {
+      lock (@lock) {
+        entry.IndexID = awaiterIndex.Add(entry.Events, matcher);
+        indexedAwaiters.Add(entry.IndexID.Value, entry);
+      }
+    }
+    catch {
+      dispatcher.Unsubscribe(entry.Events);
+      throw;
+    }
+
+    return Await(entry, timeout, cancellationToken);
+  }
+
+
+  /// <summary>
+  ///   Waits for a registered awaiter, whose events are hooked, to complete.
+  /// </summary>
+  private static async Task<HWND?> Await(
+    AwaiterEntry entry,
+    TimeSpan? timeout,
+    CancellationToken cancellationToken
+  ) {
     // Create a delay task (or never-ending task if no timeout is specified)
     var delayTask = timeout.HasValue
                       ? Task.Delay(timeout.Value, cancellationToken)
                       : Task.Delay(Timeout.Infinite, cancellationToken);
 
-    // When either the criteria completes or the delay elapses, complete the returned task.
-    return Task.WhenAny(entry.Tcs.Task, delayTask)
-      .ContinueWith(
-        t => {
-          if (t.Result == entry.Tcs.Task) {
-            return entry.Tcs.Task.Result;
-          }
+    // When either the criteria completes or the delay elapses, complete the returned task. The
+    // delay task is only compared, never awaited, so its cancellation is never thrown from here.
+    var completed = await Task.WhenAny(entry.Tcs.Task, delayTask).ConfigureAwait(false);
+    if (completed == entry.Tcs.Task) {
+      return await entry.Tcs.Task.ConfigureAwait(false);
+    }
 
-          // Timeout (or cancellation) occurred: remove the entry so it no longer waits.
-          lock (@lock) {
-            awaiters.Remove(entry);
-          }
+    // Timeout (or cancellation) occurred: remove the entry so it no longer waits, and release its
+    // events, which would otherwise stay hooked.
+    lock (@lock) {
+      if (Remove(entry)) {
+        dispatcher.Unsubscribe(entry.Events);
+      }
+    }
 
-          return (HWND?)null;
-        },
-        cancellationToken
-      );
+    cancellationToken.ThrowIfCancellationRequested();
+    return null;
   }
 
 
   /// <summary>
-  ///   The dedicated hook thread registers the global event hook and runs a message loop.
+  ///   Invokes a callback every time an event matching the criteria occurs, until cancelled. Useful
+  ///   for keeping a cache of window state up to date, e.g. invalidating it whenever the window
+  ///   moves. The events stay hooked for as long as the watch lasts, so bursts of events are never
+  ///   missed between callbacks.
   /// </summary>
-  private static void HookAndPumpMessages() {
-    hookThreadId = GetCurrentThreadId();
-
-    hook = SetWinEventHook(
-      EVENT_MIN,
-      EVENT_MAX,
-      (HMODULE)nint.Zero,
-      winEventProc,
-      0, // monitor all processes
-      0, // monitor all threads
-      WINEVENT_OUTOFCONTEXT
-    );
-
-    if (hook == nint.Zero) {
-      Console.Error.WriteLine("Failed to set event hook.");
-      return;
-    }
-
-    // Standard message loop. This is necessary for the hook to work as it relies on the message
-    // pump.
-    MSG msg;
-    while (GetMessage(out msg, (HWND)nint.Zero, 0, 0) != 0) {
-      TranslateMessage(ref msg);
-      DispatchMessage(ref msg);
+  /// <param name="events">
+  ///   The list of events to watch for. See: <see cref="Core.Utils.WinEvent" /> for possible values.
+  /// </param>
+  /// <param name="criteria">
+  ///   The criteria callback that determines if window from the event is one we're watching.
+  /// </param>
+  /// <param name="callback">
+  ///   Invoked with the window of every matching event. Called on the dispatch thread, in the order
+  ///   the events occurred, so it should return quickly.
+  /// </param>
+  /// <param name="cancellationToken"> Stops watching when cancelled. </param>
+  /// <returns>
+  ///   A task that completes once watching has stopped, or faults if the criteria or the callback
+  ///   threw, which also stops watching.
+  /// </returns>
+  /// <exception cref="InvalidOperationException"> The events couldn't be hooked. </exception>
+  public static Task WatchEvents(
+    IEnumerable<uint> events,
+    WindowCriteria criteria,
+    Action<HWND> callback,
+    CancellationToken cancellationToken
+  ) {
+    ArgumentNullException.ThrowIfNull(criteria);
+    ArgumentNullException.ThrowIfNull(callback);
+
+    if (cancellationToken.IsCancellationRequested) {
+      return Task.CompletedTask;
     }
+
+    // Hook the events before returning, so none that occur from now on are missed, and before the
+    // watcher can be stopped, since stopping it releases its events.
+    var watcher = new WatcherEntry(criteria, callback, events.ToArray());
+    dispatcher.Subscribe(watcher.Events);
+    lock (@lock) {
+      watchers.Add(watcher);
+    }
+
+    watcher.Registration = cancellationToken.Register(() => StopWatching(watcher, null));
+    return watcher.Stopped.Task;
   }
 
 
   /// <summary>
-  ///   The hook callback that fires for any event in the specified range.
-  ///   It iterates over all pending awaiters and completes any whose criteria match.
+  ///   Unregisters a watcher and unhooks its events, if it's still watching.
   /// </summary>
-  private static void WinEventProc(
-    HWINEVENTHOOK hWinEventHook,
-    uint @event,
-    HWND hWnd,
-    int idObject,
-    int idChild,
-    uint idEventThread,
-    uint dwmsEventTime
-  ) {
-    if (hWnd == nint.Zero ||
-        idChild != CHILDID_SELF ||
-        idObject != OBJID_WINDOW) {
-      return;
+  /// <param name="watcher"> The watcher to stop. </param>
+  /// <param name="error"> What stopped the watcher, if it wasn't cancelled. </param>
+  private static void StopWatching(WatcherEntry watcher, Exception? error) {
+    lock (@lock) {
+      if (!watchers.Remove(watcher)) {
+        return;
+      }
+
+      dispatcher.Unsubscribe(watcher.Events);
+    }
+
+    watcher.Registration.Dispose();
+    if (error is null) {
+      watcher.Stopped.TrySetResult();
+    }
+    else {
+      watcher.Stopped.TrySetException(error);
+    }
+  }
+
+
+  /// <summary>
+  ///   The dedicated dispatch thread reads the events that passed the native filter, in the order
+  ///   they occurred, and hands each to <see cref="WinEventProc" />.
+  /// </summary>
+  private static void DispatchEvents() {
+    var records = new WinEventRecord[readBatchSize];
+
+    while (true) {
+      var count = dispatcher.Read(records, Timeout.Infinite);
+      for (var i = 0; i < count; i++) {
+        WinEventProc(records[i].Event, new HWND(records[i].Hwnd));
+      }
     }
+  }
+
+
+  /// <summary>
+  ///   Handles an event about a window that at least one awaiter or watcher subscribed to.
+  ///   It completes the indexed awaiters that the event matches, then iterates over the awaiters
+  ///   with criteria callbacks and completes any whose criteria match. Finally, it invokes the
+  ///   callbacks of the watchers whose criteria match, outside the lock.
+  /// </summary>
+  private static void WinEventProc(uint @event, HWND hWnd) {
+    matchedWatchers.Clear();
 
-    // Check every registered awaiter.
     lock (@lock) {
+      if (indexedAwaiters.Count > 0 &&
+          awaiterIndex.Match(@event, hWnd, matchedIDs) > 0) {
+        foreach (var id in matchedIDs) {
+          var entry = indexedAwaiters[id];
+          Remove(entry);
+          dispatcher.Unsubscribe(entry.Events);
+          entry.Tcs.TrySetResult(hWnd);
+        }
+      }
+
+      // Check every awaiter with a criteria callback.
       // Iterate backwards to allow removal.
       for (var i = awaiters.Count - 1; i >= 0; i--) {
         var entry = awaiters[i];
         try {
           if (entry.Events.Contains(@event) &&
-              entry.Criteria(hWnd)) {
+              entry.Criteria!(hWnd)) {
             entry.Tcs.TrySetResult(hWnd);
             awaiters.RemoveAt(i);
+            dispatcher.Unsubscribe(entry.Events);
           }
         }
         catch (Exception ex) {
           // In case the criteria callback throws.
           entry.Tcs.TrySetException(ex);
           awaiters.RemoveAt(i);
+          dispatcher.Unsubscribe(entry.Events);
+        }
+      }
+
+      foreach (var watcher in watchers) {
+        if (watcher.Events.Contains(@event)) {
+          matchedWatchers.Add(watcher);
+        }
+      }
+    }
+
+    foreach (var watcher in matchedWatchers) {
+      try {
+        if (watcher.Criteria(hWnd)) {
+          watcher.Callback(hWnd);
         }
       }
+      catch (Exception ex) {
+        // A watcher whose criteria or callback throws stops watching, as it would have if its
+        // callback had been awaited.
+        StopWatching(watcher, ex);
+      }
+    }
+  }
+
+
+  /// <summary>
+  ///   Removes a pending awaiter from wherever it's registered. Must be called under the lock.
+  /// </summary>
+  /// <returns> Whether the awaiter was still pending. </returns>
+  private static bool Remove(AwaiterEntry entry) {
+    if (entry.IndexID is not { } id) {
+      return awaiters.Remove(entry);
+    }
+
+    awaiterIndex.Remove(id);
+    return indexedAwaiters.Remove(id);
+  }
+
+
+  /// <summary>
+  ///   Represents a watching registration, which lasts until it's cancelled.
+  /// </summary>
+  private class WatcherEntry {
+    public WindowCriteria Criteria { get; }
+
+    public Action<HWND> Callback { get; }
+
+    /// <summary>
+    ///   The list of events to watch for. See: <see cref="Core.Utils.WinEvent" /> for possible
+    ///   values.
+    /// </summary>
+    public uint[] Events { get; }
+
+    /// <summary>
+    ///   Completes once the watcher stops watching.
+    /// </summary>
+    public TaskCompletionSource Stopped { get; }
+
+    /// <summary>
+    ///   Stops the watcher when its cancellation token is cancelled.
+    /// </summary>
+    public CancellationTokenRegistration Registration { get; set; }
+
+
+    public WatcherEntry(WindowCriteria criteria, Action<HWND> callback, uint[] events) {
+      Criteria = criteria;
+      Callback = callback;
+      Events   = events;
+      Stopped  = new TaskCompletionSource(TaskCreationOptions.RunContinuationsAsynchronously);
     }
   }
 
@@ -185,17 +380,27 @@ public static class WinEventAwaiter {
   ///   Represents an awaiting registration.
   /// </summary>
   private class AwaiterEntry {
-    public WindowCriteria             Criteria { get; }
-    public TaskCompletionSource<HWND> Tcs      { get; }
+    /// <summary>
+    ///   The criteria callback, or <see langword="null" /> if the awaiter's criteria are compiled
+    ///   and registered in the awaiter index.
+    /// </summary>
+    public WindowCriteria? Criteria { get; }
+
+    public TaskCompletionSource<HWND> Tcs { get; }
+
+    /// <summary>
+    ///   The identifier of the awaiter in the awaiter index, if its criteria are compiled.
+    /// </summary>
+    public uint? IndexID { get; set; }
 
     /// <summary>
     ///   The list of events to wait for. If any event in this list occurs and matches the criteria,
     ///   the task will complete. See: <see cref="Core.Utils.WinEvent" /> for possible values.
     /// </summary>
-    public IEnumerable<uint> Events { get; }
+    public uint[] Events { get; }
 
 
-    public AwaiterEntry(WindowCriteria criteria, IEnumerable<uint> events) {
+    public AwaiterEntry(WindowCriteria? criteria, uint[] events) {
       Criteria = criteria;
       Events   = events;
       // Using RunContinuationsAsynchronously to avoid potential deadlocks.
@@ -0,0 +1,70 @@
+﻿using Windows.Win32.Foundation;
+using Core.Models;
+
+namespace Core.Utils;
+
+/// <summary>
+///   Finds windows without enumerating the desktop. Every window is kept in a native registry
+///   that's indexed by process, process name, class and title, and kept current from the events
+///   that create, destroy, rename and reparent windows. Those events are applied asynchronously, so
+///   a window created moments ago may not be found yet.
+/// </summary>
+public static class WindowRegistry {
+  /// <summary>
+  ///   The number of windows on the desktop, including child windows.
+  /// </summary>
+  public static int Count => Cpp.Core.WindowRegistry.Count;
+
+
+  /// <summary>
+  ///   Finds the windows that match every given criterion.
+  /// </summary>
+  /// <param name="hwnd"> Only the window with this handle. </param>
+  /// <param name="processId"> Only windows of this process. </param>
+  /// <param name="processName">
+  ///   Only windows of processes with this image file name, e.g. "explorer.exe". Compared
+  ///   case-insensitively.
+  /// </param>
+  /// <param name="className"> Only windows of this class. Compared case-insensitively. </param>
+  /// <param name="title"> Only windows with exactly this title. </param>
+  /// <param name="ancestor"> Only descendants of this window. </param>
+  /// <param name="topLevelOnly"> Whether to only find top-level windows. </param>
+  /// <returns> The matching windows, top-level windows first. </returns>
+  public static List<Win32Window> Find(
+    HWND? hwnd = null,
+    uint? processId = null,
+    string? processName = null,
+    string? className = null,
+    string? title = null,
+    HWND? ancestor = null,
+    bool topLevelOnly = false
+  ) {
+    var snapshot = Cpp.Core.WindowRegistry.Find(
+      hwnd ?? nint.Zero,
+      processId,
+      processName,
+      className,
+      title,
+      ancestor ?? nint.Zero,
+      topLevelOnly
+    );
+
+    return new WindowSnapshot(snapshot).ToWin32Windows();
+  }
+
+
+  /// <summary>
+  ///   Finds the windows that match compiled criteria. The criteria's literal patterns narrow the
+  ///   lookup down using the registry's indexes before the rest are compared.
+  /// </summary>
+  /// <param name="matcher"> The criteria to match. </param>
+  /// <param name="topLevelOnly"> Whether to only find top-level windows. </param>
+  /// <returns> The matching windows, top-level windows first. </returns>
+  public static List<Win32Window> Find(Cpp.Core.WindowMatcher matcher, bool topLevelOnly = false) {
+    ArgumentNullException.ThrowIfNull(matcher);
+
+    var snapshot = Cpp.Core.WindowRegistry.Find(matcher, topLevelOnly);
+
+    return new WindowSnapshot(snapshot).ToWin32Windows();
+  }
+}
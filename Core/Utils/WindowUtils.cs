@@ -3,7 +3,9 @@
 namespace Core.Utils;
 
 /// <summary>
-///   General higher-level utilities for interacting with windows.
+///   General higher-level utilities for interacting with windows. The lookups enumerate the
+///   desktop directly rather than use <see cref="WindowRegistry" />, since they're made once, and
+///   loading the registry would cost a full snapshot and leave its hooks running for nothing.
 /// </summary>
 public class WindowUtils {
   /// <summary>
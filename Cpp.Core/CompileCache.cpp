@@ -0,0 +1,212 @@
+﻿#include "compile-cache.h"
+#include "content-hash.h"
+
+#include <cstring>
+#include <vcclr.h>
+
+using namespace System;
+using namespace System::IO;
+using namespace System::Text;
+
+namespace Cpp::Core {
+  /**
+   * @brief A persistent cache of compiled scripts in a directory, keyed by a native hash of their
+   * source and a fingerprint of the compiler. Lookups probe a memory-mapped index, so a script
+   * that was compiled before is found without compiling or parsing anything.
+   */
+  public ref class CompileCache {
+    public:
+      /**
+       * @param directory The directory to keep the cache in. Created if it doesn't exist.
+       */
+      CompileCache(String^ directory) : cache(new NativeImpls::CompileCache()) {
+        if (directory == nullptr) {
+          throw gcnew ArgumentNullException("directory");
+        }
+
+        std::string error;
+        if (!cache->Open(ToPath(directory), error)) {
+          delete cache;
+          cache = nullptr;
+          throw gcnew IOException(gcnew String(error.c_str()));
+        }
+      }
+
+      ~CompileCache() {
+        this->!CompileCache();
+      }
+
+      !CompileCache() {
+        delete cache;
+        cache = nullptr;
+      }
+
+      /**
+       * @brief Looks up the output compiled from a source.
+       * @param source The bytes of the source file.
+       * @param fingerprint A hash of everything besides the source that affects the output. See
+       * `HashFile`.
+       * @returns The output, or `nullptr` if it's not in the cache.
+       */
+      String^ Lookup(array<Byte>^ source, UInt64 fingerprint) {
+        if (source == nullptr) {
+          throw gcnew ArgumentNullException("source");
+        }
+
+        std::string output;
+        pin_ptr<Byte> pinned = source->Length > 0 ? &source[0] : nullptr;
+        if (!cache->Lookup(pinned, source->Length, fingerprint, output)) {
+          return nullptr;
+        }
+
+        auto characters = reinterpret_cast<SByte*>(output.data());
+        return gcnew String(characters, 0, static_cast<int>(output.size()), Encoding::UTF8);
+      }
+
+      /**
+       * @brief Stores the output compiled from a source, replacing any stored before.
+       * @param source The bytes of the source file.
+       * @param fingerprint A hash of everything besides the source that affects the output.
+       * @param output The compiled output.
+       * @returns `false` if the output couldn't be written.
+       */
+      bool Store(array<Byte>^ source, UInt64 fingerprint, String^ output) {
+        if (source == nullptr) {
+          throw gcnew ArgumentNullException("source");
+        }
+        if (output == nullptr) {
+          throw gcnew ArgumentNullException("output");
+        }
+
+        auto bytes = Encoding::UTF8->GetBytes(output);
+        pin_ptr<Byte> pinnedSource = source->Length > 0 ? &source[0] : nullptr;
+        pin_ptr<Byte> pinnedOutput = bytes->Length > 0 ? &bytes[0] : nullptr;
+        auto view = std::string_view(reinterpret_cast<const char*>(pinnedOutput), bytes->Length);
+        return cache->Store(pinnedSource, source->Length, fingerprint, view);
+      }
+
+      /**
+       * @brief Looks up binary output, e.g. a V8 code cache, stored by `StoreBytes`.
+       * @param source The bytes of the source.
+       * @param fingerprint A hash of everything besides the source that affects the output.
+       * @returns The output, or `nullptr` if it's not in the cache.
+       */
+      array<Byte>^ LookupBytes(array<Byte>^ source, UInt64 fingerprint) {
+        if (source == nullptr) {
+          throw gcnew ArgumentNullException("source");
+        }
+
+        std::string output;
+        pin_ptr<Byte> pinned = source->Length > 0 ? &source[0] : nullptr;
+        if (!cache->Lookup(pinned, source->Length, fingerprint, output)) {
+          return nullptr;
+        }
+
+        auto bytes = gcnew array<Byte>(static_cast<int>(output.size()));
+        if (bytes->Length > 0) {
+          pin_ptr<Byte> pinnedBytes = &bytes[0];
+          std::memcpy(pinnedBytes, output.data(), output.size());
+        }
+        return bytes;
+      }
+
+      /**
+       * @brief Stores binary output compiled from a source, replacing any stored before.
+       * @param source The bytes of the source.
+       * @param fingerprint A hash of everything besides the source that affects the output.
+       * @param output The compiled output.
+       * @returns `false` if the output couldn't be written.
+       */
+      bool StoreBytes(array<Byte>^ source, UInt64 fingerprint, array<Byte>^ output) {
+        if (source == nullptr) {
+          throw gcnew ArgumentNullException("source");
+        }
+        if (output == nullptr) {
+          throw gcnew ArgumentNullException("output");
+        }
+
+        pin_ptr<Byte> pinnedSource = source->Length > 0 ? &source[0] : nullptr;
+        pin_ptr<Byte> pinnedOutput = output->Length > 0 ? &output[0] : nullptr;
+        auto view = std::string_view(reinterpret_cast<const char*>(pinnedOutput), output->Length);
+        return cache->Store(pinnedSource, source->Length, fingerprint, view);
+      }
+
+      /**
+       * @brief Removes every entry and output.
+       */
+      void Clear() {
+        cache->Clear();
+      }
+
+      /**
+       * @brief Hashes the content of a file, mapping it rather than reading it.
+       * @param seed Chains the hash onto the hash of other files.
+       */
+      static UInt64 HashFile(String^ path, UInt64 seed) {
+        if (path == nullptr) {
+          throw gcnew ArgumentNullException("path");
+        }
+
+        std::string error;
+        NativeImpls::MappedFile file;
+        if (!file.Open(ToPath(path), false, error)) {
+          throw gcnew IOException(gcnew String(error.c_str()));
+        }
+
+        return NativeImpls::HashContent(file.GetData(), file.GetSize(), seed);
+      }
+
+      /**
+       * @brief The number of entries in the cache.
+       */
+      property int Count {
+        int get() {
+          return static_cast<int>(cache->GetCount());
+        }
+      }
+
+      /**
+       * @brief The number of lookups that found output since the cache was opened.
+       */
+      property UInt64 Hits {
+        UInt64 get() {
+          return cache->GetStats().hits;
+        }
+      }
+
+      /**
+       * @brief The number of lookups that found nothing since the cache was opened.
+       */
+      property UInt64 Misses {
+        UInt64 get() {
+          return cache->GetStats().misses;
+        }
+      }
+
+      /**
+       * @brief The number of outputs stored since the cache was opened.
+       */
+      property UInt64 Stores {
+        UInt64 get() {
+          return cache->GetStats().stores;
+        }
+      }
+
+      /**
+       * @brief The number of misses whose output was in the index but missing or corrupt.
+       */
+      property UInt64 Rejected {
+        UInt64 get() {
+          return cache->GetStats().rejected;
+        }
+      }
+
+    private:
+      static std::filesystem::path ToPath(String^ value) {
+        pin_ptr<const wchar_t> characters = PtrToStringChars(value);
+        return std::filesystem::path(std::wstring(characters, value->Length));
+      }
+
+      NativeImpls::CompileCache* cache;
+  };
+}
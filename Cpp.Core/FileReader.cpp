@@ -0,0 +1,74 @@
+﻿#include "file-reader.h"
+
+#include <vcclr.h>
+
+using namespace System;
+using namespace System::IO;
+
+namespace Cpp::Core {
+  /**
+   * @brief Reads a file straight into unmanaged memory, e.g. the backing store of a script's
+   * `ArrayBuffer`, without copying it through a managed array. The file is read in chunks of the
+   * caller's choosing, so the memory only has to stay valid for the duration of each one.
+   */
+  public ref class FileReader {
+    public:
+      /**
+       * @brief Opens a file for reading from its start.
+       */
+      FileReader(String^ path) : reader(new NativeImpls::FileReader()) {
+        if (path == nullptr) {
+          throw gcnew ArgumentNullException("path");
+        }
+
+        pin_ptr<const wchar_t> characters = PtrToStringChars(path);
+        std::filesystem::path nativePath(std::wstring(characters, path->Length));
+
+        std::string error;
+        if (!reader->Open(nativePath, error)) {
+          delete reader;
+          reader = nullptr;
+          throw gcnew IOException(gcnew String(error.c_str()));
+        }
+      }
+
+      ~FileReader() {
+        this->!FileReader();
+      }
+
+      !FileReader() {
+        delete reader;
+        reader = nullptr;
+      }
+
+      /**
+       * @brief Reads the next bytes of the file.
+       * @param destination The memory to read into, which must stay valid until this returns.
+       * @param count The most bytes to read.
+       * @returns The number of bytes read, which is only less than `count` at the end of the file.
+       */
+      Int64 Read(IntPtr destination, Int64 count) {
+        if (count < 0) {
+          throw gcnew ArgumentOutOfRangeException("count");
+        }
+
+        if (count > 0 && destination == IntPtr::Zero) {
+          throw gcnew ArgumentNullException("destination");
+        }
+
+        if (reader == nullptr) {
+          throw gcnew ObjectDisposedException("FileReader");
+        }
+
+        size_t size = 0;
+        std::string error;
+        if (!reader->Read(destination.ToPointer(), static_cast<size_t>(count), size, error)) {
+          throw gcnew IOException(gcnew String(error.c_str()));
+        }
+        return static_cast<Int64>(size);
+      }
+
+    private:
+      NativeImpls::FileReader* reader;
+  };
+}
@@ -0,0 +1,168 @@
+﻿#include "glob-walker.h"
+
+#include <vcclr.h>
+
+using namespace System;
+
+namespace Cpp::Core {
+  /**
+   * @brief Finds the files in a directory tree that match a glob on a pool of native threads,
+   * which skip the subtrees that can't hold matches and stream the matches to a single managed
+   * reader as they're found.
+   */
+  public ref class GlobWalker {
+    public:
+      /**
+       * @brief Starts walking a directory.
+       * @param root The directory to walk.
+       * @param include The glob that files must match, relative to `root`.
+       * @param excludes Globs that exclude the files, and the whole directories, that they match,
+       * or `nullptr`.
+       * @param ignoreCase Whether the globs ignore case.
+       */
+      GlobWalker(String^ root, String^ include, array<String^>^ excludes, bool ignoreCase) {
+        if (root == nullptr) {
+          throw gcnew ArgumentNullException("root");
+        }
+
+        if (include == nullptr) {
+          throw gcnew ArgumentNullException("include");
+        }
+
+        std::string error;
+        NativeImpls::GlobPattern includePattern;
+        if (!includePattern.Compile(ToNative(include), ignoreCase, error)) {
+          throw gcnew ArgumentException(gcnew String(error.c_str()), "include");
+        }
+
+        std::vector<NativeImpls::GlobPattern> excludePatterns;
+        if (excludes != nullptr) {
+          for each (String^ exclude in excludes) {
+            if (exclude == nullptr) {
+              throw gcnew ArgumentException("Exclusions can't be null.", "excludes");
+            }
+
+            NativeImpls::GlobPattern excludePattern;
+            if (!excludePattern.Compile(ToNative(exclude), ignoreCase, error)) {
+              throw gcnew ArgumentException(gcnew String(error.c_str()), "excludes");
+            }
+            excludePatterns.push_back(std::move(excludePattern));
+          }
+        }
+
+        pin_ptr<const wchar_t> characters = PtrToStringChars(root);
+        walker = new NativeImpls::GlobWalker();
+        walker->Start(
+          std::filesystem::path(std::wstring(characters, root->Length)),
+          std::move(includePattern),
+          std::move(excludePatterns),
+          0
+        );
+      }
+
+      ~GlobWalker() {
+        this->!GlobWalker();
+      }
+
+      !GlobWalker() {
+        delete walker;
+        walker = nullptr;
+      }
+
+      /**
+       * @brief Checks whether a glob can be walked natively, i.e. it's not empty, doesn't refer to
+       * a parent directory, and doesn't have too many segments.
+       */
+      static bool IsSupported(String^ pattern) {
+        if (pattern == nullptr) {
+          return false;
+        }
+
+        std::string error;
+        NativeImpls::GlobPattern compiled;
+        return compiled.Compile(ToNative(pattern), false, error);
+      }
+
+      /**
+       * @brief Reads the paths of matching files, relative to the root, waiting for at least one
+       * if there are none. Must only be called from one thread at a time.
+       * @param paths Receives the paths, in no particular order.
+       * @param timeoutMilliseconds How long to wait, or `Timeout.Infinite` to wait indefinitely.
+       * @returns The number of paths read, which is 0 if the wait timed out or the walk is over.
+       * See `IsFinished`.
+       */
+      int Read(array<String^>^ paths, int timeoutMilliseconds) {
+        if (paths == nullptr) {
+          throw gcnew ArgumentNullException("paths");
+        }
+
+        if (paths->Length == 0) {
+          return 0;
+        }
+
+        std::vector<std::u16string> buffer(paths->Length);
+        auto timeout = timeoutMilliseconds < 0 ? -1 : int64_t{timeoutMilliseconds} * 1000;
+        auto count   = walker->Read(buffer.data(), paths->Length, timeout);
+        for (size_t i = 0; i < count; i++) {
+          auto& path = buffer[i];
+          paths[static_cast<int>(i)] = gcnew String(
+            reinterpret_cast<const wchar_t*>(path.data()),
+            0,
+            static_cast<int>(path.size())
+          );
+        }
+        return static_cast<int>(count);
+      }
+
+      /**
+       * @brief Stops the walk and wakes the reader.
+       */
+      void Stop() {
+        walker->Stop();
+      }
+
+      /**
+       * @brief Whether the walk is over and every path was read.
+       */
+      property bool IsFinished {
+        bool get() {
+          return walker->IsFinished();
+        }
+      }
+
+      /**
+       * @brief The number of directories listed.
+       */
+      property UInt64 DirectoryCount {
+        UInt64 get() {
+          return walker->GetDirectoryCount();
+        }
+      }
+
+      /**
+       * @brief The number of directories that couldn't be listed, e.g. for lack of access.
+       */
+      property UInt64 SkippedCount {
+        UInt64 get() {
+          return walker->GetSkippedCount();
+        }
+      }
+
+      /**
+       * @brief The number of directories a thread took from another thread's queue.
+       */
+      property UInt64 StolenCount {
+        UInt64 get() {
+          return walker->GetStolenCount();
+        }
+      }
+
+    private:
+      static std::u16string ToNative(String^ value) {
+        pin_ptr<const wchar_t> characters = PtrToStringChars(value);
+        return std::u16string(reinterpret_cast<const char16_t*>(characters), value->Length);
+      }
+
+      NativeImpls::GlobWalker* walker;
+  };
+}
@@ -0,0 +1,167 @@
+﻿#include "run-queue.h"
+
+using namespace System;
+
+namespace Cpp::Core {
+  /**
+   * @brief A native multi-producer, single-consumer queue of 64-bit items, e.g. `GCHandle`s to
+   * callbacks. Pushing never takes a lock, and the consumer takes every ready item per wakeup and
+   * only parks in the kernel once the queue is empty.
+   *
+   * It's safe to push to the queue while, or after, it's disposed. Disposing closes the queue and
+   * waits for the calls still using it before freeing it.
+   */
+  public ref class RunQueue {
+    public:
+      RunQueue() : queue(new NativeImpls::RunQueue()), users(0), isDisposed(0) {}
+
+      ~RunQueue() {
+        this->!RunQueue();
+      }
+
+      !RunQueue() {
+        if (Threading::Interlocked::Exchange(isDisposed, 1) != 0) {
+          return;
+        }
+
+        // Anyone waiting to drain returns once the queue is closed and empty.
+        queue->Close();
+
+        Threading::SpinWait spinner;
+        while (Threading::Volatile::Read(users) != 0) {
+          spinner.SpinOnce();
+        }
+
+        delete queue;
+        queue = nullptr;
+      }
+
+      /**
+       * @brief Adds an item to the back of the queue. May be called from any thread.
+       * @returns `false` if the queue was closed or disposed, in which case the item wasn't added.
+       */
+      bool Push(Int64 item) {
+        if (!Enter()) {
+          return false;
+        }
+
+        try {
+          return queue->Push(static_cast<uint64_t>(item));
+        }
+        finally {
+          Exit();
+        }
+      }
+
+      /**
+       * @brief Takes the items at the front of the queue, waiting for at least one if there are
+       * none. Must only be called from one thread at a time.
+       * @param items Receives the items, in the order they were pushed by each producer.
+       * @param timeoutMilliseconds How long to wait, or `Timeout.Infinite` to wait indefinitely.
+       * @returns The number of items taken, which is 0 if the wait timed out or the queue was
+       * closed and is empty.
+       */
+      int Drain(array<Int64>^ items, int timeoutMilliseconds) {
+        if (items == nullptr) {
+          throw gcnew ArgumentNullException("items");
+        }
+
+        if (items->Length == 0) {
+          return 0;
+        }
+
+        if (!Enter()) {
+          return 0;
+        }
+
+        try {
+          pin_ptr<Int64> pinned = &items[0];
+          auto timeout = timeoutMilliseconds < 0 ? -1 : int64_t{timeoutMilliseconds} * 1000;
+          auto count   = queue->Drain(reinterpret_cast<uint64_t*>(pinned), items->Length, timeout);
+          return static_cast<int>(count);
+        }
+        finally {
+          Exit();
+        }
+      }
+
+      /**
+       * @brief Stops accepting items and wakes the consumer. Returns once every accepted push has
+       * been linked in, so once `Drain` then returns 0 without a timeout, no item is left behind.
+       */
+      void Close() {
+        if (!Enter()) {
+          return;
+        }
+
+        try {
+          queue->Close();
+        }
+        finally {
+          Exit();
+        }
+      }
+
+      /**
+       * @brief The number of times the consumer parked because the queue was empty.
+       */
+      property UInt64 ParkCount {
+        UInt64 get() {
+          if (!Enter()) {
+            return 0;
+          }
+
+          try {
+            return queue->GetParkCount();
+          }
+          finally {
+            Exit();
+          }
+        }
+      }
+
+      /**
+       * @brief The number of times a producer woke the parked consumer.
+       */
+      property UInt64 WakeCount {
+        UInt64 get() {
+          if (!Enter()) {
+            return 0;
+          }
+
+          try {
+            return queue->GetWakeCount();
+          }
+          finally {
+            Exit();
+          }
+        }
+      }
+
+    private:
+      NativeImpls::RunQueue* queue;
+
+      // The calls using `queue`, which the finalizer waits for before freeing it.
+      int users;
+      int isDisposed;
+
+      /**
+       * @brief Registers a call that uses the native queue.
+       * @returns `false` if the queue is disposed, in which case it mustn't be used.
+       */
+      bool Enter() {
+        // Registering first means either the finalizer waits for this call, or this call sees
+        // that the queue is disposed. Both are full fences.
+        Threading::Interlocked::Increment(users);
+        if (Threading::Interlocked::CompareExchange(isDisposed, 0, 0) != 0) {
+          Threading::Interlocked::Decrement(users);
+          return false;
+        }
+        return true;
+      }
+
+      void Exit() {
+        Threading::Interlocked::Decrement(users);
+      }
+  };
+}
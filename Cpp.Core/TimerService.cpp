@@ -0,0 +1,85 @@
+﻿#include "timer-wheel.h"
+
+using namespace System;
+
+namespace Cpp::Core {
+  /**
+   * @brief Millisecond timers kept in a native hierarchical timing wheel and driven by a single
+   * native thread, which queues the timers that expire, in order, for a single managed reader.
+   */
+  public ref class TimerService {
+    public:
+      TimerService() : service(new NativeImpls::TimerService()) {
+        service->Start();
+      }
+
+      ~TimerService() {
+        this->!TimerService();
+      }
+
+      !TimerService() {
+        delete service;
+        service = nullptr;
+      }
+
+      /**
+       * @brief Schedules a timer.
+       * @param delayMilliseconds How long until the timer expires.
+       * @param intervalMilliseconds How long between the expirations of a repeating timer, or 0 to
+       * only expire once.
+       * @returns The identifier of the timer, which is never 0.
+       */
+      UInt32 Schedule(UInt32 delayMilliseconds, UInt32 intervalMilliseconds) {
+        return service->Schedule(delayMilliseconds, intervalMilliseconds);
+      }
+
+      /**
+       * @brief Cancels a timer. An expiration that's already queued is still read.
+       * @returns Whether the timer was pending.
+       */
+      bool Cancel(UInt32 id) {
+        return service->Cancel(id);
+      }
+
+      /**
+       * @brief Reads the timers that expired, waiting for at least one if there are none. Must only
+       * be called from one thread at a time.
+       * @param ids Receives the identifiers of the timers, in the order they expired.
+       * @param timeoutMilliseconds How long to wait, or `Timeout.Infinite` to wait indefinitely.
+       * @returns The number of identifiers read, which is 0 if the wait timed out or the service
+       * was stopped.
+       */
+      int Read(array<UInt32>^ ids, int timeoutMilliseconds) {
+        if (ids == nullptr) {
+          throw gcnew ArgumentNullException("ids");
+        }
+
+        if (ids->Length == 0) {
+          return 0;
+        }
+
+        pin_ptr<UInt32> pinned = &ids[0];
+        auto timeout = timeoutMilliseconds < 0 ? -1 : int64_t{timeoutMilliseconds} * 1000;
+        return static_cast<int>(service->Read(pinned, ids->Length, timeout));
+      }
+
+      /**
+       * @brief Stops the timer thread and wakes the reader.
+       */
+      void Stop() {
+        service->Stop();
+      }
+
+      /**
+       * @brief The number of pending timers.
+       */
+      property int Count {
+        int get() {
+          return static_cast<int>(service->GetCount());
+        }
+      }
+
+    private:
+      NativeImpls::TimerService* service;
+  };
+}
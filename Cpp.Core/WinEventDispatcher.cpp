@@ -0,0 +1,155 @@
+﻿#include "win-event-dispatcher.h"
+
+#include <algorithm>
+#include <string>
+
+using namespace System;
+
+namespace Cpp::Core {
+  /**
+   * @brief A WinEvent that passed the dispatcher's filter.
+   */
+  public value struct WinEventRecord {
+    /** The identifier of the event, e.g. `EVENT_OBJECT_CREATE`. */
+    UInt32 Event;
+
+    /** The window the event is about. */
+    IntPtr Hwnd;
+
+    /** The time the event was generated, in milliseconds, as reported by the system. */
+    UInt32 Time;
+  };
+
+  /**
+   * @brief Hooks just the WinEvents that are subscribed to on a native thread, filters them there
+   * and queues the few that pass for a single managed reader. Only events about a window itself
+   * are passed on.
+   */
+  public ref class WinEventDispatcher {
+    public:
+      WinEventDispatcher() : dispatcher(new NativeImpls::WinEventDispatcher()) {
+        dispatcher->Start();
+      }
+
+      ~WinEventDispatcher() {
+        this->!WinEventDispatcher();
+      }
+
+      !WinEventDispatcher() {
+        delete dispatcher;
+        dispatcher = nullptr;
+      }
+
+      /**
+       * @brief Subscribes to events, returning once they're hooked. Subscriptions are counted per
+       * event, so every call that returns must be matched by a call to `Unsubscribe`. Throws
+       * `InvalidOperationException` if the events couldn't be hooked, and keeps no subscription.
+       * @param events The identifiers of the events. See `Core.Utils.WinEvent`.
+       */
+      void Subscribe(array<UInt32>^ events) {
+        if (events == nullptr) {
+          throw gcnew ArgumentNullException("events");
+        }
+
+        if (events->Length > 0) {
+          pin_ptr<UInt32> pinned = &events[0];
+          std::string error;
+          if (!dispatcher->Subscribe(pinned, events->Length, error)) {
+            throw gcnew InvalidOperationException(gcnew String(error.c_str()));
+          }
+        }
+      }
+
+      /**
+       * @brief Removes subscriptions added by `Subscribe`.
+       * @param events The identifiers of the events.
+       */
+      void Unsubscribe(array<UInt32>^ events) {
+        if (events == nullptr) {
+          throw gcnew ArgumentNullException("events");
+        }
+
+        if (events->Length > 0) {
+          pin_ptr<UInt32> pinned = &events[0];
+          dispatcher->Unsubscribe(pinned, events->Length);
+        }
+      }
+
+      /**
+       * @brief Reads queued events, waiting for at least one if there are none. Must only be called
+       * from one thread at a time.
+       * @param records Receives the events, in the order they occurred.
+       * @param timeoutMilliseconds How long to wait, or `Timeout.Infinite` to wait indefinitely.
+       * @returns The number of events read, which is 0 if the wait timed out or the dispatcher was
+       * stopped.
+       */
+      int Read(array<WinEventRecord>^ records, int timeoutMilliseconds) {
+        if (records == nullptr) {
+          throw gcnew ArgumentNullException("records");
+        }
+
+        // Read in chunks, and only wait for the first.
+        constexpr size_t chunkSize = 64;
+        NativeImpls::WinEventRecord chunk[chunkSize];
+
+        int total = 0;
+        auto timeout = timeoutMilliseconds < 0 ? -1 : int64_t{timeoutMilliseconds} * 1000;
+        while (total < records->Length) {
+          auto capacity = std::min(chunkSize, static_cast<size_t>(records->Length - total));
+          auto count    = dispatcher->Read(chunk, capacity, total == 0 ? timeout : 0);
+
+          for (size_t i = 0; i < count; ++i) {
+            WinEventRecord record;
+            record.Event = chunk[i].event;
+            record.Hwnd  = IntPtr(static_cast<Int64>(chunk[i].hwnd));
+            record.Time  = chunk[i].time;
+            records[total++] = record;
+          }
+
+          if (count < capacity) {
+            break;
+          }
+        }
+
+        return total;
+      }
+
+      /**
+       * @brief Unhooks every event and wakes the reader.
+       */
+      void Stop() {
+        dispatcher->Stop();
+      }
+
+      /**
+       * @brief The number of events the hooks received.
+       */
+      property UInt64 ReceivedCount {
+        UInt64 get() {
+          return dispatcher->GetReceivedCount();
+        }
+      }
+
+      /**
+       * @brief The number of events that passed the filter and were queued.
+       */
+      property UInt64 AcceptedCount {
+        UInt64 get() {
+          return dispatcher->GetAcceptedCount();
+        }
+      }
+
+      /**
+       * @brief The number of events that passed the filter but were dropped because the reader
+       * fell behind.
+       */
+      property UInt64 DroppedCount {
+        UInt64 get() {
+          return dispatcher->GetDroppedCount();
+        }
+      }
+
+    private:
+      NativeImpls::WinEventDispatcher* dispatcher;
+  };
+}
@@ -0,0 +1,113 @@
+﻿#include "window-awaiter-index.h"
+#include "WindowMatcher.h"
+
+#include <vector>
+
+using namespace System;
+using namespace System::Collections::Generic;
+
+namespace Cpp::Core {
+  /**
+   * @brief The pending waits for a window with compiled criteria, indexed by event, process and
+   * class so that an event is only compared against the awaiters it could complete. The window an
+   * event is about is queried for each field at most once, however many awaiters compare it. Not
+   * thread-safe.
+   */
+  public ref class WindowAwaiterIndex {
+    public:
+      WindowAwaiterIndex()
+        : index(new NativeImpls::WindowAwaiterIndex()), matches(new std::vector<uint32_t>()) {}
+
+      ~WindowAwaiterIndex() {
+        this->!WindowAwaiterIndex();
+      }
+
+      !WindowAwaiterIndex() {
+        delete index;
+        index = nullptr;
+        delete matches;
+        matches = nullptr;
+      }
+
+      /**
+       * @brief Adds an awaiter. The criteria are copied, so the matcher may be disposed afterwards.
+       * @param events The WinEvents the awaiter waits for. See `Core.Utils.WinEvent`.
+       * @param matcher The criteria that the window an event is about must match.
+       * @returns The identifier of the awaiter, which is never reused.
+       */
+      UInt32 Add(array<UInt32>^ events, WindowMatcher^ matcher) {
+        if (events == nullptr) {
+          throw gcnew ArgumentNullException("events");
+        }
+
+        if (matcher == nullptr) {
+          throw gcnew ArgumentNullException("matcher");
+        }
+
+        if (events->Length == 0) {
+          return index->Add(nullptr, 0, *matcher->matcher);
+        }
+
+        pin_ptr<UInt32> pinned = &events[0];
+        return index->Add(pinned, events->Length, *matcher->matcher);
+      }
+
+      /**
+       * @brief Removes an awaiter added by `Add`.
+       * @returns Whether the awaiter was in the index.
+       */
+      bool Remove(UInt32 id) {
+        return index->Remove(id);
+      }
+
+      /**
+       * @brief Finds the awaiters that an event completes. The awaiters stay in the index.
+       * @param winEvent The identifier of the event.
+       * @param hwnd The window the event is about.
+       * @param ids Receives the identifiers of the awaiters, in the order they were added. Cleared
+       * first.
+       * @returns The number of awaiters found.
+       */
+      int Match(UInt32 winEvent, IntPtr hwnd, List<UInt32>^ ids) {
+        if (ids == nullptr) {
+          throw gcnew ArgumentNullException("ids");
+        }
+
+        NativeImpls::LiveWindow window(
+          static_cast<uint64_t>(hwnd.ToInt64()),
+          NativeImpls::GetDesktopFieldSource()
+        );
+        index->Match(winEvent, window, *matches);
+
+        ids->Clear();
+        for (auto id : *matches) {
+          ids->Add(id);
+        }
+        return ids->Count;
+      }
+
+      /**
+       * @brief The number of awaiters in the index.
+       */
+      property int Count {
+        int get() {
+          return static_cast<int>(index->GetCount());
+        }
+      }
+
+      /**
+       * @brief The number of times an awaiter's criteria were compared against a window.
+       */
+      property UInt64 ComparedCount {
+        UInt64 get() {
+          return index->GetComparedCount();
+        }
+      }
+
+    private:
+      NativeImpls::WindowAwaiterIndex* index;
+
+      // Reused across calls to `Match`.
+      std::vector<uint32_t>* matches;
+  };
+}
@@ -0,0 +1 @@
+﻿#include "WindowMatcher.h"
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "window-matcher.h"
+
+#include <vcclr.h>
+
+using namespace System;
+using namespace System::Runtime::InteropServices;
+
+namespace Cpp::Core {
+  /**
+   * @brief How a `WindowMatcher` compares its patterns.
+   */
+  public enum class WindowMatchMode {
+    /** The whole string must equal the pattern. */
+    Exact = static_cast<int>(NativeImpls::MatchMode::Exact),
+
+    /**
+     * The whole string must match the pattern, where `*` matches any run of characters and `?`
+     * matches any single character.
+     */
+    Glob = static_cast<int>(NativeImpls::MatchMode::Glob),
+
+    /** The pattern is an ECMAScript regular expression that must match part of the string. */
+    Regex = static_cast<int>(NativeImpls::MatchMode::Regex)
+  };
+
+  /**
+   * @brief Criteria for finding a window, compiled once so that they can be compared against many
+   * windows without creating a managed string per window.
+   */
+  public ref class WindowMatcher {
+    public:
+      /**
+       * @param title The pattern to match titles against, or null for any title.
+       * @param className The pattern to match class names against, or null for any class.
+       * @param processName The pattern to match the file name of the window's process image
+       * against, e.g. "explorer.exe", or null for any process.
+       * @param processId Only windows of this process, or null for any process.
+       * @param mode How the patterns are compared.
+       * @param ignoreCase Whether the patterns ignore case.
+       * @throws ArgumentException A pattern is an invalid regular expression.
+       */
+      WindowMatcher(
+        String^ title,
+        String^ className,
+        String^ processName,
+        Nullable<UInt32> processId,
+        WindowMatchMode mode,
+        bool ignoreCase
+      ) : matcher(new NativeImpls::WindowMatcher()) {
+        auto nativeMode = static_cast<NativeImpls::MatchMode>(mode);
+
+        if (title != nullptr && !matcher->SetTitle(ToNative(title), nativeMode, ignoreCase)) {
+          throw gcnew ArgumentException(GetError(), "title");
+        }
+        if (className != nullptr &&
+            !matcher->SetClassName(ToNative(className), nativeMode, ignoreCase)) {
+          throw gcnew ArgumentException(GetError(), "className");
+        }
+        if (processName != nullptr &&
+            !matcher->SetProcessName(ToNative(processName), nativeMode, ignoreCase)) {
+          throw gcnew ArgumentException(GetError(), "processName");
+        }
+        if (processId.HasValue) {
+          matcher->SetProcessId(processId.Value);
+        }
+      }
+
+      ~WindowMatcher() {
+        this->!WindowMatcher();
+      }
+
+      !WindowMatcher() {
+        delete matcher;
+        matcher = nullptr;
+      }
+
+      /**
+       * @brief Checks a live window, querying just the fields the criteria compare.
+       * @returns Whether the window matches every criterion.
+       */
+      bool Matches(IntPtr hwnd) {
+        return matcher->MatchesWindow(static_cast<uint64_t>(hwnd.ToInt64()));
+      }
+
+      /**
+       * @brief Finds the windows of a snapshot that match.
+       * @param snapshot A window snapshot that gathered every field in `Fields`.
+       * @returns The indexes of the matching windows, in ascending order.
+       * @throws ArgumentException The snapshot is malformed or lacks a field.
+       */
+      array<int>^ Filter(array<Byte>^ snapshot) {
+        if (snapshot == nullptr) {
+          throw gcnew ArgumentNullException("snapshot");
+        }
+
+        if (snapshot->Length == 0) {
+          throw gcnew ArgumentException("The window snapshot is malformed.", "snapshot");
+        }
+
+        pin_ptr<Byte> data = &snapshot[0];
+
+        NativeImpls::WindowSnapshotReader reader;
+        if (!reader.Open(data, static_cast<size_t>(snapshot->Length))) {
+          throw gcnew ArgumentException("The window snapshot is malformed.", "snapshot");
+        }
+
+        if ((matcher->GetFields() & ~reader.GetFields()) != 0) {
+          throw gcnew ArgumentException(
+            "The window snapshot lacks a field the criteria compare.",
+            "snapshot"
+          );
+        }
+
+        auto matches = matcher->Filter(reader);
+
+        auto result = gcnew array<int>(static_cast<int>(matches.size()));
+        if (!matches.empty()) {
+          Marshal::Copy(IntPtr(matches.data()), result, 0, result->Length);
+        }
+        return result;
+      }
+
+      /**
+       * @brief The `WindowSnapshotFields` that the criteria compare.
+       */
+      property UInt32 Fields {
+        UInt32 get() {
+          return matcher->GetFields();
+        }
+      }
+
+    internal:
+      NativeImpls::WindowMatcher* matcher;
+
+    private:
+      String^ GetError() {
+        return gcnew String(matcher->GetError().c_str());
+      }
+
+      static std::u16string ToNative(String^ value) {
+        pin_ptr<const wchar_t> characters = PtrToStringChars(value);
+        return std::u16string(reinterpret_cast<const char16_t*>(characters), value->Length);
+      }
+  };
+}
@@ -0,0 +1,106 @@
+﻿#include "window-registry.h"
+#include "WindowMatcher.h"
+
+#include <vcclr.h>
+
+using namespace System;
+using namespace System::Runtime::InteropServices;
+
+namespace Cpp::Core {
+  /**
+   * @brief Looks up windows in the registry shared by the process, which is indexed by process,
+   * process name, class and title and kept current from window events, so lookups don't enumerate
+   * the desktop.
+   */
+  public ref class WindowRegistry {
+    public:
+      /**
+       * @brief Finds the windows that match every given criterion.
+       * @param hwnd Only the window with this handle, or zero for any window.
+       * @param processId Only windows of this process, or null for any process.
+       * @param processName Only windows of processes with this image file name, e.g.
+       * "explorer.exe", or null for any. Compared case-insensitively.
+       * @param className Only windows of this class, or null for any. Compared case-insensitively.
+       * @param title Only windows with exactly this title, or null for any.
+       * @param ancestor Only descendants of this window, or zero for any window.
+       * @param topLevelOnly Whether to only find top-level windows.
+       * @return The matching windows, top-level windows first, laid out as a window snapshot.
+       */
+      static array<Byte>^ Find(
+        IntPtr hwnd,
+        Nullable<UInt32> processId,
+        String^ processName,
+        String^ className,
+        String^ title,
+        IntPtr ancestor,
+        bool topLevelOnly
+      ) {
+        NativeImpls::WindowQuery query;
+        query.topLevelOnly = topLevelOnly;
+
+        if (hwnd != IntPtr::Zero) {
+          query.hwnd = static_cast<uint64_t>(hwnd.ToInt64());
+        }
+        if (processId.HasValue) {
+          query.processId = processId.Value;
+        }
+        if (processName != nullptr) {
+          query.processName = ToNative(processName);
+        }
+        if (className != nullptr) {
+          query.className = ToNative(className);
+        }
+        if (title != nullptr) {
+          query.title = ToNative(title);
+        }
+        if (ancestor != IntPtr::Zero) {
+          query.ancestor = static_cast<uint64_t>(ancestor.ToInt64());
+        }
+
+        auto windows  = NativeImpls::GetWindowRegistry().Find(query);
+        auto snapshot = NativeImpls::ToWindowSnapshot(windows);
+
+        auto result = gcnew array<Byte>(static_cast<int>(snapshot.size()));
+        Marshal::Copy(IntPtr(snapshot.data()), result, 0, result->Length);
+        return result;
+      }
+
+      /**
+       * @brief Finds the windows that match a matcher, narrowing the lookup with its literal
+       * patterns.
+       * @param topLevelOnly Whether to only find top-level windows.
+       * @return The matching windows, top-level windows first, laid out as a window snapshot.
+       */
+      static array<Byte>^ Find(WindowMatcher^ matcher, bool topLevelOnly) {
+        if (matcher == nullptr) {
+          throw gcnew ArgumentNullException("matcher");
+        }
+
+        auto windows = NativeImpls::FindWindows(
+          NativeImpls::GetWindowRegistry(),
+          *matcher->matcher,
+          topLevelOnly
+        );
+        auto snapshot = NativeImpls::ToWindowSnapshot(windows);
+
+        auto result = gcnew array<Byte>(static_cast<int>(snapshot.size()));
+        Marshal::Copy(IntPtr(snapshot.data()), result, 0, result->Length);
+        return result;
+      }
+
+      /**
+       * @brief The number of windows in the registry.
+       */
+      static property int Count {
+        int get() {
+          return static_cast<int>(NativeImpls::GetWindowRegistry().GetCount());
+        }
+      }
+
+    private:
+      static std::u16string ToNative(String^ value) {
+        pin_ptr<const wchar_t> characters = PtrToStringChars(value);
+        return std::u16string(reinterpret_cast<const char16_t*>(characters), value->Length);
+      }
+  };
+}
@@ -1,6 +1,9 @@
 ﻿#include "window-utils.h";
+#include "window-snapshot.h"
 
 using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::Runtime::InteropServices;
 using namespace Cpp::Core;
 
 namespace Cpp::Core {
@@ -18,5 +21,56 @@ namespace Cpp::Core {
         auto processName = NativeImpls::GetProcessName(nativeHwnd);
         return gcnew String(processName.data());
       }
+
+      /**
+       * @brief Gets the process names for a batch of windows. Each process is only looked up once,
+       * and windows of the same process share the same managed string.
+       * @param hwnds The window handles.
+       * @return The process name for each window, in the same order as the handles.
+       */
+      static array<String^>^ GetProcessNames(array<IntPtr>^ hwnds) {
+        if (hwnds == nullptr) {
+          throw gcnew ArgumentNullException("hwnds");
+        }
+
+        auto names     = gcnew array<String^>(hwnds->Length);
+        auto byProcess = gcnew Dictionary<UInt32, String^>();
+
+        for (int i = 0; i < hwnds->Length; ++i) {
+          DWORD processId = 0;
+          GetWindowThreadProcessId(reinterpret_cast<HWND>(hwnds[i].ToPointer()), &processId);
+
+          String^ name;
+          if (!byProcess->TryGetValue(processId, name)) {
+            name = gcnew String(NativeImpls::GetProcessImageName(processId).data());
+            byProcess->Add(processId, name);
+          }
+
+          names[i] = name;
+        }
+
+        return names;
+      }
+
+      /**
+       * @brief Takes a snapshot of the windows on the desktop in a single pass, and copies it into
+       * managed memory in one go.
+       * @param fields The `WindowSnapshotFields` to gather.
+       * @param root The window whose descendants to snapshot, or zero for the top-level windows.
+       * @param includeChildren Whether to include the descendants of the top-level windows.
+       * @return The snapshot, as laid out by `NativeImpls::WindowSnapshotBuilder`.
+       */
+      static array<Byte>^ SnapshotWindows(UInt32 fields, IntPtr root, bool includeChildren) {
+        auto snapshot = NativeImpls::SnapshotWindows(
+          fields,
+          static_cast<uint64_t>(root.ToInt64()),
+          includeChildren
+        );
+
+        auto result = gcnew array<Byte>(static_cast<int>(snapshot.size()));
+        Marshal::Copy(IntPtr(snapshot.data()), result, 0, result->Length);
+
+        return result;
+      }
   };
 }
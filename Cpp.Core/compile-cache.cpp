@@ -0,0 +1,418 @@
+#include "compile-cache.h"
+
+#include <cstring>
+#include <fstream>
+
+#include "content-hash.h"
+
+namespace Cpp::Core::NativeImpls {
+  namespace {
+    constexpr uint32_t indexMagic = 0x43434C47; // "GLCC"
+    constexpr uint32_t indexVersion = 2;
+    constexpr uint32_t initialCapacity = 256;
+
+    constexpr auto indexName = "index.bin";
+    constexpr auto lockName = "index.lock";
+    constexpr auto outputExtension = ".out";
+
+    uint32_t GetSlot(uint64_t sourceHash, uint32_t capacity) {
+      // The high bits of the hash are the best mixed.
+      return static_cast<uint32_t>(sourceHash >> 32) & (capacity - 1);
+    }
+
+    /**
+     * @brief Hashes an output, reserving 0 to mark empty entries.
+     */
+    uint64_t HashOutput(std::string_view output) {
+      auto hash = HashContent(output.data(), output.size(), 0);
+      return hash != 0 ? hash : 1;
+    }
+
+    /**
+     * @brief Holds a `FileLock` for as long as it's in scope.
+     */
+    class ScopedFileLock {
+      public:
+        ScopedFileLock(FileLock& lock, bool exclusive)
+          : lock(lock), isLocked(lock.Lock(exclusive)) {}
+
+        ~ScopedFileLock() {
+          if (isLocked) {
+            lock.Unlock();
+          }
+        }
+
+        ScopedFileLock(const ScopedFileLock&)            = delete;
+        ScopedFileLock& operator=(const ScopedFileLock&) = delete;
+
+        bool IsLocked() const {
+          return isLocked;
+        }
+
+      private:
+        FileLock& lock;
+        bool isLocked;
+    };
+  }
+
+  struct CompileCache::Header {
+    uint32_t magic;
+    uint32_t version;
+
+    /** The number of entries the table has room for. A power of two. */
+    uint32_t capacity;
+
+    /** The number of entries in use. */
+    uint32_t count;
+
+    /** Set once another index has replaced this one, which processes still mapping it then map. */
+    uint32_t retired;
+    uint32_t reserved;
+  };
+
+  struct CompileCache::Entry {
+    /** The hash of the source, seeded with the fingerprint. */
+    uint64_t sourceHash;
+    uint64_t fingerprint;
+
+    /** The hash of the output, which also names its file. 0 if the entry is empty. */
+    uint64_t outputHash;
+    uint32_t sourceLength;
+    uint32_t outputLength;
+  };
+
+  bool CompileCache::Open(const std::filesystem::path& directory, std::string& error) {
+    std::lock_guard guard(lock);
+
+    std::error_code code;
+    std::filesystem::create_directories(directory, code);
+    if (code) {
+      error = "Creating " + directory.u8string() + " failed: " + code.message();
+      return false;
+    }
+
+    this->directory = directory;
+    if (!fileLock.Open(directory / lockName, error)) {
+      return false;
+    }
+
+    ScopedFileLock fileGuard(fileLock, true);
+    if (!fileGuard.IsLocked()) {
+      error = "Locking " + (directory / lockName).u8string() + " failed";
+      return false;
+    }
+
+    // An index from an older version, or that was cut short, is replaced along with the outputs
+    // it refers to.
+    return OpenIndex() || Reset(error);
+  }
+
+  bool CompileCache::Lookup(
+    const void* source,
+    size_t size,
+    uint64_t fingerprint,
+    std::string& output
+  ) {
+    std::lock_guard guard(lock);
+
+    // Entries record the length of their source in 32 bits, so a larger source was never stored.
+    if (size > UINT32_MAX) {
+      ++stats.misses;
+      return false;
+    }
+
+    // Held until the output is read, so another process can't remove it in the meantime.
+    ScopedFileLock fileGuard(fileLock, false);
+    Entry* entry = nullptr;
+    if (fileGuard.IsLocked()) {
+      Refresh();
+
+      auto sourceHash = HashContent(source, size, fingerprint);
+      entry           = Find(sourceHash, fingerprint, static_cast<uint32_t>(size));
+    }
+
+    if (!entry || entry->outputHash == 0) {
+      ++stats.misses;
+      return false;
+    }
+
+    std::ifstream file(GetOutputPath(entry->outputHash), std::ios::binary);
+    output.resize(entry->outputLength);
+    if (!file.read(output.data(), static_cast<std::streamsize>(output.size())) ||
+        file.peek() != std::ifstream::traits_type::eof() ||
+        HashOutput(output) != entry->outputHash) {
+      output.clear();
+      ++stats.misses;
+      ++stats.rejected;
+      return false;
+    }
+
+    ++stats.hits;
+    return true;
+  }
+
+  bool CompileCache::Store(
+    const void* source,
+    size_t size,
+    uint64_t fingerprint,
+    std::string_view output
+  ) {
+    std::lock_guard guard(lock);
+    if (size > UINT32_MAX || output.size() > UINT32_MAX) {
+      return false;
+    }
+
+    ScopedFileLock fileGuard(fileLock, true);
+    if (!fileGuard.IsLocked()) {
+      return false;
+    }
+
+    Refresh();
+    std::string error;
+    if (!index.GetData() && !Reset(error)) {
+      return false;
+    }
+
+    // If the index can't be replaced when it's full, the cache is read-only until it can be.
+    auto header = reinterpret_cast<Header*>(index.GetData());
+    if ((header->count + 1) * 2 > header->capacity) {
+      if (header->count >= MaxEntries ? !Reset(error) : !Grow()) {
+        return false;
+      }
+      header = reinterpret_cast<Header*>(index.GetData());
+    }
+
+    // Outputs are written under a temporary name and then renamed, so a reader never sees one
+    // half-written. Identical outputs share a file.
+    auto outputHash = HashOutput(output);
+    auto outputPath = GetOutputPath(outputHash);
+    auto temporary  = outputPath;
+    temporary += ".tmp";
+    {
+      std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+      if (!file.write(output.data(), static_cast<std::streamsize>(output.size())) ||
+          !file.flush()) {
+        return false;
+      }
+    }
+
+    std::error_code code;
+    std::filesystem::rename(temporary, outputPath, code);
+    if (code) {
+      std::filesystem::remove(temporary, code);
+      return false;
+    }
+
+    auto sourceHash = HashContent(source, size, fingerprint);
+    auto entry      = Find(sourceHash, fingerprint, static_cast<uint32_t>(size));
+    if (entry->outputHash == 0) {
+      ++header->count;
+    }
+
+    // The output hash marks the entry as used, so it's written last.
+    entry->sourceHash   = sourceHash;
+    entry->fingerprint  = fingerprint;
+    entry->sourceLength = static_cast<uint32_t>(size);
+    entry->outputLength = static_cast<uint32_t>(output.size());
+    entry->outputHash   = outputHash;
+
+    ++stats.stores;
+    return true;
+  }
+
+  void CompileCache::Clear() {
+    std::lock_guard guard(lock);
+
+    ScopedFileLock fileGuard(fileLock, true);
+    if (fileGuard.IsLocked()) {
+      std::string error;
+      Reset(error);
+    }
+  }
+
+  size_t CompileCache::GetCount() {
+    std::lock_guard guard(lock);
+
+    ScopedFileLock fileGuard(fileLock, false);
+    if (!fileGuard.IsLocked()) {
+      return 0;
+    }
+
+    Refresh();
+    if (!index.GetData()) {
+      return 0;
+    }
+    return reinterpret_cast<const Header*>(index.GetData())->count;
+  }
+
+  CompileCacheStats CompileCache::GetStats() const {
+    std::lock_guard guard(lock);
+    return stats;
+  }
+
+  bool CompileCache::Reset(std::string& error) {
+    auto temporary = GetIndexPath();
+    temporary += ".tmp";
+
+    MappedFile empty;
+    if (!CreateIndex(empty, temporary, initialCapacity, error)) {
+      return false;
+    }
+    empty.Close();
+
+    if (!ReplaceIndex(temporary, error)) {
+      return false;
+    }
+
+    // Nothing refers to the outputs anymore, and every process that reads them holds the lock file.
+    std::error_code code;
+    for (const auto& file : std::filesystem::directory_iterator(directory, code)) {
+      if (file.path().extension() == outputExtension) {
+        std::filesystem::remove(file.path(), code);
+      }
+    }
+
+    return true;
+  }
+
+  bool CompileCache::OpenIndex() {
+    std::string error;
+    if (index.Open(GetIndexPath(), true, error) && index.GetSize() >= sizeof(Header)) {
+      auto header = reinterpret_cast<const Header*>(index.GetData());
+      auto valid  = header->magic == indexMagic && header->version == indexVersion &&
+        header->capacity != 0 && (header->capacity & (header->capacity - 1)) == 0 &&
+        index.GetSize() == sizeof(Header) + size_t{header->capacity} * sizeof(Entry);
+      if (valid) {
+        return true;
+      }
+    }
+
+    index.Close();
+    return false;
+  }
+
+  void CompileCache::Refresh() {
+    auto header = reinterpret_cast<const Header*>(index.GetData());
+    if (!header || header->retired != 0) {
+      OpenIndex();
+    }
+  }
+
+  bool CompileCache::ReplaceIndex(const std::filesystem::path& temporary, std::string& error) {
+    // Tell the other processes mapping the current index to map the new one once they get the
+    // lock file. Files can't be renamed over while they're mapped on Windows, so it's unmapped.
+    if (auto header = reinterpret_cast<Header*>(index.GetData())) {
+      header->retired = 1;
+    }
+    index.Close();
+
+    std::error_code code;
+    std::filesystem::rename(temporary, GetIndexPath(), code);
+    if (!code) {
+      return OpenIndex();
+    }
+
+    // The current index is still in place and still valid, so carry on with it.
+    error = "Replacing " + GetIndexPath().u8string() + " failed: " + code.message();
+    std::filesystem::remove(temporary, code);
+    if (OpenIndex()) {
+      reinterpret_cast<Header*>(index.GetData())->retired = 0;
+    }
+    return false;
+  }
+
+  std::filesystem::path CompileCache::GetIndexPath() const {
+    return directory / indexName;
+  }
+
+  bool CompileCache::CreateIndex(
+    MappedFile& file,
+    const std::filesystem::path& path,
+    uint32_t capacity,
+    std::string& error
+  ) {
+    static_assert(sizeof(Header) == 24 && sizeof(Entry) == 32, "The index is persisted");
+
+    if (!file.Create(path, sizeof(Header) + size_t{capacity} * sizeof(Entry), error)) {
+      return false;
+    }
+
+    auto header      = reinterpret_cast<Header*>(file.GetData());
+    header->magic    = indexMagic;
+    header->version  = indexVersion;
+    header->capacity = capacity;
+    header->count    = 0;
+    return true;
+  }
+
+  bool CompileCache::Grow() {
+    auto header   = reinterpret_cast<const Header*>(index.GetData());
+    auto capacity = header->capacity * 2;
+
+    // The larger index is built beside the current one and then renamed over it, so the cache is
+    // never left without a valid index.
+    auto temporary = GetIndexPath();
+    temporary += ".tmp";
+
+    std::string error;
+    MappedFile grown;
+    if (!CreateIndex(grown, temporary, capacity, error)) {
+      return false;
+    }
+
+    auto grownHeader   = reinterpret_cast<Header*>(grown.GetData());
+    grownHeader->count = header->count;
+
+    auto entries      = reinterpret_cast<const Entry*>(header + 1);
+    auto grownEntries = reinterpret_cast<Entry*>(grownHeader + 1);
+    for (uint32_t i = 0; i < header->capacity; ++i) {
+      if (entries[i].outputHash == 0) {
+        continue;
+      }
+
+      auto slot = GetSlot(entries[i].sourceHash, capacity);
+      while (grownEntries[slot].outputHash != 0) {
+        slot = (slot + 1) & (capacity - 1);
+      }
+      grownEntries[slot] = entries[i];
+    }
+
+    grown.Close();
+    return ReplaceIndex(temporary, error);
+  }
+
+  CompileCache::Entry* CompileCache::Find(
+    uint64_t sourceHash,
+    uint64_t fingerprint,
+    uint32_t sourceLength
+  ) const {
+    if (!index.GetData()) {
+      return nullptr;
+    }
+
+    // Returns the entry for the key, or the empty entry where it would go. The table is never
+    // more than half full, so there's always an empty entry to stop at.
+    auto header  = reinterpret_cast<Header*>(index.GetData());
+    auto entries = reinterpret_cast<Entry*>(header + 1);
+    auto slot    = GetSlot(sourceHash, header->capacity);
+    while (true) {
+      auto& entry = entries[slot];
+      if (entry.outputHash == 0 || (entry.sourceHash == sourceHash &&
+                                    entry.fingerprint == fingerprint &&
+                                    entry.sourceLength == sourceLength)) {
+        return &entry;
+      }
+      slot = (slot + 1) & (header->capacity - 1);
+    }
+  }
+
+  std::filesystem::path CompileCache::GetOutputPath(uint64_t outputHash) const {
+    char name[17];
+    for (int i = 15; i >= 0; --i) {
+      name[i] = "0123456789abcdef"[outputHash & 15];
+      outputHash >>= 4;
+    }
+    name[16] = '\0';
+    return directory / (std::string(name) + outputExtension);
+  }
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include "file-lock.h"
+#include "mapped-file.h"
+
+namespace Cpp::Core::NativeImpls {
+  /**
+   * @brief How a `CompileCache` fared since it was opened.
+   */
+  struct CompileCacheStats {
+    /** Lookups that found output. */
+    uint64_t hits = 0;
+
+    /** Lookups that found nothing. */
+    uint64_t misses = 0;
+
+    /** Outputs stored. */
+    uint64_t stores = 0;
+
+    /** Lookups whose entry was found but whose output was missing or corrupt. Also misses. */
+    uint64_t rejected = 0;
+  };
+
+  /**
+   * @brief A persistent cache of compiled scripts, keyed by a hash of their source and of
+   * everything else that affects the output, such as the compiler and its configuration.
+   *
+   * The cache is a directory holding an index and the outputs. The index is an open-addressing
+   * hash table in a memory-mapped file, so a lookup is a hash of the source and a probe of a few
+   * entries, without parsing anything. Outputs are stored in files named by the hash of their
+   * content, and are checked against it when read, so a corrupt or half-written output is only
+   * ever a miss. Once the index holds `MaxEntries` entries the cache starts over.
+   *
+   * Thread-safe, and safe to share between processes. Every process takes a lock file before using
+   * the index, shared to look up and exclusive to change it. The index is never resized or
+   * truncated in place, since that would pull it out from under the other processes that have it
+   * mapped. A larger or empty one is built beside it and renamed over it instead, and the old one
+   * is marked as retired so the others map the new one. If it can't be replaced, e.g. because
+   * another process still has it mapped on Windows, the cache carries on read-only.
+   */
+  class CompileCache {
+    public:
+      /** The most entries kept before the cache is cleared. */
+      static constexpr uint32_t MaxEntries = 4096;
+
+      CompileCache() = default;
+
+      CompileCache(const CompileCache&)            = delete;
+      CompileCache& operator=(const CompileCache&) = delete;
+
+      /**
+       * @brief Opens a cache, creating its directory and index if they don't exist, and replacing
+       * an index that isn't valid.
+       * @param error Receives a description of the problem if the cache can't be opened.
+       * @returns `false` if the cache can't be opened.
+       */
+      bool Open(const std::filesystem::path& directory, std::string& error);
+
+      /**
+       * @brief Looks up the output compiled from a source.
+       * @param fingerprint A hash of everything besides the source that affects the output.
+       * @param output Receives the output if it's found.
+       * @returns Whether the output was found.
+       */
+      bool Lookup(const void* source, size_t size, uint64_t fingerprint, std::string& output);
+
+      /**
+       * @brief Stores the output compiled from a source, replacing any stored before.
+       * @param fingerprint A hash of everything besides the source that affects the output.
+       * @returns `false` if the output couldn't be written.
+       */
+      bool Store(const void* source, size_t size, uint64_t fingerprint, std::string_view output);
+
+      /**
+       * @brief Removes every entry and output.
+       */
+      void Clear();
+
+      /**
+       * @returns The number of entries in the index.
+       */
+      size_t GetCount();
+
+      /**
+       * @returns How the cache fared since it was opened.
+       */
+      CompileCacheStats GetStats() const;
+
+    private:
+      struct Header;
+      struct Entry;
+
+      /**
+       * @brief Replaces the index with an empty one and removes every output. The lock and the
+       * lock file must be held exclusively.
+       */
+      bool Reset(std::string& error);
+
+      /**
+       * @brief Maps the index, if it's valid. The lock file must be held.
+       */
+      bool OpenIndex();
+
+      /**
+       * @brief Maps the index again if another process has replaced it. The lock file must be held.
+       */
+      void Refresh();
+
+      /**
+       * @brief Renames a newly built index over the current one and maps it. If it can't be
+       * renamed, the current index stays mapped. The lock file must be held exclusively.
+       */
+      bool ReplaceIndex(const std::filesystem::path& temporary, std::string& error);
+
+      static bool CreateIndex(
+        MappedFile& file,
+        const std::filesystem::path& path,
+        uint32_t capacity,
+        std::string& error
+      );
+
+      std::filesystem::path GetIndexPath() const;
+      bool Grow();
+      Entry* Find(uint64_t sourceHash, uint64_t fingerprint, uint32_t sourceLength) const;
+      std::filesystem::path GetOutputPath(uint64_t outputHash) const;
+
+      mutable std::mutex lock;
+      std::filesystem::path directory;
+      FileLock fileLock;
+      MappedFile index;
+      CompileCacheStats stats;
+  };
+}
@@ -0,0 +1,111 @@
+#include "content-hash.h"
+
+#include <cstring>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace Cpp::Core::NativeImpls {
+  namespace {
+    constexpr uint64_t secret[4] = {
+      0xa0761d6478bd642full,
+      0xe7037ed1a0b428dbull,
+      0x8ebc6af09c88c6e3ull,
+      0x589965cc75374cc3ull
+    };
+
+    /**
+     * @brief Multiplies two 64-bit values into a 128-bit product, leaving the low half in `a` and
+     * the high half in `b`.
+     */
+    void Multiply(uint64_t& a, uint64_t& b) {
+#if defined(__SIZEOF_INT128__)
+      auto product = static_cast<unsigned __int128>(a) * b;
+      a = static_cast<uint64_t>(product);
+      b = static_cast<uint64_t>(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+      a = _umul128(a, b, &b);
+#else
+      // Schoolbook multiplication of the 32-bit halves.
+      auto aHigh = a >> 32, aLow = a & 0xFFFFFFFF;
+      auto bHigh = b >> 32, bLow = b & 0xFFFFFFFF;
+      auto high = aHigh * bHigh, middle0 = aHigh * bLow, middle1 = aLow * bHigh, low = aLow * bLow;
+      auto carry = (low >> 32) + (middle0 & 0xFFFFFFFF) + (middle1 & 0xFFFFFFFF);
+      a = (low & 0xFFFFFFFF) | (carry << 32);
+      b = high + (middle0 >> 32) + (middle1 >> 32) + (carry >> 32);
+#endif
+    }
+
+    uint64_t Mix(uint64_t a, uint64_t b) {
+      Multiply(a, b);
+      return a ^ b;
+    }
+
+    // Reads are little-endian, which every platform the launcher runs on is.
+    uint64_t Read64(const uint8_t* p) {
+      uint64_t value;
+      std::memcpy(&value, p, sizeof(value));
+      return value;
+    }
+
+    uint64_t Read32(const uint8_t* p) {
+      uint32_t value;
+      std::memcpy(&value, p, sizeof(value));
+      return value;
+    }
+
+    /**
+     * @brief Reads 1 to 3 bytes into one value.
+     */
+    uint64_t ReadSmall(const uint8_t* p, size_t size) {
+      return (uint64_t{p[0]} << 16) | (uint64_t{p[size >> 1]} << 8) | p[size - 1];
+    }
+  }
+
+  uint64_t HashContent(const void* data, size_t size, uint64_t seed) {
+    auto p = static_cast<const uint8_t*>(data);
+    seed ^= Mix(seed ^ secret[0], secret[1]);
+
+    uint64_t a = 0;
+    uint64_t b = 0;
+    if (size <= 16) {
+      if (size >= 4) {
+        auto offset = (size >> 3) << 2;
+        a = (Read32(p) << 32) | Read32(p + offset);
+        b = (Read32(p + size - 4) << 32) | Read32(p + size - 4 - offset);
+      } else if (size > 0) {
+        a = ReadSmall(p, size);
+      }
+    } else {
+      auto remaining = size;
+      if (remaining > 48) {
+        auto seed1 = seed;
+        auto seed2 = seed;
+        do {
+          seed  = Mix(Read64(p) ^ secret[1], Read64(p + 8) ^ seed);
+          seed1 = Mix(Read64(p + 16) ^ secret[2], Read64(p + 24) ^ seed1);
+          seed2 = Mix(Read64(p + 32) ^ secret[3], Read64(p + 40) ^ seed2);
+          p += 48;
+          remaining -= 48;
+        } while (remaining > 48);
+        seed ^= seed1 ^ seed2;
+      }
+
+      while (remaining > 16) {
+        seed = Mix(Read64(p) ^ secret[1], Read64(p + 8) ^ seed);
+        p += 16;
+        remaining -= 16;
+      }
+
+      // The last 16 bytes, which may overlap the ones already mixed.
+      a = Read64(p + remaining - 16);
+      b = Read64(p + remaining - 8);
+    }
+
+    a ^= secret[1];
+    b ^= seed;
+    Multiply(a, b);
+    return Mix(a ^ secret[0] ^ size, b ^ secret[1]);
+  }
+}
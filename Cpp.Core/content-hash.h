@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Cpp::Core::NativeImpls {
+  /**
+   * @brief Hashes a buffer with a fast non-cryptographic 64-bit hash, for keying caches by
+   * content.
+   *
+   * The hash is wyhash: 48 bytes per round are mixed by three independent 64x64->128-bit
+   * multiplications, which runs at memory speed on anything with a wide multiplier. The result
+   * only depends on the bytes and the seed, never on the platform, so it can be persisted.
+   *
+   * @param seed Distinguishes unrelated uses of the hash, or chains hashes together.
+   */
+  uint64_t HashContent(const void* data, size_t size, uint64_t seed = 0);
+}
@@ -0,0 +1,99 @@
+#include "file-lock.h"
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+namespace Cpp::Core::NativeImpls {
+  FileLock::~FileLock() {
+    Close();
+  }
+
+  bool FileLock::Open(const std::filesystem::path& path, std::string& error) {
+    Close();
+
+#if defined(_WIN32)
+    file = CreateFileW(
+      path.c_str(),
+      GENERIC_READ | GENERIC_WRITE,
+      FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+      nullptr,
+      OPEN_ALWAYS,
+      FILE_ATTRIBUTE_NORMAL,
+      nullptr
+    );
+    if (file == INVALID_HANDLE_VALUE) {
+      file  = nullptr;
+      error = "Opening " + path.u8string() + " failed (error " + std::to_string(GetLastError()) +
+        ")";
+      return false;
+    }
+#else
+    file = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (file < 0) {
+      error = "Opening " + path.u8string() + " failed: " + std::strerror(errno);
+      return false;
+    }
+#endif
+
+    return true;
+  }
+
+  void FileLock::Close() {
+#if defined(_WIN32)
+    if (file) {
+      CloseHandle(file);
+      file = nullptr;
+    }
+#else
+    if (file >= 0) {
+      close(file);
+      file = -1;
+    }
+#endif
+  }
+
+  bool FileLock::Lock(bool exclusive) {
+#if defined(_WIN32)
+    if (!file) {
+      return false;
+    }
+
+    // Only the first byte is locked, which works whether or not the file is that long.
+    OVERLAPPED overlapped = {};
+    auto flags = exclusive ? LOCKFILE_EXCLUSIVE_LOCK : 0;
+    return LockFileEx(file, flags, 0, 1, 0, &overlapped) != FALSE;
+#else
+    if (file < 0) {
+      return false;
+    }
+
+    while (flock(file, exclusive ? LOCK_EX : LOCK_SH) != 0) {
+      if (errno != EINTR) {
+        return false;
+      }
+    }
+    return true;
+#endif
+  }
+
+  void FileLock::Unlock() {
+#if defined(_WIN32)
+    if (file) {
+      OVERLAPPED overlapped = {};
+      UnlockFileEx(file, 0, 1, 0, &overlapped);
+    }
+#else
+    if (file >= 0) {
+      flock(file, LOCK_UN);
+    }
+#endif
+  }
+}
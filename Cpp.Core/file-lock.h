@@ -0,0 +1,52 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+namespace Cpp::Core::NativeImpls {
+  /**
+   * @brief An advisory lock on a file, shared between processes. Taken with `LockFileEx` on
+   * Windows and `flock` elsewhere. It isn't reentrant, and threads of the same process aren't
+   * excluded from each other, so it should be taken under a lock of the process's own.
+   */
+  class FileLock {
+    public:
+      FileLock() = default;
+      ~FileLock();
+
+      FileLock(const FileLock&)            = delete;
+      FileLock& operator=(const FileLock&) = delete;
+
+      /**
+       * @brief Opens the file to lock, creating it if it doesn't exist, and closing any file opened
+       * before.
+       * @param error Receives a description of the problem if the file can't be opened.
+       * @returns `false` if the file can't be opened.
+       */
+      bool Open(const std::filesystem::path& path, std::string& error);
+
+      /**
+       * @brief Closes the file, releasing the lock if it's held.
+       */
+      void Close();
+
+      /**
+       * @brief Waits for the lock.
+       * @param exclusive Whether to exclude every other holder, rather than only exclusive ones.
+       * @returns `false` if no file is open or the lock can't be taken.
+       */
+      bool Lock(bool exclusive);
+
+      /**
+       * @brief Releases the lock.
+       */
+      void Unlock();
+
+    private:
+#if defined(_WIN32)
+      void* file = nullptr;
+#else
+      int file = -1;
+#endif
+  };
+}
@@ -0,0 +1,126 @@
+#include "file-reader.h"
+
+#include <algorithm>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Cpp::Core::NativeImpls {
+  namespace {
+    /** The most bytes to ask the system for at once, which `ReadFile` takes as 32 bits. */
+    constexpr size_t maxReadSize = 1024 * 1024 * 1024;
+
+    std::string Describe(const char* action, const std::filesystem::path& path) {
+#if defined(_WIN32)
+      auto code = GetLastError();
+#else
+      auto code = errno;
+#endif
+      auto description = std::string(action) + " " + path.u8string() + " failed";
+#if defined(_WIN32)
+      return description + " (error " + std::to_string(code) + ")";
+#else
+      return description + ": " + std::strerror(code);
+#endif
+    }
+  }
+
+  FileReader::~FileReader() {
+    Close();
+  }
+
+  bool FileReader::Open(const std::filesystem::path& path, std::string& error) {
+    Close();
+    this->path = path;
+
+#if defined(_WIN32)
+    file = CreateFileW(
+      path.c_str(),
+      GENERIC_READ,
+      FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+      nullptr,
+      OPEN_EXISTING,
+      FILE_FLAG_SEQUENTIAL_SCAN,
+      nullptr
+    );
+    if (file == INVALID_HANDLE_VALUE) {
+      file  = nullptr;
+      error = Describe("Opening", path);
+      return false;
+    }
+#else
+    file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file < 0) {
+      error = Describe("Opening", path);
+      return false;
+    }
+#endif
+
+    return true;
+  }
+
+  bool FileReader::Read(void* destination, size_t capacity, size_t& size, std::string& error) {
+    auto bytes = static_cast<char*>(destination);
+    size       = 0;
+
+#if defined(_WIN32)
+    if (!file) {
+#else
+    if (file < 0) {
+#endif
+      error = "Reading " + path.u8string() + " failed: the file isn't open";
+      return false;
+    }
+
+    // The system may return fewer bytes than asked for before the end of the file, so keep going
+    // until it returns none.
+    while (size < capacity) {
+#if defined(_WIN32)
+      DWORD read   = 0;
+      auto request = static_cast<DWORD>(std::min(capacity - size, maxReadSize));
+      if (!ReadFile(file, bytes + size, request, &read, nullptr)) {
+        error = Describe("Reading", path);
+        return false;
+      }
+#else
+      auto read = ::read(file, bytes + size, std::min(capacity - size, maxReadSize));
+      if (read < 0 && errno == EINTR) {
+        continue;
+      }
+
+      if (read < 0) {
+        error = Describe("Reading", path);
+        return false;
+      }
+#endif
+
+      if (read == 0) {
+        break;
+      }
+      size += static_cast<size_t>(read);
+    }
+
+    return true;
+  }
+
+  void FileReader::Close() {
+#if defined(_WIN32)
+    if (file) {
+      CloseHandle(file);
+      file = nullptr;
+    }
+#else
+    if (file >= 0) {
+      close(file);
+      file = -1;
+    }
+#endif
+  }
+}
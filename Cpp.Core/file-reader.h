@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+namespace Cpp::Core::NativeImpls {
+  /**
+   * @brief Reads a file straight into memory that the caller owns, e.g. the backing store of a
+   * script's `ArrayBuffer`, so its bytes are copied once rather than through intermediate
+   * buffers.
+   *
+   * The file is read with `ReadFile` or `read` rather than mapped. A mapped file that's truncated
+   * or on a failing device raises `EXCEPTION_IN_PAGE_ERROR` or `SIGBUS` during the copy, while a
+   * read just fails. The caller reads the file in chunks of its choosing, so it can let go of the
+   * destination between them.
+   */
+  class FileReader {
+    public:
+      FileReader() = default;
+      ~FileReader();
+
+      FileReader(const FileReader&)            = delete;
+      FileReader& operator=(const FileReader&) = delete;
+
+      /**
+       * @brief Opens a file for reading from its start, closing any file opened before.
+       * @param error Receives a description of the problem if the file can't be opened.
+       * @returns `false` if the file can't be opened.
+       */
+      bool Open(const std::filesystem::path& path, std::string& error);
+
+      /**
+       * @brief Reads the next bytes of the file.
+       * @param capacity The most bytes to read.
+       * @param size Receives the number of bytes read, which is only less than `capacity` at the
+       * end of the file.
+       * @param error Receives a description of the problem if the file can't be read.
+       * @returns `false` if the file can't be read.
+       */
+      bool Read(void* destination, size_t capacity, size_t& size, std::string& error);
+
+      /**
+       * @brief Closes the file.
+       */
+      void Close();
+
+    private:
+      std::filesystem::path path;
+
+#if defined(_WIN32)
+      void* file = nullptr;
+#else
+      int file = -1;
+#endif
+  };
+}
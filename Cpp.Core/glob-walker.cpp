@@ -0,0 +1,561 @@
+#include "glob-walker.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+namespace Cpp::Core::NativeImpls {
+  bool GlobPattern::Compile(std::u16string_view pattern, bool ignoreCase, std::string& error) {
+    segments.clear();
+
+    size_t start = 0;
+    while (start <= pattern.size()) {
+      auto end = pattern.find_first_of(u"/\\", start);
+      if (end == std::u16string_view::npos) {
+        end = pattern.size();
+      }
+
+      auto segment = pattern.substr(start, end - start);
+      start        = end + 1;
+
+      if (segment.empty() || segment == u".") {
+        continue;
+      }
+
+      if (segment == u"..") {
+        error = "Patterns can't refer to a parent directory";
+        return false;
+      }
+
+      if (segment == u"**") {
+        // `**/**` matches exactly what `**` does.
+        if (segments.empty() || !segments.back().anyDirectories) {
+          segments.push_back({ true, {} });
+        }
+        continue;
+      }
+
+      Segment compiled{ false, {} };
+      if (!compiled.pattern.Compile(segment, MatchMode::Glob, ignoreCase, error)) {
+        return false;
+      }
+      segments.push_back(std::move(compiled));
+    }
+
+    if (segments.empty()) {
+      error = "The pattern is empty";
+      return false;
+    }
+
+    // A trailing `**` matches every file below it rather than a directory.
+    if (segments.back().anyDirectories) {
+      Segment anyFile{ false, {} };
+      anyFile.pattern.Compile(u"*", MatchMode::Glob, ignoreCase, error);
+      segments.push_back(std::move(anyFile));
+    }
+
+    if (segments.size() > MaxSegments) {
+      error = "The pattern has more than " + std::to_string(MaxSegments) + " segments";
+      return false;
+    }
+
+    return true;
+  }
+
+  GlobPattern::States GlobPattern::Close(States states) const {
+    for (size_t i = 0; i < segments.size(); i++) {
+      if ((states >> i & 1) && segments[i].anyDirectories) {
+        states |= States(1) << (i + 1);
+      }
+    }
+    return states;
+  }
+
+  GlobPattern::States GlobPattern::GetStart() const {
+    return Close(1);
+  }
+
+  GlobPattern::States GlobPattern::Step(States states, std::u16string_view name) const {
+    States next = 0;
+    for (size_t i = 0; i < segments.size(); i++) {
+      if (!(states >> i & 1)) {
+        continue;
+      }
+
+      // `**` consumes the name and stays where it is; the segment after it was already added to
+      // the states by `Close`, so it's tried against the name too.
+      if (segments[i].anyDirectories) {
+        next |= States(1) << i;
+      } else if (segments[i].pattern.Matches(name)) {
+        next |= States(1) << (i + 1);
+      }
+    }
+    return next ? Close(next) : 0;
+  }
+
+  bool GlobPattern::IsMatch(States states) const {
+    return states >> segments.size() & 1;
+  }
+
+  bool GlobPattern::CanContinue(States states) const {
+    return (states & ((States(1) << segments.size()) - 1)) != 0;
+  }
+
+  namespace {
+    /** The most matches a thread buffers before handing them to the reader. */
+    constexpr size_t flushSize = 256;
+
+    /** How many matches may wait for the reader before threads pause. */
+    constexpr size_t maxQueued = 64 * 1024;
+
+#if defined(_WIN32)
+    constexpr char16_t separator = u'\\';
+#else
+    constexpr char16_t separator = u'/';
+
+    /**
+     * @brief Decodes a file name, which Linux treats as bytes, as UTF-8. Invalid bytes decode to
+     * U+FFFD.
+     */
+    void DecodeName(const char* name, std::u16string& decoded) {
+      decoded.clear();
+
+      auto bytes = reinterpret_cast<const unsigned char*>(name);
+      while (*bytes) {
+        uint32_t codePoint = *bytes++;
+        size_t continuations = 0;
+        if (codePoint >= 0xF0 && codePoint < 0xF8) {
+          codePoint &= 0x07;
+          continuations = 3;
+        } else if (codePoint >= 0xE0) {
+          codePoint &= 0x0F;
+          continuations = 2;
+        } else if (codePoint >= 0xC0) {
+          codePoint &= 0x1F;
+          continuations = 1;
+        } else if (codePoint >= 0x80) {
+          codePoint = 0xFFFD;
+        }
+
+        for (; continuations && (*bytes & 0xC0) == 0x80; continuations--) {
+          codePoint = codePoint << 6 | (*bytes++ & 0x3F);
+        }
+        if (continuations || codePoint > 0x10FFFF) {
+          codePoint = 0xFFFD;
+        }
+
+        if (codePoint >= 0x10000) {
+          codePoint -= 0x10000;
+          decoded.push_back(static_cast<char16_t>(0xD800 + (codePoint >> 10)));
+          decoded.push_back(static_cast<char16_t>(0xDC00 + (codePoint & 0x3FF)));
+        } else {
+          decoded.push_back(static_cast<char16_t>(codePoint));
+        }
+      }
+    }
+#endif
+
+    enum class EntryKind : uint8_t {
+      File,
+      Directory,
+
+      /** A link to a directory, or anything else that's neither listed nor descended into. */
+      Other
+    };
+  }
+
+  struct GlobWalker::Impl {
+    /**
+     * @brief A directory waiting to be listed, with the states its path left the patterns in.
+     */
+    struct Task {
+      std::filesystem::path::string_type path;
+      std::u16string relative;
+      GlobPattern::States include;
+
+      /** The states of each exclusion, 0 once an exclusion can no longer match below. */
+      std::vector<GlobPattern::States> excludes;
+    };
+
+    struct Worker {
+      std::mutex lock;
+      std::deque<Task> tasks;
+    };
+
+    std::filesystem::path root;
+    GlobPattern include;
+    std::vector<GlobPattern> excludes;
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+
+    /** The directories that are queued or being listed. The walk is over once it's 0. */
+    std::atomic<size_t> pending{ 0 };
+
+    std::atomic<uint64_t> directoryCount{ 0 };
+    std::atomic<uint64_t> skippedCount{ 0 };
+    std::atomic<uint64_t> stolenCount{ 0 };
+
+    // The matches that haven't been read, guarded by `lock`.
+    std::mutex lock;
+    std::condition_variable readable;
+    std::condition_variable writable;
+    std::deque<std::u16string> results;
+    size_t runningCount = 0;
+    bool started = false;
+    std::atomic<bool> stopped{ false };
+
+    bool Take(size_t index, Task& task) {
+      {
+        auto& own = *workers[index];
+        std::lock_guard guard(own.lock);
+        if (!own.tasks.empty()) {
+          task = std::move(own.tasks.back());
+          own.tasks.pop_back();
+          return true;
+        }
+      }
+
+      for (size_t i = 1; i < workers.size(); i++) {
+        auto& victim = *workers[(index + i) % workers.size()];
+        std::lock_guard guard(victim.lock);
+        if (!victim.tasks.empty()) {
+          task = std::move(victim.tasks.front());
+          victim.tasks.pop_front();
+          ++stolenCount;
+          return true;
+        }
+      }
+
+      return false;
+    }
+
+    void Push(size_t index, Task task) {
+      // Counted before it's visible to other threads, so `pending` never drops to 0 early.
+      ++pending;
+
+      auto& own = *workers[index];
+      std::lock_guard guard(own.lock);
+      own.tasks.push_back(std::move(task));
+    }
+
+    void Flush(std::vector<std::u16string>& found) {
+      if (found.empty()) {
+        return;
+      }
+
+      {
+        std::unique_lock guard(lock);
+        writable.wait(guard, [this] { return results.size() < maxQueued || stopped; });
+        for (auto& path : found) {
+          results.push_back(std::move(path));
+        }
+      }
+      readable.notify_one();
+      found.clear();
+    }
+
+    /**
+     * @brief Handles an entry of a directory, queueing it if it's a directory that could hold
+     * matches and recording it if it's a matching file.
+     * @param nativeName The name as it was listed, which is how it's appended to the path of a
+     * directory to list, so names that aren't valid UTF-8 can still be walked.
+     */
+    void Visit(
+      size_t index,
+      const Task& parent,
+      std::filesystem::path::string_type::const_pointer nativeName,
+      std::u16string_view name,
+      EntryKind kind,
+      std::vector<std::u16string>& found
+    ) {
+      if (kind == EntryKind::Other) {
+        return;
+      }
+
+      auto includeStates = include.Step(parent.include, name);
+      if (kind == EntryKind::Directory ? !include.CanContinue(includeStates)
+                                       : !include.IsMatch(includeStates)) {
+        return;
+      }
+
+      std::vector<GlobPattern::States> excludeStates(excludes.size());
+      for (size_t i = 0; i < excludes.size(); i++) {
+        if (!parent.excludes[i]) {
+          continue;
+        }
+
+        auto states = excludes[i].Step(parent.excludes[i], name);
+        if (excludes[i].IsMatch(states)) {
+          return;
+        }
+        excludeStates[i] = excludes[i].CanContinue(states) ? states : 0;
+      }
+
+      std::u16string relative;
+      relative.reserve(parent.relative.size() + 1 + name.size());
+      relative = parent.relative;
+      if (!relative.empty()) {
+        relative.push_back(separator);
+      }
+      relative.append(name);
+
+      if (kind == EntryKind::File) {
+        found.push_back(std::move(relative));
+        return;
+      }
+
+      Task child;
+      child.path = parent.path;
+      child.path.push_back(std::filesystem::path::preferred_separator);
+      child.path.append(nativeName);
+      child.relative = std::move(relative);
+      child.include  = includeStates;
+      child.excludes = std::move(excludeStates);
+      Push(index, std::move(child));
+    }
+
+    void List(size_t index, const Task& task, std::vector<std::u16string>& found) {
+#if defined(_WIN32)
+      auto pattern = task.path + L"\\*";
+      WIN32_FIND_DATAW data;
+      auto find = FindFirstFileExW(
+        pattern.c_str(),
+        FindExInfoBasic,
+        &data,
+        FindExSearchNameMatch,
+        nullptr,
+        FIND_FIRST_EX_LARGE_FETCH
+      );
+      if (find == INVALID_HANDLE_VALUE) {
+        if (GetLastError() != ERROR_FILE_NOT_FOUND) {
+          ++skippedCount;
+        }
+        return;
+      }
+
+      ++directoryCount;
+      do {
+        std::u16string_view name(reinterpret_cast<const char16_t*>(data.cFileName));
+        if (name == u"." || name == u"..") {
+          continue;
+        }
+
+        auto kind = EntryKind::File;
+        if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+          // Junctions and links to directories can form cycles.
+          kind = data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT ? EntryKind::Other
+                                                                      : EntryKind::Directory;
+        }
+        Visit(index, task, data.cFileName, name, kind, found);
+      } while (!stopped && FindNextFileW(find, &data));
+
+      FindClose(find);
+#else
+      auto directory = opendir(task.path.c_str());
+      if (!directory) {
+        ++skippedCount;
+        return;
+      }
+
+      ++directoryCount;
+      std::u16string name;
+      while (!stopped) {
+        auto entry = readdir(directory);
+        if (!entry) {
+          break;
+        }
+
+        auto raw = entry->d_name;
+        if (raw[0] == '.' && (raw[1] == 0 || (raw[1] == '.' && raw[2] == 0))) {
+          continue;
+        }
+
+        auto kind = EntryKind::Other;
+        auto type = entry->d_type;
+        if (type == DT_UNKNOWN || type == DT_LNK) {
+          // Links to files are listed as files, but links to directories can form cycles.
+          auto path = task.path + '/' + raw;
+          struct stat status;
+          if (lstat(path.c_str(), &status) != 0) {
+            type = DT_UNKNOWN;
+          } else if (S_ISLNK(status.st_mode)) {
+            type = stat(path.c_str(), &status) == 0 && S_ISREG(status.st_mode) ? DT_REG : DT_LNK;
+          } else {
+            type = S_ISDIR(status.st_mode) ? DT_DIR : S_ISREG(status.st_mode) ? DT_REG : DT_UNKNOWN;
+          }
+        }
+
+        if (type == DT_DIR) {
+          kind = EntryKind::Directory;
+        } else if (type == DT_REG) {
+          kind = EntryKind::File;
+        }
+
+        DecodeName(raw, name);
+        Visit(index, task, raw, name, kind, found);
+      }
+
+      closedir(directory);
+#endif
+    }
+
+    void Run(size_t index) {
+      std::vector<std::u16string> found;
+      size_t idleRounds = 0;
+
+      while (!stopped) {
+        Task task;
+        if (!Take(index, task)) {
+          if (pending == 0) {
+            break;
+          }
+
+          // Whatever was found so far is worth reading while other threads finish their subtrees.
+          Flush(found);
+
+          if (++idleRounds < 64) {
+            std::this_thread::yield();
+          } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+          }
+          continue;
+        }
+
+        idleRounds = 0;
+        List(index, task, found);
+        if (found.size() >= flushSize) {
+          Flush(found);
+        }
+        --pending;
+      }
+
+      Flush(found);
+
+      {
+        std::lock_guard guard(lock);
+        --runningCount;
+      }
+      readable.notify_all();
+    }
+  };
+
+  GlobWalker::GlobWalker() : impl(std::make_unique<Impl>()) {}
+
+  GlobWalker::~GlobWalker() {
+    Stop();
+  }
+
+  void GlobWalker::Start(
+    const std::filesystem::path& root,
+    GlobPattern include,
+    std::vector<GlobPattern> excludes,
+    size_t threadCount
+  ) {
+    auto& state = *impl;
+    if (state.started) {
+      return;
+    }
+
+    if (threadCount == 0) {
+      threadCount = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, 8);
+    }
+
+    state.root     = root;
+    state.include  = std::move(include);
+    state.excludes = std::move(excludes);
+
+    for (size_t i = 0; i < threadCount; i++) {
+      state.workers.push_back(std::make_unique<Impl::Worker>());
+    }
+
+    Impl::Task task;
+    task.path    = root.native();
+    task.include = state.include.GetStart();
+    for (auto& exclude : state.excludes) {
+      task.excludes.push_back(exclude.GetStart());
+    }
+    while (task.path.size() > 1 && (task.path.back() == '/' || task.path.back() == '\\')) {
+      task.path.pop_back();
+    }
+    state.Push(0, std::move(task));
+
+    state.started      = true;
+    state.runningCount = threadCount;
+    for (size_t i = 0; i < threadCount; i++) {
+      state.threads.emplace_back([&state, i] { state.Run(i); });
+    }
+  }
+
+  size_t GlobWalker::Read(std::u16string* paths, size_t capacity, int64_t timeoutMicroseconds) {
+    auto& state = *impl;
+
+    size_t count = 0;
+    {
+      std::unique_lock guard(state.lock);
+      auto isReadable = [&state] {
+        return !state.results.empty() || state.runningCount == 0 || state.stopped;
+      };
+      if (timeoutMicroseconds < 0) {
+        state.readable.wait(guard, isReadable);
+      } else {
+        state.readable.wait_for(guard, std::chrono::microseconds(timeoutMicroseconds), isReadable);
+      }
+
+      while (count < capacity && !state.results.empty()) {
+        paths[count++] = std::move(state.results.front());
+        state.results.pop_front();
+      }
+    }
+
+    if (count) {
+      state.writable.notify_all();
+    }
+    return count;
+  }
+
+  void GlobWalker::Stop() {
+    auto& state = *impl;
+    {
+      std::lock_guard guard(state.lock);
+      state.stopped = true;
+    }
+    state.writable.notify_all();
+    state.readable.notify_all();
+
+    for (auto& thread : state.threads) {
+      if (thread.joinable()) {
+        thread.join();
+      }
+    }
+  }
+
+  bool GlobWalker::IsFinished() const {
+    std::lock_guard guard(impl->lock);
+    return impl->started && impl->runningCount == 0 && impl->results.empty();
+  }
+
+  uint64_t GlobWalker::GetDirectoryCount() const {
+    return impl->directoryCount;
+  }
+
+  uint64_t GlobWalker::GetSkippedCount() const {
+    return impl->skippedCount;
+  }
+
+  uint64_t GlobWalker::GetStolenCount() const {
+    return impl->stolenCount;
+  }
+}
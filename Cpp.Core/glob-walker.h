@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "window-matcher.h"
+
+namespace Cpp::Core::NativeImpls {
+  /**
+   * @brief A path glob compiled into an automaton that's stepped one path segment at a time, so a
+   * walker can tell from a directory's name alone whether anything below it could match.
+   *
+   * Segments are separated by `/` or `\`. `**` matches any number of directories, including none,
+   * and within a segment `*` matches any run of characters and `?` any single character. The
+   * automaton's states are the positions in the pattern's segments that the path so far could
+   * have reached, kept as a bit set; a subtree is pruned once the set is empty.
+   */
+  class GlobPattern {
+    public:
+      /** The most segments a pattern may have. */
+      static constexpr size_t MaxSegments = 63;
+
+      /** A set of positions in the pattern, one bit per segment plus one for the end. */
+      using States = uint64_t;
+
+      /**
+       * @brief Parses a pattern.
+       * @param error Receives a description of the problem if the pattern is invalid.
+       * @returns `false` if the pattern is invalid, i.e. has too many segments or refers to a
+       * parent directory.
+       */
+      bool Compile(std::u16string_view pattern, bool ignoreCase, std::string& error);
+
+      /**
+       * @returns The states before any segment of a path is matched.
+       */
+      States GetStart() const;
+
+      /**
+       * @returns The states after matching the next segment of a path.
+       */
+      States Step(States states, std::u16string_view name) const;
+
+      /**
+       * @returns Whether a path that reached these states matches the whole pattern.
+       */
+      bool IsMatch(States states) const;
+
+      /**
+       * @returns Whether a path that reached these states could match once more segments follow,
+       * i.e. whether a directory is worth descending into.
+       */
+      bool CanContinue(States states) const;
+
+    private:
+      struct Segment {
+        /** Whether the segment is `**`. */
+        bool anyDirectories;
+        StringPattern pattern;
+      };
+
+      /**
+       * @brief Adds the positions after each `**`, which may match no directories at all.
+       */
+      States Close(States states) const;
+
+      std::vector<Segment> segments;
+  };
+
+  /**
+   * @brief Walks a directory tree on a pool of threads, streaming the relative paths of the files
+   * that match a glob to a single reader.
+   *
+   * Each thread works depth-first through its own deque of directories and, once that's empty,
+   * steals the oldest directory from another thread's deque, which is the nearest to the root and
+   * so usually the largest subtree left. Directories whose names rule out every match are never
+   * listed, and nor are directories that an exclusion matches. Symbolic links and junctions to
+   * directories aren't followed, so the walk always ends.
+   *
+   * Matches are buffered per thread and handed over in batches. Threads pause once the reader
+   * falls far enough behind, so memory stays bounded however large the tree is.
+   */
+  class GlobWalker {
+    public:
+      GlobWalker();
+      ~GlobWalker();
+
+      GlobWalker(const GlobWalker&)            = delete;
+      GlobWalker& operator=(const GlobWalker&) = delete;
+
+      /**
+       * @brief Starts walking a directory. May only be called once.
+       * @param include The glob that files must match, relative to the root.
+       * @param excludes Globs that exclude the files, and the whole directories, that they match.
+       * @param threadCount The number of threads to walk with, or 0 for one per processor, up to
+       * 8.
+       */
+      void Start(
+        const std::filesystem::path& root,
+        GlobPattern include,
+        std::vector<GlobPattern> excludes,
+        size_t threadCount
+      );
+
+      /**
+       * @brief Reads the paths of matching files, relative to the root, waiting for at least one
+       * if there are none. Must be called from a single thread.
+       * @param paths Receives the paths, in no particular order.
+       * @param capacity The most paths to read.
+       * @param timeoutMicroseconds How long to wait. Waits indefinitely if negative.
+       * @returns The number of paths read, which is 0 if the wait timed out or the walk is over
+       * and every path was read.
+       */
+      size_t Read(std::u16string* paths, size_t capacity, int64_t timeoutMicroseconds);
+
+      /**
+       * @brief Stops the walk, waiting for the threads to finish, and wakes the reader.
+       */
+      void Stop();
+
+      /**
+       * @returns Whether the walk is over and every path was read.
+       */
+      bool IsFinished() const;
+
+      /**
+       * @returns The number of directories listed.
+       */
+      uint64_t GetDirectoryCount() const;
+
+      /**
+       * @returns The number of directories that couldn't be listed, e.g. for lack of access.
+       */
+      uint64_t GetSkippedCount() const;
+
+      /**
+       * @returns The number of directories a thread took from another thread's deque.
+       */
+      uint64_t GetStolenCount() const;
+
+    private:
+      struct Impl;
+      std::unique_ptr<Impl> impl;
+  };
+}
@@ -0,0 +1,184 @@
+#include "mapped-file.h"
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Cpp::Core::NativeImpls {
+  namespace {
+    std::string Describe(const char* action, const std::filesystem::path& path) {
+#if defined(_WIN32)
+      auto code = GetLastError();
+#else
+      auto code = errno;
+#endif
+      auto description = std::string(action) + " " + path.u8string() + " failed";
+#if defined(_WIN32)
+      return description + " (error " + std::to_string(code) + ")";
+#else
+      return description + ": " + std::strerror(code);
+#endif
+    }
+  }
+
+  MappedFile::~MappedFile() {
+    Close();
+  }
+
+  bool MappedFile::Open(const std::filesystem::path& path, bool writable, std::string& error) {
+    return Map(path, 0, writable, false, error);
+  }
+
+  bool MappedFile::Create(const std::filesystem::path& path, size_t size, std::string& error) {
+    return Map(path, size, true, true, error);
+  }
+
+  bool MappedFile::Map(
+    const std::filesystem::path& path,
+    size_t size,
+    bool writable,
+    bool create,
+    std::string& error
+  ) {
+    Close();
+
+#if defined(_WIN32)
+    auto access = GENERIC_READ | (writable ? GENERIC_WRITE : 0);
+    file = CreateFileW(
+      path.c_str(),
+      access,
+      FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+      nullptr,
+      create ? CREATE_ALWAYS : OPEN_EXISTING,
+      FILE_ATTRIBUTE_NORMAL,
+      nullptr
+    );
+    if (file == INVALID_HANDLE_VALUE) {
+      file  = nullptr;
+      error = Describe("Opening", path);
+      return false;
+    }
+
+    if (!create) {
+      LARGE_INTEGER fileSize;
+      if (!GetFileSizeEx(file, &fileSize)) {
+        error = Describe("Querying the size of", path);
+        Close();
+        return false;
+      }
+      size = static_cast<size_t>(fileSize.QuadPart);
+    }
+
+    // Empty files can't be mapped, and there's nothing to map anyway.
+    if (size == 0) {
+      return true;
+    }
+
+    // Mapping a new file extends it to the size of the mapping, filled with zeroes.
+    auto protection = writable ? PAGE_READWRITE : PAGE_READONLY;
+    mapping = CreateFileMappingW(
+      file,
+      nullptr,
+      protection,
+      static_cast<DWORD>(uint64_t{size} >> 32),
+      static_cast<DWORD>(size),
+      nullptr
+    );
+    if (!mapping) {
+      error = Describe("Mapping", path);
+      Close();
+      return false;
+    }
+
+    auto view = MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, size);
+    if (!view) {
+      error = Describe("Mapping", path);
+      Close();
+      return false;
+    }
+#else
+    auto flags = (writable ? O_RDWR : O_RDONLY) | O_CLOEXEC | (create ? O_CREAT | O_TRUNC : 0);
+    file       = open(path.c_str(), flags, 0644);
+    if (file < 0) {
+      error = Describe("Opening", path);
+      return false;
+    }
+
+    if (create) {
+      if (ftruncate(file, static_cast<off_t>(size)) != 0) {
+        error = Describe("Resizing", path);
+        Close();
+        return false;
+      }
+    } else {
+      struct stat status;
+      if (fstat(file, &status) != 0) {
+        error = Describe("Querying the size of", path);
+        Close();
+        return false;
+      }
+      size = static_cast<size_t>(status.st_size);
+    }
+
+    // Empty files can't be mapped, and there's nothing to map anyway.
+    if (size == 0) {
+      return true;
+    }
+
+    auto protection = PROT_READ | (writable ? PROT_WRITE : 0);
+    auto view       = mmap(nullptr, size, protection, MAP_SHARED, file, 0);
+    if (view == MAP_FAILED) {
+      error = Describe("Mapping", path);
+      Close();
+      return false;
+    }
+#endif
+
+    data       = static_cast<uint8_t*>(view);
+    this->size = size;
+    return true;
+  }
+
+  void MappedFile::Close() {
+#if defined(_WIN32)
+    if (data) {
+      UnmapViewOfFile(data);
+    }
+    if (mapping) {
+      CloseHandle(mapping);
+      mapping = nullptr;
+    }
+    if (file) {
+      CloseHandle(file);
+      file = nullptr;
+    }
+#else
+    if (data) {
+      munmap(data, size);
+    }
+    if (file >= 0) {
+      close(file);
+      file = -1;
+    }
+#endif
+
+    data = nullptr;
+    size = 0;
+  }
+
+  uint8_t* MappedFile::GetData() const {
+    return data;
+  }
+
+  size_t MappedFile::GetSize() const {
+    return size;
+  }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+namespace Cpp::Core::NativeImpls {
+  /**
+   * @brief A file mapped into memory, so that it's read and written in place without copying it
+   * through buffers.
+   */
+  class MappedFile {
+    public:
+      MappedFile() = default;
+      ~MappedFile();
+
+      MappedFile(const MappedFile&)            = delete;
+      MappedFile& operator=(const MappedFile&) = delete;
+
+      /**
+       * @brief Maps the whole of an existing file, closing any file mapped before.
+       * @param writable Whether to map the file for writing as well as reading.
+       * @param error Receives a description of the problem if the file can't be mapped.
+       * @returns `false` if the file can't be mapped.
+       */
+      bool Open(const std::filesystem::path& path, bool writable, std::string& error);
+
+      /**
+       * @brief Creates a file, or truncates an existing one, of a given size filled with zeroes
+       * and maps it for writing, closing any file mapped before.
+       * @param error Receives a description of the problem if the file can't be created.
+       * @returns `false` if the file can't be created.
+       */
+      bool Create(const std::filesystem::path& path, size_t size, std::string& error);
+
+      /**
+       * @brief Unmaps the file. Changes are written back by the system.
+       */
+      void Close();
+
+      /**
+       * @returns The mapped bytes, or `nullptr` if nothing is mapped or the file is empty.
+       */
+      uint8_t* GetData() const;
+
+      /**
+       * @returns The number of bytes mapped.
+       */
+      size_t GetSize() const;
+
+    private:
+      bool Map(
+        const std::filesystem::path& path,
+        size_t size,
+        bool writable,
+        bool create,
+        std::string& error
+      );
+
+      uint8_t* data = nullptr;
+      size_t size = 0;
+
+#if defined(_WIN32)
+      void* file = nullptr;
+      void* mapping = nullptr;
+#else
+      int file = -1;
+#endif
+  };
+}
@@ -0,0 +1,248 @@
+#include "process-name-cache.h"
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <unordered_set>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+namespace Cpp::Core::NativeImpls {
+  namespace {
+#if defined(_WIN32)
+    void CloseProcess(void* process) {
+      CloseHandle(process);
+    }
+
+    bool HasExited(void* process) {
+      DWORD exitCode = 0;
+      return GetExitCodeProcess(process, &exitCode) && exitCode != STILL_ACTIVE;
+    }
+#else
+    // Without processes to hold on to, handles are only tokens.
+    void CloseProcess(void*) {}
+
+    bool HasExited(void*) {
+      return false;
+    }
+#endif
+
+    /**
+     * @brief An entry of the cache. The fields that readers see are published with a sequence
+     * lock: the sequence is odd while the entry is being written, and readers retry or give up if
+     * it changed while they were reading.
+     */
+    struct Slot {
+      std::atomic<uint32_t> sequence{0};
+      std::atomic<uint32_t> processId{0};
+      std::atomic<const std::wstring*> name{nullptr};
+      std::atomic<uint64_t> lastUsed{0};
+
+      // Only touched by writers, under the cache's lock.
+      void* process = nullptr;
+    };
+
+    size_t SetFor(uint32_t processId) {
+      // Process identifiers are multiples of 4, so mix the bits before picking a set.
+      auto hash = processId * 0x9E3779B1u;
+      return (hash >> 16) % ProcessNameCache::SetCount;
+    }
+  }
+
+  struct ProcessNameCache::Impl {
+    std::array<std::array<Slot, WaysPerSet>, SetCount> sets;
+
+    // Advanced on every hit and insert, to order entries by when they were last used.
+    std::atomic<uint64_t> tick{0};
+
+    mutable std::atomic<uint64_t> hits{0};
+    mutable std::atomic<uint64_t> misses{0};
+
+    // Serialises writers. Readers never take it.
+    std::mutex writeLock;
+
+    // Every image path an entry has pointed at. Paths are never freed while the cache exists, so
+    // a reader can safely copy one even if its entry is being replaced. Few distinct executables
+    // own windows, so this stays small.
+    std::unordered_set<std::wstring> names;
+
+    void Write(Slot& slot, uint32_t processId, const std::wstring* name) {
+      auto sequence = slot.sequence.load(std::memory_order_relaxed);
+      slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+
+      slot.processId.store(processId, std::memory_order_relaxed);
+      slot.name.store(name, std::memory_order_relaxed);
+      slot.lastUsed.store(tick.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
+
+      slot.sequence.store(sequence + 2, std::memory_order_release);
+    }
+  };
+
+  ProcessNameCache::ProcessNameCache() : impl(std::make_unique<Impl>()) {}
+
+  ProcessNameCache::~ProcessNameCache() {
+    Clear();
+  }
+
+  bool ProcessNameCache::TryGet(uint32_t processId, std::wstring& name) const {
+    for (auto& slot : impl->sets[SetFor(processId)]) {
+      auto sequence = slot.sequence.load(std::memory_order_acquire);
+      if ((sequence & 1) != 0) {
+        continue;
+      }
+
+      auto slotProcessId = slot.processId.load(std::memory_order_relaxed);
+      auto slotName      = slot.name.load(std::memory_order_relaxed);
+
+      // Make sure the entry wasn't replaced while it was being read.
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot.sequence.load(std::memory_order_relaxed) != sequence) {
+        continue;
+      }
+
+      if (slotName != nullptr && slotProcessId == processId) {
+        name = *slotName;
+        slot.lastUsed.store(
+          impl->tick.fetch_add(1, std::memory_order_relaxed),
+          std::memory_order_relaxed
+        );
+        impl->hits.fetch_add(1, std::memory_order_relaxed);
+        return true;
+      }
+    }
+
+    impl->misses.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  void ProcessNameCache::Insert(uint32_t processId, void* process, const std::wstring& name) {
+    std::lock_guard lock(impl->writeLock);
+
+    auto& set = impl->sets[SetFor(processId)];
+
+    // Another thread may have inserted the process in the meantime. Its handle keeps the entry
+    // valid, so this one isn't needed.
+    for (auto& slot : set) {
+      if (slot.process != nullptr && slot.processId.load(std::memory_order_relaxed) == processId) {
+        CloseProcess(process);
+        return;
+      }
+    }
+
+    auto interned = impl->names.find(name);
+    if (interned == impl->names.end()) {
+      if (impl->names.size() >= MaxNames) {
+        CloseProcess(process);
+        return;
+      }
+      interned = impl->names.insert(name).first;
+    }
+
+    // Fill an empty entry if there is one, then replace a process that has exited, and only then
+    // the least recently used one.
+    Slot* victim = nullptr;
+    for (auto& slot : set) {
+      if (slot.process == nullptr) {
+        victim = &slot;
+        break;
+      }
+    }
+    if (victim == nullptr) {
+      for (auto& slot : set) {
+        if (HasExited(slot.process)) {
+          victim = &slot;
+          break;
+        }
+      }
+    }
+    if (victim == nullptr) {
+      victim = &set[0];
+      for (auto& slot : set) {
+        if (slot.lastUsed.load(std::memory_order_relaxed) <
+            victim->lastUsed.load(std::memory_order_relaxed)) {
+          victim = &slot;
+        }
+      }
+    }
+
+    auto evicted = victim->process;
+    impl->Write(*victim, processId, &*interned);
+    victim->process = process;
+
+    // The evicted identifier can only be reused once its handle is closed, which is after the
+    // entry stopped pointing at it.
+    if (evicted != nullptr) {
+      CloseProcess(evicted);
+    }
+  }
+
+  void ProcessNameCache::Clear() {
+    std::lock_guard lock(impl->writeLock);
+
+    for (auto& set : impl->sets) {
+      for (auto& slot : set) {
+        if (slot.process == nullptr) {
+          continue;
+        }
+
+        impl->Write(slot, 0, nullptr);
+        CloseProcess(slot.process);
+        slot.process = nullptr;
+      }
+    }
+  }
+
+  uint64_t ProcessNameCache::GetHits() const {
+    return impl->hits.load(std::memory_order_relaxed);
+  }
+
+  uint64_t ProcessNameCache::GetMisses() const {
+    return impl->misses.load(std::memory_order_relaxed);
+  }
+
+  ProcessNameCache& GetProcessNameCache() {
+    static ProcessNameCache cache;
+    return cache;
+  }
+
+#if defined(_WIN32)
+  std::wstring GetProcessImageName(uint32_t processId) {
+    auto& cache = GetProcessNameCache();
+
+    std::wstring name;
+    if (cache.TryGet(processId, name)) {
+      return name;
+    }
+
+    // Open the process given the process identifier to get the process handle. If it can't be
+    // opened, e.g. because it's elevated, the name can't be retrieved.
+    const auto process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processId);
+    if (process == nullptr) {
+      return L"";
+    }
+
+    // Retrieves the full name of the executable image for the specified process.
+    std::array<WCHAR, 1024> processName;
+    DWORD size = static_cast<DWORD>(processName.size());
+    if (!QueryFullProcessImageNameW(process, 0, processName.data(), &size)) {
+      CloseHandle(process);
+      return L"";
+    }
+
+    // The cache holds on to the handle, which keeps the identifier from being reused.
+    name.assign(processName.data(), size);
+    cache.Insert(processId, process, name);
+    return name;
+  }
+#else
+  std::wstring GetProcessImageName(uint32_t processId) {
+    std::wstring name;
+    GetProcessNameCache().TryGet(processId, name);
+    return name;
+  }
+#endif
+}
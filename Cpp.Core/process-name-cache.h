@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Cpp::Core::NativeImpls {
+  /**
+   * @brief Caches the image paths of processes by their identifiers, so enumerating windows doesn't
+   * open every process that owns one.
+   *
+   * Each entry keeps a handle to its process open. Windows never reuses the identifier of a process
+   * while a handle to it is open, so an entry can't be mistaken for a newer process that was given
+   * the same identifier, and lookups don't need to check the process at all.
+   *
+   * Entries are grouped into small sets by identifier and evicted least recently used first,
+   * preferring processes that have exited. Lookups are lock-free, so any number of threads can
+   * read while another inserts.
+   */
+  class ProcessNameCache {
+    public:
+      /** The number of sets that entries are grouped into. */
+      static constexpr size_t SetCount = 32;
+
+      /** The number of entries in each set. */
+      static constexpr size_t WaysPerSet = 8;
+
+      /** The number of distinct image paths that are kept at most. */
+      static constexpr size_t MaxNames = 4096;
+
+      ProcessNameCache();
+      ~ProcessNameCache();
+
+      ProcessNameCache(const ProcessNameCache&)            = delete;
+      ProcessNameCache& operator=(const ProcessNameCache&) = delete;
+
+      /**
+       * @brief Looks up the image path of a process.
+       * @param processId The identifier of the process.
+       * @param name Receives the image path if the process is in the cache.
+       * @returns Whether the process is in the cache.
+       */
+      bool TryGet(uint32_t processId, std::wstring& name) const;
+
+      /**
+       * @brief Adds the image path of a process.
+       * @param processId The identifier of the process.
+       * @param process An open handle to the process, which the cache takes ownership of and closes
+       * once the entry is evicted.
+       * @param name The image path of the process.
+       */
+      void Insert(uint32_t processId, void* process, const std::wstring& name);
+
+      /**
+       * @brief Evicts every entry, closing their process handles.
+       */
+      void Clear();
+
+      /**
+       * @returns The number of lookups that found their process.
+       */
+      uint64_t GetHits() const;
+
+      /**
+       * @returns The number of lookups that didn't find their process.
+       */
+      uint64_t GetMisses() const;
+
+    private:
+      struct Impl;
+      std::unique_ptr<Impl> impl;
+  };
+
+  /**
+   * @returns The cache shared by every lookup of a process's image path. The returned cache lives
+   * for the lifetime of the process.
+   */
+  ProcessNameCache& GetProcessNameCache();
+
+  /**
+   * @brief Gets the full image path of a process, from the shared cache if possible.
+   * @param processId The identifier of the process.
+   * @returns The image path, or an empty string if the process can't be queried.
+   */
+  std::wstring GetProcessImageName(uint32_t processId);
+}
@@ -0,0 +1,255 @@
+#include "run-queue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#pragma comment(lib, "Synchronization.lib")
+#elif defined(__linux__)
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Cpp::Core::NativeImpls {
+  namespace {
+    // The values of the word the consumer parks on.
+    constexpr uint32_t running = 0;
+    constexpr uint32_t parked  = 1;
+
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+
+    /**
+     * @brief Blocks while a word is `parked`, until it's woken or the timeout elapses. May return
+     * spuriously.
+     * @param timeoutMicroseconds How long to wait. Waits indefinitely if negative.
+     */
+    void Park(std::atomic<uint32_t>& word, int64_t timeoutMicroseconds) {
+#if defined(_WIN32)
+      auto expected = parked;
+      auto timeout  = timeoutMicroseconds < 0
+        ? INFINITE
+        : static_cast<DWORD>(std::min<int64_t>((timeoutMicroseconds + 999) / 1000, INFINITE - 1));
+      WaitOnAddress(&word, &expected, sizeof(expected), timeout);
+#elif defined(__linux__)
+      timespec timeout{};
+      timeout.tv_sec  = static_cast<time_t>(timeoutMicroseconds / 1000000);
+      timeout.tv_nsec = static_cast<long>(timeoutMicroseconds % 1000000 * 1000);
+      syscall(
+        SYS_futex,
+        reinterpret_cast<uint32_t*>(&word),
+        FUTEX_WAIT_PRIVATE,
+        parked,
+        timeoutMicroseconds < 0 ? nullptr : &timeout,
+        nullptr,
+        0
+      );
+#else
+      // Where there's nothing to park on, poll.
+      auto timeout = timeoutMicroseconds < 0 ? 1000 : std::min<int64_t>(timeoutMicroseconds, 1000);
+      std::this_thread::sleep_for(std::chrono::microseconds(timeout));
+#endif
+    }
+
+    /**
+     * @brief Wakes the thread parked on a word, if any.
+     */
+    void Unpark(std::atomic<uint32_t>& word) {
+#if defined(_WIN32)
+      WakeByAddressSingle(&word);
+#elif defined(__linux__)
+      syscall(
+        SYS_futex,
+        reinterpret_cast<uint32_t*>(&word),
+        FUTEX_WAKE_PRIVATE,
+        1,
+        nullptr,
+        nullptr,
+        0
+      );
+#else
+      (void)word;
+#endif
+    }
+
+    /**
+     * @brief Adds to a counter that only one thread writes to, without a locked instruction.
+     */
+    void Increment(std::atomic<uint64_t>& counter) {
+      counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+  }
+
+  struct RunQueue::Impl {
+    struct Node {
+      std::atomic<Node*> next{nullptr};
+      uint64_t item = 0;
+    };
+
+    // Producers exchange their node into `head` and then link the previous head to it. The
+    // consumer owns `tail`, a node whose item was already taken, and takes the items after it.
+    // The two are kept on separate cache lines so that producers don't contend with the consumer.
+    alignas(64) std::atomic<Node*> head;
+    alignas(64) Node* tail;
+
+    std::atomic<uint32_t> state{running};
+    std::atomic<bool> closed{false};
+
+    // The producers between checking `closed` and linking their item in. Once the queue is closed,
+    // it's only known to be empty for good when none are left.
+    std::atomic<uint32_t> producers{0};
+    std::atomic<uint64_t> parkCount{0};
+    std::atomic<uint64_t> wakeCount{0};
+
+    Impl() : head(new Node()), tail(head.load()) {}
+
+    ~Impl() {
+      while (tail) {
+        auto next = tail->next.load(std::memory_order_relaxed);
+        delete tail;
+        tail = next;
+      }
+    }
+
+    /**
+     * @returns Whether no producer has pushed an item the consumer hasn't taken, including items
+     * that are still being linked in.
+     */
+    bool IsEmpty() const {
+      return head.load(std::memory_order_seq_cst) == tail;
+    }
+
+    /**
+     * @brief Takes the items that are linked in, without waiting.
+     */
+    size_t TryTake(uint64_t* items, size_t capacity) {
+      size_t count = 0;
+      while (count < capacity) {
+        auto next = tail->next.load(std::memory_order_acquire);
+        if (!next) {
+          break;
+        }
+
+        items[count++] = next->item;
+        delete tail;
+        tail = next;
+      }
+      return count;
+    }
+
+    void Wake() {
+      // Sequentially consistent so that either the consumer sees the item before it parks, or
+      // this sees that it parked.
+      if (state.load(std::memory_order_seq_cst) == parked &&
+          state.exchange(running, std::memory_order_seq_cst) == parked) {
+        wakeCount.fetch_add(1, std::memory_order_relaxed);
+        Unpark(state);
+      }
+    }
+  };
+
+  RunQueue::RunQueue() : impl(std::make_unique<Impl>()) {}
+
+  RunQueue::~RunQueue() = default;
+
+  bool RunQueue::Push(uint64_t item) {
+    // Announce the push before checking whether the queue is closed. Either `Close` then waits for
+    // the item to be linked in, or this sees that the queue was closed and backs out.
+    impl->producers.fetch_add(1, std::memory_order_seq_cst);
+    if (impl->closed.load(std::memory_order_seq_cst)) {
+      impl->producers.fetch_sub(1, std::memory_order_release);
+      return false;
+    }
+
+    auto node  = new Impl::Node();
+    node->item = item;
+
+    auto previous = impl->head.exchange(node, std::memory_order_seq_cst);
+    previous->next.store(node, std::memory_order_release);
+
+    impl->Wake();
+    impl->producers.fetch_sub(1, std::memory_order_release);
+    return true;
+  }
+
+  size_t RunQueue::Drain(uint64_t* items, size_t capacity, int64_t timeoutMicroseconds) {
+    if (capacity == 0) {
+      return 0;
+    }
+
+    auto& state   = *impl;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(
+      std::max<int64_t>(timeoutMicroseconds, 0)
+    );
+
+    while (true) {
+      auto count = state.TryTake(items, capacity);
+      if (count > 0) {
+        return count;
+      }
+
+      // A producer swapped its node in but hasn't linked it yet, which takes a few instructions.
+      if (!state.IsEmpty()) {
+        std::this_thread::yield();
+        continue;
+      }
+
+      // Once closed, the queue is only empty for good when no producer is still linking an item.
+      if (state.closed.load(std::memory_order_seq_cst)) {
+        if (state.producers.load(std::memory_order_seq_cst) == 0 && state.IsEmpty()) {
+          return 0;
+        }
+
+        std::this_thread::yield();
+        continue;
+      }
+
+      int64_t remaining = -1;
+      if (timeoutMicroseconds >= 0) {
+        auto left = deadline - std::chrono::steady_clock::now();
+        remaining = std::chrono::duration_cast<std::chrono::microseconds>(left).count();
+        if (remaining <= 0) {
+          return 0;
+        }
+      }
+
+      // Announce that the consumer is parking, then check again for anything pushed before the
+      // announcement was visible.
+      state.state.store(parked, std::memory_order_seq_cst);
+      if (!state.IsEmpty() || state.closed.load(std::memory_order_seq_cst)) {
+        state.state.store(running, std::memory_order_relaxed);
+        continue;
+      }
+
+      Increment(state.parkCount);
+      Park(state.state, remaining);
+      state.state.store(running, std::memory_order_relaxed);
+    }
+  }
+
+  void RunQueue::Close() {
+    impl->closed.store(true, std::memory_order_seq_cst);
+
+    // Wait for the producers that got in before the queue closed, so every item that was accepted
+    // is linked in by the time this returns. They're only ever a few instructions from done.
+    while (impl->producers.load(std::memory_order_acquire) != 0) {
+      std::this_thread::yield();
+    }
+
+    impl->Wake();
+  }
+
+  uint64_t RunQueue::GetParkCount() const {
+    return impl->parkCount.load(std::memory_order_relaxed);
+  }
+
+  uint64_t RunQueue::GetWakeCount() const {
+    return impl->wakeCount.load(std::memory_order_relaxed);
+  }
+}
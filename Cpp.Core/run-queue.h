@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace Cpp::Core::NativeImpls {
+  /**
+   * @brief An unbounded multi-producer, single-consumer queue of 64-bit items, e.g. handles to the
+   * callbacks of an event loop.
+   *
+   * Pushing never takes a lock: a producer links its item in with a single atomic exchange. The
+   * consumer takes every item that's ready in one call, and only parks in the kernel once the
+   * queue is empty, on a futex on Linux and with `WaitOnAddress` on Windows. Producers only make a
+   * system call to wake the consumer while it's parked.
+   */
+  class RunQueue {
+    public:
+      RunQueue();
+      ~RunQueue();
+
+      RunQueue(const RunQueue&)            = delete;
+      RunQueue& operator=(const RunQueue&) = delete;
+
+      /**
+       * @brief Adds an item to the back of the queue. May be called from any thread.
+       * @returns `false` if the queue was closed, in which case the item wasn't added.
+       */
+      bool Push(uint64_t item);
+
+      /**
+       * @brief Takes the items at the front of the queue, waiting for at least one if there are
+       * none. Must be called from a single thread.
+       * @param items Receives the items, in the order they were pushed by each producer.
+       * @param capacity The most items to take.
+       * @param timeoutMicroseconds How long to wait. Waits indefinitely if negative.
+       * @returns The number of items taken, which is 0 if the wait timed out or the queue was
+       * closed and is empty.
+       */
+      size_t Drain(uint64_t* items, size_t capacity, int64_t timeoutMicroseconds);
+
+      /**
+       * @brief Stops accepting items and wakes the consumer. Returns once every push that was
+       * accepted has been linked in, so items already pushed can still be drained, and once
+       * `Drain` returns 0 without a timeout, no item is left behind.
+       */
+      void Close();
+
+      /**
+       * @returns The number of times the consumer parked because the queue was empty.
+       */
+      uint64_t GetParkCount() const;
+
+      /**
+       * @returns The number of times a producer woke the parked consumer.
+       */
+      uint64_t GetWakeCount() const;
+
+    private:
+      struct Impl;
+      std::unique_ptr<Impl> impl;
+  };
+}
@@ -0,0 +1,412 @@
+#include "timer-wheel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Cpp::Core::NativeImpls {
+  namespace {
+    constexpr uint32_t wordBits = 64;
+
+    uint32_t CountTrailingZeros(uint64_t value) {
+#if defined(_MSC_VER)
+      unsigned long index;
+      _BitScanForward64(&index, value);
+      return index;
+#else
+      return static_cast<uint32_t>(__builtin_ctzll(value));
+#endif
+    }
+
+    /**
+     * @brief Finds the first set bit of a bitmap after a given bit.
+     * @returns The index of the bit, or `count` if there is none.
+     */
+    template <size_t words>
+    uint32_t FindNextSet(const uint64_t (&bits)[words], uint32_t after, uint32_t count) {
+      auto start = after + 1;
+      if (start >= count) {
+        return count;
+      }
+
+      auto word = start / wordBits;
+      auto mask = bits[word] & (~uint64_t{0} << (start % wordBits));
+      while (mask == 0) {
+        if (++word == words) {
+          return count;
+        }
+        mask = bits[word];
+      }
+
+      return word * wordBits + CountTrailingZeros(mask);
+    }
+  }
+
+  TimerWheel::TimerWheel(uint64_t now) : now(now), heads(overflowList + 1, none) {}
+
+  uint32_t TimerWheel::Schedule(uint64_t deadline, uint64_t interval) {
+    uint32_t node;
+    if (!freeNodes.empty()) {
+      node = freeNodes.back();
+      freeNodes.pop_back();
+    } else {
+      node = static_cast<uint32_t>(nodes.size());
+      nodes.emplace_back();
+    }
+
+    // Identifiers wrap around after billions of timers, skipping 0 and any still pending.
+    auto id = nextId;
+    while (id == 0 || nodesById.count(id) != 0) {
+      ++id;
+    }
+    nextId = id + 1;
+
+    auto& timer    = nodes[node];
+    timer.id       = id;
+    timer.deadline = std::max(deadline, now + 1);
+    timer.interval = interval;
+    timer.sequence = nextSequence++;
+
+    nodesById[id] = node;
+    Insert(node);
+    return id;
+  }
+
+  bool TimerWheel::Cancel(uint32_t id) {
+    auto found = nodesById.find(id);
+    if (found == nodesById.end()) {
+      return false;
+    }
+
+    auto node = found->second;
+    Unlink(node);
+    Release(node);
+    return true;
+  }
+
+  void TimerWheel::Advance(uint64_t target, std::vector<uint32_t>& expired) {
+    if (target <= now) {
+      return;
+    }
+
+    // Only the ticks with work to do are visited, so an idle wheel catches up in a few steps
+    // however far the clock moved.
+    while (true) {
+      auto tick = GetNextTick();
+      if (!tick || *tick > target) {
+        break;
+      }
+      Step(*tick, target, expired);
+    }
+
+    now = target;
+  }
+
+  std::optional<uint64_t> TimerWheel::GetNextTick() const {
+    if (nodesById.empty()) {
+      return std::nullopt;
+    }
+
+    // Every timer sits in a slot after the clock's position in its level, and the slots of a
+    // lower level are all reached before the next slot of a higher one.
+    for (uint32_t level = 0; level < LevelCount; ++level) {
+      auto shift    = SlotBits * level;
+      auto position = static_cast<uint32_t>((now >> shift) & (SlotCount - 1));
+      auto slot     = FindNextSet(occupied[level], position, SlotCount);
+      if (slot < SlotCount) {
+        auto rotation = SlotBits * (level + 1);
+        return ((now >> rotation) << rotation) | (uint64_t{slot} << shift);
+      }
+    }
+
+    if (heads[overflowList] != none) {
+      auto rotation = SlotBits * LevelCount;
+      return ((now >> rotation) + 1) << rotation;
+    }
+
+    return std::nullopt;
+  }
+
+  uint64_t TimerWheel::GetNow() const {
+    return now;
+  }
+
+  size_t TimerWheel::GetCount() const {
+    return nodesById.size();
+  }
+
+  bool TimerWheel::IsPending(uint32_t id) const {
+    return nodesById.count(id) != 0;
+  }
+
+  void TimerWheel::Insert(uint32_t node) {
+    auto deadline = nodes[node].deadline;
+    if (deadline <= now) {
+      nodes[node].list = none;
+      due.push_back(node);
+      return;
+    }
+
+    // The lowest level whose current rotation contains the deadline.
+    for (uint32_t level = 0; level < LevelCount; ++level) {
+      auto rotation = SlotBits * (level + 1);
+      if ((deadline >> rotation) == (now >> rotation)) {
+        auto slot = static_cast<uint32_t>((deadline >> (SlotBits * level)) & (SlotCount - 1));
+        Link(level * SlotCount + slot, node);
+        return;
+      }
+    }
+
+    Link(overflowList, node);
+  }
+
+  void TimerWheel::Link(uint32_t list, uint32_t node) {
+    auto& timer = nodes[node];
+    timer.list  = list;
+    timer.prev  = none;
+    timer.next  = heads[list];
+    if (timer.next != none) {
+      nodes[timer.next].prev = node;
+    }
+    heads[list] = node;
+
+    if (list != overflowList) {
+      auto level = list / SlotCount;
+      auto slot  = list % SlotCount;
+      occupied[level][slot / wordBits] |= uint64_t{1} << (slot % wordBits);
+    }
+  }
+
+  void TimerWheel::Unlink(uint32_t node) {
+    auto& timer = nodes[node];
+    auto list   = timer.list;
+    if (list == none) {
+      return;
+    }
+
+    if (timer.prev != none) {
+      nodes[timer.prev].next = timer.next;
+    } else {
+      heads[list] = timer.next;
+    }
+    if (timer.next != none) {
+      nodes[timer.next].prev = timer.prev;
+    }
+    timer.list = none;
+
+    if (list != overflowList && heads[list] == none) {
+      auto level = list / SlotCount;
+      auto slot  = list % SlotCount;
+      occupied[level][slot / wordBits] &= ~(uint64_t{1} << (slot % wordBits));
+    }
+  }
+
+  void TimerWheel::Release(uint32_t node) {
+    nodesById.erase(nodes[node].id);
+    nodes[node].list = none;
+    freeNodes.push_back(node);
+  }
+
+  void TimerWheel::Step(uint64_t tick, uint64_t target, std::vector<uint32_t>& expired) {
+    now = tick;
+
+    // Moves every timer of a list down to where its deadline now belongs.
+    auto cascade = [&](uint32_t list) {
+      auto node = heads[list];
+      while (node != none) {
+        auto next = nodes[node].next;
+        Unlink(node);
+        Insert(node);
+        node = next;
+      }
+    };
+
+    // The overflow list is revisited each time the top level wraps around, then each level is
+    // cascaded whose slot starts at this tick, from the top down.
+    auto topRotation = SlotBits * LevelCount;
+    if ((tick & ((uint64_t{1} << topRotation) - 1)) == 0) {
+      cascade(overflowList);
+    }
+
+    for (auto level = LevelCount - 1; level > 0; --level) {
+      auto shift = SlotBits * level;
+      if ((tick & ((uint64_t{1} << shift) - 1)) == 0) {
+        cascade(level * SlotCount + static_cast<uint32_t>((tick >> shift) & (SlotCount - 1)));
+      }
+    }
+
+    cascade(static_cast<uint32_t>(tick & (SlotCount - 1)));
+
+    std::sort(due.begin(), due.end(), [&](uint32_t left, uint32_t right) {
+      auto& a = nodes[left];
+      auto& b = nodes[right];
+      return a.deadline != b.deadline ? a.deadline < b.deadline : a.sequence < b.sequence;
+    });
+
+    for (auto node : due) {
+      auto& timer = nodes[node];
+      expired.push_back(timer.id);
+
+      if (timer.interval == 0) {
+        Release(node);
+        continue;
+      }
+
+      timer.deadline = std::max(timer.deadline + timer.interval, target + 1);
+      timer.sequence = nextSequence++;
+      Insert(node);
+    }
+
+    due.clear();
+  }
+
+  struct TimerService::Impl {
+    std::mutex lock;
+    TimerWheel wheel;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    // Wakes the timer thread when a timer is scheduled before the tick it's sleeping until.
+    std::condition_variable rescheduled;
+    uint64_t sleepingUntil = std::numeric_limits<uint64_t>::max();
+    bool wakePending = false;
+
+    // The timers that expired and haven't been read, guarded by `lock`.
+    std::condition_variable readable;
+    std::deque<uint32_t> queue;
+    std::unordered_set<uint32_t> queuedRepeating;
+
+    std::thread thread;
+    bool started = false;
+    bool stopped = false;
+
+    uint64_t Now() const {
+      auto elapsed = std::chrono::steady_clock::now() - start;
+      return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()
+      );
+    }
+
+    void Run() {
+      std::vector<uint32_t> expired;
+
+      std::unique_lock guard(lock);
+      while (!stopped) {
+        expired.clear();
+        wheel.Advance(Now(), expired);
+
+        auto wasEmpty = queue.empty();
+        for (auto id : expired) {
+          // A repeating timer is still pending after it expires. Only one of its expirations is
+          // queued at a time.
+          if (!wheel.IsPending(id) || queuedRepeating.insert(id).second) {
+            queue.push_back(id);
+          }
+        }
+        if (wasEmpty && !queue.empty()) {
+          readable.notify_one();
+        }
+
+        auto next     = wheel.GetNextTick();
+        sleepingUntil = next ? *next : std::numeric_limits<uint64_t>::max();
+        wakePending   = false;
+
+        auto isWoken = [this] { return stopped || wakePending; };
+        if (next) {
+          rescheduled.wait_until(guard, start + std::chrono::milliseconds(*next), isWoken);
+        } else {
+          rescheduled.wait(guard, isWoken);
+        }
+      }
+    }
+  };
+
+  TimerService::TimerService() : impl(std::make_unique<Impl>()) {}
+
+  TimerService::~TimerService() {
+    Stop();
+  }
+
+  bool TimerService::Start() {
+    std::lock_guard guard(impl->lock);
+    if (impl->started) {
+      return true;
+    }
+
+    if (impl->stopped) {
+      return false;
+    }
+
+    impl->thread  = std::thread([this] { impl->Run(); });
+    impl->started = true;
+    return true;
+  }
+
+  void TimerService::Stop() {
+    {
+      std::lock_guard guard(impl->lock);
+      impl->stopped = true;
+    }
+    impl->rescheduled.notify_all();
+    impl->readable.notify_all();
+
+    if (impl->thread.joinable()) {
+      impl->thread.join();
+    }
+  }
+
+  uint32_t TimerService::Schedule(uint64_t delayMilliseconds, uint64_t intervalMilliseconds) {
+    std::lock_guard guard(impl->lock);
+
+    auto deadline = impl->Now() + delayMilliseconds;
+    auto id       = impl->wheel.Schedule(deadline, intervalMilliseconds);
+
+    // The wheel may not have caught up with the clock yet, so the timer could expire on an
+    // earlier tick than its deadline, but never on a later one.
+    if (impl->wheel.GetNextTick() < impl->sleepingUntil) {
+      impl->wakePending = true;
+      impl->rescheduled.notify_one();
+    }
+    return id;
+  }
+
+  bool TimerService::Cancel(uint32_t id) {
+    // A cancelled timer at most makes the thread wake up for nothing, so it's left asleep.
+    std::lock_guard guard(impl->lock);
+    return impl->wheel.Cancel(id);
+  }
+
+  size_t TimerService::Read(uint32_t* ids, size_t capacity, int64_t timeoutMicroseconds) {
+    auto& state = *impl;
+
+    std::unique_lock guard(state.lock);
+    auto isReadable = [&state] { return !state.queue.empty() || state.stopped; };
+    if (timeoutMicroseconds < 0) {
+      state.readable.wait(guard, isReadable);
+    } else {
+      state.readable.wait_for(guard, std::chrono::microseconds(timeoutMicroseconds), isReadable);
+    }
+
+    size_t count = 0;
+    while (count < capacity && !state.queue.empty()) {
+      auto id = state.queue.front();
+      state.queue.pop_front();
+      state.queuedRepeating.erase(id);
+      ids[count++] = id;
+    }
+    return count;
+  }
+
+  size_t TimerService::GetCount() const {
+    std::lock_guard guard(impl->lock);
+    return impl->wheel.GetCount();
+  }
+}
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace Cpp::Core::NativeImpls {
+  /**
+   * @brief A hierarchical timing wheel: timers are scheduled and cancelled in constant time, and
+   * advancing the clock only visits the slots that hold timers.
+   *
+   * Time is measured in ticks. The wheel has `LevelCount` levels of `SlotCount` slots each, where a
+   * slot of level 0 spans one tick and a slot of each higher level spans a full rotation of the
+   * level below. A timer is placed in the lowest level whose rotation still contains its deadline,
+   * and moves down a level each time the clock reaches the start of its slot, until it expires from
+   * level 0. Deadlines beyond the top level wait in an overflow list that's only revisited when the
+   * top level wraps around.
+   *
+   * Timers expire in order of their deadlines, and timers with the same deadline in the order they
+   * were scheduled or last re-armed. Timers are kept in a pool that's reused as they expire or are
+   * cancelled, so memory only grows with the number of timers pending at once.
+   *
+   * Not thread-safe.
+   */
+  class TimerWheel {
+    public:
+      /** The number of bits of a tick that each level covers. */
+      static constexpr uint32_t SlotBits = 8;
+
+      /** The number of slots in each level. */
+      static constexpr uint32_t SlotCount = 1u << SlotBits;
+
+      /** The number of levels. Together they span 2^32 ticks. */
+      static constexpr uint32_t LevelCount = 4;
+
+      /**
+       * @param now The tick the wheel starts at.
+       */
+      explicit TimerWheel(uint64_t now = 0);
+
+      /**
+       * @brief Schedules a timer.
+       * @param deadline The tick the timer expires at. A deadline that has already passed expires
+       * on the next tick.
+       * @param interval How many ticks to re-arm the timer for each time it expires, or 0 to only
+       * expire once.
+       * @returns The identifier of the timer, which is never 0.
+       */
+      uint32_t Schedule(uint64_t deadline, uint64_t interval = 0);
+
+      /**
+       * @brief Cancels a timer so that it never expires again.
+       * @returns Whether the timer was pending.
+       */
+      bool Cancel(uint32_t id);
+
+      /**
+       * @brief Advances the clock, expiring every timer whose deadline is reached. Timers that
+       * repeat are re-armed relative to their deadline, or to the tick after `now` if the clock
+       * moved past more than one interval, so a late clock doesn't cause a burst of expirations.
+       * @param now The tick to advance to. Ignored if it's not after the current tick.
+       * @param expired Receives the identifiers of the expired timers, in the order they expired.
+       * Appended to.
+       */
+      void Advance(uint64_t now, std::vector<uint32_t>& expired);
+
+      /**
+       * @returns The earliest tick at which `Advance` has work to do, i.e. either a timer expires
+       * or timers move down a level, or nothing if there are no timers. Never later than the
+       * earliest deadline.
+       */
+      std::optional<uint64_t> GetNextTick() const;
+
+      /**
+       * @returns The current tick.
+       */
+      uint64_t GetNow() const;
+
+      /**
+       * @returns Whether a timer is pending, i.e. it was scheduled, and hasn't been cancelled or
+       * expired without repeating.
+       */
+      bool IsPending(uint32_t id) const;
+
+      /**
+       * @returns The number of pending timers.
+       */
+      size_t GetCount() const;
+
+    private:
+      static constexpr uint32_t none = 0xFFFFFFFF;
+
+      /** The index of the list of overflowing timers, after the slots of every level. */
+      static constexpr uint32_t overflowList = LevelCount * SlotCount;
+
+      struct Node {
+        uint32_t id;
+        uint32_t prev;
+        uint32_t next;
+
+        /** The list the node is in: a slot, `overflowList`, or `none` if it's free. */
+        uint32_t list;
+
+        uint64_t deadline;
+        uint64_t interval;
+
+        /** Breaks ties between timers with the same deadline. */
+        uint64_t sequence;
+      };
+
+      void Insert(uint32_t node);
+      void Link(uint32_t list, uint32_t node);
+      void Unlink(uint32_t node);
+      void Release(uint32_t node);
+
+      /**
+       * @brief Moves the clock to a tick at which `GetNextTick` said there's work to do, and does
+       * it.
+       * @param target The tick that `Advance` is advancing to.
+       */
+      void Step(uint64_t tick, uint64_t target, std::vector<uint32_t>& expired);
+
+      uint64_t now;
+      uint64_t nextSequence = 0;
+      uint32_t nextId = 1;
+
+      std::vector<Node> nodes;
+      std::vector<uint32_t> freeNodes;
+      std::unordered_map<uint32_t, uint32_t> nodesById;
+
+      /** The first node of each slot and of the overflow list. */
+      std::vector<uint32_t> heads;
+
+      /** A bit per slot of each level, set if the slot holds any timers. */
+      uint64_t occupied[LevelCount][SlotCount / 64] = {};
+
+      /** Nodes that expired during a step, sorted before they're reported. */
+      std::vector<uint32_t> due;
+  };
+
+  /**
+   * @brief Drives a `TimerWheel` of millisecond ticks from a single thread and queues the timers
+   * that expire, in order, for a single reader.
+   *
+   * The thread sleeps until the next tick that has work to do, and is woken early when a timer
+   * is scheduled before that. A repeating timer that expires again before the reader caught up
+   * with its last expiration is only queued once, so the queue never holds more entries than
+   * there are timers.
+   *
+   * `Schedule` and `Cancel` may be called from any thread. `Read` must be called from a single
+   * thread.
+   */
+  class TimerService {
+    public:
+      TimerService();
+      ~TimerService();
+
+      TimerService(const TimerService&)            = delete;
+      TimerService& operator=(const TimerService&) = delete;
+
+      /**
+       * @brief Starts the timer thread.
+       * @returns `false` if the thread couldn't be started.
+       */
+      bool Start();
+
+      /**
+       * @brief Stops the timer thread, if started, and wakes the reader.
+       */
+      void Stop();
+
+      /**
+       * @brief Schedules a timer.
+       * @param delayMilliseconds How long until the timer expires.
+       * @param intervalMilliseconds How long between the expirations of a repeating timer, or 0 to
+       * only expire once.
+       * @returns The identifier of the timer, which is never 0.
+       */
+      uint32_t Schedule(uint64_t delayMilliseconds, uint64_t intervalMilliseconds);
+
+      /**
+       * @brief Cancels a timer. An expiration that's already queued is still read.
+       * @returns Whether the timer was pending.
+       */
+      bool Cancel(uint32_t id);
+
+      /**
+       * @brief Reads the timers that expired, waiting for at least one if there are none.
+       * @param ids Receives the identifiers of the timers, in the order they expired.
+       * @param capacity The most identifiers to read.
+       * @param timeoutMicroseconds How long to wait. Waits indefinitely if negative.
+       * @returns The number of identifiers read, which is 0 if the wait timed out or the service
+       * was stopped.
+       */
+      size_t Read(uint32_t* ids, size_t capacity, int64_t timeoutMicroseconds);
+
+      /**
+       * @returns The number of pending timers.
+       */
+      size_t GetCount() const;
+
+    private:
+      struct Impl;
+      std::unique_ptr<Impl> impl;
+  };
+}
@@ -0,0 +1,575 @@
+#include "win-event-dispatcher.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+namespace Cpp::Core::NativeImpls {
+  namespace {
+    // The object and child identifiers of an event about a window itself.
+    constexpr int32_t objectIdWindow = 0;
+    constexpr int32_t childIdSelf    = 0;
+
+    // How long `Subscribe` waits for the hook thread to install the hooks.
+    constexpr auto hookTimeout = std::chrono::seconds(1);
+
+    size_t RoundUpToPowerOfTwo(size_t value) {
+      size_t result = 1;
+      while (result < value) {
+        result <<= 1;
+      }
+      return result;
+    }
+
+    /**
+     * @brief Adds to a counter that only one thread writes to, without a locked instruction.
+     */
+    void Increment(std::atomic<uint64_t>& counter) {
+      counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+  }
+
+  WinEventFilter::WinEventFilter(std::vector<uint32_t> events, size_t maxRanges) {
+    std::sort(events.begin(), events.end());
+    events.erase(std::unique(events.begin(), events.end()), events.end());
+
+    for (auto event : events) {
+      auto index = event >> 8;
+      if (pages.empty() || pages.back().index != index) {
+        pages.push_back({index, {0, 0, 0, 0}});
+      }
+      pages.back().bits[(event >> 6) & 3] |= uint64_t{1} << (event & 63);
+
+      // Extend the last range when the event follows on from it.
+      if (!ranges.empty() && ranges.back().max + 1 == event) {
+        ranges.back().max = event;
+      } else {
+        ranges.push_back({event, event});
+      }
+    }
+
+    // Merge the ranges with the smallest gap between them until few enough are left.
+    maxRanges = std::max<size_t>(maxRanges, 1);
+    while (ranges.size() > maxRanges) {
+      size_t closest = 0;
+      for (size_t i = 1; i + 1 < ranges.size(); ++i) {
+        auto gap = ranges[i + 1].min - ranges[i].max;
+        if (gap < ranges[closest + 1].min - ranges[closest].max) {
+          closest = i;
+        }
+      }
+
+      ranges[closest].max = ranges[closest + 1].max;
+      ranges.erase(ranges.begin() + static_cast<ptrdiff_t>(closest) + 1);
+    }
+  }
+
+  bool WinEventFilter::Contains(uint32_t event) const {
+    // There are rarely more than two pages, so a linear search beats anything cleverer.
+    auto index = event >> 8;
+    for (const auto& page : pages) {
+      if (page.index == index) {
+        return ((page.bits[(event >> 6) & 3] >> (event & 63)) & 1) != 0;
+      }
+    }
+
+    return false;
+  }
+
+  const std::vector<WinEventRange>& WinEventFilter::GetRanges() const {
+    return ranges;
+  }
+
+  struct WinEventDispatcher::Impl {
+    WinEventDispatcherOptions options;
+
+    struct Subscription {
+      uint32_t count = 0;
+
+      // The generation that first hooked the event. A later subscriber waits for it too, since
+      // the hooks may still be being installed for an earlier one.
+      uint64_t generation = 0;
+    };
+
+    // The subscriptions to each event, guarded by `lock`.
+    std::mutex lock;
+    std::map<uint32_t, Subscription> subscriptions;
+
+    // Bumped whenever the set of subscribed events changes, guarded by `lock`. `applied` is the
+    // generation whose hooks are installed and is signalled through `hooksApplied`.
+    uint64_t requested = 0;
+    uint64_t applied   = 0;
+    std::condition_variable hooksApplied;
+
+    // The ranges whose hooks are installed as of `applied`, and the error of the last hook that
+    // couldn't be installed, guarded by `lock`.
+    std::vector<WinEventRange> hooked;
+    uint32_t hookError = 0;
+
+    // State owned by the thread that filters events.
+    WinEventFilter filter;
+    uint64_t compiled = 0;
+
+    // The queue of accepted events. The hook thread pushes at `tail`, the reader pops at `head`.
+    std::vector<WinEventRecord> ring;
+    size_t mask;
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<size_t> tail{0};
+
+    // Set by the reader before it sleeps, so the hook thread only signals when someone's waiting.
+    std::atomic<bool> waiting{false};
+    std::atomic<bool> stopped{false};
+    std::mutex readLock;
+    std::condition_variable readable;
+
+    std::atomic<uint64_t> received{0};
+    std::atomic<uint64_t> accepted{0};
+    std::atomic<uint64_t> dropped{0};
+
+    bool started = false;
+    std::thread thread;
+
+#if defined(_WIN32)
+    DWORD threadId = 0;
+    std::atomic<bool> wakePending{false};
+
+    struct Hook {
+      WinEventRange range;
+      HWINEVENTHOOK handle;
+    };
+    std::vector<Hook> hooks;
+#endif
+
+    explicit Impl(const WinEventDispatcherOptions& options)
+      : options(options),
+        ring(RoundUpToPowerOfTwo(std::max<size_t>(options.queueCapacity, 1))),
+        mask(ring.size() - 1) {}
+
+    size_t TryRead(WinEventRecord* records, size_t capacity) {
+      auto begin = head.load(std::memory_order_relaxed);
+      auto end   = tail.load(std::memory_order_acquire);
+      auto count = std::min(end - begin, capacity);
+
+      for (size_t i = 0; i < count; ++i) {
+        records[i] = ring[(begin + i) & mask];
+      }
+
+      head.store(begin + count, std::memory_order_release);
+      return count;
+    }
+
+    void MarkApplied(std::vector<WinEventRange> ranges, uint32_t error) {
+      {
+        std::lock_guard guard(lock);
+        applied = compiled;
+        hooked  = std::move(ranges);
+        if (error != 0) {
+          hookError = error;
+        }
+      }
+      hooksApplied.notify_all();
+    }
+
+    /**
+     * @returns Whether an installed hook covers the event. Must be called under `lock`.
+     */
+    bool IsHooked(uint32_t event) const {
+      return std::any_of(hooked.begin(), hooked.end(), [&](const WinEventRange& range) {
+        return range.min <= event && event <= range.max;
+      });
+    }
+
+    /**
+     * @brief Asks the hook thread to refresh the hooks. Does nothing if the thread isn't running.
+     */
+    void Wake();
+
+#if defined(_WIN32)
+    /**
+     * @brief Refreshes the filter and reinstalls the hooks, on the hook thread.
+     */
+    void Apply(WinEventDispatcher& dispatcher);
+
+    /**
+     * @returns The ranges of the installed hooks, on the hook thread.
+     */
+    std::vector<WinEventRange> GetHookedRanges() const;
+
+    /**
+     * @brief Installs the hooks and pumps messages until the thread is asked to quit.
+     */
+    void Run(WinEventDispatcher& dispatcher, std::promise<bool>& ready);
+#endif
+  };
+
+  WinEventDispatcher::WinEventDispatcher(const WinEventDispatcherOptions& options)
+    : impl(std::make_unique<Impl>(options)) {}
+
+  WinEventDispatcher::~WinEventDispatcher() {
+    Stop();
+  }
+
+  bool WinEventDispatcher::Subscribe(const uint32_t* events, size_t count, std::string& error) {
+    uint64_t generation = 0;
+    {
+      std::lock_guard guard(impl->lock);
+
+      // Every new event is hooked by the same generation.
+      auto next = impl->requested + 1;
+      for (size_t i = 0; i < count; ++i) {
+        auto& subscription = impl->subscriptions[events[i]];
+        if (subscription.count++ == 0) {
+          subscription.generation = next;
+        }
+        generation = std::max(generation, subscription.generation);
+      }
+
+      if (generation == next) {
+        impl->requested = next;
+      }
+    }
+
+    if (!impl->started) {
+      return true;
+    }
+
+    {
+      // Wait for the hooks, so that no event is missed once this returns.
+      std::unique_lock guard(impl->lock);
+      if (impl->applied < generation) {
+        guard.unlock();
+        impl->Wake();
+        guard.lock();
+
+        impl->hooksApplied.wait_for(guard, hookTimeout, [&] {
+          return impl->applied >= generation || impl->stopped.load();
+        });
+      }
+
+      if (impl->stopped.load()) {
+        error = "The dispatcher was stopped";
+      } else if (impl->applied < generation) {
+        error = "The hook thread didn't install the hooks in time";
+      } else if (!std::all_of(events, events + count, [&](uint32_t event) {
+                   return impl->IsHooked(event);
+                 })) {
+        error = "SetWinEventHook failed (error " + std::to_string(impl->hookError) + ")";
+      } else {
+        return true;
+      }
+    }
+
+    Unsubscribe(events, count);
+    return false;
+  }
+
+  void WinEventDispatcher::Unsubscribe(const uint32_t* events, size_t count) {
+    {
+      std::lock_guard guard(impl->lock);
+
+      auto isRemoved = false;
+      for (size_t i = 0; i < count; ++i) {
+        auto found = impl->subscriptions.find(events[i]);
+        if (found != impl->subscriptions.end() && --found->second.count == 0) {
+          impl->subscriptions.erase(found);
+          isRemoved = true;
+        }
+      }
+
+      if (!isRemoved) {
+        return;
+      }
+      ++impl->requested;
+    }
+
+    impl->Wake();
+  }
+
+  bool WinEventDispatcher::Refresh() {
+    std::vector<uint32_t> events;
+    {
+      std::lock_guard guard(impl->lock);
+      if (impl->requested == impl->compiled) {
+        return false;
+      }
+
+      impl->compiled = impl->requested;
+      events.reserve(impl->subscriptions.size());
+      for (const auto& [event, subscription] : impl->subscriptions) {
+        events.push_back(event);
+      }
+    }
+
+    auto previous = impl->filter.GetRanges();
+    impl->filter  = WinEventFilter(std::move(events), impl->options.maxHooks);
+    return impl->filter.GetRanges() != previous;
+  }
+
+  std::vector<WinEventRange> WinEventDispatcher::GetRanges() const {
+    return impl->filter.GetRanges();
+  }
+
+  bool WinEventDispatcher::OnEvent(
+    uint32_t event,
+    uint64_t hwnd,
+    int32_t idObject,
+    int32_t idChild,
+    uint32_t time
+  ) {
+    auto& state = *impl;
+    Increment(state.received);
+
+    if (state.options.onlyWindowObjects &&
+        (hwnd == 0 || idObject != objectIdWindow || idChild != childIdSelf)) {
+      return false;
+    }
+
+    if (!state.filter.Contains(event)) {
+      return false;
+    }
+
+    auto end = state.tail.load(std::memory_order_relaxed);
+    if (end - state.head.load(std::memory_order_acquire) == state.ring.size()) {
+      Increment(state.dropped);
+      return false;
+    }
+
+    state.ring[end & state.mask] = {event, time, hwnd};
+
+    // Sequentially consistent, so that either the reader sees the event before sleeping or the
+    // hook thread sees that the reader is waiting.
+    state.tail.store(end + 1, std::memory_order_seq_cst);
+    Increment(state.accepted);
+
+    if (state.waiting.load(std::memory_order_seq_cst) && state.waiting.exchange(false)) {
+      std::lock_guard guard(state.readLock);
+      state.readable.notify_one();
+    }
+
+    return true;
+  }
+
+  size_t WinEventDispatcher::Read(
+    WinEventRecord* records,
+    size_t capacity,
+    int64_t timeoutMicroseconds
+  ) {
+    auto& state = *impl;
+
+    auto count = state.TryRead(records, capacity);
+    if (count > 0 || timeoutMicroseconds == 0 || capacity == 0) {
+      return count;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::microseconds(std::max<int64_t>(timeoutMicroseconds, 0));
+
+    std::unique_lock guard(state.readLock);
+    while (true) {
+      // Announce the wait before checking the queue a final time, see `OnEvent`.
+      state.waiting.store(true, std::memory_order_seq_cst);
+
+      count = state.TryRead(records, capacity);
+      if (count > 0 || state.stopped.load()) {
+        state.waiting.store(false, std::memory_order_relaxed);
+        return count;
+      }
+
+      if (timeoutMicroseconds < 0) {
+        state.readable.wait(guard);
+      } else if (state.readable.wait_until(guard, deadline) == std::cv_status::timeout) {
+        state.waiting.store(false, std::memory_order_relaxed);
+        return state.TryRead(records, capacity);
+      }
+    }
+  }
+
+  uint64_t WinEventDispatcher::GetReceivedCount() const {
+    return impl->received.load(std::memory_order_relaxed);
+  }
+
+  uint64_t WinEventDispatcher::GetAcceptedCount() const {
+    return impl->accepted.load(std::memory_order_relaxed);
+  }
+
+  uint64_t WinEventDispatcher::GetDroppedCount() const {
+    return impl->dropped.load(std::memory_order_relaxed);
+  }
+
+  void WinEventDispatcher::Stop() {
+    impl->stopped.store(true);
+
+    {
+      std::lock_guard guard(impl->readLock);
+    }
+    impl->readable.notify_all();
+
+    {
+      std::lock_guard guard(impl->lock);
+    }
+    impl->hooksApplied.notify_all();
+
+#if defined(_WIN32)
+    if (impl->thread.joinable()) {
+      PostThreadMessageW(impl->threadId, WM_QUIT, 0, 0);
+      impl->thread.join();
+    }
+#endif
+  }
+
+#if defined(_WIN32)
+  namespace {
+    // The message that asks the hook thread to refresh its hooks.
+    constexpr UINT refreshMessage = WM_APP + 1;
+
+    // The dispatcher whose hooks the current thread pumps. Out-of-context hooks are called on the
+    // thread that installed them, and the hook procedure has no other way to find its dispatcher.
+    thread_local WinEventDispatcher* currentDispatcher = nullptr;
+
+    void CALLBACK OnWinEvent(
+      HWINEVENTHOOK,
+      DWORD event,
+      HWND hwnd,
+      LONG idObject,
+      LONG idChild,
+      DWORD,
+      DWORD time
+    ) {
+      if (currentDispatcher != nullptr) {
+        currentDispatcher->OnEvent(
+          event,
+          reinterpret_cast<uint64_t>(hwnd),
+          idObject,
+          idChild,
+          time
+        );
+      }
+    }
+  }
+
+  void WinEventDispatcher::Impl::Wake() {
+    if (!thread.joinable() || wakePending.exchange(true)) {
+      return;
+    }
+
+    PostThreadMessageW(threadId, refreshMessage, 0, 0);
+  }
+
+  void WinEventDispatcher::Impl::Apply(WinEventDispatcher& dispatcher) {
+    wakePending.store(false);
+    if (!dispatcher.Refresh()) {
+      MarkApplied(GetHookedRanges(), 0);
+      return;
+    }
+
+    // Install the new hooks before removing the old ones, so no event is missed in between. Hooks
+    // whose range didn't change are kept as they are.
+    std::vector<Hook> next;
+    DWORD error = 0;
+    for (const auto& range : filter.GetRanges()) {
+      auto kept = std::find_if(hooks.begin(), hooks.end(), [&](const Hook& hook) {
+        return hook.handle != nullptr && hook.range == range;
+      });
+
+      if (kept != hooks.end()) {
+        next.push_back(*kept);
+        kept->handle = nullptr;
+        continue;
+      }
+
+      auto handle = SetWinEventHook(
+        range.min,
+        range.max,
+        nullptr,
+        OnWinEvent,
+        0, // monitor all processes
+        0, // monitor all threads
+        WINEVENT_OUTOFCONTEXT
+      );
+
+      if (handle != nullptr) {
+        next.push_back({range, handle});
+      } else {
+        error = GetLastError();
+      }
+    }
+
+    for (const auto& hook : hooks) {
+      if (hook.handle != nullptr) {
+        UnhookWinEvent(hook.handle);
+      }
+    }
+
+    hooks = std::move(next);
+    MarkApplied(GetHookedRanges(), error);
+  }
+
+  std::vector<WinEventRange> WinEventDispatcher::Impl::GetHookedRanges() const {
+    std::vector<WinEventRange> ranges;
+    for (const auto& hook : hooks) {
+      ranges.push_back(hook.range);
+    }
+    return ranges;
+  }
+
+  void WinEventDispatcher::Impl::Run(WinEventDispatcher& dispatcher, std::promise<bool>& ready) {
+    currentDispatcher = &dispatcher;
+
+    // Create the thread's message queue before anyone posts to it.
+    MSG msg;
+    PeekMessageW(&msg, nullptr, WM_USER, WM_USER, PM_NOREMOVE);
+    threadId = GetCurrentThreadId();
+    ready.set_value(true);
+
+    Apply(dispatcher);
+
+    // The hooks are called from within the message loop.
+    while (GetMessageW(&msg, nullptr, 0, 0) > 0) {
+      if (msg.hwnd == nullptr && msg.message == refreshMessage) {
+        Apply(dispatcher);
+        continue;
+      }
+
+      TranslateMessage(&msg);
+      DispatchMessageW(&msg);
+    }
+
+    for (const auto& hook : hooks) {
+      UnhookWinEvent(hook.handle);
+    }
+    hooks.clear();
+    currentDispatcher = nullptr;
+  }
+
+  bool WinEventDispatcher::Start() {
+    if (impl->started) {
+      return true;
+    }
+
+    std::promise<bool> ready;
+    auto isReady = ready.get_future();
+
+    impl->thread  = std::thread([this, &ready] { impl->Run(*this, ready); });
+    impl->started = isReady.get();
+    return impl->started;
+  }
+#else
+  void WinEventDispatcher::Impl::Wake() {}
+
+  bool WinEventDispatcher::Start() {
+    // There are no WinEvents to hook. `Refresh` and `OnEvent` can still be driven directly.
+    return false;
+  }
+#endif
+}
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Cpp::Core::NativeImpls {
+  /**
+   * @brief An inclusive range of WinEvent identifiers.
+   */
+  struct WinEventRange {
+    uint32_t min;
+    uint32_t max;
+
+    bool operator==(const WinEventRange& other) const {
+      return min == other.min && max == other.max;
+    }
+  };
+
+  /**
+   * @brief A WinEvent that passed a dispatcher's filter.
+   */
+  struct WinEventRecord {
+    /** The identifier of the event, e.g. `EVENT_OBJECT_CREATE`. */
+    uint32_t event;
+
+    /** The time the event was generated, in milliseconds, as reported by the system. */
+    uint32_t time;
+
+    /** The window the event is about. */
+    uint64_t hwnd;
+  };
+
+  /**
+   * @brief A set of WinEvent identifiers compiled for fast membership tests.
+   *
+   * WinEvent identifiers are sparse: the system events start at 0x0001 and the object events at
+   * 0x8000, with a few smaller blocks elsewhere. The set is stored as a 256-bit page per block of
+   * identifiers in use, so testing an event is a page lookup and a bit test. The set also describes
+   * the ranges of identifiers to hook, which are merged across the smallest gaps until there are no
+   * more than a given number. Events in the gaps are rejected by the bit test.
+   */
+  class WinEventFilter {
+    public:
+      WinEventFilter() = default;
+
+      /**
+       * @param events The identifiers in the set, in any order and possibly repeated.
+       * @param maxRanges The most ranges to describe the set with. At least 1.
+       */
+      WinEventFilter(std::vector<uint32_t> events, size_t maxRanges);
+
+      /**
+       * @returns Whether the event is in the set.
+       */
+      bool Contains(uint32_t event) const;
+
+      /**
+       * @returns The ranges to hook to receive every event in the set, in ascending order.
+       */
+      const std::vector<WinEventRange>& GetRanges() const;
+
+    private:
+      struct Page {
+        uint32_t index;
+        uint64_t bits[4];
+      };
+
+      std::vector<Page> pages;
+      std::vector<WinEventRange> ranges;
+  };
+
+  /**
+   * @brief Configures a `WinEventDispatcher`.
+   */
+  struct WinEventDispatcherOptions {
+    /** The number of events that can wait to be read. Rounded up to a power of two. */
+    size_t queueCapacity = 4096;
+
+    /** The most hooks to install. More hooks mean fewer events outside of the set to reject. */
+    size_t maxHooks = 8;
+
+    /**
+     * Whether to only accept events about a window itself, rather than one of its child objects
+     * such as the caret or a scroll bar.
+     */
+    bool onlyWindowObjects = true;
+  };
+
+  /**
+   * @brief Hooks just the WinEvents that are subscribed to and queues the ones that pass its filter
+   * for a reader, so that irrelevant events never reach managed code.
+   *
+   * Once started, the dispatcher runs a hook thread that installs and pumps the hooks. The hooks
+   * are narrowed to the subscribed ranges whenever the subscriptions change. Every event is
+   * filtered on the hook thread and the events that pass are pushed onto a lock-free ring buffer.
+   * When the ring buffer is full, events are dropped and counted.
+   *
+   * `Subscribe` and `Unsubscribe` may be called from any thread. `Refresh` and `OnEvent` must be
+   * called from a single thread, which is the hook thread once started. `Read` must be called from
+   * a single thread.
+   */
+  class WinEventDispatcher {
+    public:
+      explicit WinEventDispatcher(const WinEventDispatcherOptions& options = {});
+      ~WinEventDispatcher();
+
+      WinEventDispatcher(const WinEventDispatcher&)            = delete;
+      WinEventDispatcher& operator=(const WinEventDispatcher&) = delete;
+
+      /**
+       * @brief Starts the hook thread.
+       * @returns `false` if the thread couldn't be started, or there are no WinEvents to hook on
+       * this platform.
+       */
+      bool Start();
+
+      /**
+       * @brief Stops the hook thread, if started, and wakes any reader.
+       */
+      void Stop();
+
+      /**
+       * @brief Subscribes to events. Once started, returns after the events are hooked.
+       * @param events The identifiers of the events. Subscriptions are counted per event.
+       * @param error Receives a description of the problem if the events couldn't be hooked.
+       * @returns `false` if the hook thread didn't install the hooks in time, a hook couldn't be
+       * installed or the dispatcher was stopped, in which case the subscription isn't kept.
+       */
+      bool Subscribe(const uint32_t* events, size_t count, std::string& error);
+
+      /**
+       * @brief Removes subscriptions added by `Subscribe`. Returns without waiting for the events
+       * to be unhooked, and events are filtered out immediately once the hook thread catches up.
+       */
+      void Unsubscribe(const uint32_t* events, size_t count);
+
+      /**
+       * @brief Recompiles the filter if the subscriptions changed.
+       * @returns Whether the ranges to hook changed.
+       */
+      bool Refresh();
+
+      /**
+       * @returns The ranges the current filter hooks.
+       */
+      std::vector<WinEventRange> GetRanges() const;
+
+      /**
+       * @brief Filters an event and queues it if it passes. Called by the hook procedure.
+       * @returns Whether the event was queued.
+       */
+      bool OnEvent(uint32_t event, uint64_t hwnd, int32_t idObject, int32_t idChild, uint32_t time);
+
+      /**
+       * @brief Reads queued events, waiting for at least one if there are none.
+       * @param records Receives the events, in the order they were queued.
+       * @param capacity The most events to read.
+       * @param timeoutMicroseconds How long to wait. Waits indefinitely if negative.
+       * @returns The number of events read, which is 0 if the wait timed out or the dispatcher was
+       * stopped.
+       */
+      size_t Read(WinEventRecord* records, size_t capacity, int64_t timeoutMicroseconds);
+
+      /**
+       * @returns The number of events the hook procedure received.
+       */
+      uint64_t GetReceivedCount() const;
+
+      /**
+       * @returns The number of events that passed the filter and were queued.
+       */
+      uint64_t GetAcceptedCount() const;
+
+      /**
+       * @returns The number of events that passed the filter but were dropped because the queue was
+       * full.
+       */
+      uint64_t GetDroppedCount() const;
+
+    private:
+      struct Impl;
+      std::unique_ptr<Impl> impl;
+  };
+}
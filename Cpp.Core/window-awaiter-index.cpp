@@ -0,0 +1,166 @@
+#include "window-awaiter-index.h"
+
+#include <algorithm>
+
+namespace Cpp::Core::NativeImpls {
+  WindowAwaiterIndex::WindowAwaiterIndex()  = default;
+  WindowAwaiterIndex::~WindowAwaiterIndex() = default;
+
+  namespace {
+    template <typename Awaiter>
+    void EraseFrom(std::vector<const Awaiter*>& list, const Awaiter* awaiter) {
+      auto found = std::find(list.begin(), list.end(), awaiter);
+      if (found != list.end()) {
+        list.erase(found);
+      }
+    }
+
+    /**
+     * @brief Removes an awaiter from an index, dropping its list once empty so that lookups skip
+     * querying fields that no awaiter compares.
+     */
+    template <typename Key, typename Awaiter>
+    void EraseFrom(
+      std::unordered_map<Key, std::vector<const Awaiter*>>& index,
+      const Key& key,
+      const Awaiter* awaiter
+    ) {
+      auto found = index.find(key);
+      if (found != index.end()) {
+        EraseFrom(found->second, awaiter);
+        if (found->second.empty()) {
+          index.erase(found);
+        }
+      }
+    }
+  }
+
+  void WindowAwaiterIndex::Bucket::Insert(const Awaiter* awaiter) {
+    // Process identifiers are the cheapest field to query and the most selective, then classes.
+    auto& matcher = awaiter->matcher;
+    if (matcher.processId) {
+      byProcessId[*matcher.processId].push_back(awaiter);
+    } else if (matcher.className && matcher.className->IsLiteral()) {
+      byClassName[FoldedHash(matcher.className->GetLiteral())].push_back(awaiter);
+    } else {
+      unindexed.push_back(awaiter);
+    }
+  }
+
+  void WindowAwaiterIndex::Bucket::Erase(const Awaiter* awaiter) {
+    auto& matcher = awaiter->matcher;
+    if (matcher.processId) {
+      EraseFrom(byProcessId, *matcher.processId, awaiter);
+    } else if (matcher.className && matcher.className->IsLiteral()) {
+      EraseFrom(byClassName, FoldedHash(matcher.className->GetLiteral()), awaiter);
+    } else {
+      EraseFrom(unindexed, awaiter);
+    }
+  }
+
+  bool WindowAwaiterIndex::Bucket::IsEmpty() const {
+    return byProcessId.empty() && byClassName.empty() && unindexed.empty();
+  }
+
+  uint32_t WindowAwaiterIndex::Add(const uint32_t* events, size_t count, WindowMatcher matcher) {
+    auto awaiter     = std::make_unique<Awaiter>();
+    awaiter->id      = nextId++;
+    awaiter->matcher = std::move(matcher);
+    awaiter->events.assign(events, events + count);
+
+    // An awaiter that lists an event twice is still only compared once per event.
+    std::sort(awaiter->events.begin(), awaiter->events.end());
+    awaiter->events.erase(
+      std::unique(awaiter->events.begin(), awaiter->events.end()),
+      awaiter->events.end()
+    );
+
+    for (auto event : awaiter->events) {
+      buckets[event].Insert(awaiter.get());
+    }
+
+    auto id = awaiter->id;
+    awaiters.emplace(id, std::move(awaiter));
+    return id;
+  }
+
+  bool WindowAwaiterIndex::Remove(uint32_t id) {
+    auto found = awaiters.find(id);
+    if (found == awaiters.end()) {
+      return false;
+    }
+
+    auto awaiter = found->second.get();
+    for (auto event : awaiter->events) {
+      auto bucket = buckets.find(event);
+      if (bucket == buckets.end()) {
+        continue;
+      }
+
+      bucket->second.Erase(awaiter);
+      if (bucket->second.IsEmpty()) {
+        buckets.erase(bucket);
+      }
+    }
+
+    awaiters.erase(found);
+    return true;
+  }
+
+  size_t WindowAwaiterIndex::GetCount() const {
+    return awaiters.size();
+  }
+
+  void WindowAwaiterIndex::Match(
+    uint32_t event,
+    LiveWindow& window,
+    std::vector<uint32_t>& ids
+  ) const {
+    ids.clear();
+
+    auto found = buckets.find(event);
+    if (found == buckets.end()) {
+      return;
+    }
+
+    auto& bucket = found->second;
+    auto test    = [&](const std::vector<const Awaiter*>& candidates) {
+      for (auto awaiter : candidates) {
+        ++comparedCount;
+        if (awaiter->matcher.Matches(window)) {
+          ids.push_back(awaiter->id);
+        }
+      }
+    };
+
+    if (!bucket.byProcessId.empty()) {
+      uint32_t processId = 0;
+      if (window.GetProcessId(processId)) {
+        auto candidates = bucket.byProcessId.find(processId);
+        if (candidates != bucket.byProcessId.end()) {
+          test(candidates->second);
+        }
+      }
+    }
+
+    // Hashes only select candidates; every candidate is still compared in full.
+    if (!bucket.byClassName.empty()) {
+      std::u16string_view className;
+      if (window.GetClassName(className)) {
+        auto candidates = bucket.byClassName.find(FoldedHash(className));
+        if (candidates != bucket.byClassName.end()) {
+          test(candidates->second);
+        }
+      }
+    }
+
+    test(bucket.unindexed);
+
+    // Identifiers are handed out in ascending order, so sorting restores the order of `Add`.
+    std::sort(ids.begin(), ids.end());
+  }
+
+  uint64_t WindowAwaiterIndex::GetComparedCount() const {
+    return comparedCount;
+  }
+}
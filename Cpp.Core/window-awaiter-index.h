@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "window-matcher.h"
+
+namespace Cpp::Core::NativeImpls {
+  /**
+   * @brief The pending waits for a window, indexed so that an event is only compared against the
+   * awaiters it could complete.
+   *
+   * Awaiters are grouped by the WinEvents they wait for. Within an event, awaiters whose criteria
+   * name a process are indexed by its identifier, and awaiters whose criteria name a literal class
+   * are indexed by a hash of the class name; the rest are compared against every event. The fields
+   * of the event's window are queried at most once per event, however many candidates compare
+   * them, and not at all if no candidate does.
+   *
+   * Not thread-safe.
+   */
+  class WindowAwaiterIndex {
+    public:
+      WindowAwaiterIndex();
+      ~WindowAwaiterIndex();
+
+      WindowAwaiterIndex(const WindowAwaiterIndex&)            = delete;
+      WindowAwaiterIndex& operator=(const WindowAwaiterIndex&) = delete;
+
+      /**
+       * @brief Adds an awaiter.
+       * @param events The WinEvents the awaiter waits for.
+       * @param matcher The criteria that the window an event is about must match.
+       * @returns The identifier of the awaiter, which is never reused.
+       */
+      uint32_t Add(const uint32_t* events, size_t count, WindowMatcher matcher);
+
+      /**
+       * @brief Removes an awaiter added by `Add`.
+       * @returns Whether the awaiter was in the index.
+       */
+      bool Remove(uint32_t id);
+
+      /**
+       * @returns The number of awaiters in the index.
+       */
+      size_t GetCount() const;
+
+      /**
+       * @brief Finds the awaiters that an event completes. The awaiters stay in the index.
+       * @param window The window the event is about.
+       * @param ids Receives the identifiers of the awaiters, in the order they were added. Cleared
+       * first.
+       */
+      void Match(uint32_t event, LiveWindow& window, std::vector<uint32_t>& ids) const;
+
+      /**
+       * @returns The number of times an awaiter's criteria were compared against a window.
+       */
+      uint64_t GetComparedCount() const;
+
+    private:
+      struct Awaiter {
+        uint32_t id;
+        std::vector<uint32_t> events;
+        WindowMatcher matcher;
+      };
+
+      /**
+       * @brief The awaiters of one event.
+       */
+      struct Bucket {
+        std::unordered_map<uint32_t, std::vector<const Awaiter*>> byProcessId;
+        std::unordered_map<uint64_t, std::vector<const Awaiter*>> byClassName;
+        std::vector<const Awaiter*> unindexed;
+
+        void Insert(const Awaiter* awaiter);
+        void Erase(const Awaiter* awaiter);
+        bool IsEmpty() const;
+      };
+
+      std::unordered_map<uint32_t, std::unique_ptr<Awaiter>> awaiters;
+      std::unordered_map<uint32_t, Bucket> buckets;
+      uint32_t nextId = 1;
+      mutable uint64_t comparedCount = 0;
+  };
+}
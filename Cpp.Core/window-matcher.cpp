@@ -0,0 +1,651 @@
+#include "window-matcher.h"
+#include "process-name-cache.h"
+
+#include <algorithm>
+#include <iterator>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+namespace Cpp::Core::NativeImpls {
+  namespace {
+    /**
+     * @brief Folds a UTF-16 code unit to lower case. Covers the letters of ASCII, Latin-1, Greek
+     * and Cyrillic, whose upper and lower cases are a fixed distance apart.
+     */
+    char16_t Fold(char16_t character) {
+      if (character < 0x80) {
+        return character >= u'A' && character <= u'Z'
+                 ? static_cast<char16_t>(character + 0x20)
+                 : character;
+      }
+
+      if ((character >= 0x00C0 && character <= 0x00DE && character != 0x00D7) ||
+          (character >= 0x0391 && character <= 0x03AB && character != 0x03A2) ||
+          (character >= 0x0410 && character <= 0x042F)) {
+        return static_cast<char16_t>(character + 0x20);
+      }
+
+      if (character >= 0x0400 && character <= 0x040F) {
+        return static_cast<char16_t>(character + 0x50);
+      }
+
+      return character;
+    }
+
+    std::u16string FoldCase(std::u16string_view value) {
+      std::u16string folded(value);
+      for (auto& character : folded) {
+        character = Fold(character);
+      }
+      return folded;
+    }
+
+    bool IsAscii(std::u16string_view value) {
+      return std::all_of(value.begin(), value.end(), [](char16_t c) { return c < 0x80; });
+    }
+
+    /**
+     * @brief Gets the file name of a path, e.g. "explorer.exe" for "C:\Windows\explorer.exe".
+     */
+    std::u16string_view FileName(std::u16string_view path) {
+      auto separator = path.find_last_of(u'\\');
+      return separator == std::u16string_view::npos ? path : path.substr(separator + 1);
+    }
+
+    /**
+     * @brief Compares part of a string against a glob segment, where `?` matches anything.
+     * @param position Where in the string the segment starts. The string must be long enough.
+     */
+    bool SegmentMatches(
+      std::u16string_view value,
+      size_t position,
+      const std::u16string& segment,
+      bool ignoreCase
+    ) {
+      for (size_t i = 0; i < segment.size(); ++i) {
+        auto expected = segment[i];
+        if (expected == u'?') {
+          continue;
+        }
+
+        auto actual = value[position + i];
+        if ((ignoreCase ? Fold(actual) : actual) != expected) {
+          return false;
+        }
+      }
+
+      return true;
+    }
+
+    std::wstring ToWide(std::u16string_view value) {
+      return {value.begin(), value.end()};
+    }
+  }
+
+  uint64_t FoldedHash(std::u16string_view value) {
+    // FNV-1a.
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (auto character : value) {
+      hash = (hash ^ Fold(character)) * 0x100000001B3ull;
+    }
+    return hash;
+  }
+
+  bool StringPattern::Compile(
+    std::u16string_view pattern,
+    MatchMode mode,
+    bool ignoreCase,
+    std::string& error
+  ) {
+    this->ignoreCase = ignoreCase;
+    literal.clear();
+    segments.clear();
+    minLength = 0;
+    regex.reset();
+
+    // A glob without wildcards only matches one string.
+    if (mode == MatchMode::Glob && pattern.find_first_of(u"*?") == std::u16string_view::npos) {
+      mode = MatchMode::Exact;
+    }
+
+    this->mode = mode;
+
+    switch (mode) {
+      case MatchMode::Exact:
+        literal = ignoreCase ? FoldCase(pattern) : std::u16string(pattern);
+        return true;
+
+      case MatchMode::Glob: {
+        size_t start = 0;
+        while (true) {
+          auto star    = pattern.find(u'*', start);
+          auto segment = pattern.substr(start, star - start);
+          segments.push_back(ignoreCase ? FoldCase(segment) : std::u16string(segment));
+          minLength += segment.size();
+          if (star == std::u16string_view::npos) {
+            break;
+          }
+          start = star + 1;
+        }
+
+        // Empty segments between consecutive stars match nothing in particular, but the first
+        // and last anchor the ends of the string, so keep those even if empty.
+        if (segments.size() > 2) {
+          segments.erase(
+            std::remove_if(
+              segments.begin() + 1,
+              segments.end() - 1,
+              [](const std::u16string& segment) { return segment.empty(); }
+            ),
+            segments.end() - 1
+          );
+        }
+        return true;
+      }
+
+      case MatchMode::Regex: {
+        auto flags = std::regex_constants::ECMAScript | std::regex_constants::optimize;
+        if (ignoreCase) {
+          flags |= std::regex_constants::icase;
+        }
+
+        // The standard library reports an invalid expression by throwing, so this is the one
+        // place the matcher catches an exception.
+        try {
+          regex = std::make_shared<const std::wregex>(ToWide(pattern), flags);
+        } catch (const std::regex_error& exception) {
+          error = exception.what();
+          return false;
+        }
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  bool StringPattern::Matches(std::u16string_view value) const {
+    switch (mode) {
+      case MatchMode::Exact:
+        if (value.size() != literal.size()) {
+          return false;
+        }
+        if (!ignoreCase) {
+          return value == literal;
+        }
+        for (size_t i = 0; i < value.size(); ++i) {
+          if (Fold(value[i]) != literal[i]) {
+            return false;
+          }
+        }
+        return true;
+
+      case MatchMode::Glob:
+        return MatchesGlob(value);
+
+      case MatchMode::Regex:
+        try {
+#if defined(_WIN32)
+          auto begin = reinterpret_cast<const wchar_t*>(value.data());
+          return std::regex_search(begin, begin + value.size(), *regex);
+#else
+          return std::regex_search(ToWide(value), *regex);
+#endif
+        } catch (const std::regex_error&) {
+          // The expression was too complex to evaluate against this string.
+          return false;
+        }
+    }
+
+    return false;
+  }
+
+  bool StringPattern::MatchesGlob(std::u16string_view value) const {
+    // Without a star, the pattern must cover the whole string.
+    if (value.size() < minLength || (segments.size() == 1 && value.size() != minLength)) {
+      return false;
+    }
+
+    // The first and last segments are anchored, so they're compared in place before searching
+    // for the ones in between.
+    auto& first = segments.front();
+    auto& last  = segments.back();
+    if (!SegmentMatches(value, 0, first, ignoreCase) ||
+        !SegmentMatches(value, value.size() - last.size(), last, ignoreCase)) {
+      return false;
+    }
+
+    auto position = first.size();
+    auto end      = value.size() - last.size();
+    for (size_t i = 1; i + 1 < segments.size(); ++i) {
+      auto& segment = segments[i];
+
+      // Taking the earliest occurrence of each segment leaves the most room for the rest.
+      auto found = false;
+      while (position + segment.size() <= end) {
+        if (SegmentMatches(value, position, segment, ignoreCase)) {
+          found = true;
+          break;
+        }
+        ++position;
+      }
+
+      if (!found) {
+        return false;
+      }
+      position += segment.size();
+    }
+
+    return true;
+  }
+
+  bool StringPattern::IsLiteral() const {
+    return mode == MatchMode::Exact;
+  }
+
+  bool StringPattern::IgnoresCase() const {
+    return ignoreCase;
+  }
+
+  const std::u16string& StringPattern::GetLiteral() const {
+    return literal;
+  }
+
+#if defined(_WIN32)
+  static_assert(sizeof(wchar_t) == sizeof(char16_t), "Window strings are stored as UTF-16.");
+
+  namespace {
+    class DesktopFieldSource : public IWindowFieldSource {
+      public:
+        bool GetProcessId(uint64_t hwnd, uint32_t& processId) override {
+          DWORD windowProcessId = 0;
+          if (GetWindowThreadProcessId(reinterpret_cast<HWND>(hwnd), &windowProcessId) == 0) {
+            return false;
+          }
+
+          processId = windowProcessId;
+          return true;
+        }
+
+        bool GetClassName(uint64_t hwnd, std::u16string& className) override {
+          // Class names are at most 256 characters long, and every window has one.
+          WCHAR buffer[257];
+          auto window = reinterpret_cast<HWND>(hwnd);
+          auto length = GetClassNameW(window, buffer, static_cast<int>(std::size(buffer)));
+          if (length <= 0) {
+            return false;
+          }
+
+          className.assign(reinterpret_cast<const char16_t*>(buffer), static_cast<size_t>(length));
+          return true;
+        }
+
+        bool GetTitle(uint64_t hwnd, std::u16string& title) override {
+          // Titles are capped at the same length as in snapshots. An empty title can't be told
+          // apart from a window that no longer exists, so it's taken at face value.
+          WCHAR buffer[1024];
+          auto window = reinterpret_cast<HWND>(hwnd);
+          auto length = std::max(
+            GetWindowTextW(window, buffer, static_cast<int>(std::size(buffer))),
+            0
+          );
+
+          title.assign(reinterpret_cast<const char16_t*>(buffer), static_cast<size_t>(length));
+          return true;
+        }
+
+        bool GetProcessName(uint32_t processId, std::u16string& processName) override {
+          auto path = GetProcessImageName(processId);
+          if (path.empty()) {
+            return false;
+          }
+
+          processName.assign(reinterpret_cast<const char16_t*>(path.data()), path.size());
+          return true;
+        }
+    };
+  }
+#else
+  namespace {
+    class DesktopFieldSource : public IWindowFieldSource {
+      public:
+        bool GetProcessId(uint64_t, uint32_t&) override {
+          return false;
+        }
+
+        bool GetClassName(uint64_t, std::u16string&) override {
+          return false;
+        }
+
+        bool GetTitle(uint64_t, std::u16string&) override {
+          return false;
+        }
+
+        bool GetProcessName(uint32_t, std::u16string&) override {
+          return false;
+        }
+    };
+  }
+#endif
+
+  IWindowFieldSource& GetDesktopFieldSource() {
+    static DesktopFieldSource source;
+    return source;
+  }
+
+  LiveWindow::LiveWindow(uint64_t hwnd, IWindowFieldSource& source) : hwnd(hwnd), source(source) {}
+
+  uint64_t LiveWindow::GetHwnd() const {
+    return hwnd;
+  }
+
+  bool LiveWindow::GetProcessId(uint32_t& processId) {
+    if (processIdState == Unknown) {
+      ++queryCount;
+      processIdState = source.GetProcessId(hwnd, this->processId) ? Known : Missing;
+    }
+
+    processId = this->processId;
+    return processIdState == Known;
+  }
+
+  bool LiveWindow::GetClassName(std::u16string_view& className) {
+    if (classNameState == Unknown) {
+      ++queryCount;
+      classNameState = source.GetClassName(hwnd, this->className) ? Known : Missing;
+    }
+
+    className = this->className;
+    return classNameState == Known;
+  }
+
+  bool LiveWindow::GetProcessName(std::u16string_view& processName) {
+    if (processNameState == Unknown) {
+      uint32_t windowProcessId = 0;
+      auto found = GetProcessId(windowProcessId);
+      if (found) {
+        ++queryCount;
+        found = source.GetProcessName(windowProcessId, this->processName);
+      }
+      processNameState = found ? Known : Missing;
+    }
+
+    processName = this->processName;
+    return processNameState == Known;
+  }
+
+  bool LiveWindow::GetTitle(std::u16string_view& title) {
+    if (titleState == Unknown) {
+      ++queryCount;
+      titleState = source.GetTitle(hwnd, this->title) ? Known : Missing;
+    }
+
+    title = this->title;
+    return titleState == Known;
+  }
+
+  size_t LiveWindow::GetQueryCount() const {
+    return queryCount;
+  }
+
+  bool WindowMatcher::SetTitle(std::u16string_view pattern, MatchMode mode, bool ignoreCase) {
+    StringPattern compiled;
+    if (!compiled.Compile(pattern, mode, ignoreCase, error)) {
+      return false;
+    }
+
+    title = std::move(compiled);
+    return true;
+  }
+
+  bool WindowMatcher::SetClassName(std::u16string_view pattern, MatchMode mode, bool ignoreCase) {
+    StringPattern compiled;
+    if (!compiled.Compile(pattern, mode, ignoreCase, error)) {
+      return false;
+    }
+
+    className = std::move(compiled);
+    return true;
+  }
+
+  bool WindowMatcher::SetProcessName(
+    std::u16string_view pattern,
+    MatchMode mode,
+    bool ignoreCase
+  ) {
+    StringPattern compiled;
+    if (!compiled.Compile(pattern, mode, ignoreCase, error)) {
+      return false;
+    }
+
+    processName = std::move(compiled);
+    return true;
+  }
+
+  void WindowMatcher::SetProcessId(uint32_t processId) {
+    this->processId = processId;
+  }
+
+  const std::string& WindowMatcher::GetError() const {
+    return error;
+  }
+
+  uint32_t WindowMatcher::GetFields() const {
+    uint32_t fields = 0;
+    if (title) {
+      fields |= WindowSnapshotTitle;
+    }
+    if (className) {
+      fields |= WindowSnapshotClassName;
+    }
+    if (processName) {
+      fields |= WindowSnapshotProcessName;
+    }
+    return fields;
+  }
+
+  bool WindowMatcher::Matches(const WindowView& window) const {
+    return (!processId || *processId == window.processId) &&
+           (!className || className->Matches(window.className)) &&
+           (!processName || processName->Matches(FileName(window.processName))) &&
+           (!title || title->Matches(window.title));
+  }
+
+  bool WindowMatcher::Matches(LiveWindow& window) const {
+    if (processId) {
+      uint32_t windowProcessId = 0;
+      if (!window.GetProcessId(windowProcessId) || windowProcessId != *processId) {
+        return false;
+      }
+    }
+
+    std::u16string_view value;
+    if (className && (!window.GetClassName(value) || !className->Matches(value))) {
+      return false;
+    }
+    if (processName && (!window.GetProcessName(value) || !processName->Matches(FileName(value)))) {
+      return false;
+    }
+    if (title && (!window.GetTitle(value) || !title->Matches(value))) {
+      return false;
+    }
+
+    return true;
+  }
+
+  bool WindowMatcher::MatchesWindow(uint64_t hwnd) const {
+    LiveWindow window(hwnd, GetDesktopFieldSource());
+    return Matches(window);
+  }
+
+  std::vector<uint32_t> WindowMatcher::Filter(const WindowSnapshotReader& snapshot) const {
+    std::vector<uint32_t> matches;
+
+    auto count = snapshot.GetCount();
+    for (size_t i = 0; i < count; ++i) {
+      auto record = snapshot.GetRecord(i);
+
+      WindowView window;
+      window.hwnd        = record.hwnd;
+      window.processId   = record.processId;
+      window.title       = snapshot.GetString(record.title);
+      window.className   = snapshot.GetString(record.className);
+      window.processName = snapshot.GetString(record.processName);
+
+      if (Matches(window)) {
+        matches.push_back(static_cast<uint32_t>(i));
+      }
+    }
+
+    return matches;
+  }
+
+  WindowQuery WindowMatcher::ToWindowQuery() const {
+    // The registry folds the case of class and process names as ASCII only, so a literal that
+    // ignores case can only narrow the query if folding it further made no difference.
+    auto canNarrow = [](const std::optional<StringPattern>& pattern) {
+      return pattern && pattern->IsLiteral() &&
+             (!pattern->IgnoresCase() || IsAscii(pattern->GetLiteral()));
+    };
+
+    WindowQuery query;
+    query.processId = processId;
+
+    if (canNarrow(className)) {
+      query.className = className->GetLiteral();
+    }
+
+    if (canNarrow(processName)) {
+      query.processName = processName->GetLiteral();
+    }
+
+    // Titles are indexed with their case intact.
+    if (title && title->IsLiteral() && !title->IgnoresCase()) {
+      query.title = title->GetLiteral();
+    }
+
+    return query;
+  }
+
+  std::vector<WindowRecord> FindWindows(
+    const WindowRegistry& registry,
+    const WindowMatcher& matcher,
+    bool topLevelOnly
+  ) {
+    auto query = matcher.ToWindowQuery();
+    query.topLevelOnly = topLevelOnly;
+
+    auto windows = registry.Find(query);
+    windows.erase(
+      std::remove_if(
+        windows.begin(),
+        windows.end(),
+        [&](const WindowRecord& record) {
+          WindowView window;
+          window.hwnd        = record.hwnd;
+          window.processId   = record.processId;
+          window.title       = record.title;
+          window.className   = record.className;
+          window.processName = record.processName;
+          return !matcher.Matches(window);
+        }
+      ),
+      windows.end()
+    );
+    return windows;
+  }
+
+  uint32_t WindowMatcherSet::Add(WindowMatcher matcher) {
+    auto id = nextId++;
+    entries.push_back({id, std::move(matcher)});
+    Rebuild();
+    return id;
+  }
+
+  bool WindowMatcherSet::Remove(uint32_t id) {
+    // Identifiers are handed out in ascending order and entries are kept in that order.
+    auto found = std::lower_bound(
+      entries.begin(),
+      entries.end(),
+      id,
+      [](const Entry& entry, uint32_t id) { return entry.id < id; }
+    );
+    if (found == entries.end() || found->id != id) {
+      return false;
+    }
+
+    entries.erase(found);
+    Rebuild();
+    return true;
+  }
+
+  size_t WindowMatcherSet::GetCount() const {
+    return entries.size();
+  }
+
+  uint32_t WindowMatcherSet::GetFields() const {
+    return fields;
+  }
+
+  void WindowMatcherSet::Rebuild() {
+    byClassName.clear();
+    byProcessName.clear();
+    byTitle.clear();
+    unindexed.clear();
+    fields = 0;
+
+    for (uint32_t i = 0; i < entries.size(); ++i) {
+      auto& matcher = entries[i].matcher;
+      fields |= matcher.GetFields();
+
+      // Class names are the most selective literal that's cheap to get, then process names.
+      if (matcher.className && matcher.className->IsLiteral()) {
+        byClassName[FoldedHash(matcher.className->GetLiteral())].push_back(i);
+      } else if (matcher.processName && matcher.processName->IsLiteral()) {
+        byProcessName[FoldedHash(matcher.processName->GetLiteral())].push_back(i);
+      } else if (matcher.title && matcher.title->IsLiteral()) {
+        byTitle[FoldedHash(matcher.title->GetLiteral())].push_back(i);
+      } else {
+        unindexed.push_back(i);
+      }
+    }
+  }
+
+  void WindowMatcherSet::Match(const WindowView& window, std::vector<uint32_t>& ids) const {
+    ids.clear();
+
+    auto test = [&](uint32_t position) {
+      auto& entry = entries[position];
+      if (entry.matcher.Matches(window)) {
+        ids.push_back(entry.id);
+      }
+    };
+
+    // Hashes only select candidates; every candidate is still compared in full.
+    auto lookup = [&](const Index& index, std::u16string_view value) {
+      if (index.empty()) {
+        return;
+      }
+
+      auto found = index.find(FoldedHash(value));
+      if (found != index.end()) {
+        for (auto position : found->second) {
+          test(position);
+        }
+      }
+    };
+
+    lookup(byClassName, window.className);
+    lookup(byProcessName, FileName(window.processName));
+    lookup(byTitle, window.title);
+    for (auto position : unindexed) {
+      test(position);
+    }
+
+    // Each matcher is in exactly one index, so there are no duplicates to remove.
+    std::sort(ids.begin(), ids.end());
+  }
+}
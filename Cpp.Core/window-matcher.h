@@ -0,0 +1,378 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "window-registry.h"
+#include "window-snapshot.h"
+
+namespace Cpp::Core::NativeImpls {
+  /**
+   * @brief How a `StringPattern` compares strings.
+   */
+  enum class MatchMode : uint8_t {
+    /** The whole string must equal the pattern. */
+    Exact,
+
+    /**
+     * The whole string must match the pattern, where `*` matches any run of characters and `?`
+     * matches any single character.
+     */
+    Glob,
+
+    /** The pattern is an ECMAScript regular expression that must match part of the string. */
+    Regex
+  };
+
+  /**
+   * @brief A string pattern that's parsed once and then compared against many strings without
+   * allocating.
+   *
+   * Exact patterns compare lengths before characters. Glob patterns are split into the literal
+   * segments between stars; the first and last segments are anchored to the ends of the string and
+   * a string that's too short for every segment is rejected without comparing anything. A glob
+   * without wildcards is compared as an exact pattern.
+   *
+   * Ignoring case folds ASCII, Latin-1, Greek and Cyrillic letters, which covers practically every
+   * title and class name without depending on the locale.
+   */
+  class StringPattern {
+    public:
+      /**
+       * @brief Parses a pattern.
+       * @param error Receives a description of the problem if the pattern is invalid.
+       * @returns `false` if the pattern is invalid, which only regular expressions can be.
+       */
+      bool Compile(
+        std::u16string_view pattern,
+        MatchMode mode,
+        bool ignoreCase,
+        std::string& error
+      );
+
+      /**
+       * @returns Whether a string matches the pattern.
+       */
+      bool Matches(std::u16string_view value) const;
+
+      /**
+       * @returns Whether the pattern only matches a single string, ignoring case or not.
+       */
+      bool IsLiteral() const;
+
+      /**
+       * @returns Whether the pattern ignores case.
+       */
+      bool IgnoresCase() const;
+
+      /**
+       * @returns The string a literal pattern matches, with its case folded if the pattern ignores
+       * case.
+       */
+      const std::u16string& GetLiteral() const;
+
+    private:
+      bool MatchesGlob(std::u16string_view value) const;
+
+      MatchMode mode = MatchMode::Exact;
+      bool ignoreCase = false;
+
+      /** The literal of an exact pattern, folded if case is ignored. */
+      std::u16string literal;
+
+      /**
+       * The segments of a glob pattern between stars, folded if case is ignored. The first segment
+       * is anchored to the start of the string and the last to the end; either may be empty.
+       */
+      std::vector<std::u16string> segments;
+
+      /** The total length of the segments, which is the shortest string the glob can match. */
+      size_t minLength = 0;
+
+      std::shared_ptr<const std::wregex> regex;
+  };
+
+  /**
+   * @brief The fields of a window that a `WindowMatcher` compares.
+   */
+  struct WindowView {
+    uint64_t hwnd = 0;
+    uint32_t processId = 0;
+    std::u16string_view title;
+    std::u16string_view className;
+
+    /** The full image path of the window's process. */
+    std::u16string_view processName;
+  };
+
+  /**
+   * @brief Queries the fields of live windows. Kept abstract so that matchers can be driven by a
+   * simulated desktop.
+   */
+  class IWindowFieldSource {
+    public:
+      virtual ~IWindowFieldSource() = default;
+
+      /**
+       * @brief Gets the process that owns a window.
+       * @returns `false` if the window no longer exists.
+       */
+      virtual bool GetProcessId(uint64_t hwnd, uint32_t& processId) = 0;
+
+      /**
+       * @brief Gets the class name of a window.
+       * @returns `false` if the window no longer exists.
+       */
+      virtual bool GetClassName(uint64_t hwnd, std::u16string& className) = 0;
+
+      /**
+       * @brief Gets the title of a window.
+       * @returns `false` if the window no longer exists.
+       */
+      virtual bool GetTitle(uint64_t hwnd, std::u16string& title) = 0;
+
+      /**
+       * @brief Gets the full image path of a process.
+       * @returns `false` if the process can't be queried.
+       */
+      virtual bool GetProcessName(uint32_t processId, std::u16string& processName) = 0;
+  };
+
+  /**
+   * @returns The source that queries the windows on the desktop. Where there are no windows to
+   * query, every query fails. The returned source lives for the lifetime of the process.
+   */
+  IWindowFieldSource& GetDesktopFieldSource();
+
+  /**
+   * @brief A live window whose fields are queried the first time they're needed and then shared by
+   * every matcher that compares them.
+   */
+  class LiveWindow {
+    public:
+      LiveWindow(uint64_t hwnd, IWindowFieldSource& source);
+
+      uint64_t GetHwnd() const;
+
+      /**
+       * @returns `false` if the window no longer exists.
+       */
+      bool GetProcessId(uint32_t& processId);
+
+      /**
+       * @returns `false` if the window no longer exists.
+       */
+      bool GetClassName(std::u16string_view& className);
+
+      /**
+       * @brief Gets the full image path of the window's process.
+       * @returns `false` if the window no longer exists or its process can't be queried.
+       */
+      bool GetProcessName(std::u16string_view& processName);
+
+      /**
+       * @returns `false` if the window no longer exists.
+       */
+      bool GetTitle(std::u16string_view& title);
+
+      /**
+       * @returns The number of times the source was queried.
+       */
+      size_t GetQueryCount() const;
+
+    private:
+      enum FieldState : uint8_t {
+        Unknown,
+        Known,
+        Missing
+      };
+
+      uint64_t hwnd;
+      IWindowFieldSource& source;
+      size_t queryCount = 0;
+
+      FieldState processIdState = Unknown;
+      FieldState classNameState = Unknown;
+      FieldState processNameState = Unknown;
+      FieldState titleState = Unknown;
+
+      uint32_t processId = 0;
+      std::u16string className;
+      std::u16string processName;
+      std::u16string title;
+  };
+
+  /**
+   * @brief Hashes a string with its case folded the way patterns that ignore case fold it, so
+   * strings that only differ in case collide.
+   */
+  uint64_t FoldedHash(std::u16string_view value);
+
+  /**
+   * @brief Criteria for finding a window, compiled once so that they can be evaluated against
+   * thousands of windows. Every criterion that's set must match. The cheapest criteria are
+   * compared first: the process, then the class, the process name and finally the title.
+   */
+  class WindowMatcher {
+    public:
+      /**
+       * @brief Matches the window's title against a pattern.
+       * @returns `false` if the pattern is invalid. See `GetError`.
+       */
+      bool SetTitle(std::u16string_view pattern, MatchMode mode, bool ignoreCase);
+
+      /**
+       * @brief Matches the window's class name against a pattern.
+       * @returns `false` if the pattern is invalid. See `GetError`.
+       */
+      bool SetClassName(std::u16string_view pattern, MatchMode mode, bool ignoreCase);
+
+      /**
+       * @brief Matches the file name of the window's process image, e.g. "explorer.exe", against a
+       * pattern.
+       * @returns `false` if the pattern is invalid. See `GetError`.
+       */
+      bool SetProcessName(std::u16string_view pattern, MatchMode mode, bool ignoreCase);
+
+      /**
+       * @brief Only matches windows of a process.
+       */
+      void SetProcessId(uint32_t processId);
+
+      /**
+       * @returns A description of why the last pattern was invalid.
+       */
+      const std::string& GetError() const;
+
+      /**
+       * @returns The `WindowSnapshotFields` that the criteria compare.
+       */
+      uint32_t GetFields() const;
+
+      /**
+       * @returns Whether a window matches every criterion.
+       */
+      bool Matches(const WindowView& window) const;
+
+      /**
+       * @brief Checks a live window, stopping at the first criterion that doesn't match so that
+       * the window is only queried for the fields it needs to be.
+       * @returns Whether the window matches every criterion.
+       */
+      bool Matches(LiveWindow& window) const;
+
+      /**
+       * @brief Checks a window on the desktop. See `Matches(LiveWindow&)`.
+       * @returns Whether the window matches every criterion. Always `false` where there are no
+       * windows to query.
+       */
+      bool MatchesWindow(uint64_t hwnd) const;
+
+      /**
+       * @brief Finds the windows of a snapshot that match. Every field the criteria compare must
+       * have been gathered; see `GetFields`.
+       * @returns The indexes of the matching windows, in ascending order.
+       */
+      std::vector<uint32_t> Filter(const WindowSnapshotReader& snapshot) const;
+
+      /**
+       * @returns The narrowest registry query whose results include every window that matches.
+       * Only literal patterns narrow the query.
+       */
+      WindowQuery ToWindowQuery() const;
+
+    private:
+      friend class WindowAwaiterIndex;
+      friend class WindowMatcherSet;
+
+      std::optional<StringPattern> title;
+      std::optional<StringPattern> className;
+      std::optional<StringPattern> processName;
+      std::optional<uint32_t> processId;
+      std::string error;
+  };
+
+  /**
+   * @brief Finds the windows in a registry that match, narrowing the lookup with the matcher's
+   * literal patterns before comparing the rest.
+   * @param topLevelOnly Whether to only find top-level windows.
+   * @returns The matching windows, top-level windows first.
+   */
+  std::vector<WindowRecord> FindWindows(
+    const WindowRegistry& registry,
+    const WindowMatcher& matcher,
+    bool topLevelOnly
+  );
+
+  /**
+   * @brief Many `WindowMatcher`s evaluated against each window at once, e.g. one per pending
+   * wait for a window.
+   *
+   * Matchers with a literal class name, process name or title are indexed by a hash of that
+   * string with its case folded, so a window is only compared against the matchers that could
+   * match it plus the ones that can't be indexed. Not thread-safe.
+   */
+  class WindowMatcherSet {
+    public:
+      /**
+       * @brief Adds a matcher.
+       * @returns The identifier of the matcher, which is never reused.
+       */
+      uint32_t Add(WindowMatcher matcher);
+
+      /**
+       * @brief Removes a matcher added by `Add`.
+       * @returns Whether the matcher was in the set.
+       */
+      bool Remove(uint32_t id);
+
+      /**
+       * @returns The number of matchers in the set.
+       */
+      size_t GetCount() const;
+
+      /**
+       * @returns The `WindowSnapshotFields` that any of the matchers compare.
+       */
+      uint32_t GetFields() const;
+
+      /**
+       * @brief Finds the matchers that a window matches.
+       * @param ids Receives the identifiers of the matchers, in ascending order. Cleared first.
+       */
+      void Match(const WindowView& window, std::vector<uint32_t>& ids) const;
+
+    private:
+      struct Entry {
+        uint32_t id;
+        WindowMatcher matcher;
+      };
+
+      using Index = std::unordered_map<uint64_t, std::vector<uint32_t>>;
+
+      void Rebuild();
+
+      std::vector<Entry> entries;
+      uint32_t nextId = 1;
+      uint32_t fields = 0;
+
+      /** Positions in `entries` by the folded hash of a literal class name. */
+      Index byClassName;
+
+      /** Positions in `entries` by the folded hash of a literal process file name. */
+      Index byProcessName;
+
+      /** Positions in `entries` by the folded hash of a literal title. */
+      Index byTitle;
+
+      /** Positions in `entries` of the matchers without a literal to index. */
+      std::vector<uint32_t> unindexed;
+  };
+}
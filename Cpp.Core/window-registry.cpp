@@ -0,0 +1,552 @@
+#include "window-registry.h"
+#include "process-name-cache.h"
+#include "win-event-dispatcher.h"
+
+#include <algorithm>
+#include <iterator>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+namespace Cpp::Core::NativeImpls {
+  namespace {
+    constexpr uint32_t eventObjectCreate       = 0x8000;
+    constexpr uint32_t eventObjectDestroy      = 0x8001;
+    constexpr uint32_t eventObjectNameChange   = 0x800C;
+    constexpr uint32_t eventObjectParentChange = 0x800F;
+
+    // Parent links deeper than this are treated as a cycle, which a stale parent can cause.
+    constexpr uint32_t maxDepth = 256;
+
+    /**
+     * @brief Folds the ASCII letters of a string to lower case. Class names and image paths are
+     * practically always ASCII, and folding the rest would depend on the locale.
+     */
+    std::u16string FoldCase(std::u16string_view value) {
+      std::u16string folded(value);
+      for (auto& character : folded) {
+        if (character >= u'A' && character <= u'Z') {
+          character = static_cast<char16_t>(character - u'A' + u'a');
+        }
+      }
+      return folded;
+    }
+
+    /**
+     * @brief Gets the file name of a path, e.g. "explorer.exe" for "C:\Windows\explorer.exe".
+     */
+    std::u16string_view FileName(std::u16string_view path) {
+      auto separator = path.find_last_of(u'\\');
+      return separator == std::u16string_view::npos ? path : path.substr(separator + 1);
+    }
+
+    template <typename Key>
+    using Index = std::unordered_map<Key, std::unordered_set<uint64_t>>;
+
+    template <typename Key>
+    void AddTo(Index<Key>& index, const Key& key, uint64_t hwnd) {
+      index[key].insert(hwnd);
+    }
+
+    template <typename Key>
+    void RemoveFrom(Index<Key>& index, const Key& key, uint64_t hwnd) {
+      auto found = index.find(key);
+      if (found != index.end() && found->second.erase(hwnd) > 0 && found->second.empty()) {
+        index.erase(found);
+      }
+    }
+
+    template <typename Key>
+    const std::unordered_set<uint64_t>* Lookup(const Index<Key>& index, const Key& key) {
+      static const std::unordered_set<uint64_t> none;
+      auto found = index.find(key);
+      return found != index.end() ? &found->second : &none;
+    }
+  }
+
+  struct WindowRegistry::Impl {
+    struct Entry {
+      WindowRecord record;
+
+      // The order the window became known in, which lookups sort by.
+      uint64_t sequence;
+
+      // The keys of the case-insensitive indexes.
+      std::u16string processKey;
+      std::u16string classKey;
+    };
+
+    mutable std::shared_mutex lock;
+
+    std::unordered_map<uint64_t, Entry> windows;
+    uint64_t nextSequence = 0;
+
+    Index<uint32_t> byProcessId;
+    Index<std::u16string> byProcessName;
+    Index<std::u16string> byClassName;
+    Index<std::u16string> byTitle;
+    Index<uint64_t> byParent;
+
+    void AddToIndexes(const Entry& entry) {
+      auto hwnd = entry.record.hwnd;
+      AddTo(byProcessId, entry.record.processId, hwnd);
+      AddTo(byProcessName, entry.processKey, hwnd);
+      AddTo(byClassName, entry.classKey, hwnd);
+      AddTo(byTitle, entry.record.title, hwnd);
+      AddTo(byParent, entry.record.parent, hwnd);
+    }
+
+    void RemoveFromIndexes(const Entry& entry) {
+      auto hwnd = entry.record.hwnd;
+      RemoveFrom(byProcessId, entry.record.processId, hwnd);
+      RemoveFrom(byProcessName, entry.processKey, hwnd);
+      RemoveFrom(byClassName, entry.classKey, hwnd);
+      RemoveFrom(byTitle, entry.record.title, hwnd);
+      RemoveFrom(byParent, entry.record.parent, hwnd);
+    }
+
+    void Upsert(const WindowRecord& record) {
+      auto [found, isNew] = windows.try_emplace(record.hwnd);
+      auto& entry = found->second;
+
+      if (isNew) {
+        entry.sequence = nextSequence++;
+      } else {
+        RemoveFromIndexes(entry);
+      }
+
+      entry.record       = record;
+      entry.record.depth = 0;
+      entry.processKey   = FoldCase(FileName(record.processName));
+      entry.classKey     = FoldCase(record.className);
+      AddToIndexes(entry);
+    }
+
+    bool Remove(uint64_t hwnd) {
+      if (windows.count(hwnd) == 0) {
+        return false;
+      }
+
+      // Destroying a window destroys its descendants, whose own events may never be seen.
+      std::vector<uint64_t> pending{hwnd};
+      while (!pending.empty()) {
+        auto current = pending.back();
+        pending.pop_back();
+
+        auto children = byParent.find(current);
+        if (children != byParent.end()) {
+          pending.insert(pending.end(), children->second.begin(), children->second.end());
+        }
+
+        auto found = windows.find(current);
+        if (found != windows.end()) {
+          RemoveFromIndexes(found->second);
+          windows.erase(found);
+        }
+      }
+
+      return true;
+    }
+
+    uint32_t DepthOf(const Entry& entry) const {
+      uint32_t depth = 0;
+      auto parent    = entry.record.parent;
+      while (parent != 0 && depth < maxDepth) {
+        auto found = windows.find(parent);
+        if (found == windows.end()) {
+          break;
+        }
+
+        parent = found->second.record.parent;
+        ++depth;
+      }
+
+      // A window whose parent isn't known is still a child, just of an unknown window.
+      return entry.record.parent != 0 ? std::max<uint32_t>(depth, 1) : 0;
+    }
+
+    bool IsDescendantOf(const Entry& entry, uint64_t ancestor) const {
+      auto parent = entry.record.parent;
+      for (uint32_t depth = 0; parent != 0 && depth < maxDepth; ++depth) {
+        if (parent == ancestor) {
+          return true;
+        }
+
+        auto found = windows.find(parent);
+        if (found == windows.end()) {
+          return false;
+        }
+        parent = found->second.record.parent;
+      }
+
+      return false;
+    }
+
+    // The folded keys of a query's case-insensitive criteria.
+    struct QueryKeys {
+      std::u16string processKey;
+      std::u16string classKey;
+    };
+
+    bool Matches(const Entry& entry, const WindowQuery& query, const QueryKeys& keys) const;
+  };
+
+  bool WindowRegistry::Impl::Matches(
+    const Entry& entry,
+    const WindowQuery& query,
+    const QueryKeys& keys
+  ) const {
+    const auto& record = entry.record;
+    return (!query.hwnd || record.hwnd == *query.hwnd) &&
+           (!query.processId || record.processId == *query.processId) &&
+           (!query.processName || entry.processKey == keys.processKey) &&
+           (!query.className || entry.classKey == keys.classKey) &&
+           (!query.title || record.title == *query.title) &&
+           (!query.topLevelOnly || record.parent == 0) &&
+           (!query.ancestor || IsDescendantOf(entry, *query.ancestor));
+  }
+
+  WindowRegistry::WindowRegistry() : impl(std::make_unique<Impl>()) {}
+
+  WindowRegistry::~WindowRegistry() = default;
+
+  void WindowRegistry::Load(const WindowSnapshotReader& snapshot) {
+    std::unique_lock guard(impl->lock);
+
+    impl->windows.clear();
+    impl->byProcessId.clear();
+    impl->byProcessName.clear();
+    impl->byClassName.clear();
+    impl->byTitle.clear();
+    impl->byParent.clear();
+
+    for (size_t i = 0; i < snapshot.GetCount(); ++i) {
+      auto window = snapshot.GetRecord(i);
+
+      WindowRecord record;
+      record.hwnd        = window.hwnd;
+      record.parent      = window.parent;
+      record.processId   = window.processId;
+      record.title       = snapshot.GetString(window.title);
+      record.className   = snapshot.GetString(window.className);
+      record.processName = snapshot.GetString(window.processName);
+      impl->Upsert(record);
+    }
+  }
+
+  void WindowRegistry::Upsert(const WindowRecord& record) {
+    std::unique_lock guard(impl->lock);
+    impl->Upsert(record);
+  }
+
+  bool WindowRegistry::Remove(uint64_t hwnd) {
+    std::unique_lock guard(impl->lock);
+    return impl->Remove(hwnd);
+  }
+
+  bool WindowRegistry::SetTitle(uint64_t hwnd, std::u16string_view title) {
+    std::unique_lock guard(impl->lock);
+
+    auto found = impl->windows.find(hwnd);
+    if (found == impl->windows.end()) {
+      return false;
+    }
+
+    auto& entry = found->second;
+    RemoveFrom(impl->byTitle, entry.record.title, hwnd);
+    entry.record.title = title;
+    AddTo(impl->byTitle, entry.record.title, hwnd);
+    return true;
+  }
+
+  bool WindowRegistry::SetParent(uint64_t hwnd, uint64_t parent) {
+    std::unique_lock guard(impl->lock);
+
+    auto found = impl->windows.find(hwnd);
+    if (found == impl->windows.end()) {
+      return false;
+    }
+
+    auto& entry = found->second;
+    RemoveFrom(impl->byParent, entry.record.parent, hwnd);
+    entry.record.parent = parent;
+    AddTo(impl->byParent, entry.record.parent, hwnd);
+    return true;
+  }
+
+  void WindowRegistry::ApplyEvent(uint32_t event, uint64_t hwnd, IWindowSource& source) {
+    // Windows that were never seen, e.g. because their creation was missed, are described in full.
+    auto describe = [&] {
+      WindowRecord record;
+      if (source.Describe(hwnd, record)) {
+        Upsert(record);
+      } else {
+        Remove(hwnd);
+      }
+    };
+
+    switch (event) {
+      case eventObjectCreate: {
+        describe();
+        break;
+      }
+      case eventObjectDestroy: {
+        Remove(hwnd);
+        break;
+      }
+      case eventObjectNameChange: {
+        std::u16string title;
+        if (!source.GetTitle(hwnd, title)) {
+          Remove(hwnd);
+        } else if (!SetTitle(hwnd, title)) {
+          describe();
+        }
+        break;
+      }
+      case eventObjectParentChange: {
+        uint64_t parent = 0;
+        if (!source.GetParent(hwnd, parent)) {
+          Remove(hwnd);
+        } else if (!SetParent(hwnd, parent)) {
+          describe();
+        }
+        break;
+      }
+      default: {
+        break;
+      }
+    }
+  }
+
+  std::vector<WindowRecord> WindowRegistry::Find(const WindowQuery& query) const {
+    std::shared_lock guard(impl->lock);
+
+    Impl::QueryKeys keys;
+    if (query.processName) {
+      keys.processKey = FoldCase(*query.processName);
+    }
+    if (query.className) {
+      keys.classKey = FoldCase(*query.className);
+    }
+
+    // Scan the smallest set of candidates that the query narrows the windows down to.
+    const std::unordered_set<uint64_t>* candidates = nullptr;
+    auto narrow = [&](const std::unordered_set<uint64_t>* set) {
+      if (candidates == nullptr || set->size() < candidates->size()) {
+        candidates = set;
+      }
+    };
+
+    std::unordered_set<uint64_t> single;
+    if (query.hwnd) {
+      if (impl->windows.count(*query.hwnd) > 0) {
+        single.insert(*query.hwnd);
+      }
+      narrow(&single);
+    }
+    if (query.processId) {
+      narrow(Lookup(impl->byProcessId, *query.processId));
+    }
+    if (query.processName) {
+      narrow(Lookup(impl->byProcessName, keys.processKey));
+    }
+    if (query.className) {
+      narrow(Lookup(impl->byClassName, keys.classKey));
+    }
+    if (query.title) {
+      narrow(Lookup(impl->byTitle, *query.title));
+    }
+    if (query.topLevelOnly) {
+      narrow(Lookup(impl->byParent, uint64_t{0}));
+    }
+
+    std::vector<const Impl::Entry*> matches;
+    auto consider = [&](const Impl::Entry& entry) {
+      if (impl->Matches(entry, query, keys)) {
+        matches.push_back(&entry);
+      }
+    };
+
+    if (candidates != nullptr) {
+      for (auto hwnd : *candidates) {
+        consider(impl->windows.at(hwnd));
+      }
+    } else {
+      for (const auto& [hwnd, entry] : impl->windows) {
+        consider(entry);
+      }
+    }
+
+    // Top-level windows first, then in the order they became known.
+    std::sort(matches.begin(), matches.end(), [](const auto* left, const auto* right) {
+      auto leftIsChild  = left->record.parent != 0;
+      auto rightIsChild = right->record.parent != 0;
+      return leftIsChild != rightIsChild ? rightIsChild : left->sequence < right->sequence;
+    });
+
+    std::vector<WindowRecord> result;
+    result.reserve(matches.size());
+    for (const auto* entry : matches) {
+      result.push_back(entry->record);
+      result.back().depth = impl->DepthOf(*entry);
+    }
+
+    return result;
+  }
+
+  size_t WindowRegistry::GetCount() const {
+    std::shared_lock guard(impl->lock);
+    return impl->windows.size();
+  }
+
+  std::vector<uint8_t> ToWindowSnapshot(const std::vector<WindowRecord>& windows) {
+    WindowSnapshotBuilder builder(WindowSnapshotAll);
+    for (const auto& window : windows) {
+      builder.Add(
+        window.hwnd,
+        window.parent,
+        window.processId,
+        window.depth,
+        window.title,
+        window.className,
+        window.processName
+      );
+    }
+
+    return builder.Finish();
+  }
+
+#if defined(_WIN32)
+  namespace {
+    static_assert(sizeof(wchar_t) == sizeof(char16_t), "Window strings are stored as UTF-16.");
+
+    /**
+     * @brief Describes the live windows on the desktop.
+     */
+    class Win32WindowSource final : public IWindowSource {
+      public:
+        bool Describe(uint64_t hwnd, WindowRecord& record) override {
+          auto window = reinterpret_cast<HWND>(hwnd);
+          if (!IsWindow(window)) {
+            return false;
+          }
+
+          DWORD processId = 0;
+          GetWindowThreadProcessId(window, &processId);
+
+          auto length = GetClassNameW(window, buffer, static_cast<int>(std::size(buffer)));
+          record.className.assign(reinterpret_cast<const char16_t*>(buffer), std::max(length, 0));
+
+          auto processName = GetProcessImageName(processId);
+          record.processName.assign(
+            reinterpret_cast<const char16_t*>(processName.data()),
+            processName.size()
+          );
+
+          record.hwnd      = hwnd;
+          record.processId = processId;
+          return GetTitle(hwnd, record.title) && GetParent(hwnd, record.parent);
+        }
+
+        bool GetTitle(uint64_t hwnd, std::u16string& title) override {
+          auto window = reinterpret_cast<HWND>(hwnd);
+          auto length = GetWindowTextW(window, buffer, static_cast<int>(std::size(buffer)));
+          title.assign(reinterpret_cast<const char16_t*>(buffer), std::max(length, 0));
+          return IsWindow(window) != FALSE;
+        }
+
+        bool GetParent(uint64_t hwnd, uint64_t& parent) override {
+          auto window = reinterpret_cast<HWND>(hwnd);
+          auto found  = GetAncestor(window, GA_PARENT);
+
+          // Top-level windows are children of the desktop window.
+          parent = found == nullptr || found == GetDesktopWindow()
+                     ? 0
+                     : reinterpret_cast<uint64_t>(found);
+          return IsWindow(window) != FALSE;
+        }
+
+      private:
+        // Capped at the same length as `Win32WindowBlittable`'s strings.
+        WCHAR buffer[1024];
+    };
+
+    void LoadFromDesktop(WindowRegistry& registry) {
+      auto snapshot = SnapshotWindows(WindowSnapshotAll, 0, true);
+
+      WindowSnapshotReader reader;
+      if (reader.Open(snapshot.data(), snapshot.size())) {
+        registry.Load(reader);
+      }
+    }
+
+    /**
+     * @brief Keeps a registry current from the window events, on a thread of its own.
+     */
+    void Watch(WindowRegistry& registry, std::unique_ptr<WinEventDispatcher> dispatcher) {
+      Win32WindowSource source;
+      WinEventRecord records[256];
+      uint64_t dropped = 0;
+
+      while (true) {
+        auto count = dispatcher->Read(records, std::size(records), -1);
+        if (count == 0) {
+          return;
+        }
+
+        // Events were lost, so the registry can't be trusted until it's reloaded.
+        if (dispatcher->GetDroppedCount() != dropped) {
+          dropped = dispatcher->GetDroppedCount();
+          LoadFromDesktop(registry);
+          continue;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+          registry.ApplyEvent(records[i].event, records[i].hwnd, source);
+        }
+      }
+    }
+  }
+
+  WindowRegistry& GetWindowRegistry() {
+    static WindowRegistry registry;
+    static std::once_flag started;
+
+    std::call_once(started, [] {
+      auto dispatcher = std::make_unique<WinEventDispatcher>();
+      auto isHooked   = dispatcher->Start();
+
+      // Hook the events before loading, so nothing that happens while loading is missed. Events
+      // for windows that are already loaded are simply applied again. If they can't be hooked,
+      // the registry is only loaded once.
+      std::string error;
+      isHooked = isHooked && dispatcher->Subscribe(
+                               WindowRegistry::WatchedEvents,
+                               std::size(WindowRegistry::WatchedEvents),
+                               error
+                             );
+      LoadFromDesktop(registry);
+
+      // The thread runs for the lifetime of the process, like the registry itself.
+      if (isHooked) {
+        std::thread(Watch, std::ref(registry), std::move(dispatcher)).detach();
+      }
+    });
+
+    return registry;
+  }
+#else
+  WindowRegistry& GetWindowRegistry() {
+    // There are no windows to watch. The registry can still be driven directly.
+    static WindowRegistry registry;
+    return registry;
+  }
+#endif
+}
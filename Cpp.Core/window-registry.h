@@ -0,0 +1,179 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "window-snapshot.h"
+
+namespace Cpp::Core::NativeImpls {
+  /**
+   * @brief A window known to a `WindowRegistry`.
+   */
+  struct WindowRecord {
+    uint64_t hwnd = 0;
+
+    /** The parent window, or 0 for a top-level window. */
+    uint64_t parent = 0;
+
+    uint32_t processId = 0;
+
+    /** How deeply the window is nested, where 0 is a top-level window. Filled in by lookups. */
+    uint32_t depth = 0;
+
+    std::u16string title;
+    std::u16string className;
+
+    /** The full image path of the window's process. */
+    std::u16string processName;
+  };
+
+  /**
+   * @brief The windows to look up in a `WindowRegistry`. Every criterion that's set must match.
+   */
+  struct WindowQuery {
+    /** Only the window with this handle. */
+    std::optional<uint64_t> hwnd;
+
+    /** Only windows of this process. */
+    std::optional<uint32_t> processId;
+
+    /**
+     * Only windows of processes whose image has this file name, e.g. "explorer.exe". Compared
+     * case-insensitively.
+     */
+    std::optional<std::u16string> processName;
+
+    /** Only windows of this class. Compared case-insensitively. */
+    std::optional<std::u16string> className;
+
+    /** Only windows with exactly this title. */
+    std::optional<std::u16string> title;
+
+    /** Only descendants of this window. */
+    std::optional<uint64_t> ancestor;
+
+    /** Only top-level windows. */
+    bool topLevelOnly = false;
+  };
+
+  /**
+   * @brief Describes live windows to a `WindowRegistry` as it applies events. Kept abstract so the
+   * registry can be driven by a simulated desktop.
+   */
+  class IWindowSource {
+    public:
+      virtual ~IWindowSource() = default;
+
+      /**
+       * @brief Describes a window.
+       * @returns `false` if the window no longer exists.
+       */
+      virtual bool Describe(uint64_t hwnd, WindowRecord& record) = 0;
+
+      /**
+       * @brief Gets the title of a window.
+       * @returns `false` if the window no longer exists.
+       */
+      virtual bool GetTitle(uint64_t hwnd, std::u16string& title) = 0;
+
+      /**
+       * @brief Gets the parent of a window, which is 0 for a top-level window.
+       * @returns `false` if the window no longer exists.
+       */
+      virtual bool GetParent(uint64_t hwnd, uint64_t& parent) = 0;
+  };
+
+  /**
+   * @brief Every window on the desktop, indexed by process, process name, class and title so that
+   * finding a window doesn't mean enumerating all of them.
+   *
+   * The registry is loaded from a snapshot once and then kept current by applying the events that
+   * create, destroy, rename and reparent windows. Applying an event is idempotent, so events that
+   * arrive while a snapshot is loaded can be replayed afterwards. Lookups return windows in the
+   * order they became known, top-level windows first.
+   *
+   * The registry may be read from any number of threads while another thread updates it.
+   */
+  class WindowRegistry {
+    public:
+      /** The WinEvents that keep the registry current. */
+      static constexpr uint32_t WatchedEvents[] = {
+        0x8000, // EVENT_OBJECT_CREATE
+        0x8001, // EVENT_OBJECT_DESTROY
+        0x800C, // EVENT_OBJECT_NAMECHANGE
+        0x800F  // EVENT_OBJECT_PARENTCHANGE
+      };
+
+      WindowRegistry();
+      ~WindowRegistry();
+
+      WindowRegistry(const WindowRegistry&)            = delete;
+      WindowRegistry& operator=(const WindowRegistry&) = delete;
+
+      /**
+       * @brief Replaces every window with the windows in a snapshot.
+       */
+      void Load(const WindowSnapshotReader& snapshot);
+
+      /**
+       * @brief Adds a window, or replaces it if it's already known.
+       */
+      void Upsert(const WindowRecord& record);
+
+      /**
+       * @brief Removes a window and its descendants.
+       * @returns Whether the window was known.
+       */
+      bool Remove(uint64_t hwnd);
+
+      /**
+       * @brief Changes the title of a window.
+       * @returns Whether the window is known.
+       */
+      bool SetTitle(uint64_t hwnd, std::u16string_view title);
+
+      /**
+       * @brief Moves a window under another parent, or to the top level if the parent is 0.
+       * @returns Whether the window is known.
+       */
+      bool SetParent(uint64_t hwnd, uint64_t parent);
+
+      /**
+       * @brief Applies one of the `WatchedEvents`. Other events are ignored.
+       * @param source Describes the window the event is about.
+       */
+      void ApplyEvent(uint32_t event, uint64_t hwnd, IWindowSource& source);
+
+      /**
+       * @brief Looks up windows using the most selective index that the query allows.
+       * @returns The matching windows, top-level windows first.
+       */
+      std::vector<WindowRecord> Find(const WindowQuery& query) const;
+
+      /**
+       * @returns The number of windows in the registry.
+       */
+      size_t GetCount() const;
+
+    private:
+      struct Impl;
+      std::unique_ptr<Impl> impl;
+  };
+
+  /**
+   * @returns The registry shared by every window lookup. On Windows, the first call loads it and
+   * starts a thread that keeps it current. The returned registry lives for the lifetime of the
+   * process.
+   */
+  WindowRegistry& GetWindowRegistry();
+
+  /**
+   * @brief Lays out windows as a snapshot, with every field gathered.
+   */
+  std::vector<uint8_t> ToWindowSnapshot(const std::vector<WindowRecord>& windows);
+}
@@ -0,0 +1,274 @@
+#include "window-snapshot.h"
+#include "process-name-cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+namespace Cpp::Core::NativeImpls {
+  WindowSnapshotBuilder::WindowSnapshotBuilder(uint32_t fields)
+    : fields(fields & WindowSnapshotAll) {}
+
+  uint32_t WindowSnapshotBuilder::GetFields() const {
+    return fields;
+  }
+
+  WindowSnapshotString WindowSnapshotBuilder::Intern(uint32_t field, std::u16string_view value) {
+    if ((fields & field) == 0) {
+      return {WindowSnapshotString::NotGathered, 0};
+    }
+
+    // Store each distinct string once. Many windows share a class or process name.
+    auto [entry, isNew] = offsets.try_emplace(std::u16string(value), 0);
+    if (isNew) {
+      entry->second = static_cast<uint32_t>(pool.size());
+      pool.append(value);
+    }
+
+    return {entry->second, static_cast<uint32_t>(value.size())};
+  }
+
+  void WindowSnapshotBuilder::Add(
+    uint64_t hwnd,
+    uint64_t parent,
+    uint32_t processId,
+    uint32_t depth,
+    std::u16string_view title,
+    std::u16string_view className,
+    std::u16string_view processName
+  ) {
+    WindowSnapshotRecord record;
+    record.hwnd        = hwnd;
+    record.parent      = parent;
+    record.processId   = processId;
+    record.depth       = depth;
+    record.title       = Intern(WindowSnapshotTitle, title);
+    record.className   = Intern(WindowSnapshotClassName, className);
+    record.processName = Intern(WindowSnapshotProcessName, processName);
+    records.push_back(record);
+  }
+
+  size_t WindowSnapshotBuilder::GetCount() const {
+    return records.size();
+  }
+
+  std::vector<uint8_t> WindowSnapshotBuilder::Finish() const {
+    WindowSnapshotHeader header;
+    header.magic            = WindowSnapshotHeader::Magic;
+    header.version          = WindowSnapshotHeader::Version;
+    header.recordSize       = sizeof(WindowSnapshotRecord);
+    header.recordCount      = static_cast<uint32_t>(records.size());
+    header.fields           = fields;
+    header.stringPoolLength = static_cast<uint32_t>(pool.size());
+    header.reserved         = 0;
+
+    auto recordBytes = records.size() * sizeof(WindowSnapshotRecord);
+    auto poolBytes   = pool.size() * sizeof(char16_t);
+
+    std::vector<uint8_t> snapshot(sizeof(header) + recordBytes + poolBytes);
+    auto cursor = snapshot.data();
+
+    std::memcpy(cursor, &header, sizeof(header));
+    cursor += sizeof(header);
+
+    if (recordBytes > 0) {
+      std::memcpy(cursor, records.data(), recordBytes);
+      cursor += recordBytes;
+    }
+
+    if (poolBytes > 0) {
+      std::memcpy(cursor, pool.data(), poolBytes);
+    }
+
+    return snapshot;
+  }
+
+  bool WindowSnapshotReader::Open(const uint8_t* data, size_t size) {
+    if (data == nullptr || size < sizeof(WindowSnapshotHeader)) {
+      return false;
+    }
+
+    WindowSnapshotHeader header;
+    std::memcpy(&header, data, sizeof(header));
+
+    if (header.magic != WindowSnapshotHeader::Magic ||
+        header.version != WindowSnapshotHeader::Version ||
+        header.recordSize != sizeof(WindowSnapshotRecord)) {
+      return false;
+    }
+
+    auto recordBytes = size_t{header.recordCount} * sizeof(WindowSnapshotRecord);
+    auto poolBytes   = size_t{header.stringPoolLength} * sizeof(char16_t);
+    if (size != sizeof(header) + recordBytes + poolBytes) {
+      return false;
+    }
+
+    records    = data + sizeof(header);
+    pool       = reinterpret_cast<const char16_t*>(records + recordBytes);
+    count      = header.recordCount;
+    poolLength = header.stringPoolLength;
+    fields     = header.fields;
+
+    // Check every string up front, so reading one never has to.
+    for (size_t i = 0; i < count; ++i) {
+      auto record = GetRecord(i);
+      for (const auto& string : {record.title, record.className, record.processName}) {
+        auto isInPool = string.offset <= poolLength && string.length <= poolLength - string.offset;
+        if (string.offset != WindowSnapshotString::NotGathered && !isInPool) {
+          count = 0;
+          return false;
+        }
+      }
+    }
+
+    return true;
+  }
+
+  uint32_t WindowSnapshotReader::GetFields() const {
+    return fields;
+  }
+
+  size_t WindowSnapshotReader::GetCount() const {
+    return count;
+  }
+
+  WindowSnapshotRecord WindowSnapshotReader::GetRecord(size_t index) const {
+    WindowSnapshotRecord record;
+    std::memcpy(&record, records + index * sizeof(WindowSnapshotRecord), sizeof(record));
+    return record;
+  }
+
+  std::u16string_view WindowSnapshotReader::GetString(const WindowSnapshotString& string) const {
+    if (string.offset == WindowSnapshotString::NotGathered) {
+      return {};
+    }
+
+    return {pool + string.offset, string.length};
+  }
+
+#if defined(_WIN32)
+  static_assert(sizeof(wchar_t) == sizeof(char16_t), "Window strings are stored as UTF-16.");
+
+  namespace {
+    std::u16string_view View(const wchar_t* text, int length) {
+      return {reinterpret_cast<const char16_t*>(text), static_cast<size_t>(std::max(length, 0))};
+    }
+
+    BOOL CALLBACK CollectWindow(HWND hwnd, LPARAM lParam) {
+      reinterpret_cast<std::vector<HWND>*>(lParam)->push_back(hwnd);
+      return TRUE;
+    }
+
+    /**
+     * @brief Gathers the fields of windows into a builder, looking up each process only once.
+     */
+    class WindowGatherer {
+      public:
+        explicit WindowGatherer(WindowSnapshotBuilder& builder) : builder(builder) {}
+
+        void Add(HWND hwnd, HWND parent, uint32_t depth) {
+          auto fields = builder.GetFields();
+
+          DWORD processId = 0;
+          GetWindowThreadProcessId(hwnd, &processId);
+
+          // Titles and class names are capped at the same length as `Win32WindowBlittable`'s.
+          int titleLength = 0;
+          if ((fields & WindowSnapshotTitle) != 0) {
+            titleLength = GetWindowTextW(hwnd, title, static_cast<int>(std::size(title)));
+          }
+
+          int classNameLength = 0;
+          if ((fields & WindowSnapshotClassName) != 0) {
+            classNameLength =
+              GetClassNameW(hwnd, className, static_cast<int>(std::size(className)));
+          }
+
+          const std::wstring* processName = &noProcessName;
+          if ((fields & WindowSnapshotProcessName) != 0) {
+            auto [entry, isNew] = processNames.try_emplace(processId);
+            if (isNew) {
+              entry->second = GetProcessImageName(processId);
+            }
+            processName = &entry->second;
+          }
+
+          builder.Add(
+            reinterpret_cast<uint64_t>(hwnd),
+            reinterpret_cast<uint64_t>(parent),
+            processId,
+            depth,
+            View(title, titleLength),
+            View(className, classNameLength),
+            View(processName->data(), static_cast<int>(processName->size()))
+          );
+        }
+
+        /**
+         * @brief Adds every descendant of a window.
+         * @param depth The depth of the window's direct children.
+         */
+        void AddDescendants(HWND root, uint32_t depth) {
+          descendants.clear();
+          EnumChildWindows(root, CollectWindow, reinterpret_cast<LPARAM>(&descendants));
+
+          // Descendants are enumerated depth first, so a window's parent has always been seen
+          // before the window itself.
+          depths.clear();
+          depths[root] = depth - 1;
+          for (auto child : descendants) {
+            auto parent = GetAncestor(child, GA_PARENT);
+            auto found  = depths.find(parent);
+            auto level  = found != depths.end() ? found->second + 1 : depth;
+            depths[child] = level;
+            Add(child, parent, level);
+          }
+        }
+
+      private:
+        WindowSnapshotBuilder& builder;
+
+        WCHAR title[1024];
+        WCHAR className[1024];
+
+        const std::wstring noProcessName;
+        std::unordered_map<DWORD, std::wstring> processNames;
+
+        std::vector<HWND> descendants;
+        std::unordered_map<HWND, uint32_t> depths;
+    };
+  }
+
+  std::vector<uint8_t> SnapshotWindows(uint32_t fields, uint64_t root, bool includeChildren) {
+    WindowSnapshotBuilder builder(fields);
+    WindowGatherer gatherer(builder);
+
+    if (root != 0) {
+      gatherer.AddDescendants(reinterpret_cast<HWND>(root), 0);
+      return builder.Finish();
+    }
+
+    std::vector<HWND> windows;
+    EnumWindows(CollectWindow, reinterpret_cast<LPARAM>(&windows));
+
+    for (auto hwnd : windows) {
+      gatherer.Add(hwnd, nullptr, 0);
+      if (includeChildren) {
+        gatherer.AddDescendants(hwnd, 1);
+      }
+    }
+
+    return builder.Finish();
+  }
+#else
+  std::vector<uint8_t> SnapshotWindows(uint32_t fields, uint64_t, bool) {
+    // There are no windows to snapshot.
+    return WindowSnapshotBuilder(fields).Finish();
+  }
+#endif
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Cpp::Core::NativeImpls {
+  /**
+   * @brief The fields of each window that a snapshot can gather. The handle, parent, depth and
+   * process identifier are always gathered.
+   */
+  enum WindowSnapshotFields : uint32_t {
+    WindowSnapshotTitle       = 1 << 0,
+    WindowSnapshotClassName   = 1 << 1,
+    WindowSnapshotProcessName = 1 << 2,
+    WindowSnapshotAll         = WindowSnapshotTitle |
+                                WindowSnapshotClassName |
+                                WindowSnapshotProcessName
+  };
+
+  /**
+   * @brief A string in the string pool of a snapshot.
+   */
+  struct WindowSnapshotString {
+    /** The offset of the string into the pool, in UTF-16 code units, or `NotGathered`. */
+    uint32_t offset;
+
+    /** The length of the string, in UTF-16 code units. */
+    uint32_t length;
+
+    /** The offset of a string whose field wasn't gathered. */
+    static constexpr uint32_t NotGathered = 0xFFFFFFFF;
+  };
+
+  /**
+   * @brief The start of a snapshot.
+   */
+  struct WindowSnapshotHeader {
+    /** Always `Magic`. */
+    uint32_t magic;
+
+    /** Always `Version`. Bumped whenever the layout changes. */
+    uint16_t version;
+
+    /** The size of each record, in bytes. */
+    uint16_t recordSize;
+
+    /** The number of records that follow the header. */
+    uint32_t recordCount;
+
+    /** The `WindowSnapshotFields` that were gathered. */
+    uint32_t fields;
+
+    /** The length of the string pool that follows the records, in UTF-16 code units. */
+    uint32_t stringPoolLength;
+
+    uint32_t reserved;
+
+    static constexpr uint32_t Magic   = 0x50534E57; // "WNSP"
+    static constexpr uint16_t Version = 1;
+  };
+
+  /**
+   * @brief A window in a snapshot.
+   */
+  struct WindowSnapshotRecord {
+    uint64_t hwnd;
+
+    /** The parent window, or 0 for a top-level window. */
+    uint64_t parent;
+
+    uint32_t processId;
+
+    /**
+     * How deeply the window is nested, where 0 is a top-level window, or a direct child of the
+     * window the snapshot was taken of.
+     */
+    uint32_t depth;
+
+    WindowSnapshotString title;
+    WindowSnapshotString className;
+    WindowSnapshotString processName;
+  };
+
+  static_assert(sizeof(WindowSnapshotHeader) == 24, "The snapshot layout is shared with C#.");
+  static_assert(sizeof(WindowSnapshotRecord) == 48, "The snapshot layout is shared with C#.");
+
+  /**
+   * @brief Builds a snapshot of windows: a single contiguous block made of a header, a record of
+   * fixed layout per window, and a pool of UTF-16 strings the records point into. Identical
+   * strings, such as the class and process names that many windows share, are only stored once.
+   */
+  class WindowSnapshotBuilder {
+    public:
+      /**
+       * @param fields The `WindowSnapshotFields` that are gathered. Strings of the other fields
+       * are recorded as not gathered.
+       */
+      explicit WindowSnapshotBuilder(uint32_t fields);
+
+      /**
+       * @returns The `WindowSnapshotFields` that are gathered.
+       */
+      uint32_t GetFields() const;
+
+      /**
+       * @brief Adds a window.
+       * @param title The window's title. Ignored unless the title is gathered.
+       * @param className The window's class name. Ignored unless the class name is gathered.
+       * @param processName The path of the window's process. Ignored unless the process name is
+       * gathered.
+       */
+      void Add(
+        uint64_t hwnd,
+        uint64_t parent,
+        uint32_t processId,
+        uint32_t depth,
+        std::u16string_view title,
+        std::u16string_view className,
+        std::u16string_view processName
+      );
+
+      /**
+       * @returns The number of windows added.
+       */
+      size_t GetCount() const;
+
+      /**
+       * @brief Lays out the snapshot.
+       * @returns The snapshot.
+       */
+      std::vector<uint8_t> Finish() const;
+
+    private:
+      WindowSnapshotString Intern(uint32_t field, std::u16string_view value);
+
+      uint32_t fields;
+      std::vector<WindowSnapshotRecord> records;
+      std::u16string pool;
+      std::unordered_map<std::u16string, uint32_t> offsets;
+  };
+
+  /**
+   * @brief Reads a snapshot laid out by `WindowSnapshotBuilder`.
+   */
+  class WindowSnapshotReader {
+    public:
+      /**
+       * @brief Validates a snapshot and prepares it for reading. The snapshot must outlive the
+       * reader.
+       * @returns Whether the snapshot is well-formed, i.e. its header matches this version and
+       * every string lies within the pool.
+       */
+      bool Open(const uint8_t* data, size_t size);
+
+      /**
+       * @returns The `WindowSnapshotFields` that were gathered.
+       */
+      uint32_t GetFields() const;
+
+      /**
+       * @returns The number of windows in the snapshot.
+       */
+      size_t GetCount() const;
+
+      /**
+       * @returns The record of the window at the given index.
+       */
+      WindowSnapshotRecord GetRecord(size_t index) const;
+
+      /**
+       * @returns The contents of a string, or an empty string if it wasn't gathered.
+       */
+      std::u16string_view GetString(const WindowSnapshotString& string) const;
+
+    private:
+      const uint8_t* records = nullptr;
+      const char16_t* pool = nullptr;
+      size_t count = 0;
+      size_t poolLength = 0;
+      uint32_t fields = 0;
+  };
+
+  /**
+   * @brief Takes a snapshot of the windows on the desktop in a single pass.
+   * @param fields The `WindowSnapshotFields` to gather. The others can be queried later, for just
+   * the windows that need them.
+   * @param root The window whose descendants to snapshot, or 0 for the top-level windows.
+   * @param includeChildren Whether to include the descendants of the top-level windows. Always
+   * the case when `root` is given.
+   * @returns The snapshot, as laid out by `WindowSnapshotBuilder`.
+   */
+  std::vector<uint8_t> SnapshotWindows(uint32_t fields, uint64_t root, bool includeChildren);
+}
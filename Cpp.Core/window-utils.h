@@ -5,6 +5,8 @@
 #include <vector>
 #include <array>
 
+#include "process-name-cache.h"
+
 namespace Cpp::Core::NativeImpls {
   /**
    * @brief Retrieves the name of the process that created the window.
@@ -13,31 +15,13 @@ namespace Cpp::Core::NativeImpls {
    */
   inline std::wstring GetProcessName(HWND hwnd) {
     // The numeric identifier of the process that created the window.
-    DWORD processId;
+    DWORD processId = 0;
 
     // Retrieves the identifier of the thread that created the specified window and, optionally, the identifier of the process that created the window.
     GetWindowThreadProcessId(hwnd, &processId);
 
-    // Open the process given the process identifier to get the process handle.
-    const auto process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processId);
-
-    // If the process handle is null, return an empty string since the process name cannot be retrieved.
-    if (process == nullptr) {
-      return L"";
-    }
-
-    // The full path of the executable file of the process.
-    std::array<WCHAR, 1024> processName;
-    DWORD size = processName.size();
-
-    // Retrieves the full name of the executable image for the specified process.
-    QueryFullProcessImageNameW(process, 0, processName.data(), &size);
-
-    // Close the process handle since it is no longer needed.
-    CloseHandle(process);
-
-    // Convert the process name to a wide string and return it.
-    std::wstring name(processName.data());
-    return name;
+    // Look up the full path of the executable file of the process. Only the first lookup of a
+    // process actually queries it; later ones are served from the cache.
+    return GetProcessImageName(processId);
   }
 }
@@ -1,6 +1,333 @@
 #include <windows.h>
-#include <sstream>
 #include <windowsx.h>
+#include <dwmapi.h>
+#include <shellapi.h>
+#include <timeapi.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cwchar>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "latency-pattern.h"
+#include "latency-probe.h"
+
+#pragma comment(lib, "dwmapi.lib")
+#pragma comment(lib, "winmm.lib")
+
+using namespace DiagnosticWindow;
+
+namespace {
+  // The size of each cell of the latency pattern. Large enough that the cells are still a few
+  // pixels wide after an 8x downscale.
+  constexpr int32_t patternCellSize = 32;
+
+  // How often the probe injects a mouse move, and how long it waits for one to be displayed
+  // before giving up on it, in microseconds.
+  constexpr int64_t injectInterval = 100'000;
+  constexpr int64_t injectTimeout = 1'000'000;
+
+  // How often the probe refreshes the statistics shown in the window, in microseconds.
+  constexpr int64_t reportInterval = 1'000'000;
+
+  // The latest mouse position forwarded to the window, and the number of moves received so far.
+  std::atomic<int> xPos{-1};
+  std::atomic<int> yPos{-1};
+  std::atomic<uint32_t> inputCount{0};
+
+  std::atomic<bool> isRunning{true};
+
+  LatencyProbe probe;
+
+  // The statistics shown in the window, written by the probe thread.
+  std::mutex reportMutex;
+  std::wstring report = L"Run with --probe <window title> to measure latency.";
+
+  /**
+   * @brief A 32-bit, top-down DIB that frames are rendered into before being copied to the window.
+   */
+  struct BackBuffer {
+    HDC dc = nullptr;
+    HBITMAP bitmap = nullptr;
+    HGDIOBJ previous = nullptr;
+    uint8_t* pixels = nullptr;
+    int width = 0;
+    int height = 0;
+  };
+
+  int64_t NowMicroseconds() {
+    static auto frequency = [] {
+      LARGE_INTEGER value;
+      QueryPerformanceFrequency(&value);
+      return value.QuadPart;
+    }();
+
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart / frequency * 1'000'000 +
+           counter.QuadPart % frequency * 1'000'000 / frequency;
+  }
+
+  void ReleaseBackBuffer(BackBuffer& buffer) {
+    if (buffer.dc != nullptr) {
+      SelectObject(buffer.dc, buffer.previous);
+      DeleteObject(buffer.bitmap);
+      DeleteDC(buffer.dc);
+    }
+
+    buffer = {};
+  }
+
+  /**
+   * @brief Creates a DIB section of the given size, or reuses the existing one if it matches.
+   */
+  bool EnsureBackBuffer(BackBuffer& buffer, HDC target, int width, int height) {
+    if (buffer.dc != nullptr && buffer.width == width && buffer.height == height) {
+      return true;
+    }
+
+    ReleaseBackBuffer(buffer);
+    if (width <= 0 || height <= 0) {
+      return false;
+    }
+
+    BITMAPINFO info = {};
+    info.bmiHeader.biSize        = sizeof(info.bmiHeader);
+    info.bmiHeader.biWidth       = width;
+    info.bmiHeader.biHeight      = -height;
+    info.bmiHeader.biPlanes      = 1;
+    info.bmiHeader.biBitCount    = 32;
+    info.bmiHeader.biCompression = BI_RGB;
+
+    void* pixels = nullptr;
+    buffer.bitmap = CreateDIBSection(target, &info, DIB_RGB_COLORS, &pixels, nullptr, 0);
+    if (buffer.bitmap == nullptr) {
+      return false;
+    }
+
+    buffer.dc       = CreateCompatibleDC(target);
+    buffer.previous = SelectObject(buffer.dc, buffer.bitmap);
+    buffer.pixels   = static_cast<uint8_t*>(pixels);
+    buffer.width    = width;
+    buffer.height   = height;
+    return true;
+  }
+
+  /**
+   * @brief Renders the next frame: the latency pattern, followed by the mouse position and the
+   * latest statistics.
+   */
+  void RenderFrame(HWND hwnd, BackBuffer& buffer, uint32_t frame) {
+    RECT client;
+    GetClientRect(hwnd, &client);
+
+    auto windowDc = GetDC(hwnd);
+    if (!EnsureBackBuffer(buffer, windowDc, client.right, client.bottom)) {
+      ReleaseDC(hwnd, windowDc);
+      return;
+    }
+
+    auto stride = static_cast<size_t>(buffer.width) * 4;
+    memset(buffer.pixels, 0x40, stride * buffer.height);
+
+    LatencyPattern::Render(
+      buffer.pixels,
+      buffer.width,
+      buffer.height,
+      stride,
+      patternCellSize,
+      {frame, inputCount.load(std::memory_order_relaxed)}
+    );
+
+    // Format into fixed buffers rather than a stream, since this runs every frame.
+    wchar_t position[96];
+    auto length = swprintf_s(
+      position,
+      L"Mouse Position: (%d, %d)  Moves: %u  Frame: %u",
+      xPos.load(std::memory_order_relaxed),
+      yPos.load(std::memory_order_relaxed),
+      inputCount.load(std::memory_order_relaxed),
+      frame
+    );
+
+    std::wstring statistics;
+    {
+      std::lock_guard lock(reportMutex);
+      statistics = report;
+    }
+
+    RECT textRect = {5, LatencyPattern::Rows * patternCellSize + 5, buffer.width, buffer.height};
+    SetBkMode(buffer.dc, TRANSPARENT);
+    SetTextColor(buffer.dc, RGB(255, 255, 255));
+    TextOut(buffer.dc, textRect.left, textRect.top, position, length > 0 ? length : 0);
+    textRect.top += 20;
+    DrawText(buffer.dc, statistics.c_str(), -1, &textRect, DT_LEFT | DT_TOP);
+
+    BitBlt(windowDc, 0, 0, buffer.width, buffer.height, buffer.dc, 0, 0, SRCCOPY);
+    ReleaseDC(hwnd, windowDc);
+
+    probe.OnFrameRendered(frame, NowMicroseconds());
+  }
+
+  /**
+   * @brief Formats a percentile summary of a latency histogram in milliseconds.
+   */
+  std::wstring Summarize(
+    const wchar_t* name,
+    const Downscaler::Cpp::Core::NativeImpls::LatencyHistogram& histogram
+  ) {
+    wchar_t line[160];
+    swprintf_s(
+      line,
+      L"%ls: p50 %.2f ms  p90 %.2f ms  p99 %.2f ms  max %.2f ms  (%llu samples)",
+      name,
+      histogram.GetPercentile(50) / 1000.0,
+      histogram.GetPercentile(90) / 1000.0,
+      histogram.GetPercentile(99) / 1000.0,
+      histogram.GetMax() / 1000.0,
+      histogram.GetCount()
+    );
+    return line;
+  }
+
+  /**
+   * @brief Injects mouse moves over the downscaler window and decodes the latency pattern from its
+   * output until the window closes. The cursor must rest over the downscaler window so the moves
+   * are forwarded back to this window.
+   * @param source This window.
+   * @param targetTitle The title of the downscaler window.
+   */
+  void RunProbe(HWND source, std::wstring targetTitle) {
+    auto screenDc  = GetDC(nullptr);
+    BackBuffer capture;
+    HWND target    = nullptr;
+    LONG direction = 1;
+    int64_t lastInjection = 0;
+    int64_t lastReport    = 0;
+
+    // Poll the output at a millisecond granularity.
+    timeBeginPeriod(1);
+
+    while (isRunning.load(std::memory_order_relaxed)) {
+      if (target == nullptr || !IsWindow(target)) {
+        target = FindWindowW(nullptr, targetTitle.c_str());
+        Sleep(250);
+        continue;
+      }
+
+      // The downscaler scales this window's client area onto its own, so the pattern occupies the
+      // same fraction of both.
+      RECT sourceClient;
+      RECT targetClient;
+      GetClientRect(source, &sourceClient);
+      GetClientRect(target, &targetClient);
+      if (sourceClient.right <= 0 || sourceClient.bottom <= 0) {
+        Sleep(1);
+        continue;
+      }
+
+      auto scaleX = static_cast<double>(targetClient.right) / sourceClient.right;
+      auto scaleY = static_cast<double>(targetClient.bottom) / sourceClient.bottom;
+      LatencyPatternRegion region = {
+        0.0,
+        0.0,
+        LatencyPattern::Columns * patternCellSize * scaleX,
+        LatencyPattern::Rows * patternCellSize * scaleY
+      };
+
+      // Only capture the pattern rather than the whole window.
+      auto width  = static_cast<int>(region.width) + 1;
+      auto height = static_cast<int>(region.height) + 1;
+      POINT origin = {0, 0};
+      ClientToScreen(target, &origin);
+
+      if (EnsureBackBuffer(capture, screenDc, width, height) &&
+          BitBlt(capture.dc, 0, 0, width, height, screenDc, origin.x, origin.y, SRCCOPY)) {
+        GdiFlush();
+        auto capturedAt = NowMicroseconds();
+
+        LatencyPatternPayload payload;
+        if (LatencyPattern::Decode(
+              capture.pixels,
+              width,
+              height,
+              static_cast<size_t>(width) * 4,
+              region,
+              payload
+            )) {
+          probe.OnFrameObserved(payload, capturedAt);
+        }
+      }
+
+      auto now = NowMicroseconds();
+
+      // Inject the next move once the last one was displayed, or given up on.
+      auto isDue     = now - lastInjection >= injectInterval;
+      auto isTimeout = now - lastInjection >= injectTimeout;
+      if (isDue && (!probe.IsInputPending() || isTimeout)) {
+        INPUT input      = {};
+        input.type       = INPUT_MOUSE;
+        input.mi.dx      = direction;
+        input.mi.dwFlags = MOUSEEVENTF_MOVE;
+
+        probe.OnInputInjected(inputCount.load(std::memory_order_acquire), now);
+        SendInput(1, &input, sizeof(input));
+
+        direction     = -direction;
+        lastInjection = now;
+      }
+
+      if (now - lastReport >= reportInterval) {
+        wchar_t frames[96];
+        swprintf_s(
+          frames,
+          L"Frames observed: %llu  skipped: %llu",
+          probe.GetObservedFrames(),
+          probe.GetSkippedFrames()
+        );
+
+        auto text = Summarize(L"Input to display", probe.GetInputToDisplay()) + L"\n" +
+                    Summarize(L"Render to display", probe.GetRenderToDisplay()) + L"\n" +
+                    frames;
+
+        std::lock_guard lock(reportMutex);
+        report     = std::move(text);
+        lastReport = now;
+      }
+
+      Sleep(1);
+    }
+
+    timeEndPeriod(1);
+    ReleaseBackBuffer(capture);
+    ReleaseDC(nullptr, screenDc);
+  }
+
+  /**
+   * @returns The window title following `--probe` on the command line, or an empty string.
+   */
+  std::wstring GetProbeTarget() {
+    int count = 0;
+    auto arguments = CommandLineToArgvW(GetCommandLineW(), &count);
+    if (arguments == nullptr) {
+      return {};
+    }
+
+    std::wstring target;
+    for (int i = 1; i + 1 < count; ++i) {
+      if (wcscmp(arguments[i], L"--probe") == 0) {
+        target = arguments[i + 1];
+        break;
+      }
+    }
+
+    LocalFree(arguments);
+    return target;
+  }
+}
 
 LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
 
@@ -36,45 +363,69 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE, PWSTR pCmdLine, int nCmdShow
 
   ShowWindow(hwnd, nCmdShow);
 
-  // Run the message loop.
+  std::thread probeThread;
+  auto probeTarget = GetProbeTarget();
+  if (!probeTarget.empty()) {
+    probeThread = std::thread(RunProbe, hwnd, probeTarget);
+  }
+
+  // Render continuously rather than on demand, so every refresh shows a new frame number.
+  BackBuffer backBuffer;
+  uint32_t frame = 0;
   MSG msg = {};
-  while (GetMessage(&msg, nullptr, 0, 0)) {
-    TranslateMessage(&msg);
-    DispatchMessage(&msg);
+  while (isRunning.load(std::memory_order_relaxed)) {
+    while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE)) {
+      if (msg.message == WM_QUIT) {
+        isRunning.store(false, std::memory_order_relaxed);
+        break;
+      }
+
+      TranslateMessage(&msg);
+      DispatchMessage(&msg);
+    }
+
+    if (!isRunning.load(std::memory_order_relaxed)) {
+      break;
+    }
+
+    RenderFrame(hwnd, backBuffer, frame++);
+
+    // Wait for the compositor, so each frame is shown for exactly one refresh.
+    if (FAILED(DwmFlush())) {
+      Sleep(1);
+    }
   }
 
+  if (probeThread.joinable()) {
+    probeThread.join();
+  }
+
+  ReleaseBackBuffer(backBuffer);
   return 0;
 }
 
 LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam) {
-  static int xPos = -1;
-  static int yPos = -1;
-
   switch (uMsg) {
   case WM_DESTROY:
     PostQuitMessage(0);
     return 0;
 
-  case WM_MOUSEMOVE: {
-    xPos = GET_X_LPARAM(lParam);
-    yPos = GET_Y_LPARAM(lParam);
+  case WM_MOUSEMOVE:
+    xPos.store(GET_X_LPARAM(lParam), std::memory_order_relaxed);
+    yPos.store(GET_Y_LPARAM(lParam), std::memory_order_relaxed);
 
-    // Trigger a paint message for the window.
-    InvalidateRect(hwnd, nullptr, TRUE);
-  }
-                   return 0;
+    // Record the arrival of the move. The next frame that's rendered reflects it.
+    inputCount.fetch_add(1, std::memory_order_release);
+    return 0;
+
+  case WM_ERASEBKGND:
+    // Every frame covers the whole client area, so erasing it only causes flicker.
+    return 1;
 
   case WM_PAINT: {
+    // Frames are rendered by the message loop, so only validate the window here.
     PAINTSTRUCT ps;
-    auto hdc = BeginPaint(hwnd, &ps);
-
-    // Set up the text to display.
-    std::wstringstream ss;
-    ss << L"Mouse Position: (" << xPos << L", " << yPos << L")";
-
-    // Draw the text in the client area.
-    TextOut(hdc, 5, 5, ss.str().c_str(), ss.str().size());
-
+    BeginPaint(hwnd, &ps);
     EndPaint(hwnd, &ps);
   }
                return 0;
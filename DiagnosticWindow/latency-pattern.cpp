@@ -0,0 +1,180 @@
+#include "latency-pattern.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace DiagnosticWindow::LatencyPattern {
+  namespace {
+    constexpr int32_t cellCount = Columns * Rows;
+
+    // The cells that hold each part of the pattern.
+    constexpr int32_t payloadStart = 2;
+    constexpr int32_t payloadBits = 64;
+    constexpr int32_t crcStart = payloadStart + payloadBits;
+    constexpr int32_t crcBits = 8;
+
+    // The minimum difference in luma between the white and black references. Anything less isn't
+    // the pattern, e.g. because the window is covered.
+    constexpr int32_t minContrast = 64;
+
+    static_assert(crcStart + crcBits <= cellCount - 2, "The pattern doesn't fit its grid.");
+
+    /**
+     * @brief Computes a CRC-8 with the polynomial x^8 + x^2 + x + 1.
+     */
+    uint8_t Crc8(uint64_t value) {
+      uint8_t crc = 0;
+      for (int byte = 7; byte >= 0; --byte) {
+        crc ^= static_cast<uint8_t>(value >> (byte * 8));
+        for (int bit = 0; bit < 8; ++bit) {
+          crc = static_cast<uint8_t>((crc & 0x80) != 0 ? (crc << 1) ^ 0x07 : crc << 1);
+        }
+      }
+      return crc;
+    }
+
+    uint64_t Pack(const LatencyPatternPayload& payload) {
+      return (uint64_t{payload.frame} << 32) | payload.inputCount;
+    }
+
+    /**
+     * @returns Whether each cell of the pattern is white, for the given payload.
+     */
+    std::array<bool, cellCount> Layout(const LatencyPatternPayload& payload) {
+      std::array<bool, cellCount> cells{};
+
+      cells[0]             = true;
+      cells[cellCount - 2] = true;
+
+      auto packed = Pack(payload);
+      for (int32_t bit = 0; bit < payloadBits; ++bit) {
+        cells[payloadStart + bit] = ((packed >> (payloadBits - 1 - bit)) & 1) != 0;
+      }
+
+      auto crc = Crc8(packed);
+      for (int32_t bit = 0; bit < crcBits; ++bit) {
+        cells[crcStart + bit] = ((crc >> (crcBits - 1 - bit)) & 1) != 0;
+      }
+
+      return cells;
+    }
+
+    /**
+     * @brief Averages the luma of the middle half of a cell, which stays clear of the blur that
+     * scaling leaves at the cell's edges.
+     */
+    int32_t SampleCell(
+      const uint8_t* pixels,
+      int32_t width,
+      int32_t height,
+      size_t stride,
+      const LatencyPatternRegion& region,
+      int32_t cell
+    ) {
+      auto cellWidth  = region.width / Columns;
+      auto cellHeight = region.height / Rows;
+      auto left       = region.x + (cell % Columns + 0.25) * cellWidth;
+      auto top        = region.y + (cell / Columns + 0.25) * cellHeight;
+
+      // Always sample at least one pixel, however small the cells were scaled down to.
+      auto x0 = std::clamp(static_cast<int32_t>(std::floor(left)), 0, width - 1);
+      auto y0 = std::clamp(static_cast<int32_t>(std::floor(top)), 0, height - 1);
+      auto x1 = std::clamp(static_cast<int32_t>(std::ceil(left + cellWidth * 0.5)), x0 + 1, width);
+      auto y1 = std::clamp(static_cast<int32_t>(std::ceil(top + cellHeight * 0.5)), y0 + 1, height);
+
+      int64_t sum = 0;
+      for (auto y = y0; y < y1; ++y) {
+        auto row = pixels + static_cast<size_t>(y) * stride;
+        for (auto x = x0; x < x1; ++x) {
+          auto pixel = row + static_cast<size_t>(x) * 4;
+          sum += (29 * pixel[0] + 150 * pixel[1] + 77 * pixel[2]) >> 8;
+        }
+      }
+
+      return static_cast<int32_t>(sum / (int64_t{x1 - x0} * (y1 - y0)));
+    }
+  }
+
+  void Render(
+    uint8_t* pixels,
+    int32_t width,
+    int32_t height,
+    size_t stride,
+    int32_t cellSize,
+    const LatencyPatternPayload& payload
+  ) {
+    auto cells = Layout(payload);
+
+    auto patternWidth  = std::min(width, Columns * cellSize);
+    auto patternHeight = std::min(height, Rows * cellSize);
+
+    for (int32_t y = 0; y < patternHeight; ++y) {
+      auto row = reinterpret_cast<uint32_t*>(pixels + static_cast<size_t>(y) * stride);
+      for (int32_t x = 0; x < patternWidth; ++x) {
+        auto isWhite = cells[(y / cellSize) * Columns + x / cellSize];
+        row[x]       = isWhite ? 0xFFFFFFFF : 0xFF000000;
+      }
+    }
+  }
+
+  bool Decode(
+    const uint8_t* pixels,
+    int32_t width,
+    int32_t height,
+    size_t stride,
+    const LatencyPatternRegion& region,
+    LatencyPatternPayload& payload
+  ) {
+    if (width <= 0 || height <= 0 || region.width <= 0.0 || region.height <= 0.0) {
+      return false;
+    }
+
+    std::array<int32_t, cellCount> samples;
+    for (int32_t cell = 0; cell < cellCount; ++cell) {
+      samples[cell] = SampleCell(pixels, width, height, stride, region, cell);
+    }
+
+    // Threshold halfway between the references at either end of the pattern, which also copes
+    // with a gradient across it, e.g. from a partially transparent overlay.
+    auto white = (samples[0] + samples[cellCount - 2]) / 2;
+    auto black = (samples[1] + samples[cellCount - 1]) / 2;
+    if (white - black < minContrast) {
+      return false;
+    }
+
+    auto threshold = (white + black) / 2;
+    auto margin    = (white - black) / 4;
+
+    // Reads a cell as a bit. A cell that's neither clearly white nor clearly black comes from two
+    // frames blended together, which the CRC alone would miss one time in 256.
+    auto isAmbiguous = false;
+    auto readBit = [&](int32_t cell) -> uint64_t {
+      auto sample = samples[cell];
+      isAmbiguous |= sample > threshold - margin && sample < threshold + margin;
+      return sample > threshold ? 1 : 0;
+    };
+
+    uint64_t packed = 0;
+    for (int32_t bit = 0; bit < payloadBits; ++bit) {
+      packed = (packed << 1) | readBit(payloadStart + bit);
+    }
+
+    uint8_t crc = 0;
+    for (int32_t bit = 0; bit < crcBits; ++bit) {
+      crc = static_cast<uint8_t>((crc << 1) | readBit(crcStart + bit));
+    }
+
+    if (isAmbiguous) {
+      return false;
+    }
+
+    if (crc != Crc8(packed)) {
+      return false;
+    }
+
+    payload.frame      = static_cast<uint32_t>(packed >> 32);
+    payload.inputCount = static_cast<uint32_t>(packed);
+    return true;
+  }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace DiagnosticWindow {
+  /**
+   * @brief The values encoded in a latency pattern.
+   */
+  struct LatencyPatternPayload {
+    /** The number of the frame the pattern was rendered in. */
+    uint32_t frame = 0;
+
+    /** The number of mouse moves the window had received when the frame was rendered. */
+    uint32_t inputCount = 0;
+
+    bool operator==(const LatencyPatternPayload& other) const {
+      return frame == other.frame && inputCount == other.inputCount;
+    }
+  };
+
+  /**
+   * @brief Where a latency pattern is within a frame that is decoded, in that frame's pixels. The
+   * region is fractional since the pattern is usually decoded from a scaled copy of the window.
+   */
+  struct LatencyPatternRegion {
+    double x = 0.0;
+    double y = 0.0;
+    double width = 0.0;
+    double height = 0.0;
+  };
+
+  /**
+   * @brief A grid of black and white cells that encodes a `LatencyPatternPayload`, so the frame a
+   * window showed can be identified from a capture of it, even after it has been scaled.
+   *
+   * The first two and last two cells are white and black references that the decoder derives its
+   * threshold from. They are followed by the 64 bits of the payload and an 8-bit CRC. Frames that
+   * were torn or blended together are rejected, either by the CRC or because some of their cells
+   * are neither clearly white nor clearly black.
+   */
+  namespace LatencyPattern {
+    /** The number of cells per row. */
+    constexpr int32_t Columns = 8;
+
+    /** The number of rows of cells. */
+    constexpr int32_t Rows = 10;
+
+    /**
+     * @brief Renders a pattern into the top-left corner of a 32-bit BGRA image.
+     * @param pixels The first row of the image.
+     * @param width The width of the image in pixels.
+     * @param height The height of the image in pixels.
+     * @param stride The distance between rows, in bytes.
+     * @param cellSize The size of each cell in pixels. The pattern is clipped to the image.
+     * @param payload The values to encode.
+     */
+    void Render(
+      uint8_t* pixels,
+      int32_t width,
+      int32_t height,
+      size_t stride,
+      int32_t cellSize,
+      const LatencyPatternPayload& payload
+    );
+
+    /**
+     * @brief Decodes a pattern from a 32-bit BGRA image.
+     * @param pixels The first row of the image.
+     * @param width The width of the image in pixels.
+     * @param height The height of the image in pixels.
+     * @param stride The distance between rows, in bytes.
+     * @param region Where the pattern is within the image.
+     * @param payload Receives the decoded values.
+     * @returns `false` if no intact pattern was found, e.g. because the frame was torn.
+     */
+    bool Decode(
+      const uint8_t* pixels,
+      int32_t width,
+      int32_t height,
+      size_t stride,
+      const LatencyPatternRegion& region,
+      LatencyPatternPayload& payload
+    );
+  }
+}
@@ -0,0 +1,115 @@
+#include "latency-probe.h"
+
+#include <array>
+#include <atomic>
+
+using Downscaler::Cpp::Core::NativeImpls::LatencyHistogram;
+
+namespace DiagnosticWindow {
+  namespace {
+    // The number of recent frames whose render times are kept. Frames take far less than this
+    // many refreshes to reach the output.
+    constexpr size_t frameHistory = 1024;
+
+    /**
+     * @brief When a frame was rendered, shared between the render and probe threads.
+     */
+    struct FrameRecord {
+      std::atomic<uint32_t> frame{0};
+      std::atomic<int64_t> time{-1};
+    };
+  }
+
+  struct LatencyProbe::Impl {
+    std::array<FrameRecord, frameHistory> frames;
+
+    LatencyHistogram inputToDisplay;
+    LatencyHistogram renderToDisplay;
+
+    // Owned by the probe thread.
+    bool isInputPending = false;
+    uint32_t pendingInputCount = 0;
+    int64_t pendingInputTime = 0;
+    bool hasObservedFrame = false;
+    uint32_t lastObservedFrame = 0;
+    uint64_t observedFrames = 0;
+    uint64_t skippedFrames = 0;
+  };
+
+  LatencyProbe::LatencyProbe() : impl(std::make_unique<Impl>()) {}
+
+  LatencyProbe::~LatencyProbe() = default;
+
+  void LatencyProbe::OnFrameRendered(uint32_t frame, int64_t time) {
+    auto& record = impl->frames[frame % frameHistory];
+
+    // Invalidate the slot while it's rewritten, so a reader never pairs a frame with the time of
+    // the frame it replaces.
+    record.time.store(-1, std::memory_order_relaxed);
+    record.frame.store(frame, std::memory_order_release);
+    record.time.store(time, std::memory_order_release);
+  }
+
+  void LatencyProbe::OnInputInjected(uint32_t inputCount, int64_t time) {
+    impl->isInputPending    = true;
+    impl->pendingInputCount = inputCount;
+    impl->pendingInputTime  = time;
+  }
+
+  void LatencyProbe::OnFrameObserved(const LatencyPatternPayload& payload, int64_t time) {
+    auto& state = *impl;
+
+    // The counter wraps, so compare by the signed distance between the counts.
+    if (state.isInputPending &&
+        static_cast<int32_t>(payload.inputCount - state.pendingInputCount) > 0) {
+      state.inputToDisplay.Record(time - state.pendingInputTime);
+      state.isInputPending = false;
+    }
+
+    // Only the first capture of a frame measures its latency. Later captures of the same frame
+    // only show how long it stayed on screen.
+    if (state.hasObservedFrame && payload.frame == state.lastObservedFrame) {
+      return;
+    }
+
+    auto distance = static_cast<int32_t>(payload.frame - state.lastObservedFrame);
+    if (state.hasObservedFrame && distance < 0) {
+      // An older frame than the last one, e.g. from a stale capture. It says nothing new.
+      return;
+    }
+
+    if (state.hasObservedFrame && distance > 1) {
+      state.skippedFrames += static_cast<uint64_t>(distance - 1);
+    }
+
+    state.hasObservedFrame  = true;
+    state.lastObservedFrame = payload.frame;
+    state.observedFrames++;
+
+    auto& record  = state.frames[payload.frame % frameHistory];
+    auto rendered = record.time.load(std::memory_order_acquire);
+    if (record.frame.load(std::memory_order_acquire) == payload.frame && rendered >= 0) {
+      state.renderToDisplay.Record(time - rendered);
+    }
+  }
+
+  bool LatencyProbe::IsInputPending() const {
+    return impl->isInputPending;
+  }
+
+  LatencyHistogram& LatencyProbe::GetInputToDisplay() {
+    return impl->inputToDisplay;
+  }
+
+  LatencyHistogram& LatencyProbe::GetRenderToDisplay() {
+    return impl->renderToDisplay;
+  }
+
+  uint64_t LatencyProbe::GetObservedFrames() const {
+    return impl->observedFrames;
+  }
+
+  uint64_t LatencyProbe::GetSkippedFrames() const {
+    return impl->skippedFrames;
+  }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "latency-pattern.h"
+#include "../Downscaler.Cpp.Core/latency-histogram.h"
+
+namespace DiagnosticWindow {
+  /**
+   * @brief Measures end-to-end latency from the patterns decoded out of the downscaler's output.
+   *
+   * The window records when it renders each frame and the probe records when it injects each
+   * mouse move. When a frame is decoded from the output, the time since it was rendered is the
+   * render-to-display latency, which spans the downscaler's capture, processing and presentation.
+   * The first frame that reflects an injected move gives the input-to-display latency.
+   *
+   * `OnFrameRendered` is called from the render thread, while the other members are called from a
+   * single probe thread. All times are in microseconds of the same monotonic clock.
+   */
+  class LatencyProbe {
+    public:
+      LatencyProbe();
+      ~LatencyProbe();
+
+      LatencyProbe(const LatencyProbe&)            = delete;
+      LatencyProbe& operator=(const LatencyProbe&) = delete;
+
+      /**
+       * @brief Records when a frame was rendered.
+       */
+      void OnFrameRendered(uint32_t frame, int64_t time);
+
+      /**
+       * @brief Records that a mouse move was injected. Only one move is tracked at a time; a move
+       * injected before the last one was displayed replaces it.
+       * @param inputCount The number of moves the window had received before the injection.
+       * @param time When the move was injected.
+       */
+      void OnInputInjected(uint32_t inputCount, int64_t time);
+
+      /**
+       * @brief Records a pattern decoded from the output.
+       * @param payload The decoded pattern.
+       * @param time When the output was captured.
+       */
+      void OnFrameObserved(const LatencyPatternPayload& payload, int64_t time);
+
+      /**
+       * @returns Whether an injected move is yet to be displayed.
+       */
+      bool IsInputPending() const;
+
+      /**
+       * @returns The latencies from injecting a move to displaying a frame that reflects it.
+       */
+      Downscaler::Cpp::Core::NativeImpls::LatencyHistogram& GetInputToDisplay();
+
+      /**
+       * @returns The latencies from rendering a frame to displaying it.
+       */
+      Downscaler::Cpp::Core::NativeImpls::LatencyHistogram& GetRenderToDisplay();
+
+      /**
+       * @returns The number of distinct frames decoded from the output.
+       */
+      uint64_t GetObservedFrames() const;
+
+      /**
+       * @returns The number of rendered frames that were never observed between two that were.
+       */
+      uint64_t GetSkippedFrames() const;
+
+    private:
+      struct Impl;
+      std::unique_ptr<Impl> impl;
+  };
+}
@@ -39,6 +39,52 @@ public interface IAppState {
   /// </summary>
   IAppDebugState DebugState { get; set; }
 
+  /// <summary>
+  ///   The refresh rate, in Hz, that presentation of captured frames is paced against. If
+  ///   <c>null</c>, frames are presented as soon as they're captured.
+  /// </summary>
+  double? TargetRefreshRate { get; set; }
+
+  /// <summary>
+  ///   Whether to insert black frames between repeated frames when presentation is paced against
+  ///   <see cref="TargetRefreshRate" />.
+  /// </summary>
+  bool BlackFrameInsertion { get; set; }
+
+  /// <summary>
+  ///   The number of recent frames to blend together after scaling. A value of <c>1</c> disables
+  ///   temporal blending.
+  /// </summary>
+  uint TemporalBlendFrames { get; set; }
+
+  /// <summary>
+  ///   Whether luminance statistics are computed for every scaled frame, which enables black
+  ///   screen detection.
+  /// </summary>
+  bool FrameStatistics { get; set; }
+
+  /// <summary>
+  ///   Whether large frame buffers should be backed by large pages when the OS allows it.
+  /// </summary>
+  bool LargePages { get; set; }
+
+  /// <summary>
+  ///   The maximum number of mouse moves, per second, forwarded to the source window. If
+  ///   <c>null</c>, moves are forwarded at the capture frame rate.
+  /// </summary>
+  double? MouseForwardRate { get; set; }
+
+  /// <summary>
+  ///   Whether clicks, the mouse wheel and the keyboard are forwarded from the downscaled window to
+  ///   the source window.
+  /// </summary>
+  bool ForwardInput { get; set; }
+
+  /// <summary>
+  ///   Whether the mouse is forwarded to where it's predicted to be one capture frame from now.
+  /// </summary>
+  bool CursorPrediction { get; set; }
+
   /// <summary>
   ///   The initial X position of the downscaler window as specified by the user.
   /// </summary>
@@ -23,4 +23,51 @@ public interface IMouseEventService {
   /// <param name="x"> The x-coordinate of the mouse. </param>
   /// <param name="y"> The y-coordinate of the mouse. </param>
   void UpdateMousePosition(int x, int y);
+
+  /// <summary>
+  ///   Updates the mouse position in absolute screen coordinates, along with the relative motion
+  ///   reported by the mouse since the last update. The motion is used to track the mouse in the
+  ///   source window at the source's resolution, which is finer than the downscaled window's.
+  /// </summary>
+  /// <param name="x"> The x-coordinate of the mouse. </param>
+  /// <param name="y"> The y-coordinate of the mouse. </param>
+  /// <param name="deltaX"> The relative horizontal motion, in mouse counts. </param>
+  /// <param name="deltaY"> The relative vertical motion, in mouse counts. </param>
+  void UpdateMousePosition(int x, int y, long deltaX, long deltaY);
+
+  /// <summary>
+  ///   Notifies the service of the measured capture frame rate. Unless a forwarding rate has been
+  ///   configured, mouse moves are forwarded to the source window at this rate, since moves beyond
+  ///   it can't be seen in the downscaled window anyway. Safe to call from any thread.
+  /// </summary>
+  /// <param name="frameRate"> The capture frame rate, in frames per second. </param>
+  void SetCaptureFrameRate(double frameRate);
+
+  /// <summary>
+  ///   Queues a click or mouse wheel message received by the downscaled window, to be forwarded to
+  ///   the source window if input forwarding is enabled. Must be called from the thread of the
+  ///   downscaled window.
+  /// </summary>
+  /// <param name="message"> The message, e.g. <c> WM_LBUTTONDOWN </c>. </param>
+  /// <param name="wParam"> The message's <c> wParam </c>. </param>
+  /// <param name="x"> The x-coordinate of the mouse on the screen. </param>
+  /// <param name="y"> The y-coordinate of the mouse on the screen. </param>
+  void QueueMouseInput(uint message, nuint wParam, int x, int y);
+
+  /// <summary>
+  ///   Queues a keyboard message received by the downscaled window, to be forwarded to the source
+  ///   window if input forwarding is enabled. Must be called from the thread of the downscaled
+  ///   window.
+  /// </summary>
+  /// <param name="message"> The message, e.g. <c> WM_KEYDOWN </c>. </param>
+  /// <param name="wParam"> The message's <c> wParam </c>. </param>
+  /// <param name="lParam"> The message's <c> lParam </c>. </param>
+  void QueueKeyInput(uint message, nuint wParam, nint lParam);
+
+  /// <summary>
+  ///   Forwards the queued input to the source window, in the order it was received. Call this once
+  ///   no more input is waiting to be processed, so a burst of input costs as few messages as
+  ///   possible. Must be called from the thread of the downscaled window.
+  /// </summary>
+  void FlushInput();
 }
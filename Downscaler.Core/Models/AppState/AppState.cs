@@ -177,6 +177,30 @@ public class AppState : IAppState {
     ShowMouseCoordinates = false
   };
 
+  /// <inheritdoc />
+  public double? TargetRefreshRate { get; set; }
+
+  /// <inheritdoc />
+  public bool BlackFrameInsertion { get; set; }
+
+  /// <inheritdoc />
+  public uint TemporalBlendFrames { get; set; } = 1;
+
+  /// <inheritdoc />
+  public bool FrameStatistics { get; set; }
+
+  /// <inheritdoc />
+  public bool LargePages { get; set; }
+
+  /// <inheritdoc />
+  public double? MouseForwardRate { get; set; }
+
+  /// <inheritdoc />
+  public bool ForwardInput { get; set; }
+
+  /// <inheritdoc />
+  public bool CursorPrediction { get; set; }
+
   /// <inheritdoc />
   public int? InitialX { get; set; }
 
@@ -1,201 +1,60 @@
 ﻿using System.Drawing;
-using Core.Utils;
 using Downscaler.Core.Contracts.Models;
-using Downscaler.Core.Contracts.Models.AppState;
+using Downscaler.Cpp.Core;
 
 namespace Downscaler.Core.Models;
 
-public struct MouseCoords : IMouseCoords {
-  private Point?              relativeToDownscaledWindow;
-  private Point?              relativeToSourceWindow;
-  private (float X, float Y)? relativeToDownscaledWindowPercent;
-  private (float X, float Y)? relativeToSourceWindowPercent;
-  private bool?               isWithinDownscaledWindow;
-  private bool?               isWithinSourceWindow;
+/// <summary>
+///   The coordinates of the mouse in every coordinate space, as mapped by a
+///   <see cref="CoordinateMapper" />. All values are computed up front by the mapper, which only
+///   queries the windows after they move or are resized, so reading them is free.
+/// </summary>
+public readonly struct MouseCoords : IMouseCoords {
+  private readonly MappedPoint mapped;
+
 
-  // ReSharper disable once InconsistentNaming
   /// <summary>
-  ///   The application state. This is used to obtain the source window and the downscaled window.
-  ///   This should be set, indirectly, by the application's DI container - through a service that
-  ///   handles mouse events.
+  ///   Instantiates a new <c> MouseCoords </c>.
   /// </summary>
-  internal static IAppState? AppState;
-
-
-  public MouseCoords(Point absolutePosition) {
-    Absolute = absolutePosition;
+  /// <param name="absolutePosition"> The position of the mouse on the screen. </param>
+  /// <param name="mapped"> The position of the mouse mapped into the space of each window. </param>
+  public MouseCoords(Point absolutePosition, MappedPoint mapped = default) {
+    Absolute    = absolutePosition;
+    this.mapped = mapped;
   }
 
 
   /// <inheritdoc />
   public Point Absolute { get; }
 
-  /// <inheritdoc />
-  public Point RelativeToDownscaledWindow {
-    get {
-      // If we already have the relative position, return it.
-      if (this.relativeToDownscaledWindow is not null) {
-        return (Point)this.relativeToDownscaledWindow;
-      }
-
-      // If AppState is null, throw an exception. AppState should be set, indirectly, by the
-      // application's DI container.
-      if (AppState is null) {
-        throw new InvalidOperationException(
-          "AppState is was not set. Unable to obtain the state of the application."
-        );
-      }
-
-      // Get the coordinates of the downscaled window.
-      var downscaledWindow   = AppState.DownscaleWindow;
-      var absoluteClientRect = downscaledWindow.GetAbsoluteClientRect();
-
-      // Calculate the relative position of the mouse to the downscaled window.
-      var relativeToDownscaledWindow = new Point(
-        Absolute.X - absoluteClientRect.left,
-        Absolute.Y - absoluteClientRect.top
-      );
-      return this.relativeToDownscaledWindow ??= relativeToDownscaledWindow;
-    }
-  }
+  /// <summary>
+  ///   The position of the mouse mapped into the space of each window, as given by the mapper.
+  /// </summary>
+  public MappedPoint Mapped => mapped;
 
   /// <inheritdoc />
-  public Point RelativeToSourceWindow {
-    get {
-      // If we already have the relative position, return it.
-      if (relativeToSourceWindow is not null) {
-        return (Point)relativeToSourceWindow;
-      }
-
-      // If AppState is null, throw an exception. AppState should be set, indirectly, by the
-      // application's DI container.
-      if (AppState is null) {
-        throw new InvalidOperationException(
-          "AppState is was not set. Unable to obtain the state of the application."
-        );
-      }
-
-      // Get the source window.
-      var sourceWindow = AppState.WindowToScale;
-
-      // Calculate the scale factors to scale the coordinates of the mouse to the source window.
-      var scaleFactorX = (double)sourceWindow.GetClientWidth() /
-                         AppState.DownscaleWindow.GetClientWidth();
-      var scaleFactorY = (double)sourceWindow.GetClientHeight() /
-                         AppState.DownscaleWindow.GetClientHeight();
-
-      return relativeToSourceWindow ??= new Point(
-               (int)(RelativeToDownscaledWindow.X * scaleFactorX),
-               (int)(RelativeToDownscaledWindow.Y * scaleFactorY)
-             );
-    }
-  }
+  public Point RelativeToDownscaledWindow => new(mapped.DownscaledX, mapped.DownscaledY);
 
   /// <inheritdoc />
-  public (float X, float Y) RelativeToDownscaledWindowPercent {
-    get {
-      // If we already have the relative position, return it.
-      if (this.relativeToDownscaledWindowPercent is not null) {
-        return ((float X, float Y))this.relativeToDownscaledWindowPercent;
-      }
+  public Point RelativeToSourceWindow => new(mapped.SourceX, mapped.SourceY);
 
-      // If AppState is null, throw an exception. AppState should be set, indirectly, by the
-      // application's DI container.
-      if (AppState is null) {
-        throw new InvalidOperationException(
-          "AppState is was not set. Unable to obtain the state of the application."
-        );
-      }
-
-      // Get the coordinates of the downscaled window.
-      var downscaledWindow = AppState.DownscaleWindow;
-
-      // Calculate the relative position of the mouse to the downscaled window.
-      var relativeToDownscaledWindow = RelativeToDownscaledWindow;
-      var relativeToDownscaledWindowPercent =
-        (
-          (float)relativeToDownscaledWindow.X / downscaledWindow.GetClientWidth(),
-          (float)relativeToDownscaledWindow.Y / downscaledWindow.GetClientHeight()
-        );
-      return this.relativeToDownscaledWindowPercent ??= relativeToDownscaledWindowPercent;
-    }
-  }
+  /// <summary>
+  ///   The mouse position relative to the outer edge of the source window, including its chrome.
+  ///   This is the position that is forwarded to the source window.
+  /// </summary>
+  public Point RelativeToSourceWindowFrame => new(mapped.SourceWindowX, mapped.SourceWindowY);
 
   /// <inheritdoc />
-  public (float X, float Y) RelativeToSourceWindowPercent {
-    get {
-      // If we already have the relative position, return it.
-      if (this.relativeToSourceWindowPercent is not null) {
-        return ((float X, float Y))this.relativeToSourceWindowPercent;
-      }
-
-      // If AppState is null, throw an exception. AppState should be set, indirectly, by the
-      // application's DI container.
-      if (AppState is null) {
-        throw new InvalidOperationException(
-          "AppState is was not set. Unable to obtain the state of the application."
-        );
-      }
-
-      // Get the coordinates of the downscaled window.
-      var sourceWindow = AppState.WindowToScale;
-
-      // Calculate the relative position of the mouse to the downscaled window.
-      var relativeToSourceWindow = RelativeToSourceWindow;
-      var relativeToSourceWindowPercent =
-        (
-          (float)relativeToSourceWindow.X / sourceWindow.GetClientWidth(),
-          (float)relativeToSourceWindow.Y / sourceWindow.GetClientHeight()
-        );
-      return this.relativeToSourceWindowPercent ??= relativeToSourceWindowPercent;
-    }
-  }
+  public (float X, float Y) RelativeToDownscaledWindowPercent =>
+    (mapped.DownscaledPercentX, mapped.DownscaledPercentY);
 
   /// <inheritdoc />
-  public bool IsWithinDownscaledWindow {
-    get {
-      // If we've already calculated whether the mouse is within the downscaled window, return the
-      // result.
-      if (isWithinDownscaledWindow is not null) {
-        return (bool)isWithinDownscaledWindow;
-      }
-
-      // If AppState is null, throw an exception. AppState should be set, indirectly, by the
-      // application's DI container.
-      if (AppState is null) {
-        throw new InvalidOperationException(
-          "AppState is was not set. Unable to obtain the state of the application."
-        );
-      }
-
-      // Get the coordinates of the downscaled window.
-      var downscaledWindow   = AppState.DownscaleWindow;
-      var absoluteClientRect = downscaledWindow.GetAbsoluteClientRect();
-      return isWithinDownscaledWindow ??= absoluteClientRect.Contains(Absolute);
-    }
-  }
+  public (float X, float Y) RelativeToSourceWindowPercent =>
+    (mapped.SourcePercentX, mapped.SourcePercentY);
 
   /// <inheritdoc />
-  public bool IsWithinSourceWindow {
-    get {
-      // If we've already calculated whether the mouse is within the source window, return the
-      // result.
-      if (isWithinSourceWindow is not null) {
-        return (bool)isWithinSourceWindow;
-      }
+  public bool IsWithinDownscaledWindow => mapped.IsWithinDownscaledWindow;
 
-      // If AppState is null, throw an exception. AppState should be set, indirectly, by the
-      // application's DI container.
-      if (AppState is null) {
-        throw new InvalidOperationException(
-          "AppState is was not set. Unable to obtain the state of the application."
-        );
-      }
-
-      // Get the coordinates of the source window.
-      var sourceWindow       = AppState.WindowToScale;
-      var absoluteClientRect = sourceWindow.GetAbsoluteClientRect();
-      return isWithinSourceWindow ??= absoluteClientRect.Contains(Absolute);
-    }
-  }
+  /// <inheritdoc />
+  public bool IsWithinSourceWindow => mapped.IsWithinSourceWindow;
 }
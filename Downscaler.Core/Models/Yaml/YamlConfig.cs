@@ -30,6 +30,30 @@ public class YamlConfig : IYamlConfig {
   /// <inheritdoc />
   public int? ScaleHeight { get; set; }
 
+  /// <inheritdoc />
+  public double? TargetRefreshRate { get; set; }
+
+  /// <inheritdoc />
+  public bool? BlackFrameInsertion { get; set; }
+
+  /// <inheritdoc />
+  public int? TemporalBlendFrames { get; set; }
+
+  /// <inheritdoc />
+  public bool? FrameStatistics { get; set; }
+
+  /// <inheritdoc />
+  public bool? LargePages { get; set; }
+
+  /// <inheritdoc />
+  public double? MouseForwardRate { get; set; }
+
+  /// <inheritdoc />
+  public bool? ForwardInput { get; set; }
+
+  /// <inheritdoc />
+  public bool? CursorPrediction { get; set; }
+
   /// <inheritdoc />
   public IDebugConfig? Debug { get; set; }
 }
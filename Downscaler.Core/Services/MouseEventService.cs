@@ -1,11 +1,13 @@
-﻿using System.Diagnostics;
-using System.Drawing;
+﻿using System.Drawing;
+using Windows.Win32.Foundation;
 using Windows.Win32.System.SystemServices;
+using Core.Models;
 using Core.Utils;
 using Downscaler.Core.Contracts.Models;
 using Downscaler.Core.Contracts.Models.AppState;
 using Downscaler.Core.Contracts.Services;
 using Downscaler.Core.Models;
+using Downscaler.Cpp.Core;
 using static Core.Utils.Macros;
 using static Windows.Win32.PInvoke;
 
@@ -15,10 +17,62 @@ public class MouseEventService : IMouseEventService {
   private readonly IAppState AppState;
 
   /// <summary>
-  ///   The stopwatch monitoring the time since the last mouse event. Used to throttle the mouse
-  ///   events that are forwarded to the source window.
+  ///   The rate, in moves per second, that mouse moves are forwarded at until the capture frame
+  ///   rate is known.
   /// </summary>
-  private readonly Stopwatch lastEventTimer = new();
+  private const double DefaultForwardRate = 60;
+
+  /// <summary>
+  ///   Rate-limits the mouse moves that are forwarded to the source window. Created on the first
+  ///   move, once the configured forwarding rate is known.
+  /// </summary>
+  private MouseMoveCoalescer? moveCoalescer;
+
+  /// <summary>
+  ///   The most recently measured capture frame rate. Mouse moves are forwarded at this rate unless
+  ///   a forwarding rate has been configured.
+  /// </summary>
+  private double captureFrameRate = DefaultForwardRate;
+
+  /// <summary>
+  ///   Guards <see cref="coordinateMapper" /> while it's shared between the input thread and the
+  ///   thread that forwards held back mouse moves.
+  /// </summary>
+  private readonly object mapperLock = new();
+
+  /// <summary>
+  ///   Serializes reading the position to forward with posting it. Moves are forwarded from the
+  ///   input thread, the flush thread and the rest timer, so without it an older position could be
+  ///   posted after a newer one and leave the source window's cursor behind. Taken before
+  ///   <see cref="mapperLock" /> and <see cref="childWindowIndexLock" />.
+  /// </summary>
+  private readonly object forwardLock = new();
+
+  /// <summary>
+  ///   Refines the mapped mouse position with the relative motion reported by the mouse, so the
+  ///   source window receives positions at its own resolution rather than in steps of the
+  ///   downscale factor.
+  /// </summary>
+  private readonly SubPixelAccumulator subPixelAccumulator = new();
+
+  /// <summary>
+  ///   How long after the last predicted move the mouse's actual position is forwarded, so the
+  ///   source always ends up where the mouse came to rest. Just longer than the predictor waits
+  ///   for the mouse to report motion before considering it at rest.
+  /// </summary>
+  private const int RestDelayMilliseconds = 25;
+
+  /// <summary>
+  ///   Predicts where the mouse will be once the frame the source renders for a move is shown, if
+  ///   cursor prediction is enabled. Guarded by <see cref="mapperLock" />.
+  /// </summary>
+  private readonly CursorPredictor cursorPredictor = new();
+
+  /// <summary>
+  ///   Forwards the mouse's actual position once predicted moves stop, since the last prediction
+  ///   usually overshoots where the mouse stopped.
+  /// </summary>
+  private Timer? restTimer;
 
   /// <summary>
   ///   Represents the current known state of the mouse buttons along with certain other modifier
@@ -26,8 +80,65 @@ public class MouseEventService : IMouseEventService {
   /// </summary>
   private MODIFIERKEYS_FLAGS mouseButtonState = 0;
 
+  /// <summary>
+  ///   Maps the mouse position from the downscaled window onto the source window. Its transform is
+  ///   recomputed only after either window moves, is resized or changes DPI.
+  /// </summary>
+  private readonly CoordinateMapper coordinateMapper = new();
+
+  /// <summary>
+  ///   Stops watching the windows that <see cref="coordinateMapper" /> was computed from.
+  /// </summary>
+  private CancellationTokenSource? windowWatch;
+
+  /// <summary>
+  ///   The windows that <see cref="coordinateMapper" /> is currently watching.
+  /// </summary>
+  private (HWND Source, HWND Downscaled) watchedWindows;
+
+  /// <summary>
+  ///   Answers which child windows of the source window the mouse is within. It's rebuilt only
+  ///   after a child window is created, destroyed, shown, hidden or moved.
+  /// </summary>
+  private readonly ChildWindowIndex childWindowIndex = new();
+
+  /// <summary>
+  ///   Guards <see cref="childWindowIndex" /> and the buffers used to build and query it, which
+  ///   are shared between the input thread and the flush thread.
+  /// </summary>
+  private readonly object childWindowIndexLock = new();
+
+  /// <summary>
+  ///   The client areas of the child windows, reused between rebuilds of the index.
+  /// </summary>
+  private ChildWindowRect[] childWindowRects = new ChildWindowRect[16];
+
+  /// <summary>
+  ///   Receives the child windows that the mouse is within.
+  /// </summary>
+  private readonly ChildWindowHit[] childWindowHits = new ChildWindowHit[16];
+
+  /// <summary>
+  ///   The child windows in <see cref="childWindowIndex" />. Replaced as a whole when the index is
+  ///   rebuilt, so the window event hook can read it without locking. Destroyed windows are no
+  ///   longer children of the source window, so this is how their events are recognised.
+  /// </summary>
+  private volatile HashSet<HWND> indexedChildWindows = [];
+
+  /// <summary>
+  ///   Routes the clicks, mouse wheel and keyboard input received by the downscaled window to the
+  ///   source window and its children. Only used from the thread of the downscaled window.
+  /// </summary>
+  private readonly InputForwarder inputForwarder = new();
+
+  /// <summary>
+  ///   The most recent mouse coordinates, kept unboxed so forwarding can read the mapped position
+  ///   of the mouse in the source window's frame.
+  /// </summary>
+  private MouseCoords currentMouseCoords;
+
   /// <inheritdoc />
-  public IMouseCoords CurrentMouseCoords { get; private set; }
+  public IMouseCoords CurrentMouseCoords => currentMouseCoords;
 
   /// <inheritdoc />
   public event EventHandler<IMouseCoords>? MouseMoved;
@@ -35,74 +146,343 @@ public class MouseEventService : IMouseEventService {
 
   public MouseEventService(IAppState appState) {
     AppState           = appState;
-    CurrentMouseCoords = new MouseCoords(new Point(0, 0));
-    // The MouseCoords struct requires the AppState to be set. This is a bit of a hack, but it's
-    // necessary because otherwise there is no way for the MouseCoords struct to obtain the
-    // application state and, thereby, the source and downscaled windows. Having these calculations
-    // happen within the struct, through getters, allows us to only perform the calculations when
-    // they're actually needed. This is a performance optimization.
-    MouseCoords.AppState = appState;
-    lastEventTimer.Start();
+    currentMouseCoords = new MouseCoords(new Point(0, 0));
   }
 
 
   /// <inheritdoc />
   public void UpdateMousePosition(int x, int y) {
-    CurrentMouseCoords = new MouseCoords(new Point(x, y));
-    ForwardMouseEventToSourceWindow();
+    UpdateMousePosition(x, y, null);
+  }
+
+
+  /// <inheritdoc />
+  public void UpdateMousePosition(int x, int y, long deltaX, long deltaY) {
+    UpdateMousePosition(x, y, (deltaX, deltaY));
+  }
+
+
+  /// <summary>
+  ///   Updates the mouse position, refining it with the relative motion of the mouse if known.
+  /// </summary>
+  private void UpdateMousePosition(int x, int y, (long X, long Y)? delta) {
+    EnsureCoordinateMapper();
+
+    lock (mapperLock) {
+      var mapped = coordinateMapper.Map(x, y);
+
+      // Without relative motion, e.g. for a pen or touch, there's nothing to refine the position
+      // with, so start over from the cursor the next time there is.
+      if (delta is { } motion) {
+        mapped = subPixelAccumulator.Refine(coordinateMapper, mapped, motion.X, motion.Y);
+      } else {
+        subPixelAccumulator.Reset();
+      }
+
+      currentMouseCoords = new MouseCoords(new Point(x, y), mapped);
+
+      if (AppState.CursorPrediction) {
+        cursorPredictor.AddSample(mapped);
+      }
+    }
+
+    // Forward the move straight away if the forwarding interval has elapsed. Otherwise, it's held
+    // back and forwarded by the flush thread, unless a newer move replaces it first.
+    if (EnsureMoveCoalescer().Submit(x, y)) {
+      ForwardLatestMove();
+    }
+
     MouseMoved?.Invoke(this, CurrentMouseCoords);
   }
 
 
-  private void ForwardMouseEventToSourceWindow() {
-    // Throttle the mouse events that are forwarded to the source window to 60 events per second.
-    if (lastEventTimer.ElapsedMilliseconds < 16) {
+  /// <inheritdoc />
+  public void SetCaptureFrameRate(double frameRate) {
+    if (frameRate <= 0) {
+      return;
+    }
+
+    captureFrameRate = frameRate;
+
+    // A configured forwarding rate takes precedence over the capture frame rate.
+    if (AppState.MouseForwardRate == null && moveCoalescer != null) {
+      moveCoalescer.Rate = frameRate;
+    }
+  }
+
+
+  /// <inheritdoc />
+  public void QueueMouseInput(uint message, nuint wParam, int x, int y) {
+    if (!AppState.ForwardInput) {
       return;
     }
 
-    lastEventTimer.Restart();
+    EnsureCoordinateMapper();
+
+    var sourceWindow = AppState.WindowToScale;
+    inputForwarder.SetSourceWindow(sourceWindow.Hwnd);
+
+    // Both the mapper and the child window index are shared with the flush thread.
+    lock (mapperLock) {
+      lock (childWindowIndexLock) {
+        EnsureChildWindowIndex(sourceWindow);
+        inputForwarder.QueueMouse(message, wParam, x, y, coordinateMapper, childWindowIndex);
+      }
+    }
+  }
+
 
+  /// <inheritdoc />
+  public void QueueKeyInput(uint message, nuint wParam, nint lParam) {
+    if (!AppState.ForwardInput) {
+      return;
+    }
+
+    inputForwarder.SetSourceWindow(AppState.WindowToScale.Hwnd);
+    inputForwarder.QueueKey(message, wParam, lParam);
+  }
+
+
+  /// <inheritdoc />
+  public void FlushInput() {
+    if (inputForwarder.PendingCount > 0) {
+      inputForwarder.Flush();
+    }
+  }
+
+
+  /// <summary>
+  ///   Creates the mouse move coalescer, along with the thread that forwards the moves it holds
+  ///   back, if they don't exist yet.
+  /// </summary>
+  private MouseMoveCoalescer EnsureMoveCoalescer() {
+    if (moveCoalescer != null) {
+      return moveCoalescer;
+    }
+
+    moveCoalescer = new MouseMoveCoalescer(AppState.MouseForwardRate ?? captureFrameRate);
+
+    var flushThread = new Thread(FlushTrailingMoves) {
+      IsBackground = true,
+      Name         = "Downscaler Mouse Flush Thread",
+      Priority     = ThreadPriority.AboveNormal
+    };
+    flushThread.Start(moveCoalescer);
+
+    return moveCoalescer;
+  }
+
+
+  /// <summary>
+  ///   Forwards every mouse move that was held back once its interval elapses, so the position the
+  ///   mouse comes to rest at always reaches the source window.
+  /// </summary>
+  private void FlushTrailingMoves(object? coalescer) {
+    var moves = (MouseMoveCoalescer)coalescer!;
+
+    while (moves.WaitForTrailingMove(out _, out _)) {
+      // The held back move is always the latest one, so forward the latest coordinates, which keep
+      // the sub-pixel precision that mapping the cursor position again would lose.
+      ForwardLatestMove();
+    }
+  }
+
+
+  /// <summary>
+  ///   Forwards the latest move to the source window.
+  /// </summary>
+  private void ForwardLatestMove() {
+    lock (forwardLock) {
+      ForwardMouseEventToSourceWindow(GetForwardedMouseCoords());
+    }
+  }
+
+
+  /// <summary>
+  ///   Gets the coordinates to forward for the latest move: where the mouse is, or if cursor
+  ///   prediction is enabled, where it's predicted to be one capture frame from now.
+  /// </summary>
+  private MouseCoords GetForwardedMouseCoords() {
+    lock (mapperLock) {
+      if (!AppState.CursorPrediction) {
+        return currentMouseCoords;
+      }
+
+      var actual    = currentMouseCoords.Mapped;
+      var horizon   = (long)(1_000_000 / captureFrameRate);
+      var predicted = cursorPredictor.Predict(coordinateMapper, actual, horizon);
+
+      if (predicted.SourceX == actual.SourceX && predicted.SourceY == actual.SourceY) {
+        return currentMouseCoords;
+      }
+
+      // (Re)start the countdown to forwarding where the mouse actually comes to rest.
+      restTimer ??= new Timer(_ => ForwardRestingPosition());
+      restTimer.Change(RestDelayMilliseconds, Timeout.Infinite);
+
+      return new MouseCoords(currentMouseCoords.Absolute, predicted);
+    }
+  }
+
+
+  /// <summary>
+  ///   Forwards the actual position of the mouse, replacing the last predicted one.
+  /// </summary>
+  private void ForwardRestingPosition() {
+    lock (forwardLock) {
+      MouseCoords coords;
+      lock (mapperLock) {
+        coords = currentMouseCoords;
+      }
+
+      ForwardMouseEventToSourceWindow(coords);
+    }
+  }
+
+
+  /// <summary>
+  ///   Ensures that the coordinate mapper reflects the current geometry of the source and
+  ///   downscaled windows. The windows are only queried if one of them has changed since the last
+  ///   call.
+  /// </summary>
+  private void EnsureCoordinateMapper() {
+    var sourceWindow     = AppState.WindowToScale;
+    var downscaledWindow = AppState.DownscaleWindow;
+
+    // Start watching the windows the first time round, or if either of them has been replaced.
+    if (watchedWindows != (sourceWindow.Hwnd, downscaledWindow.Hwnd)) {
+      windowWatch?.Cancel();
+      windowWatch    = new CancellationTokenSource();
+      watchedWindows = (sourceWindow.Hwnd, downscaledWindow.Hwnd);
+      coordinateMapper.Invalidate();
+      childWindowIndex.Invalidate();
+
+      var (sourceHwnd, downscaledHwnd) = watchedWindows;
+      _ = WinEventAwaiter.WatchEvents(
+        [WinEvent.EVENT_OBJECT_LOCATIONCHANGE],
+        hwnd => hwnd == sourceHwnd || hwnd == downscaledHwnd,
+        _ => coordinateMapper.Invalidate(),
+        windowWatch.Token
+      );
+      _ = WinEventAwaiter.WatchEvents(
+        [
+          WinEvent.EVENT_OBJECT_CREATE,
+          WinEvent.EVENT_OBJECT_DESTROY,
+          WinEvent.EVENT_OBJECT_SHOW,
+          WinEvent.EVENT_OBJECT_HIDE,
+          WinEvent.EVENT_OBJECT_LOCATIONCHANGE
+        ],
+        hwnd => indexedChildWindows.Contains(hwnd) || IsChild(sourceHwnd, hwnd),
+        _ => childWindowIndex.Invalidate(),
+        windowWatch.Token
+      );
+    }
+
+    if (coordinateMapper.IsValid) {
+      return;
+    }
+
+    var downscaledClient = downscaledWindow.GetAbsoluteClientRect();
+    var sourceClient     = sourceWindow.GetAbsoluteClientRect();
+    var sourceInset      = sourceWindow.GetClientRectRelativeToWindow();
+
+    var downscaledWidth  = downscaledWindow.GetClientWidth();
+    var downscaledHeight = downscaledWindow.GetClientHeight();
+    var sourceWidth      = sourceWindow.GetClientWidth();
+    var sourceHeight     = sourceWindow.GetClientHeight();
+
+    lock (mapperLock) {
+      coordinateMapper.Update(
+        downscaledClient.left,
+        downscaledClient.top,
+        downscaledWidth,
+        downscaledHeight,
+        sourceClient.left,
+        sourceClient.top,
+        sourceWidth,
+        sourceHeight,
+        sourceInset.left,
+        sourceInset.top
+      );
+    }
+  }
+
+
+  /// <summary>
+  ///   Posts a mouse move to the source window, and to any of its child windows that the mouse is
+  ///   within. Must be called with <see cref="forwardLock" /> held.
+  /// </summary>
+  /// <param name="mouseCoords"> The position of the mouse to forward. </param>
+  private void ForwardMouseEventToSourceWindow(MouseCoords mouseCoords) {
     // If the mouse is not within the downscaled window, don't forward the event.
-    if (!CurrentMouseCoords.IsWithinDownscaledWindow) {
+    if (!mouseCoords.IsWithinDownscaledWindow) {
       return;
     }
 
-    var sourceWindow       = AppState.WindowToScale;
-    var sourceWindowAbsPos = sourceWindow.GetAbsoluteClientRect();
-    var mouseInset         = sourceWindow.GetClientRectRelativeToWindow();
-    var x                  = CurrentMouseCoords.RelativeToSourceWindow.X + mouseInset.left;
-    var y                  = CurrentMouseCoords.RelativeToSourceWindow.Y + mouseInset.top;
-    var lparam             = MAKELPARAM(x, y);
+    var sourceWindow = AppState.WindowToScale;
+    var sourceFrame  = mouseCoords.RelativeToSourceWindowFrame;
+    var lparam       = MAKELPARAM(sourceFrame.X, sourceFrame.Y);
 
     PostMessage(sourceWindow.Hwnd, (uint)Msg.WM_MOUSEMOVE, 0, lparam);
 
-    // Forward the event to any child window that the mouse is within.
-    foreach (var child in sourceWindow.Children()) {
-      var childMouseInset = child.GetAbsoluteClientRect();
+    // Forward the event to any child window that the mouse is within. The hits are in coordinates
+    // relative to the top-left corner of the child window, as the child expects.
+    lock (childWindowIndexLock) {
+      EnsureChildWindowIndex(sourceWindow);
 
-      var childOffsetFromParent = new Point {
-        X = childMouseInset.left - sourceWindowAbsPos.left,
-        Y = childMouseInset.top - sourceWindowAbsPos.top
-      };
+      var hitCount = childWindowIndex.HitTest(
+        mouseCoords.RelativeToSourceWindow.X,
+        mouseCoords.RelativeToSourceWindow.Y,
+        childWindowHits
+      );
+
+      for (var i = 0; i < hitCount; i++) {
+        var hit         = childWindowHits[i];
+        var childLparam = MAKELPARAM(hit.X, hit.Y);
 
-      // The mouse position needs to be in coordinates relation to the top-left corner of the child
-      // window.
-      var childX = CurrentMouseCoords.RelativeToSourceWindow.X +
-                   childOffsetFromParent.X;
-      var childY = CurrentMouseCoords.RelativeToSourceWindow.Y +
-                   childOffsetFromParent.Y;
-
-      // If the mouse is not within the child window, don't forward the event.
-      if (childX < 0 ||
-          childY < 0 ||
-          childX > childMouseInset.right ||
-          childY > childMouseInset.bottom) {
-        continue;
+        PostMessage((HWND)hit.Handle, (uint)Msg.WM_MOUSEMOVE, 0, childLparam);
       }
+    }
+  }
+
 
-      var childLparam = MAKELPARAM(childX, childY);
+  /// <summary>
+  ///   Ensures that the child window index reflects the current child windows of the source window.
+  ///   The children are only enumerated if one of them has changed since the index was built. Must
+  ///   be called with <see cref="childWindowIndexLock" /> held.
+  /// </summary>
+  /// <param name="sourceWindow"> The source window whose children are indexed. </param>
+  private void EnsureChildWindowIndex(Win32Window sourceWindow) {
+    if (childWindowIndex.IsValid) {
+      return;
+    }
+
+    var sourceClient = sourceWindow.GetAbsoluteClientRect();
+    var children     = new HashSet<HWND>();
+    var count        = 0;
 
-      PostMessage(child.Hwnd, (uint)Msg.WM_MOUSEMOVE, 0, childLparam);
+    foreach (var child in sourceWindow.Children()) {
+      // Index the client area of the child relative to the client area of the source window,
+      // which is the space the mouse position is mapped into.
+      var childClient = child.GetAbsoluteClientRect();
+      var left        = childClient.left - sourceClient.left;
+      var top         = childClient.top - sourceClient.top;
+
+      if (count == childWindowRects.Length) {
+        Array.Resize(ref childWindowRects, count * 2);
+      }
+
+      childWindowRects[count++] = new ChildWindowRect {
+        Handle = child.Hwnd,
+        Left   = left,
+        Top    = top,
+        Right  = left + child.GetClientWidth(),
+        Bottom = top + child.GetClientHeight()
+      };
+      children.Add(child.Hwnd);
     }
+
+    childWindowIndex.Update(childWindowRects, count);
+    indexedChildWindows = children;
   }
 }
@@ -4,11 +4,13 @@ using System.Runtime.CompilerServices;
 using System.Runtime.InteropServices;
 using Windows.Win32.Foundation;
 using Windows.Win32.UI.Input;
+using Windows.Win32.UI.Input.KeyboardAndMouse;
 using Windows.Win32.UI.Shell;
 using Windows.Win32.UI.WindowsAndMessaging;
 using Core.Utils;
 using Downscaler.Core.Contracts.Models.AppState;
 using Downscaler.Core.Contracts.Services;
+using Downscaler.Cpp.Core;
 using static Windows.Win32.PInvoke;
 using static Core.Utils.Macros;
 using static Core.Utils.NativeUtils;
@@ -20,17 +22,10 @@ public class WindowEventHandlerService : IWindowEventHandlerService {
   private static readonly HOOKPROC MouseHookProcInstance = MouseHookProc;
 
   /// <summary>
-  ///   The buffer used to store the raw input data. Points to a buffer allocated with
-  ///   <see cref="RAWINPUT" /> structures.
+  ///   Reads the raw input from the mouse in batches, coalescing every report queued since the last
+  ///   <c> WM_INPUT </c> message into a single update.
   /// </summary>
-  private static nint rawInputBuffer = nint.Zero;
-
-  /// <summary>
-  ///   The size of the buffer used to store the raw input data. This is the size of the buffer
-  ///   allocated with <see cref="RAWINPUT" /> structures. If the buffer size needs to be increased,
-  ///   the buffer will be reallocated.
-  /// </summary>
-  private static uint rawInputBufferSize;
+  private static RawInputReader? rawInputReader;
 
   private static IAppState?          AppState;
   private static IMouseEventService? MouseEventService;
@@ -64,10 +59,8 @@ public class WindowEventHandlerService : IWindowEventHandlerService {
   /// </summary>
   public void CleanUp() {
     if (!isInitialized) return;
-    if (rawInputBuffer != nint.Zero) {
-      Marshal.FreeHGlobal(rawInputBuffer);
-      rawInputBuffer = nint.Zero;
-    }
+    rawInputReader?.Dispose();
+    rawInputReader = null;
   }
 
 
@@ -120,27 +113,6 @@ public class WindowEventHandlerService : IWindowEventHandlerService {
   }
 
 
-  /// <summary>
-  ///   Allocates a buffer for raw input data. If the buffer already exists, it will be freed and a
-  ///   new buffer will be allocated if the requested size is larger than the current buffer size.
-  /// </summary>
-  /// <param name="size"> The required size of the buffer. </param>
-  [MethodImpl(MethodImplOptions.AggressiveInlining)]
-  private static void EnsureRawInputBufferSize(uint size) {
-    if (rawInputBuffer == nullptr ||
-        rawInputBufferSize < size) {
-      if (rawInputBuffer != nint.Zero) {
-        Console.WriteLine("Freeing previous buffer.");
-        Marshal.FreeHGlobal(rawInputBuffer); // Free previous buffer if it exists
-      }
-
-      Console.WriteLine($"Allocating new buffer of size: {size}");
-      rawInputBuffer     = Marshal.AllocHGlobal((int)size); // Allocate new buffer
-      rawInputBufferSize = size;
-    }
-  }
-
-
   private static LRESULT MouseHookProc(int nCode, WPARAM wParam, LPARAM lParam) {
     if (nCode >= 0) {
       Console.WriteLine($"Mouse hook called with nCode: {nCode}");
@@ -156,43 +128,32 @@ public class WindowEventHandlerService : IWindowEventHandlerService {
 
 
   [MethodImpl(MethodImplOptions.AggressiveInlining)]
-  private static unsafe void ProcessRawInput(LPARAM lParam) {
-    uint sizeNeeded = 0;
-
-    // First call to GetRawInputData: retrieves the size of the data.
-    GetRawInputData(
-      new HRAWINPUT(lParam),
-      RAW_INPUT_DATA_COMMAND_FLAGS.RID_INPUT,
-      (void*)0,
-      ref sizeNeeded,
-      (uint)sizeof(RAWINPUTHEADER)
-    );
-
-    EnsureRawInputBufferSize(sizeNeeded); // Ensure the buffer is large enough for the data
-
-    // If there is data in the buffer, process it.
-    if (sizeNeeded > 0) {
-      // Second call to GetRawInputData: retrieves the data and stores it in the buffer.
-      if (GetRawInputData(
-            new HRAWINPUT(lParam),
-            RAW_INPUT_DATA_COMMAND_FLAGS.RID_INPUT,
-            (void*)rawInputBuffer,
-            ref sizeNeeded,
-            (uint)sizeof(RAWINPUTHEADER)
-          ) ==
-          sizeNeeded) {
-        // Get the raw input data from the buffer as a RAWINPUT struct.
-        var rawInput = (RAWINPUT*)rawInputBuffer.ToPointer();
-
-        if (rawInput -> header.dwType == (uint)RawInputMethod.RIM_TYPEMOUSE) {
-          // var xPosRelative = rawInput -> data.mouse.lLastX;
-          // var yPosRelative = rawInput -> data.mouse.lLastY;
-
-          var absolutePos = GetMousePosition();
-          // Signal to the mouse event service that the mouse position has been updated.
-          MouseEventService?.UpdateMousePosition(absolutePos.X, absolutePos.Y);
-        }
-      }
+  private static void ProcessRawInput(LPARAM lParam) {
+    if (rawInputReader is null) {
+      return;
+    }
+
+    // Drain every report that has queued up since the last message in one go.
+    var batch = rawInputReader.Read(lParam);
+
+    // The cursor position is only queried once per batch, and only if the mouse actually moved.
+    if (!batch.HasMotion) {
+      return;
+    }
+
+    var absolutePos = GetMousePosition();
+
+    // Signal to the mouse event service that the mouse position has been updated. Relative motion
+    // lets it place the mouse in the source window more precisely than the cursor position can.
+    if (batch.HasAbsolutePosition) {
+      MouseEventService?.UpdateMousePosition(absolutePos.X, absolutePos.Y);
+    } else {
+      MouseEventService?.UpdateMousePosition(
+        absolutePos.X,
+        absolutePos.Y,
+        batch.DeltaX,
+        batch.DeltaY
+      );
     }
   }
 
@@ -220,12 +181,81 @@ public class WindowEventHandlerService : IWindowEventHandlerService {
       case Msg.WM_INPUT:
         ProcessRawInput(lParam);
         break;
+      case >= Msg.WM_LBUTTONDOWN and <= Msg.WM_MOUSEHWHEEL when AppState?.ForwardInput == true:
+        ForwardMouseInput(hWnd, msg, wParam, lParam);
+        break;
+      case >= Msg.WM_KEYDOWN and <= Msg.WM_SYSDEADCHAR when AppState?.ForwardInput == true:
+        if (IsSystemCommandKey(message, wParam)) {
+          break;
+        }
+
+        MouseEventService?.QueueKeyInput(msg, wParam, lParam);
+        FlushInputIfIdle(hWnd);
+        break;
     }
 
     return DefSubclassProc(hWnd, msg, wParam, lParam);
   }
 
 
+  /// <summary>
+  ///   Queues a click or mouse wheel message for forwarding to the source window.
+  /// </summary>
+  private static void ForwardMouseInput(HWND hWnd, uint msg, WPARAM wParam, LPARAM lParam) {
+    // The coordinates are signed, since the window can be on a monitor left of or above the
+    // primary one.
+    var point = new Point((short)GET_X_LPARAM(lParam), (short)GET_Y_LPARAM(lParam));
+
+    // Wheel messages carry screen coordinates, but the others are relative to the client area.
+    if ((Msg)msg is not (Msg.WM_MOUSEWHEEL or Msg.WM_MOUSEHWHEEL)) {
+      ClientToScreen(hWnd, ref point);
+    }
+
+    MouseEventService?.QueueMouseInput(msg, wParam, point.X, point.Y);
+    FlushInputIfIdle(hWnd);
+  }
+
+
+  /// <summary>
+  ///   Whether a key message is part of a chord that the system turns into a window command, such
+  ///   as Alt+F4 closing the window. Those are left to the downscaled window, since forwarding them
+  ///   would make the source window close itself, open its window menu or drop to the background.
+  /// </summary>
+  private static bool IsSystemCommandKey(Msg message, WPARAM wParam) {
+    if (message is not (Msg.WM_SYSKEYDOWN or Msg.WM_SYSKEYUP or Msg.WM_SYSCHAR)) {
+      return false;
+    }
+
+    // The window menu is opened by the space character that follows the key press.
+    if (message == Msg.WM_SYSCHAR) {
+      return wParam.Value == ' ';
+    }
+
+    return (VIRTUAL_KEY)wParam.Value is VIRTUAL_KEY.VK_F4 or VIRTUAL_KEY.VK_SPACE
+      or VIRTUAL_KEY.VK_ESCAPE;
+  }
+
+
+  /// <summary>
+  ///   Forwards the queued input once no more of it is waiting in the window's message queue. A
+  ///   burst of input, such as a fast spin of the mouse wheel, is then forwarded all at once, with
+  ///   the wheel rotation and key repeats merged into as few messages as possible.
+  /// </summary>
+  private static void FlushInputIfIdle(HWND hWnd) {
+    const PEEK_MESSAGE_REMOVE_TYPE peekOnly =
+      PEEK_MESSAGE_REMOVE_TYPE.PM_NOREMOVE | PEEK_MESSAGE_REMOVE_TYPE.PM_NOYIELD;
+
+    // Only look for the messages that are forwarded, since nothing else would flush the queue.
+    var isInputPending =
+      PeekMessage(out _, hWnd, (uint)Msg.WM_KEYDOWN, (uint)Msg.WM_SYSDEADCHAR, peekOnly) ||
+      PeekMessage(out _, hWnd, (uint)Msg.WM_LBUTTONDOWN, (uint)Msg.WM_MOUSEHWHEEL, peekOnly);
+
+    if (!isInputPending) {
+      MouseEventService?.FlushInput();
+    }
+  }
+
+
   private static LRESULT SubclassSourceWindowProc(
     HWND hWnd,
     uint msg,
@@ -265,6 +295,7 @@ public class WindowEventHandlerService : IWindowEventHandlerService {
     // InstallWindowSubclassForSourceWindow(hwnd);
 
     // Listen for raw input from the mouse globally.
+    rawInputReader ??= new RawInputReader();
     RegisterForRawInput(hwnd);
 
     // Get all child windows of the main window and install the event handlers into them.
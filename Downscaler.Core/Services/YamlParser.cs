@@ -221,6 +221,39 @@ public class YamlParser(IAppState AppState) : IYamlParser {
       }
     }
 
+    // If a target refresh rate is set, presentation will be paced against it.
+    if (yamlConfig.TargetRefreshRate != null) {
+      AppState.TargetRefreshRate = yamlConfig.TargetRefreshRate.Value;
+    }
+
+    if (yamlConfig.BlackFrameInsertion != null) {
+      AppState.BlackFrameInsertion = yamlConfig.BlackFrameInsertion.Value;
+    }
+
+    if (yamlConfig.TemporalBlendFrames != null) {
+      AppState.TemporalBlendFrames = (uint)yamlConfig.TemporalBlendFrames.Value;
+    }
+
+    if (yamlConfig.FrameStatistics != null) {
+      AppState.FrameStatistics = yamlConfig.FrameStatistics.Value;
+    }
+
+    if (yamlConfig.LargePages != null) {
+      AppState.LargePages = yamlConfig.LargePages.Value;
+    }
+
+    if (yamlConfig.MouseForwardRate != null) {
+      AppState.MouseForwardRate = Math.Max(0, yamlConfig.MouseForwardRate.Value);
+    }
+
+    if (yamlConfig.ForwardInput != null) {
+      AppState.ForwardInput = yamlConfig.ForwardInput.Value;
+    }
+
+    if (yamlConfig.CursorPrediction != null) {
+      AppState.CursorPrediction = yamlConfig.CursorPrediction.Value;
+    }
+
     // If the window title is set, search for the window by title.
     if (yamlConfig.WindowTitle != null) {
       var windowByTitle = GetWindowForWindowTitle(yamlConfig.WindowTitle, yamlConfig.ClassName);
@@ -383,6 +416,8 @@ public class YamlParser(IAppState AppState) : IYamlParser {
       CheckForGreaterThanZero(
         ("scale-width", yamlConfig.ScaleWidth),
         ("scale-height", yamlConfig.ScaleHeight),
+        ("target-refresh-rate", yamlConfig.TargetRefreshRate),
+        ("temporal-blend-frames", yamlConfig.TemporalBlendFrames),
         ("debug.font-scale", yamlConfig.Debug?.FontScale)
       ),
       CheckForNotZero(
@@ -390,6 +425,9 @@ public class YamlParser(IAppState AppState) : IYamlParser {
         ("scale-width", yamlConfig.ScaleWidth),
         ("scale-height", yamlConfig.ScaleHeight)
       ),
+      yamlConfig.TemporalBlendFrames > 16
+        ? "The property \"temporal-blend-frames\" must not be greater than 16."
+        : null,
       CheckForOneOfValues(
         ("debug.font-family", yamlConfig.Debug?.FontFamily?.ToLower(),
          [null, /* "extra-small", */ "small", "normal", "large"])
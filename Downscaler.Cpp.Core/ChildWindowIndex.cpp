@@ -0,0 +1 @@
+#include "ChildWindowIndex.h"
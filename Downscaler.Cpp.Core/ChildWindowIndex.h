@@ -0,0 +1,147 @@
+#pragma once
+
+#include "child-window-index.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace System;
+
+namespace Downscaler::Cpp::Core {
+  /**
+   * @brief The client area of a child window, relative to the client area of its parent.
+   */
+  public value struct ChildWindowRect {
+    IntPtr Handle;
+    int Left;
+    int Top;
+    /** The exclusive right edge. */
+    int Right;
+    /** The exclusive bottom edge. */
+    int Bottom;
+  };
+
+  /**
+   * @brief A child window that contains a point, along with the point relative to the child.
+   */
+  public value struct ChildWindowHit {
+    IntPtr Handle;
+    int X;
+    int Y;
+  };
+
+  /**
+   * @brief A spatial index of the child windows of a window, answering which of them contain a
+   * point without enumerating or querying the children.
+   */
+  public ref class ChildWindowIndex {
+    public:
+      ChildWindowIndex() : index(new NativeImpls::ChildWindowIndex()) {}
+
+      ~ChildWindowIndex() {
+        this->!ChildWindowIndex();
+      }
+
+      !ChildWindowIndex() {
+        delete index;
+        index = nullptr;
+      }
+
+      /**
+       * @brief Marks the index as stale so it's rebuilt before the next hit test. Safe to call
+       * from any thread, e.g. a window event hook.
+       */
+      void Invalidate() {
+        index->Invalidate();
+      }
+
+      /**
+       * @brief Whether the index is still up-to-date with the child windows.
+       */
+      property bool IsValid {
+        bool get() {
+          return index->IsValid();
+        }
+      }
+
+      /**
+       * @brief Rebuilds the index.
+       * @param children The client areas of the children, in the order hits are reported in.
+       * @param count The number of children in `children` to index.
+       */
+      void Update(array<ChildWindowRect>^ children, int count) {
+        if (children == nullptr) {
+          throw gcnew ArgumentNullException("children");
+        }
+
+        if (count < 0 || count > children->Length) {
+          throw gcnew ArgumentOutOfRangeException("count");
+        }
+
+        std::vector<NativeImpls::ChildWindowRect> nativeChildren(static_cast<size_t>(count));
+        for (int i = 0; i < count; ++i) {
+          auto% child = children[i];
+          nativeChildren[i] = {
+            static_cast<uint64_t>(child.Handle.ToInt64()),
+            child.Left,
+            child.Top,
+            child.Right,
+            child.Bottom
+          };
+        }
+
+        index->Update(nativeChildren.data(), nativeChildren.size());
+      }
+
+      /**
+       * @brief Finds the children that contain a point.
+       * @param x The x-coordinate of the point, relative to the parent's client area.
+       * @param y The y-coordinate of the point, relative to the parent's client area.
+       * @param hits Receives the hits, in the order the children were given in.
+       * @returns The number of hits written to `hits`.
+       */
+      int HitTest(int x, int y, array<ChildWindowHit>^ hits) {
+        if (hits == nullptr) {
+          throw gcnew ArgumentNullException("hits");
+        }
+
+        constexpr size_t maxHits = 16;
+        NativeImpls::ChildWindowHit nativeHits[maxHits];
+
+        auto capacity = std::min(static_cast<size_t>(hits->Length), maxHits);
+        auto count    = index->HitTest(x, y, nativeHits, capacity);
+        if (count > capacity) {
+          count = capacity;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+          hits[static_cast<int>(i)].Handle = IntPtr(static_cast<Int64>(nativeHits[i].handle));
+          hits[static_cast<int>(i)].X      = nativeHits[i].x;
+          hits[static_cast<int>(i)].Y      = nativeHits[i].y;
+        }
+
+        return static_cast<int>(count);
+      }
+
+      /**
+       * @brief The number of children in the index.
+       */
+      property int ChildCount {
+        int get() {
+          return static_cast<int>(index->GetChildCount());
+        }
+      }
+
+      /**
+       * @brief The number of times the index has been rebuilt.
+       */
+      property UInt64 UpdateCount {
+        UInt64 get() {
+          return index->GetUpdateCount();
+        }
+      }
+
+    internal:
+      NativeImpls::ChildWindowIndex* index;
+  };
+}
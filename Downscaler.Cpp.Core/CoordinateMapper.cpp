@@ -0,0 +1 @@
+#include "CoordinateMapper.h"
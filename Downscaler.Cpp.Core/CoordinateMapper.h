@@ -0,0 +1,190 @@
+#pragma once
+
+#include "coordinate-mapper.h"
+
+namespace Downscaler::Cpp::Core {
+  /**
+   * @brief A screen point mapped into the coordinate spaces of the downscaled and source windows.
+   */
+  public value struct MappedPoint {
+    /** The x-coordinate relative to the client area of the downscaled window. */
+    int DownscaledX;
+
+    /** The y-coordinate relative to the client area of the downscaled window. */
+    int DownscaledY;
+
+    /** The x-coordinate relative to the client area of the source window. */
+    int SourceX;
+
+    /** The y-coordinate relative to the client area of the source window. */
+    int SourceY;
+
+    /** The x-coordinate relative to the outer edge of the source window. */
+    int SourceWindowX;
+
+    /** The y-coordinate relative to the outer edge of the source window. */
+    int SourceWindowY;
+
+    /** The x-coordinate as a fraction of the downscaled window's client width. */
+    float DownscaledPercentX;
+
+    /** The y-coordinate as a fraction of the downscaled window's client height. */
+    float DownscaledPercentY;
+
+    /** The x-coordinate as a fraction of the source window's client width. */
+    float SourcePercentX;
+
+    /** The y-coordinate as a fraction of the source window's client height. */
+    float SourcePercentY;
+
+    /** Whether the point is within the client area of the downscaled window. */
+    bool IsWithinDownscaledWindow;
+
+    /** Whether the point is within the client area of the source window on screen. */
+    bool IsWithinSourceWindow;
+  };
+
+  /**
+   * @brief Maps screen points on the downscaled window onto the source window with a transform that
+   * is only recomputed after either window moves, is resized or changes DPI.
+   */
+  public ref class CoordinateMapper {
+    public:
+      CoordinateMapper() : mapper(new NativeImpls::CoordinateMapper()) {}
+
+      ~CoordinateMapper() {
+        this->!CoordinateMapper();
+      }
+
+      !CoordinateMapper() {
+        delete mapper;
+        mapper = nullptr;
+      }
+
+      /**
+       * @brief Marks the transform as stale so it's recomputed before the next mapping. Safe to
+       * call from any thread, e.g. a window event hook.
+       */
+      void Invalidate() {
+        mapper->Invalidate();
+      }
+
+      /**
+       * @brief Whether the transform can be used. If not, it must be recomputed with `Update`.
+       */
+      property bool IsValid {
+        bool get() {
+          return mapper->IsValid();
+        }
+      }
+
+      /**
+       * @brief Recomputes the transform from the client areas of both windows, in physical pixels.
+       * @param downscaledLeft The left edge of the downscaled window's client area on screen.
+       * @param downscaledTop The top edge of the downscaled window's client area on screen.
+       * @param downscaledWidth The width of the downscaled window's client area.
+       * @param downscaledHeight The height of the downscaled window's client area.
+       * @param sourceLeft The left edge of the source window's client area on screen.
+       * @param sourceTop The top edge of the source window's client area on screen.
+       * @param sourceWidth The width of the source window's client area.
+       * @param sourceHeight The height of the source window's client area.
+       * @param sourceInsetLeft The offset of the source client area from the window's left edge.
+       * @param sourceInsetTop The offset of the source client area from the window's top edge.
+       */
+      void Update(
+        int downscaledLeft,
+        int downscaledTop,
+        int downscaledWidth,
+        int downscaledHeight,
+        int sourceLeft,
+        int sourceTop,
+        int sourceWidth,
+        int sourceHeight,
+        int sourceInsetLeft,
+        int sourceInsetTop
+      ) {
+        NativeImpls::WindowGeometry downscaled;
+        downscaled.clientLeft   = downscaledLeft;
+        downscaled.clientTop    = downscaledTop;
+        downscaled.clientWidth  = downscaledWidth;
+        downscaled.clientHeight = downscaledHeight;
+
+        NativeImpls::WindowGeometry source;
+        source.clientLeft   = sourceLeft;
+        source.clientTop    = sourceTop;
+        source.clientWidth  = sourceWidth;
+        source.clientHeight = sourceHeight;
+        source.insetLeft    = sourceInsetLeft;
+        source.insetTop     = sourceInsetTop;
+
+        mapper->Update(downscaled, source);
+      }
+
+      /**
+       * @brief Maps a screen point into the coordinate spaces of both windows.
+       * @param screenX The x-coordinate of the point on the screen.
+       * @param screenY The y-coordinate of the point on the screen.
+       */
+      MappedPoint Map(int screenX, int screenY) {
+        auto native = mapper->Map(screenX, screenY);
+
+        MappedPoint point;
+        point.DownscaledX              = native.downscaledX;
+        point.DownscaledY              = native.downscaledY;
+        point.SourceX                  = native.sourceX;
+        point.SourceY                  = native.sourceY;
+        point.SourceWindowX            = native.sourceWindowX;
+        point.SourceWindowY            = native.sourceWindowY;
+        point.DownscaledPercentX       = native.downscaledPercentX;
+        point.DownscaledPercentY       = native.downscaledPercentY;
+        point.SourcePercentX           = native.sourcePercentX;
+        point.SourcePercentY           = native.sourcePercentY;
+        point.IsWithinDownscaledWindow = native.isWithinDownscaledWindow;
+        point.IsWithinSourceWindow     = native.isWithinSourceWindow;
+        return point;
+      }
+
+      /**
+       * @brief Maps a point in the source window's client area back onto the screen, over the
+       * downscaled window. The inverse of `Map`.
+       * @param sourceX The x-coordinate relative to the source window's client area.
+       * @param sourceY The y-coordinate relative to the source window's client area.
+       * @param screenX Receives the x-coordinate of the point on the screen.
+       * @param screenY Receives the y-coordinate of the point on the screen.
+       */
+      void MapSourceToScreen(
+        int sourceX,
+        int sourceY,
+        [System::Runtime::InteropServices::Out] int% screenX,
+        [System::Runtime::InteropServices::Out] int% screenY
+      ) {
+        int32_t nativeX = 0;
+        int32_t nativeY = 0;
+
+        mapper->MapSourceToScreen(sourceX, sourceY, nativeX, nativeY);
+        screenX = nativeX;
+        screenY = nativeY;
+      }
+
+      /**
+       * @brief The left edge of the source window's client area on screen, as of the last update.
+       */
+      property int SourceClientLeft {
+        int get() {
+          return mapper->GetSourceGeometry().clientLeft;
+        }
+      }
+
+      /**
+       * @brief The top edge of the source window's client area on screen, as of the last update.
+       */
+      property int SourceClientTop {
+        int get() {
+          return mapper->GetSourceGeometry().clientTop;
+        }
+      }
+
+    internal:
+      NativeImpls::CoordinateMapper* mapper;
+  };
+}
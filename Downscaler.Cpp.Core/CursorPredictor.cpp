@@ -0,0 +1,94 @@
+#include "cursor-predictor.h"
+#include "frame-scheduler.h"
+#include "CoordinateMapper.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace System;
+
+namespace Downscaler::Cpp::Core {
+  /**
+   * @brief Predicts where the mouse will be in the source window a short time from now, so moves
+   * forwarded to it line up with the mouse by the time the source's output reaches the screen.
+   */
+  public ref class CursorPredictor {
+    public:
+      CursorPredictor() : predictor(new NativeImpls::CursorPredictor()) {}
+
+      ~CursorPredictor() {
+        this->!CursorPredictor();
+      }
+
+      !CursorPredictor() {
+        delete predictor;
+        predictor = nullptr;
+      }
+
+      /**
+       * @brief Forgets every position, e.g. after the mouse was warped.
+       */
+      void Reset() {
+        predictor->Reset();
+      }
+
+      /**
+       * @brief Records where the mouse is in the source window as of now.
+       * @param point The position of the mouse, mapped into the coordinate spaces of both windows.
+       */
+      void AddSample(MappedPoint point) {
+        predictor->AddSample(
+          NativeImpls::GetSteadyClock().NowMicroseconds(),
+          point.SourceX,
+          point.SourceY
+        );
+      }
+
+      /**
+       * @brief Predicts where the mouse will be in the source window.
+       * @param mapper The mapper that `point` was mapped with.
+       * @param point The current position of the mouse.
+       * @param horizonMicroseconds How far ahead of now to predict the position.
+       * @returns `point`, with its source window coordinates moved to the predicted position,
+       * clamped to the source window's client area.
+       */
+      MappedPoint Predict(CoordinateMapper^ mapper, MappedPoint point, Int64 horizonMicroseconds) {
+        if (mapper == nullptr) {
+          throw gcnew ArgumentNullException("mapper");
+        }
+
+        auto predicted = predictor->Predict(
+          NativeImpls::GetSteadyClock().NowMicroseconds(),
+          horizonMicroseconds
+        );
+        if (!predicted.isExtrapolated) {
+          return point;
+        }
+
+        // Never predict the mouse out of the window, where the source would stop receiving moves.
+        const auto& source = mapper->mapper->GetSourceGeometry();
+        auto maxX = static_cast<double>(std::max(source.clientWidth - 1, 0));
+        auto maxY = static_cast<double>(std::max(source.clientHeight - 1, 0));
+        auto x    = static_cast<int>(std::lround(std::clamp(predicted.x, 0.0, maxX)));
+        auto y    = static_cast<int>(std::lround(std::clamp(predicted.y, 0.0, maxY)));
+
+        // The inset of the source client area is unaffected, so carry it over from the point.
+        point.SourceWindowX = point.SourceWindowX - point.SourceX + x;
+        point.SourceWindowY = point.SourceWindowY - point.SourceY + y;
+        point.SourceX       = x;
+        point.SourceY       = y;
+
+        if (source.clientWidth > 0) {
+          point.SourcePercentX = static_cast<float>(x) / static_cast<float>(source.clientWidth);
+        }
+        if (source.clientHeight > 0) {
+          point.SourcePercentY = static_cast<float>(y) / static_cast<float>(source.clientHeight);
+        }
+
+        return point;
+      }
+
+    private:
+      NativeImpls::CursorPredictor* predictor;
+  };
+}
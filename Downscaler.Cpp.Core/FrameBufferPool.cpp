@@ -0,0 +1,64 @@
+#include "frame-buffer-pool.h"
+
+using namespace System;
+
+namespace Downscaler::Cpp::Core {
+  /**
+   * @brief Exposes the pool that the native pipeline borrows its frame buffers from.
+   */
+  public ref class FrameBufferPool {
+    public:
+      /**
+       * @brief Sets whether new frame buffers may be backed by large pages. On Windows this
+       * requires the "Lock pages in memory" privilege to be granted to the user.
+       * @param enabled Whether to try large pages.
+       * @returns Whether large pages are available to the process.
+       */
+      static bool SetLargePagesEnabled(bool enabled) {
+        return NativeImpls::GetFrameBufferPool().SetLargePagesEnabled(enabled);
+      }
+
+      /**
+       * @brief Returns every pooled buffer that isn't in use to the OS.
+       */
+      static void Trim() {
+        NativeImpls::GetFrameBufferPool().Trim();
+      }
+
+      /**
+       * @brief The number of requests that were served from a pooled buffer.
+       */
+      static property UInt64 Hits {
+        UInt64 get() {
+          return NativeImpls::GetFrameBufferPool().GetHits();
+        }
+      }
+
+      /**
+       * @brief The number of requests that needed a new allocation.
+       */
+      static property UInt64 Misses {
+        UInt64 get() {
+          return NativeImpls::GetFrameBufferPool().GetMisses();
+        }
+      }
+
+      /**
+       * @brief The number of allocations that are backed by large pages.
+       */
+      static property UInt64 LargePageAllocations {
+        UInt64 get() {
+          return NativeImpls::GetFrameBufferPool().GetLargePageAllocations();
+        }
+      }
+
+      /**
+       * @brief The number of bytes currently allocated by the pool, whether in use or not.
+       */
+      static property UInt64 BytesAllocated {
+        UInt64 get() {
+          return NativeImpls::GetFrameBufferPool().GetBytesAllocated();
+        }
+      }
+  };
+}
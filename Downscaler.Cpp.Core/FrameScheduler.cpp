@@ -0,0 +1,131 @@
+#include "frame-scheduler.h"
+#include "LatencyHistogram.h"
+
+using namespace System;
+
+namespace Downscaler::Cpp::Core {
+  /**
+   * @brief What should be shown on the output during a refresh slot.
+   */
+  public enum class PresentAction {
+    PresentNewFrame = static_cast<int>(NativeImpls::PresentAction::PresentNewFrame),
+    RepeatFrame     = static_cast<int>(NativeImpls::PresentAction::RepeatFrame),
+    BlackFrame      = static_cast<int>(NativeImpls::PresentAction::BlackFrame)
+  };
+
+  /**
+   * @brief Paces presentation of captured frames against a fixed output refresh rate, optionally
+   * inserting black frames between repeated frames for motion clarity.
+   */
+  public ref class FrameScheduler {
+    public:
+      /**
+       * @brief Creates a scheduler that paces against the steady clock.
+       * @param targetRefreshRate The refresh rate, in Hz, to pace the output against.
+       * @param sourceFrameRate
+       *   The frame rate of the source in Hz, or zero to measure it from the captured frames.
+       * @param blackFrameInsertion Whether to insert black frames between repeated frames.
+       * @param litSlotsPerFrame
+       *   The number of refresh slots each frame is shown for before black frames are inserted.
+       */
+      FrameScheduler(
+        double targetRefreshRate,
+        double sourceFrameRate,
+        bool blackFrameInsertion,
+        unsigned int litSlotsPerFrame
+      ) {
+        if (targetRefreshRate <= 0) {
+          throw gcnew ArgumentOutOfRangeException(
+            "targetRefreshRate",
+            "The target refresh rate must be greater than zero."
+          );
+        }
+
+        NativeImpls::FrameSchedulerOptions options;
+        options.targetRefreshRate   = targetRefreshRate;
+        options.sourceFrameRate     = sourceFrameRate;
+        options.blackFrameInsertion = blackFrameInsertion;
+        options.litSlotsPerFrame    = litSlotsPerFrame > 0 ? litSlotsPerFrame : 1;
+
+        scheduler    = new NativeImpls::FrameScheduler(options);
+        cadenceError = gcnew LatencyHistogram(&scheduler->GetCadenceErrorHistogram());
+      }
+
+      ~FrameScheduler() {
+        this->!FrameScheduler();
+      }
+
+      !FrameScheduler() {
+        delete scheduler;
+        scheduler = nullptr;
+      }
+
+      /**
+       * @brief Notifies the scheduler that a new captured frame is ready to be presented. Safe to
+       * call from the capture thread.
+       */
+      void OnFrameArrived() {
+        scheduler->OnFrameArrived();
+      }
+
+      /**
+       * @brief Blocks until the next refresh slot and decides what to present during it. Must
+       * only be called from a single presentation thread.
+       * @returns The action to take for the slot.
+       */
+      PresentAction WaitForNextSlot() {
+        return static_cast<PresentAction>(scheduler->WaitForNextSlot());
+      }
+
+      /**
+       * @brief Decides what to present at a vertical blank, if the blank services a refresh slot.
+       * Use this instead of `WaitForNextSlot` when the caller waits for the vertical blank itself.
+       * Must only be called from a single presentation thread.
+       * @param action Receives the action to take for the slot.
+       * @returns `false` if the next slot isn't due yet, which happens when the display refreshes
+       * faster than the target refresh rate.
+       */
+      bool TryTakeSlot([Runtime::InteropServices::Out] PresentAction% action) {
+        auto now = NativeImpls::GetSteadyClock().NowMicroseconds();
+        if (!scheduler->IsSlotDue(now)) {
+          action = PresentAction::RepeatFrame;
+          return false;
+        }
+
+        action = static_cast<PresentAction>(scheduler->OnSlot(now));
+        return true;
+      }
+
+      /**
+       * @brief The source frame rate, in Hz, that the repetition pattern is based on.
+       */
+      property double SourceFrameRate {
+        double get() {
+          return scheduler->GetSourceFrameRate();
+        }
+      }
+
+      /**
+       * @brief The number of refresh slots that passed without being serviced.
+       */
+      property unsigned long long MissedSlots {
+        unsigned long long get() {
+          return scheduler->GetMissedSlots();
+        }
+      }
+
+      /**
+       * @brief The distribution of how far, in microseconds, each refresh slot was serviced from
+       * its ideal time. Only valid for as long as the scheduler is alive.
+       */
+      property LatencyHistogram^ CadenceError {
+        LatencyHistogram^ get() {
+          return cadenceError;
+        }
+      }
+
+    private:
+      NativeImpls::FrameScheduler* scheduler;
+      LatencyHistogram^ cadenceError;
+  };
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "frame-statistics.h"
+
+namespace Downscaler::Cpp::Core {
+  /**
+   * @brief A change between showing and not showing a black screen.
+   */
+  public enum class BlackScreenTransition {
+    None    = static_cast<int>(NativeImpls::BlackScreenTransition::None),
+    Started = static_cast<int>(NativeImpls::BlackScreenTransition::Started),
+    Ended   = static_cast<int>(NativeImpls::BlackScreenTransition::Ended)
+  };
+
+  /**
+   * @brief Luminance statistics of the most recently analyzed frame: a 256-bin luma histogram, the
+   * minimum, maximum and mean luma, and whether the frame is black.
+   */
+  public ref class FrameStatistics {
+    public:
+      /**
+       * @brief Creates an accumulator for frame statistics.
+       * @param blackThreshold The brightest luma value, 0-255, that is still considered black.
+       * @param blackTolerance
+       *   The fraction of pixels, between 0 and 1, that may be brighter than the threshold for a
+       *   frame to still be considered black.
+       */
+      FrameStatistics(System::Byte blackThreshold, double blackTolerance)
+        : accumulator(new NativeImpls::FrameStatisticsAccumulator(blackThreshold, blackTolerance)),
+          detector(new NativeImpls::BlackScreenDetector()) {}
+
+      ~FrameStatistics() {
+        this->!FrameStatistics();
+      }
+
+      !FrameStatistics() {
+        delete accumulator;
+        accumulator = nullptr;
+        delete detector;
+        detector = nullptr;
+      }
+
+      /**
+       * @brief Analyzes a tightly packed BGRA frame in a single pass.
+       * @param pixels The pixels of the frame.
+       * @param width The width of the frame in pixels.
+       * @param height The height of the frame in pixels.
+       */
+      void Analyze(array<System::Byte>^ pixels, unsigned int width, unsigned int height) {
+        auto stride = static_cast<size_t>(width) * 4;
+        if (static_cast<size_t>(pixels->Length) < stride * height) {
+          throw gcnew System::ArgumentException(
+            "The pixel buffer is smaller than the frame.",
+            "pixels"
+          );
+        }
+
+        pin_ptr<System::Byte> pinned = &pixels[0];
+        accumulator->Begin();
+        accumulator->AccumulateImage(NativeImpls::ConstImageView(pinned, width, height, stride));
+        accumulator->Finish();
+      }
+
+      /**
+       * @brief Copies the luma histogram of the last analyzed frame.
+       * @returns The number of pixels with each luma value from 0 to 255.
+       */
+      array<unsigned int>^ GetHistogram() {
+        auto& histogram = accumulator->GetStatistics().histogram;
+        auto result = gcnew array<unsigned int>(static_cast<int>(histogram.size()));
+        for (int i = 0; i < result->Length; ++i) {
+          result[i] = histogram[i];
+        }
+        return result;
+      }
+
+      /**
+       * @brief The darkest luma value, 0-255, of the last analyzed frame.
+       */
+      property System::Byte MinLuma {
+        System::Byte get() {
+          return accumulator->GetStatistics().minLuma;
+        }
+      }
+
+      /**
+       * @brief The brightest luma value, 0-255, of the last analyzed frame.
+       */
+      property System::Byte MaxLuma {
+        System::Byte get() {
+          return accumulator->GetStatistics().maxLuma;
+        }
+      }
+
+      /**
+       * @brief The average luma value, 0-255, of the last analyzed frame.
+       */
+      property double MeanLuma {
+        double get() {
+          return accumulator->GetStatistics().meanLuma;
+        }
+      }
+
+      /**
+       * @brief Whether the last analyzed frame is black, e.g. a loading screen.
+       */
+      property bool IsBlack {
+        bool get() {
+          return accumulator->GetStatistics().isBlack;
+        }
+      }
+
+      /**
+       * @brief Tracks whether the window is showing a black screen from the last analyzed frame.
+       * Only a few consecutive frames that agree start or end a black screen.
+       * @returns Whether a black screen started or ended with the last analyzed frame.
+       */
+      BlackScreenTransition UpdateBlackScreen() {
+        return static_cast<BlackScreenTransition>(
+          detector->Update(accumulator->GetStatistics().isBlack)
+        );
+      }
+
+      /**
+       * @brief Whether the window is currently considered to be showing a black screen.
+       */
+      property bool IsBlackScreen {
+        bool get() {
+          return detector->IsBlackScreen();
+        }
+      }
+
+    internal:
+      NativeImpls::FrameStatisticsAccumulator* accumulator;
+      NativeImpls::BlackScreenDetector* detector;
+  };
+}
@@ -0,0 +1,112 @@
+#include "input-forwarder.h"
+#include "ChildWindowIndex.h"
+#include "CoordinateMapper.h"
+
+using namespace System;
+
+namespace Downscaler::Cpp::Core {
+  /**
+   * @brief Forwards the mouse button, wheel and keyboard input received by the downscaled window
+   * to the source window and its children. Bursts of wheel rotation and key repeats are merged
+   * while queued, and everything else is posted in order once `Flush` is called.
+   */
+  public ref class InputForwarder {
+    public:
+      InputForwarder() : forwarder(new NativeImpls::InputForwarder()) {}
+
+      ~InputForwarder() {
+        this->!InputForwarder();
+      }
+
+      !InputForwarder() {
+        delete forwarder;
+        forwarder = nullptr;
+      }
+
+      /**
+       * @brief Changes the window that input is forwarded to.
+       */
+      void SetSourceWindow(IntPtr window) {
+        forwarder->SetSourceWindow(static_cast<uint64_t>(window.ToInt64()));
+      }
+
+      /**
+       * @brief Queues a mouse button or wheel message received by the downscaled window.
+       * @param message The message, e.g. `WM_LBUTTONDOWN` or `WM_MOUSEWHEEL`.
+       * @param wParam The message's `wParam`.
+       * @param screenX The x-coordinate of the mouse on the screen.
+       * @param screenY The y-coordinate of the mouse on the screen.
+       * @param mapper Maps the mouse onto the source window. Must be up-to-date.
+       * @param children The child windows of the source window, or null to only forward to the
+       * source window itself.
+       * @returns `false` if the message wasn't queued.
+       */
+      bool QueueMouse(
+        UInt32 message,
+        UInt64 wParam,
+        int screenX,
+        int screenY,
+        CoordinateMapper^ mapper,
+        ChildWindowIndex^ children
+      ) {
+        if (mapper == nullptr) {
+          throw gcnew ArgumentNullException("mapper");
+        }
+
+        return forwarder->QueueMouse(
+          message,
+          wParam,
+          screenX,
+          screenY,
+          *mapper->mapper,
+          children != nullptr ? children->index : nullptr
+        );
+      }
+
+      /**
+       * @brief Queues a keyboard message received by the downscaled window.
+       * @returns `false` if the message wasn't queued.
+       */
+      bool QueueKey(UInt32 message, UInt64 wParam, Int64 lParam) {
+        return forwarder->QueueKey(message, wParam, lParam);
+      }
+
+      /**
+       * @brief Posts every queued message, in order.
+       * @returns The number of messages posted.
+       */
+      int Flush() {
+        return static_cast<int>(forwarder->Flush());
+      }
+
+      /**
+       * @brief The number of messages waiting to be posted.
+       */
+      property int PendingCount {
+        int get() {
+          return static_cast<int>(forwarder->GetPendingCount());
+        }
+      }
+
+      /**
+       * @brief The number of messages queued, before any were merged.
+       */
+      property UInt64 QueuedCount {
+        UInt64 get() {
+          return forwarder->GetQueuedCount();
+        }
+      }
+
+      /**
+       * @brief The number of messages posted.
+       */
+      property UInt64 DeliveredCount {
+        UInt64 get() {
+          return forwarder->GetDeliveredCount();
+        }
+      }
+
+    private:
+      NativeImpls::InputForwarder* forwarder;
+  };
+}
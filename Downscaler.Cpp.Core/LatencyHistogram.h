@@ -0,0 +1,101 @@
+#pragma once
+
+#include "latency-histogram.h"
+
+namespace Downscaler::Cpp::Core {
+  /**
+   * @brief A histogram of latency samples measured in microseconds. Instances either own their
+   * native histogram or are a view over a histogram owned by another native component, in which
+   * case the view is only valid for as long as that component is alive.
+   */
+  public ref class LatencyHistogram {
+    public:
+      /**
+       * @brief Creates a new, empty histogram.
+       */
+      LatencyHistogram() : histogram(new NativeImpls::LatencyHistogram()), ownsHistogram(true) {}
+
+      ~LatencyHistogram() {
+        this->!LatencyHistogram();
+      }
+
+      !LatencyHistogram() {
+        if (ownsHistogram) {
+          delete histogram;
+        }
+        histogram = nullptr;
+      }
+
+      /**
+       * @brief Records a single sample.
+       * @param microseconds The sample to record, in microseconds.
+       */
+      void Record(long long microseconds) {
+        histogram->Record(microseconds);
+      }
+
+      /**
+       * @brief Discards every recorded sample.
+       */
+      void Reset() {
+        histogram->Reset();
+      }
+
+      /**
+       * @brief Estimates the value below which the given fraction of samples fall.
+       * @param percentile The percentile to compute, in the range [0, 100].
+       * @returns The estimated percentile in microseconds.
+       */
+      long long GetPercentile(double percentile) {
+        return histogram->GetPercentile(percentile);
+      }
+
+      /**
+       * @brief The number of samples recorded since the last reset.
+       */
+      property unsigned long long Count {
+        unsigned long long get() {
+          return histogram->GetCount();
+        }
+      }
+
+      /**
+       * @brief The smallest recorded sample in microseconds.
+       */
+      property long long Min {
+        long long get() {
+          return histogram->GetMin();
+        }
+      }
+
+      /**
+       * @brief The largest recorded sample in microseconds.
+       */
+      property long long Max {
+        long long get() {
+          return histogram->GetMax();
+        }
+      }
+
+      /**
+       * @brief The mean of the recorded samples in microseconds.
+       */
+      property double Mean {
+        double get() {
+          return histogram->GetMean();
+        }
+      }
+
+    internal:
+      /**
+       * @brief Creates a view over a histogram owned by a native component.
+       * @param histogram The histogram to view.
+       */
+      LatencyHistogram(NativeImpls::LatencyHistogram* histogram)
+        : histogram(histogram), ownsHistogram(false) {}
+
+    private:
+      NativeImpls::LatencyHistogram* histogram;
+      bool ownsHistogram;
+  };
+}
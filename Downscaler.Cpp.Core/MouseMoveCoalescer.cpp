@@ -0,0 +1,95 @@
+#include "mouse-move-coalescer.h"
+
+using namespace System;
+using namespace System::Runtime::InteropServices;
+
+namespace Downscaler::Cpp::Core {
+  /**
+   * @brief Rate-limits the mouse moves forwarded to the source window. A move that arrives too
+   * soon after the last forwarded one is held back rather than dropped, and is forwarded once the
+   * interval elapses unless a newer move replaces it first.
+   */
+  public ref class MouseMoveCoalescer {
+    public:
+      /**
+       * @param rate
+       *   The maximum number of moves forwarded per second, or zero to forward every move.
+       */
+      MouseMoveCoalescer(double rate) : coalescer(new NativeImpls::MouseMoveCoalescer(rate)) {}
+
+      ~MouseMoveCoalescer() {
+        this->!MouseMoveCoalescer();
+      }
+
+      !MouseMoveCoalescer() {
+        delete coalescer;
+        coalescer = nullptr;
+      }
+
+      /**
+       * @brief Records the latest position of the mouse.
+       * @returns `true` if the move should be forwarded now, `false` if it's held back.
+       */
+      bool Submit(int x, int y) {
+        return coalescer->Submit(x, y);
+      }
+
+      /**
+       * @brief Blocks until a held back move is due and takes it. Must only be called from a
+       * single flush thread.
+       * @param x Receives the x-coordinate of the move.
+       * @param y Receives the y-coordinate of the move.
+       * @returns `true` if a move was taken, `false` if the coalescer was stopped.
+       */
+      bool WaitForTrailingMove([Out] int% x, [Out] int% y) {
+        int32_t nativeX = 0;
+        int32_t nativeY = 0;
+
+        auto taken = coalescer->WaitForTrailingMove(nativeX, nativeY);
+        x = nativeX;
+        y = nativeY;
+        return taken;
+      }
+
+      /**
+       * @brief Ends any pending call to `WaitForTrailingMove`.
+       */
+      void Stop() {
+        coalescer->Stop();
+      }
+
+      /**
+       * @brief The maximum number of moves forwarded per second, or zero if every move is
+       * forwarded. May be changed from any thread.
+       */
+      property double Rate {
+        double get() {
+          return coalescer->GetRate();
+        }
+        void set(double value) {
+          coalescer->SetRate(value);
+        }
+      }
+
+      /**
+       * @brief The number of moves submitted.
+       */
+      property UInt64 Submitted {
+        UInt64 get() {
+          return coalescer->GetSubmitted();
+        }
+      }
+
+      /**
+       * @brief The number of moves forwarded.
+       */
+      property UInt64 Forwarded {
+        UInt64 get() {
+          return coalescer->GetForwarded();
+        }
+      }
+
+    private:
+      NativeImpls::MouseMoveCoalescer* coalescer;
+  };
+}
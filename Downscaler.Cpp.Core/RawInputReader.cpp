@@ -0,0 +1,129 @@
+#include "raw-input-reader.h"
+
+using namespace System;
+
+namespace Downscaler::Cpp::Core {
+  /**
+   * @brief A button transition or wheel rotation within a batch of mouse raw input reports.
+   */
+  public value struct RawMouseTransition {
+    /** The total relative horizontal motion of the batch up to this transition, in mouse counts. */
+    Int64 DeltaX;
+
+    /** The total relative vertical motion of the batch up to this transition, in mouse counts. */
+    Int64 DeltaY;
+
+    /** The button transitions and wheel rotation, as `RI_MOUSE_*` flags. */
+    UInt16 ButtonFlags;
+
+    /** The wheel rotation. */
+    int WheelDelta;
+  };
+
+  /**
+   * @brief The mouse raw input reports of a batch, with the motion coalesced into a single update.
+   */
+  public value struct RawMouseBatch {
+    /** The number of reports that were coalesced. */
+    unsigned int EventCount;
+
+    /** The total relative horizontal motion of the batch, in mouse counts. */
+    Int64 DeltaX;
+
+    /** The total relative vertical motion of the batch, in mouse counts. */
+    Int64 DeltaY;
+
+    /** Whether any report had an absolute position, e.g. from a tablet or remote desktop. */
+    bool HasAbsolutePosition;
+
+    /** The last absolute horizontal position of the batch, normalized to 0-65535. */
+    int AbsoluteX;
+
+    /** The last absolute vertical position of the batch, normalized to 0-65535. */
+    int AbsoluteY;
+
+    /** The button transitions and wheel rotations of the batch, in the order they were reported. */
+    array<RawMouseTransition>^ Transitions;
+
+    /**
+     * @brief Whether the pointer may have moved during the batch.
+     */
+    property bool HasMotion {
+      bool get() {
+        return DeltaX != 0 || DeltaY != 0 || HasAbsolutePosition;
+      }
+    }
+  };
+
+  /**
+   * @brief Reads mouse raw input in batches, coalescing every report queued since the last
+   * `WM_INPUT` message into a single update.
+   */
+  public ref class RawInputReader {
+    public:
+      RawInputReader() : reader(new NativeImpls::RawInputReader()) {}
+
+      ~RawInputReader() {
+        this->!RawInputReader();
+      }
+
+      !RawInputReader() {
+        delete reader;
+        reader = nullptr;
+      }
+
+      /**
+       * @brief Reads the report of a `WM_INPUT` message, along with every report still queued. Must
+       * be called from the thread that owns the window registered for raw input.
+       * @param rawInput The `lParam` of the `WM_INPUT` message.
+       * @returns The mouse reports of the batch, coalesced.
+       */
+      RawMouseBatch Read(IntPtr rawInput) {
+        auto& native = reader->Read(rawInput.ToPointer());
+
+        RawMouseBatch batch;
+        batch.EventCount          = native.eventCount;
+        batch.DeltaX              = native.deltaX;
+        batch.DeltaY              = native.deltaY;
+        batch.HasAbsolutePosition = native.hasAbsolutePosition;
+        batch.AbsoluteX           = native.absoluteX;
+        batch.AbsoluteY           = native.absoluteY;
+        batch.Transitions         = Array::Empty<RawMouseTransition>();
+
+        auto count = static_cast<int>(native.transitions.size());
+        if (count > 0) {
+          batch.Transitions = gcnew array<RawMouseTransition>(count);
+          for (int i = 0; i < count; ++i) {
+            auto& transition                 = native.transitions[i];
+            batch.Transitions[i].DeltaX      = transition.deltaX;
+            batch.Transitions[i].DeltaY      = transition.deltaY;
+            batch.Transitions[i].ButtonFlags = transition.buttonFlags;
+            batch.Transitions[i].WheelDelta  = transition.wheelDelta;
+          }
+        }
+
+        return batch;
+      }
+
+      /**
+       * @brief The number of batches read.
+       */
+      property UInt64 BatchCount {
+        UInt64 get() {
+          return reader->GetBatchCount();
+        }
+      }
+
+      /**
+       * @brief The number of mouse reports read across every batch.
+       */
+      property UInt64 EventCount {
+        UInt64 get() {
+          return reader->GetEventCount();
+        }
+      }
+
+    private:
+      NativeImpls::RawInputReader* reader;
+  };
+}
@@ -0,0 +1,132 @@
+#include "region-of-interest.h"
+
+#include <msclr/lock.h>
+
+using namespace System;
+
+namespace Downscaler::Cpp::Core {
+  /**
+   * @brief Caches the region of the captured frames that should be shown, e.g. the client area of
+   * the source window, until the window is moved, resized or changes DPI.
+   */
+  public ref class RegionOfInterest {
+    public:
+      RegionOfInterest()
+        : region(new NativeImpls::RegionOfInterest()),
+          invalidateLock(gcnew Object()) {}
+
+      ~RegionOfInterest() {
+        this->!RegionOfInterest();
+      }
+
+      !RegionOfInterest() {
+        msclr::lock guard(invalidateLock);
+        delete region;
+        region = nullptr;
+      }
+
+      /**
+       * @brief Marks the cached region as stale so it's recomputed for the next frame. Safe to
+       * call from any thread, e.g. a window event hook, even one that's still running after the
+       * region was disposed, in which case it does nothing.
+       */
+      void Invalidate() {
+        msclr::lock guard(invalidateLock);
+        if (region != nullptr) {
+          region->Invalidate();
+        }
+      }
+
+      /**
+       * @brief Checks whether the cached region can be used for a frame of the given size.
+       * @param frameWidth The width of the frame in pixels.
+       * @param frameHeight The height of the frame in pixels.
+       * @returns `false` if the region must be recomputed with `Update`.
+       */
+      bool IsValidFor(unsigned int frameWidth, unsigned int frameHeight) {
+        return region->IsValidFor(frameWidth, frameHeight);
+      }
+
+      /**
+       * @brief Caches a newly computed region, clamped to the bounds of the frame.
+       * @param frameWidth The width of the frame the region was computed for, in pixels.
+       * @param frameHeight The height of the frame the region was computed for, in pixels.
+       * @param x The left edge of the region, relative to the frame.
+       * @param y The top edge of the region, relative to the frame.
+       * @param width The width of the region in pixels.
+       * @param height The height of the region in pixels.
+       */
+      void Update(
+        unsigned int frameWidth,
+        unsigned int frameHeight,
+        int x,
+        int y,
+        int width,
+        int height
+      ) {
+        // Client areas can extend past the frame on either side, e.g. for a window that is partly
+        // off-screen, so negative values are clamped rather than rejected.
+        auto left = x < 0 ? 0 : x;
+        auto top  = y < 0 ? 0 : y;
+
+        NativeImpls::FrameRegion requested;
+        requested.x      = static_cast<uint32_t>(left);
+        requested.y      = static_cast<uint32_t>(top);
+        requested.width  = static_cast<uint32_t>(Math::Max(0, width - (left - x)));
+        requested.height = static_cast<uint32_t>(Math::Max(0, height - (top - y)));
+
+        region->Update(frameWidth, frameHeight, requested);
+      }
+
+      /**
+       * @brief The left edge of the cached region in pixels.
+       */
+      property unsigned int X {
+        unsigned int get() {
+          return region->GetRegion().x;
+        }
+      }
+
+      /**
+       * @brief The top edge of the cached region in pixels.
+       */
+      property unsigned int Y {
+        unsigned int get() {
+          return region->GetRegion().y;
+        }
+      }
+
+      /**
+       * @brief The width of the cached region in pixels.
+       */
+      property unsigned int Width {
+        unsigned int get() {
+          return region->GetRegion().width;
+        }
+      }
+
+      /**
+       * @brief The height of the cached region in pixels.
+       */
+      property unsigned int Height {
+        unsigned int get() {
+          return region->GetRegion().height;
+        }
+      }
+
+      /**
+       * @brief The number of times the region has been recomputed.
+       */
+      property UInt64 UpdateCount {
+        UInt64 get() {
+          return region->GetUpdateCount();
+        }
+      }
+
+    private:
+      NativeImpls::RegionOfInterest* region;
+
+      /** Keeps `Invalidate` from racing the native region being deleted. */
+      Object^ invalidateLock;
+  };
+}
@@ -0,0 +1,80 @@
+#include "sub-pixel-accumulator.h"
+#include "raw-input-reader.h"
+#include "CoordinateMapper.h"
+
+using namespace System;
+
+namespace Downscaler::Cpp::Core {
+  /**
+   * @brief Tracks the mouse in the source window at the source's resolution by accumulating the
+   * relative motion reported by the mouse, so positions between the ones the downscaled cursor can
+   * reach are forwarded too.
+   */
+  public ref class SubPixelAccumulator {
+    public:
+      /**
+       * @brief Creates an accumulator for the pointer speed currently set in Windows.
+       */
+      SubPixelAccumulator() {
+        accumulator = new NativeImpls::SubPixelAccumulator(NativeImpls::GetPointerPixelsPerCount());
+      }
+
+      ~SubPixelAccumulator() {
+        this->!SubPixelAccumulator();
+      }
+
+      !SubPixelAccumulator() {
+        delete accumulator;
+        accumulator = nullptr;
+      }
+
+      /**
+       * @brief Forgets the accumulated position, e.g. after the mouse was moved by an absolute
+       * pointing device.
+       */
+      void Reset() {
+        accumulator->Reset();
+      }
+
+      /**
+       * @brief Re-reads the pointer speed from the Windows mouse settings.
+       */
+      void RefreshPointerSpeed() {
+        accumulator->SetPixelsPerCount(NativeImpls::GetPointerPixelsPerCount());
+      }
+
+      /**
+       * @brief Accumulates the motion of a mouse update and refines a mapped point with it.
+       * @param mapper The mapper that `point` was mapped with.
+       * @param point The cursor position, mapped into the coordinate spaces of both windows.
+       * @param deltaX The relative horizontal motion since the last update, in mouse counts.
+       * @param deltaY The relative vertical motion since the last update, in mouse counts.
+       * @returns `point`, with its source window coordinates at the source's resolution.
+       */
+      MappedPoint Refine(CoordinateMapper^ mapper, MappedPoint point, Int64 deltaX, Int64 deltaY) {
+        if (mapper == nullptr) {
+          throw gcnew ArgumentNullException("mapper");
+        }
+
+        auto precise = accumulator->Accumulate(
+          *mapper->mapper,
+          point.DownscaledX,
+          point.DownscaledY,
+          deltaX,
+          deltaY
+        );
+
+        // The inset of the source client area is unaffected, so carry it over from the point.
+        point.SourceWindowX  = point.SourceWindowX - point.SourceX + precise.x;
+        point.SourceWindowY  = point.SourceWindowY - point.SourceY + precise.y;
+        point.SourceX        = precise.x;
+        point.SourceY        = precise.y;
+        point.SourcePercentX = precise.percentX;
+        point.SourcePercentY = precise.percentY;
+        return point;
+      }
+
+    private:
+      NativeImpls::SubPixelAccumulator* accumulator;
+  };
+}
@@ -0,0 +1,129 @@
+#include "temporal-blender.h"
+#include "FrameStatistics.h"
+
+using namespace System;
+
+namespace Downscaler::Cpp::Core {
+  /**
+   * @brief Blends the most recently captured frames together at the downscaled resolution to
+   * smooth out frame-rate down-conversion. Works on 32-bit-per-pixel images such as BGRA8.
+   */
+  public ref class TemporalBlender {
+    public:
+      /**
+       * @brief Creates a blender that weights every frame in the ring equally.
+       * @param width The width of the frames in pixels.
+       * @param height The height of the frames in pixels.
+       * @param frameCount The number of recent frames to blend together.
+       */
+      TemporalBlender(unsigned int width, unsigned int height, unsigned int frameCount) {
+        if (frameCount < 1 || frameCount > NativeImpls::TemporalBlender::MaxFrameCount) {
+          throw gcnew ArgumentOutOfRangeException(
+            "frameCount",
+            String::Format(
+              "The frame count must be between 1 and {0}.",
+              NativeImpls::TemporalBlender::MaxFrameCount
+            )
+          );
+        }
+
+        blender = new NativeImpls::TemporalBlender(width, height, frameCount);
+      }
+
+      ~TemporalBlender() {
+        this->!TemporalBlender();
+      }
+
+      !TemporalBlender() {
+        delete blender;
+        blender = nullptr;
+      }
+
+      /**
+       * @brief Replaces the equal weighting of the frames with custom weights.
+       * @param weights
+       *   The weight of each frame, starting with the newest. There must be one weight per frame
+       *   and they must add up to 256.
+       */
+      void SetWeights(array<UInt16>^ weights) {
+        std::vector<uint16_t> nativeWeights(weights->Length);
+        for (int i = 0; i < weights->Length; ++i) {
+          nativeWeights[i] = weights[i];
+        }
+
+        if (!blender->SetWeights(nativeWeights)) {
+          throw gcnew ArgumentException(
+            "There must be one weight per frame and the weights must add up to 256.",
+            "weights"
+          );
+        }
+      }
+
+      /**
+       * @brief Adds a tightly packed frame to the ring and overwrites it with the blend of the
+       * frames in the ring.
+       * @param pixels The frame to add, which receives the blended result.
+       */
+      void PushAndBlend(array<Byte>^ pixels) {
+        PushAndBlend(pixels, nullptr);
+      }
+
+      /**
+       * @brief Adds a tightly packed frame to the ring and overwrites it with the blend of the
+       * frames in the ring, analyzing the blended result as it's written.
+       * @param pixels The frame to add, which receives the blended result.
+       * @param statistics
+       *   Receives the statistics of the blended frame. May be null to skip the analysis.
+       */
+      void PushAndBlend(array<Byte>^ pixels, FrameStatistics^ statistics) {
+        auto stride = static_cast<size_t>(blender->GetWidth()) * 4;
+        if (static_cast<size_t>(pixels->Length) < stride * blender->GetHeight()) {
+          throw gcnew ArgumentException("The pixel buffer is smaller than the frame.", "pixels");
+        }
+
+        auto accumulator = statistics != nullptr ? statistics->accumulator : nullptr;
+
+        pin_ptr<Byte> pinned = &pixels[0];
+        NativeImpls::ImageView frame(pinned, blender->GetWidth(), blender->GetHeight(), stride);
+        blender->PushFrame(frame);
+
+        if (accumulator != nullptr) {
+          accumulator->Begin();
+        }
+
+        blender->Blend(frame, accumulator);
+
+        if (accumulator != nullptr) {
+          accumulator->Finish();
+        }
+      }
+
+      /**
+       * @brief Discards every frame in the ring, e.g. after a scene change.
+       */
+      void Reset() {
+        blender->Reset();
+      }
+
+      /**
+       * @brief The width of the frames in pixels.
+       */
+      property unsigned int Width {
+        unsigned int get() {
+          return blender->GetWidth();
+        }
+      }
+
+      /**
+       * @brief The height of the frames in pixels.
+       */
+      property unsigned int Height {
+        unsigned int get() {
+          return blender->GetHeight();
+        }
+      }
+
+    private:
+      NativeImpls::TemporalBlender* blender;
+  };
+}
@@ -0,0 +1,282 @@
+#include "child-window-index.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+namespace Downscaler::Cpp::Core::NativeImpls {
+  namespace {
+    // The number of entries per node. Wide nodes keep the tree shallow, and a node's boxes still
+    // fit in a handful of cache lines.
+    constexpr size_t fanout = 16;
+
+    /**
+     * @brief A bounding box with exclusive right and bottom edges.
+     */
+    struct Box {
+      int32_t left;
+      int32_t top;
+      int32_t right;
+      int32_t bottom;
+
+      bool Contains(int32_t x, int32_t y) const {
+        return x >= left && x < right && y >= top && y < bottom;
+      }
+
+      // Doubled centres, so they stay integral.
+      int64_t CenterX() const { return int64_t{left} + right; }
+      int64_t CenterY() const { return int64_t{top} + bottom; }
+    };
+
+    /**
+     * @brief A child in the leaves of the tree.
+     */
+    struct Entry {
+      Box box;
+      uint64_t handle;
+      // The position of the child in the order it was given in, which hits are reported in.
+      uint32_t order;
+    };
+
+    /**
+     * @brief A node of the tree. Nodes on the lowest level refer to a range of entries, and nodes
+     * on every other level refer to a range of nodes on the level below.
+     */
+    struct Node {
+      Box box;
+      uint32_t first;
+      uint32_t count;
+    };
+
+    /**
+     * @brief Sort-Tile-Recursive packing: sorts the items into vertical slices by their centre,
+     * then each slice by the vertical centre, so that runs of `fanout` items are spatially close.
+     */
+    template<typename TItem>
+    void SortTileRecursive(std::vector<TItem>& items, size_t first, size_t count) {
+      auto begin = items.begin() + static_cast<std::ptrdiff_t>(first);
+      auto end   = begin + static_cast<std::ptrdiff_t>(count);
+
+      std::sort(begin, end, [](const TItem& a, const TItem& b) {
+        return a.box.CenterX() < b.box.CenterX();
+      });
+
+      auto nodeCount  = (count + fanout - 1) / fanout;
+      auto sliceCount = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(nodeCount))));
+      auto sliceSize  = sliceCount * fanout;
+
+      for (size_t slice = 0; slice < count; slice += sliceSize) {
+        auto sliceEnd = begin + static_cast<std::ptrdiff_t>(std::min(slice + sliceSize, count));
+        auto sliceBegin = begin + static_cast<std::ptrdiff_t>(slice);
+        std::sort(sliceBegin, sliceEnd, [](const TItem& a, const TItem& b) {
+          return a.box.CenterY() < b.box.CenterY();
+        });
+      }
+    }
+
+    /**
+     * @brief Groups runs of `fanout` items into nodes, appending them to `nodes`.
+     */
+    template<typename TItem>
+    void Pack(
+      const std::vector<TItem>& items,
+      size_t first,
+      size_t count,
+      std::vector<Node>& nodes
+    ) {
+      for (size_t offset = 0; offset < count; offset += fanout) {
+        auto childCount = std::min(fanout, count - offset);
+
+        Node node{
+          items[first + offset].box,
+          static_cast<uint32_t>(first + offset),
+          static_cast<uint32_t>(childCount)
+        };
+        for (size_t child = 1; child < childCount; ++child) {
+          const auto& box = items[first + offset + child].box;
+          node.box.left   = std::min(node.box.left, box.left);
+          node.box.top    = std::min(node.box.top, box.top);
+          node.box.right  = std::max(node.box.right, box.right);
+          node.box.bottom = std::max(node.box.bottom, box.bottom);
+        }
+
+        nodes.push_back(node);
+      }
+    }
+  }
+
+  struct ChildWindowIndex::Impl {
+    // Bumped by `Invalidate`, which may run on a window event thread.
+    std::atomic<uint64_t> generation{1};
+
+    // See `RegionOfInterest` for how the generations make sure no invalidation is lost.
+    mutable uint64_t checkedGeneration = 0;
+    uint64_t validGeneration = 0;
+    uint64_t updateCount = 0;
+
+    std::vector<Entry> entries;
+
+    // Every level of the tree, from the leaves up, stored back to back.
+    std::vector<Node> nodes;
+    std::vector<size_t> levelStarts;
+
+    /**
+     * @brief Visits the entries below a node that contain the point.
+     */
+    void Search(
+      size_t level,
+      const Node& node,
+      int32_t x,
+      int32_t y,
+      ChildWindowHit* hits,
+      uint32_t* hitOrders,
+      size_t capacity,
+      size_t& hitCount
+    ) const {
+      for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+        if (level == 0) {
+          const auto& entry = entries[i];
+          if (entry.box.Contains(x, y)) {
+            Record(entry, x, y, hits, hitOrders, capacity, hitCount);
+          }
+          continue;
+        }
+
+        const auto& child = nodes[levelStarts[level - 1] + i];
+        if (child.box.Contains(x, y)) {
+          Search(level - 1, child, x, y, hits, hitOrders, capacity, hitCount);
+        }
+      }
+    }
+
+    /**
+     * @brief Inserts a hit so the hits stay in the order the children were given in, keeping only
+     * the first `capacity` of them.
+     */
+    static void Record(
+      const Entry& entry,
+      int32_t x,
+      int32_t y,
+      ChildWindowHit* hits,
+      uint32_t* hitOrders,
+      size_t capacity,
+      size_t& hitCount
+    ) {
+      auto kept = std::min(hitCount, capacity);
+      hitCount++;
+
+      // Only a handful of children ever overlap a point, so an insertion sort is plenty.
+      auto position = kept;
+      while (position > 0 && hitOrders[position - 1] > entry.order) {
+        position--;
+      }
+
+      if (position >= capacity) {
+        return;
+      }
+
+      auto last = std::min(kept, capacity - 1);
+      for (auto i = last; i > position; --i) {
+        hits[i]      = hits[i - 1];
+        hitOrders[i] = hitOrders[i - 1];
+      }
+
+      hits[position]      = {entry.handle, x - entry.box.left, y - entry.box.top};
+      hitOrders[position] = entry.order;
+    }
+  };
+
+  ChildWindowIndex::ChildWindowIndex() : impl(std::make_unique<Impl>()) {}
+
+  ChildWindowIndex::~ChildWindowIndex() = default;
+
+  void ChildWindowIndex::Invalidate() {
+    impl->generation.fetch_add(1, std::memory_order_release);
+  }
+
+  bool ChildWindowIndex::IsValid() const {
+    impl->checkedGeneration = impl->generation.load(std::memory_order_acquire);
+    return impl->validGeneration == impl->checkedGeneration;
+  }
+
+  void ChildWindowIndex::Update(const ChildWindowRect* children, size_t count) {
+    auto& state = *impl;
+
+    state.entries.clear();
+    state.nodes.clear();
+    state.levelStarts.clear();
+
+    for (size_t i = 0; i < count; ++i) {
+      const auto& child = children[i];
+      if (child.right > child.left && child.bottom > child.top) {
+        state.entries.push_back({
+          {child.left, child.top, child.right, child.bottom},
+          child.handle,
+          static_cast<uint32_t>(i)
+        });
+      }
+    }
+
+    // Bulk load the tree bottom-up, packing each level into nodes until a single root remains.
+    if (!state.entries.empty()) {
+      SortTileRecursive(state.entries, 0, state.entries.size());
+      state.levelStarts.push_back(0);
+      Pack(state.entries, 0, state.entries.size(), state.nodes);
+
+      while (state.nodes.size() - state.levelStarts.back() > 1) {
+        auto first = state.levelStarts.back();
+        auto size  = state.nodes.size() - first;
+
+        SortTileRecursive(state.nodes, first, size);
+        state.levelStarts.push_back(state.nodes.size());
+
+        // Child ranges are relative to the start of the level below, so packing them doesn't
+        // depend on where that level sits in `nodes`.
+        auto level = std::vector<Node>(
+          state.nodes.begin() + static_cast<std::ptrdiff_t>(first),
+          state.nodes.end()
+        );
+        Pack(level, 0, size, state.nodes);
+      }
+    }
+
+    state.updateCount++;
+    state.validGeneration = state.checkedGeneration != 0
+                              ? state.checkedGeneration
+                              : state.generation.load(std::memory_order_acquire);
+  }
+
+  size_t ChildWindowIndex::HitTest(
+    int32_t x,
+    int32_t y,
+    ChildWindowHit* hits,
+    size_t capacity
+  ) const {
+    const auto& state = *impl;
+    if (state.nodes.empty()) {
+      return 0;
+    }
+
+    // The orders of the kept hits, which the hits are sorted by.
+    constexpr size_t maxCapacity = 64;
+    uint32_t hitOrders[maxCapacity];
+    capacity = std::min(capacity, maxCapacity);
+
+    const auto& root = state.nodes.back();
+    size_t hitCount  = 0;
+    if (root.box.Contains(x, y)) {
+      state.Search(state.levelStarts.size() - 1, root, x, y, hits, hitOrders, capacity, hitCount);
+    }
+
+    return hitCount;
+  }
+
+  size_t ChildWindowIndex::GetChildCount() const {
+    return impl->entries.size();
+  }
+
+  uint64_t ChildWindowIndex::GetUpdateCount() const {
+    return impl->updateCount;
+  }
+}
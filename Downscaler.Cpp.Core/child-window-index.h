@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace Downscaler::Cpp::Core::NativeImpls {
+  /**
+   * @brief The client area of a child window, relative to the client area of its parent.
+   */
+  struct ChildWindowRect {
+    /** An opaque handle that identifies the window, e.g. its `HWND`. */
+    uint64_t handle = 0;
+    int32_t left = 0;
+    int32_t top = 0;
+    /** The exclusive right edge. */
+    int32_t right = 0;
+    /** The exclusive bottom edge. */
+    int32_t bottom = 0;
+  };
+
+  /**
+   * @brief A child window that contains a point, along with the point relative to the child.
+   */
+  struct ChildWindowHit {
+    uint64_t handle = 0;
+    int32_t x = 0;
+    int32_t y = 0;
+  };
+
+  /**
+   * @brief A spatial index of the child windows of a window, answering which of them contain a
+   * point.
+   *
+   * Enumerating the children and querying each of their client areas for every mouse move is
+   * slow for windows with many children, e.g. embedded browsers. Instead, the children are bulk
+   * loaded into a packed R-tree once, and reused until a child is created, destroyed, shown,
+   * hidden or moved, at which point `Invalidate` is called, typically from a window event hook.
+   * The next hit test then rebuilds the index with `Update`.
+   *
+   * `Invalidate` may be called from any thread. The other members must not be called
+   * concurrently.
+   */
+  class ChildWindowIndex {
+    public:
+      ChildWindowIndex();
+      ~ChildWindowIndex();
+
+      ChildWindowIndex(const ChildWindowIndex&)            = delete;
+      ChildWindowIndex& operator=(const ChildWindowIndex&) = delete;
+
+      /**
+       * @brief Marks the index as stale so it's rebuilt before the next hit test.
+       */
+      void Invalidate();
+
+      /**
+       * @returns `false` if the index was invalidated since it was last built.
+       */
+      bool IsValid() const;
+
+      /**
+       * @brief Rebuilds the index. Children with an empty client area are left out.
+       * @param children The client areas of the children, in the order hits are reported in.
+       * @param count The number of children.
+       */
+      void Update(const ChildWindowRect* children, size_t count);
+
+      /**
+       * @brief Finds the children that contain a point.
+       * @param x The x-coordinate of the point, relative to the parent's client area.
+       * @param y The y-coordinate of the point, relative to the parent's client area.
+       * @param hits Receives the first `capacity` hits, in the order the children were given in.
+       * @param capacity The number of hits that `hits` can hold.
+       * @returns The number of children that contain the point, which may exceed `capacity`.
+       */
+      size_t HitTest(int32_t x, int32_t y, ChildWindowHit* hits, size_t capacity) const;
+
+      /**
+       * @returns The number of children in the index.
+       */
+      size_t GetChildCount() const;
+
+      /**
+       * @returns The number of times the index has been rebuilt.
+       */
+      uint64_t GetUpdateCount() const;
+
+    private:
+      struct Impl;
+      std::unique_ptr<Impl> impl;
+  };
+}
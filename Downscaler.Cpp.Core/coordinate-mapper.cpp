@@ -0,0 +1,147 @@
+#include "coordinate-mapper.h"
+
+#include <atomic>
+
+namespace Downscaler::Cpp::Core::NativeImpls {
+  namespace {
+    /**
+     * @brief Whether a point lies within a client area. The right and bottom edges are inclusive
+     * to match `RectExtensions.Contains`.
+     */
+    inline bool Contains(const WindowGeometry& geometry, int32_t x, int32_t y) {
+      return x >= geometry.clientLeft &&
+             y >= geometry.clientTop &&
+             x <= geometry.clientLeft + geometry.clientWidth &&
+             y <= geometry.clientTop + geometry.clientHeight;
+    }
+
+    /**
+     * @returns `1 / value`, or 0 for an empty client area so that mapping never divides by zero.
+     */
+    inline double Reciprocal(int32_t value) {
+      return value > 0 ? 1.0 / static_cast<double>(value) : 0.0;
+    }
+
+    /**
+     * @brief Scales a source offset onto the downscaled client area, rounding away from zero. Since
+     * `Map` truncates towards zero, this finds the downscaled offset that `Map` sends onto the
+     * source offset, or else the next one beyond it.
+     */
+    inline int32_t ScaleToDownscaled(int32_t offset, int32_t downscaledSize, int32_t sourceSize) {
+      if (sourceSize <= 0) {
+        return 0;
+      }
+
+      auto numerator = int64_t{offset} * downscaledSize;
+      auto quotient  = numerator / sourceSize;
+      if (numerator % sourceSize != 0) {
+        quotient += numerator < 0 ? -1 : 1;
+      }
+      return static_cast<int32_t>(quotient);
+    }
+  }
+
+  struct CoordinateMapper::Impl {
+    // Bumped by `Invalidate`. The transform is valid while `validGeneration` matches it.
+    // `checkedGeneration` is the generation seen by the last validity check, which is the newest
+    // one the next update can be sure it accounts for.
+    std::atomic<uint64_t> generation{1};
+    mutable uint64_t checkedGeneration = 0;
+    uint64_t validGeneration = 0;
+
+    WindowGeometry downscaled;
+    WindowGeometry source;
+
+    // The scale from the downscaled client area to the source client area.
+    double scaleX = 1.0;
+    double scaleY = 1.0;
+
+    // The reciprocal sizes of the client areas, for computing fractions without dividing.
+    double downscaledInverseWidth = 0.0;
+    double downscaledInverseHeight = 0.0;
+    double sourceInverseWidth = 0.0;
+    double sourceInverseHeight = 0.0;
+  };
+
+  CoordinateMapper::CoordinateMapper() : impl(std::make_unique<Impl>()) {}
+
+  CoordinateMapper::~CoordinateMapper() = default;
+
+  void CoordinateMapper::Invalidate() {
+    impl->generation.fetch_add(1, std::memory_order_release);
+  }
+
+  bool CoordinateMapper::IsValid() const {
+    impl->checkedGeneration = impl->generation.load(std::memory_order_acquire);
+    return impl->validGeneration == impl->checkedGeneration;
+  }
+
+  void CoordinateMapper::Update(const WindowGeometry& downscaled, const WindowGeometry& source) {
+    impl->downscaled = downscaled;
+    impl->source     = source;
+
+    impl->downscaledInverseWidth  = Reciprocal(downscaled.clientWidth);
+    impl->downscaledInverseHeight = Reciprocal(downscaled.clientHeight);
+    impl->sourceInverseWidth      = Reciprocal(source.clientWidth);
+    impl->sourceInverseHeight     = Reciprocal(source.clientHeight);
+
+    impl->scaleX = static_cast<double>(source.clientWidth) * impl->downscaledInverseWidth;
+    impl->scaleY = static_cast<double>(source.clientHeight) * impl->downscaledInverseHeight;
+
+    // Only vouch for the generation that was current when the transform was found to be stale. If
+    // either window changed again while the caller was querying them, the next check fails.
+    impl->validGeneration = impl->checkedGeneration != 0
+                              ? impl->checkedGeneration
+                              : impl->generation.load(std::memory_order_acquire);
+  }
+
+  MappedPoint CoordinateMapper::Map(int32_t screenX, int32_t screenY) const {
+    auto& state = *impl;
+    MappedPoint point;
+
+    point.downscaledX = screenX - state.downscaled.clientLeft;
+    point.downscaledY = screenY - state.downscaled.clientTop;
+
+    // Truncate towards zero, as the forwarding always has.
+    point.sourceX = static_cast<int32_t>(point.downscaledX * state.scaleX);
+    point.sourceY = static_cast<int32_t>(point.downscaledY * state.scaleY);
+
+    point.sourceWindowX = point.sourceX + state.source.insetLeft;
+    point.sourceWindowY = point.sourceY + state.source.insetTop;
+
+    point.downscaledPercentX = static_cast<float>(point.downscaledX * state.downscaledInverseWidth);
+    point.downscaledPercentY = static_cast<float>(point.downscaledY * state.downscaledInverseHeight);
+    point.sourcePercentX     = static_cast<float>(point.sourceX * state.sourceInverseWidth);
+    point.sourcePercentY     = static_cast<float>(point.sourceY * state.sourceInverseHeight);
+
+    point.isWithinDownscaledWindow = Contains(state.downscaled, screenX, screenY);
+    point.isWithinSourceWindow     = Contains(state.source, screenX, screenY);
+
+    return point;
+  }
+
+  void CoordinateMapper::MapSourceToScreen(
+    int32_t sourceX,
+    int32_t sourceY,
+    int32_t& screenX,
+    int32_t& screenY
+  ) const {
+    const auto& downscaled = impl->downscaled;
+    const auto& source     = impl->source;
+
+    // Dividing exactly rather than multiplying by the reciprocal scale keeps this consistent with
+    // the truncation in `Map`.
+    screenX = downscaled.clientLeft +
+              ScaleToDownscaled(sourceX, downscaled.clientWidth, source.clientWidth);
+    screenY = downscaled.clientTop +
+              ScaleToDownscaled(sourceY, downscaled.clientHeight, source.clientHeight);
+  }
+
+  const WindowGeometry& CoordinateMapper::GetDownscaledGeometry() const {
+    return impl->downscaled;
+  }
+
+  const WindowGeometry& CoordinateMapper::GetSourceGeometry() const {
+    return impl->source;
+  }
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+namespace Downscaler::Cpp::Core::NativeImpls {
+  /**
+   * @brief The position and size of a window's client area, in physical pixels.
+   */
+  struct WindowGeometry {
+    /** The left edge of the client area in screen coordinates. */
+    int32_t clientLeft = 0;
+
+    /** The top edge of the client area in screen coordinates. */
+    int32_t clientTop = 0;
+
+    /** The width of the client area. */
+    int32_t clientWidth = 0;
+
+    /** The height of the client area. */
+    int32_t clientHeight = 0;
+
+    /** The horizontal offset of the client area from the window's outer edge. */
+    int32_t insetLeft = 0;
+
+    /** The vertical offset of the client area from the window's outer edge. */
+    int32_t insetTop = 0;
+  };
+
+  /**
+   * @brief A screen point mapped into every coordinate space the mouse forwarding needs.
+   */
+  struct MappedPoint {
+    /** The point relative to the client area of the downscaled window. */
+    int32_t downscaledX = 0;
+    int32_t downscaledY = 0;
+
+    /** The point relative to the client area of the source window. */
+    int32_t sourceX = 0;
+    int32_t sourceY = 0;
+
+    /** The point relative to the outer edge of the source window, i.e. including its chrome. */
+    int32_t sourceWindowX = 0;
+    int32_t sourceWindowY = 0;
+
+    /** The point as a fraction of the downscaled window's client area, 0 to 1 within it. */
+    float downscaledPercentX = 0.0f;
+    float downscaledPercentY = 0.0f;
+
+    /** The point as a fraction of the source window's client area, 0 to 1 within it. */
+    float sourcePercentX = 0.0f;
+    float sourcePercentY = 0.0f;
+
+    /** Whether the point is within the client area of the downscaled window. */
+    bool isWithinDownscaledWindow = false;
+
+    /** Whether the point is within the client area of the source window on screen. */
+    bool isWithinSourceWindow = false;
+  };
+
+  /**
+   * @brief Maps screen points on the downscaled window onto the source window with a precomputed
+   * affine transform, so that forwarding a mouse event doesn't need to query either window.
+   *
+   * The transform is derived from the geometry of both windows and only has to be recomputed when
+   * either of them moves, is resized or changes DPI. Because the geometry is in physical pixels, a
+   * difference in DPI between the monitors the windows are on is part of the scale factor. Like
+   * `RegionOfInterest`, `Invalidate` may be called from a window event thread, while the other
+   * members belong to the thread that handles the mouse input.
+   */
+  class CoordinateMapper {
+    public:
+      CoordinateMapper();
+      ~CoordinateMapper();
+
+      CoordinateMapper(const CoordinateMapper&)            = delete;
+      CoordinateMapper& operator=(const CoordinateMapper&) = delete;
+
+      /**
+       * @brief Marks the transform as stale so it's recomputed before the next mapping.
+       */
+      void Invalidate();
+
+      /**
+       * @returns `false` if the transform must be recomputed with `Update` before mapping points.
+       */
+      bool IsValid() const;
+
+      /**
+       * @brief Recomputes the transform from the geometry of the two windows.
+       * @param downscaled The geometry of the downscaled window.
+       * @param source The geometry of the source window.
+       */
+      void Update(const WindowGeometry& downscaled, const WindowGeometry& source);
+
+      /**
+       * @brief Maps a screen point into the coordinate spaces of both windows.
+       * @param screenX The x-coordinate of the point on the screen.
+       * @param screenY The y-coordinate of the point on the screen.
+       */
+      MappedPoint Map(int32_t screenX, int32_t screenY) const;
+
+      /**
+       * @brief Maps a point in the source window's client area back onto the screen, over the
+       * downscaled window. The inverse of `Map`: the result is the point that `Map` sends onto the
+       * source point, or the next one away from the client area's origin if there's none. So when
+       * the source is at least as large as the downscaled window, every point maps back onto
+       * itself.
+       * @param sourceX The x-coordinate relative to the source window's client area.
+       * @param sourceY The y-coordinate relative to the source window's client area.
+       * @param screenX Receives the x-coordinate of the point on the screen.
+       * @param screenY Receives the y-coordinate of the point on the screen.
+       */
+      void MapSourceToScreen(
+        int32_t sourceX,
+        int32_t sourceY,
+        int32_t& screenX,
+        int32_t& screenY
+      ) const;
+
+      /**
+       * @returns The geometry of the downscaled window the transform was computed from.
+       */
+      const WindowGeometry& GetDownscaledGeometry() const;
+
+      /**
+       * @returns The geometry of the source window the transform was computed from.
+       */
+      const WindowGeometry& GetSourceGeometry() const;
+
+    private:
+      struct Impl;
+      std::unique_ptr<Impl> impl;
+  };
+}
@@ -0,0 +1,93 @@
+#include "cursor-predictor.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Downscaler::Cpp::Core::NativeImpls {
+  CursorPredictor::CursorPredictor(const CursorPredictorOptions& options) : options(options) {
+    this->options.velocityTimeConstant = std::max<int64_t>(options.velocityTimeConstant, 1);
+    this->options.maxHorizon           = std::max<int64_t>(options.maxHorizon, 0);
+    this->options.idleTimeout          = std::max<int64_t>(options.idleTimeout, 1);
+  }
+
+  void CursorPredictor::Reset() {
+    hasSample   = false;
+    hasVelocity = false;
+    velocityX   = 0.0;
+    velocityY   = 0.0;
+  }
+
+  void CursorPredictor::AddSample(int64_t time, double x, double y) {
+    auto elapsed = time - lastTime;
+
+    // Start over from the sample the first time round, or when the mouse was at rest, since the
+    // velocity from before then says nothing about the motion that's starting now.
+    if (!hasSample || elapsed > options.idleTimeout || elapsed < 0) {
+      this->x     = x;
+      this->y     = y;
+      lastTime    = time;
+      hasSample   = true;
+      hasVelocity = false;
+      velocityX   = 0.0;
+      velocityY   = 0.0;
+      return;
+    }
+
+    // Samples that arrive together, e.g. from the same batch of raw input, only move the cursor.
+    if (elapsed == 0) {
+      this->x = x;
+      this->y = y;
+      return;
+    }
+
+    auto interval  = static_cast<double>(elapsed);
+    auto measuredX = (x - this->x) / interval;
+    auto measuredY = (y - this->y) / interval;
+
+    // Blend in the measured velocity by how long it was measured over relative to the time
+    // constant, so a burst of closely spaced samples weighs as much as a single sparse one. The
+    // first measurement is taken as is.
+    auto weight = hasVelocity
+                    ? 1.0 - std::exp(-interval / static_cast<double>(options.velocityTimeConstant))
+                    : 1.0;
+    velocityX  += weight * (measuredX - velocityX);
+    velocityY  += weight * (measuredY - velocityY);
+
+    this->x     = x;
+    this->y     = y;
+    lastTime    = time;
+    hasVelocity = true;
+  }
+
+  PredictedPoint CursorPredictor::Predict(int64_t now, int64_t horizon) const {
+    PredictedPoint point;
+    if (!hasSample) {
+      return point;
+    }
+
+    point.x = x;
+    point.y = y;
+
+    // Once the mouse has gone quiet, it's at rest wherever it was last reported.
+    auto sinceLastSample = now - lastTime;
+    if (!hasVelocity || sinceLastSample > options.idleTimeout) {
+      return point;
+    }
+
+    auto ahead = static_cast<double>(
+      std::clamp<int64_t>(sinceLastSample + horizon, 0, options.maxHorizon)
+    );
+    point.x              = x + velocityX * ahead;
+    point.y              = y + velocityY * ahead;
+    point.isExtrapolated = true;
+    return point;
+  }
+
+  double CursorPredictor::GetVelocityX() const {
+    return velocityX * 1'000'000.0;
+  }
+
+  double CursorPredictor::GetVelocityY() const {
+    return velocityY * 1'000'000.0;
+  }
+}
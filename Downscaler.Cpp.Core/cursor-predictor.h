@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Downscaler::Cpp::Core::NativeImpls {
+  /**
+   * @brief Configures how a `CursorPredictor` filters and extrapolates the cursor.
+   */
+  struct CursorPredictorOptions {
+    /**
+     * The time constant, in microseconds, of the filter that smooths the velocity of the cursor.
+     * Shorter time constants react to changes of direction sooner, longer ones jitter less. Being
+     * a time rather than a per-sample gain, it behaves the same whatever the mouse's polling rate.
+     */
+    int64_t velocityTimeConstant = 6'000;
+
+    /**
+     * The furthest ahead, in microseconds, that the cursor is ever extrapolated past its last
+     * sample.
+     */
+    int64_t maxHorizon = 50'000;
+
+    /**
+     * How long, in microseconds, the mouse can go without reporting motion before it's considered
+     * to be at rest. Mice report motion every 1 to 8 ms while they're moving.
+     */
+    int64_t idleTimeout = 20'000;
+  };
+
+  /**
+   * @brief A predicted cursor position.
+   */
+  struct PredictedPoint {
+    double x = 0.0;
+    double y = 0.0;
+
+    /** Whether the position was extrapolated, rather than being the last known position. */
+    bool isExtrapolated = false;
+  };
+
+  /**
+   * @brief Predicts where the cursor will be a short time from now, so input forwarded to a window
+   * whose output is shown with a delay lines up with where the mouse is by the time it's shown.
+   *
+   * The cursor is modelled as moving at a constant velocity, which is estimated from timestamped
+   * samples of its position with an exponential filter. Predictions extrapolate the last sample
+   * along the filtered velocity. Once the mouse stops reporting motion, it's assumed to be at rest
+   * and predictions fall back to the last sample, so the cursor never drifts on its own.
+   *
+   * Must be used from a single thread, or under a lock.
+   */
+  class CursorPredictor {
+    public:
+      explicit CursorPredictor(const CursorPredictorOptions& options = {});
+
+      /**
+       * @brief Forgets every sample, e.g. after the cursor was warped.
+       */
+      void Reset();
+
+      /**
+       * @brief Adds a sample of the cursor position.
+       * @param time When the cursor was at the position, in microseconds.
+       * @param x The x-coordinate of the cursor.
+       * @param y The y-coordinate of the cursor.
+       */
+      void AddSample(int64_t time, double x, double y);
+
+      /**
+       * @brief Predicts the position of the cursor.
+       * @param now The current time, in microseconds.
+       * @param horizon How far ahead of `now` to predict the position, in microseconds.
+       * @returns The predicted position, or the last sample if the mouse is at rest.
+       */
+      PredictedPoint Predict(int64_t now, int64_t horizon) const;
+
+      /**
+       * @returns The filtered horizontal velocity, in units per second.
+       */
+      double GetVelocityX() const;
+
+      /**
+       * @returns The filtered vertical velocity, in units per second.
+       */
+      double GetVelocityY() const;
+
+    private:
+      CursorPredictorOptions options;
+
+      // The last sample.
+      double x = 0.0;
+      double y = 0.0;
+      int64_t lastTime = 0;
+      bool hasSample = false;
+
+      // The filtered velocity, in units per microsecond.
+      double velocityX = 0.0;
+      double velocityY = 0.0;
+      bool hasVelocity = false;
+  };
+}
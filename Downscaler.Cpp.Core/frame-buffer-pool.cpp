@@ -0,0 +1,310 @@
+#include "frame-buffer-pool.h"
+
+#include <array>
+#include <atomic>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace Downscaler::Cpp::Core::NativeImpls {
+  namespace {
+    // The power of two of the smallest and largest size classes: 4 KiB to 64 GiB.
+    constexpr int firstExponent = 12;
+    constexpr int lastExponent = 36;
+    constexpr size_t classCount = lastExponent - firstExponent + 1;
+
+    static_assert(
+      (size_t{1} << firstExponent) == FrameBufferPool::MinBufferSize,
+      "The first size class must match the minimum buffer size."
+    );
+
+    /**
+     * @brief Maps a request onto the index of the smallest size class that can hold it.
+     * @returns The index of the size class, or `classCount` if the request is too large.
+     */
+    size_t ClassFor(size_t bytes) {
+      size_t index = 0;
+      while (index < classCount && (size_t{1} << (firstExponent + index)) < bytes) {
+        ++index;
+      }
+      return index;
+    }
+
+    /**
+     * @returns The size of a large page in bytes, or 0 if large pages aren't supported.
+     */
+    size_t LargePageSize() {
+#ifdef _WIN32
+      return GetLargePageMinimum();
+#else
+      // The default huge page size on x86-64 and most ARM64 configurations.
+      return size_t{2} * 1024 * 1024;
+#endif
+    }
+
+    /**
+     * @brief Tries to make large pages usable by the process.
+     * @returns Whether large pages can be allocated.
+     */
+    bool EnableLargePages() {
+#ifdef _WIN32
+      if (GetLargePageMinimum() == 0) {
+        return false;
+      }
+
+      // Large pages can only be allocated while the "Lock pages in memory" privilege is enabled on
+      // the process token, which it never is by default.
+      HANDLE token;
+      if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token)) {
+        return false;
+      }
+
+      TOKEN_PRIVILEGES privileges{};
+      privileges.PrivilegeCount = 1;
+      privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+
+      auto isEnabled =
+        LookupPrivilegeValueW(nullptr, SE_LOCK_MEMORY_NAME, &privileges.Privileges[0].Luid) &&
+        AdjustTokenPrivileges(token, FALSE, &privileges, 0, nullptr, nullptr) &&
+        // AdjustTokenPrivileges succeeds even if the privilege wasn't granted to the user.
+        GetLastError() == ERROR_SUCCESS;
+
+      CloseHandle(token);
+      return isEnabled;
+#else
+      // Allocation falls back to transparent huge pages when none are reserved.
+      return true;
+#endif
+    }
+
+    /**
+     * @brief Allocates memory straight from the OS. OS allocations are page aligned, which
+     * satisfies `FrameBufferPool::Alignment`.
+     * @param bytes The size of the allocation, which is a power of two.
+     * @param tryLargePages Whether to back the allocation with large pages if possible.
+     * @param isLargePage Receives whether the allocation is backed by large pages.
+     */
+    uint8_t* AllocatePages(size_t bytes, bool tryLargePages, bool& isLargePage) {
+      isLargePage = false;
+
+#ifdef _WIN32
+      if (tryLargePages) {
+        auto memory = VirtualAlloc(
+          nullptr,
+          bytes,
+          MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+          PAGE_READWRITE
+        );
+        if (memory != nullptr) {
+          isLargePage = true;
+          return static_cast<uint8_t*>(memory);
+        }
+      }
+
+      return static_cast<uint8_t*>(
+        VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE)
+      );
+#else
+      constexpr int protection = PROT_READ | PROT_WRITE;
+      constexpr int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+
+#ifdef MAP_HUGETLB
+      if (tryLargePages) {
+        auto memory = mmap(nullptr, bytes, protection, flags | MAP_HUGETLB, -1, 0);
+        if (memory != MAP_FAILED) {
+          isLargePage = true;
+          return static_cast<uint8_t*>(memory);
+        }
+      }
+#endif
+
+      auto memory = mmap(nullptr, bytes, protection, flags, -1, 0);
+      if (memory == MAP_FAILED) {
+        return nullptr;
+      }
+
+#ifdef MADV_HUGEPAGE
+      // Without reserved huge pages, ask for transparent huge pages instead.
+      if (tryLargePages) {
+        isLargePage = madvise(memory, bytes, MADV_HUGEPAGE) == 0;
+      }
+#endif
+
+      return static_cast<uint8_t*>(memory);
+#endif
+    }
+
+    void FreePages(uint8_t* memory, size_t bytes) {
+#ifdef _WIN32
+      (void)bytes;
+      VirtualFree(memory, 0, MEM_RELEASE);
+#else
+      munmap(memory, bytes);
+#endif
+    }
+  }
+
+  PooledFrameBuffer::~PooledFrameBuffer() {
+    Reset();
+  }
+
+  PooledFrameBuffer::PooledFrameBuffer(PooledFrameBuffer&& other) noexcept
+    : pool(other.pool), data(other.data), capacity(other.capacity) {
+    other.pool     = nullptr;
+    other.data     = nullptr;
+    other.capacity = 0;
+  }
+
+  PooledFrameBuffer& PooledFrameBuffer::operator=(PooledFrameBuffer&& other) noexcept {
+    if (this != &other) {
+      Reset();
+      pool           = other.pool;
+      data           = other.data;
+      capacity       = other.capacity;
+      other.pool     = nullptr;
+      other.data     = nullptr;
+      other.capacity = 0;
+    }
+    return *this;
+  }
+
+  void PooledFrameBuffer::Reset() {
+    if (pool != nullptr && data != nullptr) {
+      pool->Release(data, capacity);
+    }
+
+    pool     = nullptr;
+    data     = nullptr;
+    capacity = 0;
+  }
+
+  struct FrameBufferPool::Impl {
+    // The free buffers of each size class. A null slot is empty. Buffers are taken with an
+    // exchange and returned with a compare-exchange against null, so a slot can never hand the
+    // same buffer out twice and there's no ABA problem to guard against.
+    std::array<std::array<std::atomic<uint8_t*>, BuffersPerClass>, classCount> slots{};
+
+    std::atomic<bool> useLargePages{false};
+    size_t largePageSize = LargePageSize();
+
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+    std::atomic<uint64_t> largePageAllocations{0};
+    std::atomic<uint64_t> bytesAllocated{0};
+  };
+
+  FrameBufferPool::FrameBufferPool() : impl(std::make_unique<Impl>()) {}
+
+  FrameBufferPool::~FrameBufferPool() {
+    Trim();
+  }
+
+  PooledFrameBuffer FrameBufferPool::Acquire(size_t bytes) {
+    if (bytes == 0) {
+      return {};
+    }
+
+    auto index = ClassFor(bytes);
+    if (index == classCount) {
+      return {};
+    }
+
+    auto capacity = size_t{1} << (firstExponent + index);
+
+    for (auto& slot : impl->slots[index]) {
+      // Skip the exchange, and the cache line ownership it takes, when the slot is empty.
+      if (slot.load(std::memory_order_relaxed) == nullptr) {
+        continue;
+      }
+
+      auto data = slot.exchange(nullptr, std::memory_order_acquire);
+      if (data != nullptr) {
+        impl->hits.fetch_add(1, std::memory_order_relaxed);
+        return {this, data, capacity};
+      }
+    }
+
+    impl->misses.fetch_add(1, std::memory_order_relaxed);
+
+    // Only buffers spanning whole large pages can be backed by them.
+    auto tryLargePages = impl->useLargePages.load(std::memory_order_relaxed) &&
+                         impl->largePageSize != 0 &&
+                         capacity >= impl->largePageSize;
+
+    bool isLargePage;
+    auto data = AllocatePages(capacity, tryLargePages, isLargePage);
+    if (data == nullptr) {
+      return {};
+    }
+
+    if (isLargePage) {
+      impl->largePageAllocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    impl->bytesAllocated.fetch_add(capacity, std::memory_order_relaxed);
+
+    return {this, data, capacity};
+  }
+
+  void FrameBufferPool::Release(uint8_t* data, size_t capacity) {
+    auto index = ClassFor(capacity);
+
+    for (auto& slot : impl->slots[index]) {
+      uint8_t* expected = nullptr;
+      if (slot.load(std::memory_order_relaxed) == nullptr &&
+          slot.compare_exchange_strong(expected, data, std::memory_order_release)) {
+        return;
+      }
+    }
+
+    // Every slot of the class is taken, so the buffer is surplus.
+    FreePages(data, capacity);
+    impl->bytesAllocated.fetch_sub(capacity, std::memory_order_relaxed);
+  }
+
+  bool FrameBufferPool::SetLargePagesEnabled(bool enabled) {
+    auto isAvailable = enabled && impl->largePageSize != 0 && EnableLargePages();
+    impl->useLargePages.store(isAvailable, std::memory_order_relaxed);
+    return isAvailable;
+  }
+
+  void FrameBufferPool::Trim() {
+    for (size_t index = 0; index < classCount; ++index) {
+      auto capacity = size_t{1} << (firstExponent + index);
+
+      for (auto& slot : impl->slots[index]) {
+        auto data = slot.exchange(nullptr, std::memory_order_acquire);
+        if (data != nullptr) {
+          FreePages(data, capacity);
+          impl->bytesAllocated.fetch_sub(capacity, std::memory_order_relaxed);
+        }
+      }
+    }
+  }
+
+  uint64_t FrameBufferPool::GetHits() const {
+    return impl->hits.load(std::memory_order_relaxed);
+  }
+
+  uint64_t FrameBufferPool::GetMisses() const {
+    return impl->misses.load(std::memory_order_relaxed);
+  }
+
+  uint64_t FrameBufferPool::GetLargePageAllocations() const {
+    return impl->largePageAllocations.load(std::memory_order_relaxed);
+  }
+
+  uint64_t FrameBufferPool::GetBytesAllocated() const {
+    return impl->bytesAllocated.load(std::memory_order_relaxed);
+  }
+
+  FrameBufferPool& GetFrameBufferPool() {
+    // Deliberately never destroyed, so buffers released during static destruction, e.g. by a
+    // blender owned by a static, still have a pool to go back to.
+    static auto* pool = new FrameBufferPool();
+    return *pool;
+  }
+}
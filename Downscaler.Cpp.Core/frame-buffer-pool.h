@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace Downscaler::Cpp::Core::NativeImpls {
+  class FrameBufferPool;
+
+  /**
+   * @brief A buffer borrowed from a `FrameBufferPool`. The buffer is returned to the pool when
+   * this is destroyed or reset, so it can be handed out again without another allocation.
+   */
+  class PooledFrameBuffer {
+    public:
+      PooledFrameBuffer() = default;
+      ~PooledFrameBuffer();
+
+      PooledFrameBuffer(PooledFrameBuffer&& other) noexcept;
+      PooledFrameBuffer& operator=(PooledFrameBuffer&& other) noexcept;
+
+      PooledFrameBuffer(const PooledFrameBuffer&)            = delete;
+      PooledFrameBuffer& operator=(const PooledFrameBuffer&) = delete;
+
+      /**
+       * @brief Returns the buffer to its pool, leaving this empty.
+       */
+      void Reset();
+
+      /**
+       * @returns The start of the buffer, aligned to `FrameBufferPool::Alignment`, or null if
+       * this is empty.
+       */
+      uint8_t* GetData() const {
+        return data;
+      }
+
+      /**
+       * @returns The number of usable bytes in the buffer. May be more than was requested.
+       */
+      size_t GetCapacity() const {
+        return capacity;
+      }
+
+      explicit operator bool() const {
+        return data != nullptr;
+      }
+
+    private:
+      friend class FrameBufferPool;
+
+      PooledFrameBuffer(FrameBufferPool* pool, uint8_t* data, size_t capacity)
+        : pool(pool), data(data), capacity(capacity) {}
+
+      FrameBufferPool* pool = nullptr;
+      uint8_t* data = nullptr;
+      size_t capacity = 0;
+  };
+
+  /**
+   * @brief Hands out large, aligned buffers for frames and scratch space and recycles them, so
+   * that a pipeline running at a steady frame size stops allocating after its first frame.
+   *
+   * Requests are rounded up to a power-of-two size class. Each size class keeps a small, fixed
+   * number of free buffers in a lock-free slot array, so buffers can be acquired and released from
+   * any thread without taking a lock. Buffers that don't fit in their class's slots are returned
+   * to the OS.
+   *
+   * Buffers are allocated straight from the OS. When large pages are enabled, buffers that are at
+   * least one large page in size are backed by large pages where the OS allows it, which cuts TLB
+   * misses when a whole frame is streamed through. Allocation falls back to regular pages if large
+   * pages are unavailable, e.g. because the process lacks the "Lock pages in memory" privilege on
+   * Windows or no huge pages are reserved on Linux.
+   *
+   * The pool backs the native pipeline's own memory, such as the temporal blender's frame ring.
+   * Frames read back from the GPU land in a managed array first, since Win2D can only read back
+   * into a WinRT buffer.
+   */
+  class FrameBufferPool {
+    public:
+      /**
+       * @brief The alignment, in bytes, of every buffer handed out. Matches a cache line.
+       */
+      static constexpr size_t Alignment = 64;
+
+      /**
+       * @brief The smallest size class in bytes.
+       */
+      static constexpr size_t MinBufferSize = 4096;
+
+      /**
+       * @brief The number of free buffers kept for each size class.
+       */
+      static constexpr size_t BuffersPerClass = 8;
+
+      FrameBufferPool();
+      ~FrameBufferPool();
+
+      FrameBufferPool(const FrameBufferPool&)            = delete;
+      FrameBufferPool& operator=(const FrameBufferPool&) = delete;
+
+      /**
+       * @brief Borrows a buffer of at least the given size. The contents of the buffer are
+       * undefined.
+       * @param bytes The number of bytes needed.
+       * @returns The buffer, or an empty buffer if `bytes` is zero or the allocation failed.
+       */
+      PooledFrameBuffer Acquire(size_t bytes);
+
+      /**
+       * @brief Sets whether new buffers may be backed by large pages. Buffers that are already
+       * pooled are unaffected.
+       * @param enabled Whether to try large pages.
+       * @returns Whether large pages are available to the process.
+       */
+      bool SetLargePagesEnabled(bool enabled);
+
+      /**
+       * @brief Returns every pooled buffer to the OS. Borrowed buffers are unaffected.
+       */
+      void Trim();
+
+      /**
+       * @returns The number of requests served from a pooled buffer.
+       */
+      uint64_t GetHits() const;
+
+      /**
+       * @returns The number of requests that needed a new allocation.
+       */
+      uint64_t GetMisses() const;
+
+      /**
+       * @returns The number of allocations that are backed by large pages.
+       */
+      uint64_t GetLargePageAllocations() const;
+
+      /**
+       * @returns The number of bytes currently allocated by the pool, borrowed or not.
+       */
+      uint64_t GetBytesAllocated() const;
+
+    private:
+      friend class PooledFrameBuffer;
+
+      void Release(uint8_t* data, size_t capacity);
+
+      struct Impl;
+      std::unique_ptr<Impl> impl;
+  };
+
+  /**
+   * @returns The pool shared by the native pipeline. It lives for the lifetime of the process.
+   */
+  FrameBufferPool& GetFrameBufferPool();
+}
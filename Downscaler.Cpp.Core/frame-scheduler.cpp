@@ -0,0 +1,233 @@
+#include "frame-scheduler.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+namespace Downscaler::Cpp::Core::NativeImpls {
+  namespace {
+    /**
+     * @brief The default clock, backed by `std::chrono::steady_clock`.
+     */
+    class SteadyClock final : public IClock {
+      public:
+        int64_t NowMicroseconds() override {
+          return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()
+          ).count();
+        }
+
+        void SleepUntil(int64_t microseconds) override {
+          // The OS scheduler can overshoot a sleep by a millisecond or more, so we only sleep for
+          // the bulk of the wait and spin for the remainder.
+          constexpr int64_t spinThreshold = 1500;
+
+          auto remaining = microseconds - NowMicroseconds();
+          if (remaining > spinThreshold) {
+            std::this_thread::sleep_for(std::chrono::microseconds(remaining - spinThreshold));
+          }
+
+          while (NowMicroseconds() < microseconds) {
+            std::this_thread::yield();
+          }
+        }
+    };
+
+    // Source frame intervals longer than this are treated as a pause in the source rather than a
+    // sample of its frame rate.
+    constexpr int64_t maxFrameInterval = 1'000'000;
+
+    // How close, relative to the nearest whole number, the refresh-to-source ratio must be before
+    // the source frame rate is snapped to an exact divisor of the refresh rate.
+    constexpr double snapTolerance = 0.01;
+  }
+
+  IClock& GetSteadyClock() {
+    static SteadyClock clock;
+    return clock;
+  }
+
+  struct FrameScheduler::Impl {
+    FrameSchedulerOptions options;
+    IClock* clock;
+
+    // The length of a single refresh slot in microseconds.
+    double slotPeriod;
+
+    LatencyHistogram cadenceError;
+
+    // State shared with the capture thread.
+    std::atomic<uint64_t> framesArrived{0};
+    std::atomic<int64_t> lastArrival{-1};
+    std::atomic<int64_t> averageFrameInterval{0};
+    std::atomic<uint64_t> missedSlots{0};
+
+    // State owned by the presentation thread.
+    bool started = false;
+    int64_t epoch = 0;
+    uint64_t slotIndex = 0;
+    uint64_t framesConsumed = 0;
+    double phase = 0.0;
+    uint32_t slotsShown = 0;
+    bool hasFrame = false;
+
+    // Whether a frame boundary passed without a new frame being available. The next frame to
+    // arrive is then presented immediately and the repetition pattern is realigned to it.
+    bool frameOwed = true;
+
+    Impl(const FrameSchedulerOptions& options, IClock* clock)
+      : options(options),
+        clock(clock != nullptr ? clock : &GetSteadyClock()),
+        slotPeriod(1'000'000.0 / options.targetRefreshRate) {}
+
+    int64_t SlotTime(uint64_t index) const {
+      return epoch + static_cast<int64_t>(std::llround(static_cast<double>(index) * slotPeriod));
+    }
+
+    double SourceFrameRate() const {
+      auto target = options.targetRefreshRate;
+      auto source = options.sourceFrameRate;
+
+      // Fall back to the measured frame rate, and if there isn't one yet, assume the source
+      // matches the output.
+      if (source <= 0.0) {
+        auto interval = averageFrameInterval.load(std::memory_order_relaxed);
+        source = interval > 0 ? 1'000'000.0 / static_cast<double>(interval) : target;
+      }
+
+      // Measured frame rates are never exact. When the source is within tolerance of an exact
+      // divisor of the refresh rate, use the divisor so every frame is held for the same number
+      // of slots.
+      auto ratio = target / source;
+      auto whole = std::round(ratio);
+      if (whole >= 1.0 && std::abs(ratio - whole) / whole < snapTolerance) {
+        return target / whole;
+      }
+
+      return source;
+    }
+  };
+
+  FrameScheduler::FrameScheduler(const FrameSchedulerOptions& options, IClock* clock)
+    : impl(std::make_unique<Impl>(options, clock)) {}
+
+  FrameScheduler::~FrameScheduler() = default;
+
+  void FrameScheduler::OnFrameArrived() {
+    auto now  = impl->clock->NowMicroseconds();
+    auto last = impl->lastArrival.exchange(now, std::memory_order_relaxed);
+
+    // Track an exponential moving average of the source frame interval.
+    if (last >= 0) {
+      auto interval = now - last;
+      if (interval > 0 && interval < maxFrameInterval) {
+        auto average = impl->averageFrameInterval.load(std::memory_order_relaxed);
+        average = average == 0 ? interval : average + (interval - average) / 8;
+        impl->averageFrameInterval.store(average, std::memory_order_relaxed);
+      }
+    }
+
+    impl->framesArrived.fetch_add(1, std::memory_order_release);
+  }
+
+  PresentAction FrameScheduler::WaitForNextSlot() {
+    impl->clock->SleepUntil(GetNextSlotTime());
+    return OnSlot(impl->clock->NowMicroseconds());
+  }
+
+  PresentAction FrameScheduler::OnSlot(int64_t now) {
+    auto& state = *impl;
+
+    if (!state.started) {
+      state.started   = true;
+      state.epoch     = now;
+      state.slotIndex = 0;
+    }
+
+    auto target = state.options.targetRefreshRate;
+    auto source = state.SourceFrameRate();
+
+    // If whole slots were skipped, e.g. because the presentation thread was descheduled, jump
+    // ahead rather than trying to catch up by presenting in a burst.
+    auto ideal = state.SlotTime(state.slotIndex);
+    if (static_cast<double>(now - ideal) >= state.slotPeriod) {
+      auto missed = static_cast<uint64_t>(static_cast<double>(now - ideal) / state.slotPeriod);
+      state.slotIndex += missed;
+      state.phase = std::fmod(state.phase + static_cast<double>(missed) * source, target);
+      state.missedSlots.fetch_add(missed, std::memory_order_relaxed);
+      ideal = state.SlotTime(state.slotIndex);
+    }
+
+    state.cadenceError.Record(now - ideal);
+    state.slotIndex++;
+
+    // Distribute the source frames across the slots by accumulating the source rate each slot and
+    // starting a new frame whenever a full slot's worth has accumulated. Any excess beyond a
+    // single frame is dropped, which is the expected behaviour when the source outpaces the output.
+    state.phase += source;
+    auto isFrameBoundary = state.phase >= target;
+    if (isFrameBoundary) {
+      state.phase = std::fmod(state.phase, target);
+    }
+
+    auto arrived   = state.framesArrived.load(std::memory_order_acquire);
+    auto isPending = arrived != state.framesConsumed;
+
+    if ((isFrameBoundary || state.frameOwed) && isPending) {
+      // A late frame restarts the pattern so it's held for as long as an on-time frame would be.
+      if (state.frameOwed && !isFrameBoundary) {
+        state.phase = 0.0;
+      }
+
+      state.framesConsumed = arrived;
+      state.hasFrame       = true;
+      state.frameOwed      = false;
+      state.slotsShown     = 1;
+      return PresentAction::PresentNewFrame;
+    }
+
+    if (isFrameBoundary) {
+      state.frameOwed = true;
+    }
+
+    if (!state.hasFrame) {
+      return PresentAction::BlackFrame;
+    }
+
+    state.slotsShown++;
+
+    // Black frames are only inserted when every frame is held for at least two slots. Otherwise
+    // the light output would flicker unevenly between frames.
+    auto canInsertBlackFrames = state.options.blackFrameInsertion && target >= 2.0 * source;
+    if (canInsertBlackFrames && state.slotsShown > state.options.litSlotsPerFrame) {
+      return PresentAction::BlackFrame;
+    }
+
+    return PresentAction::RepeatFrame;
+  }
+
+  bool FrameScheduler::IsSlotDue(int64_t now) const {
+    return static_cast<double>(GetNextSlotTime() - now) <= impl->slotPeriod / 4;
+  }
+
+  int64_t FrameScheduler::GetNextSlotTime() const {
+    if (!impl->started) {
+      return impl->clock->NowMicroseconds();
+    }
+
+    return impl->SlotTime(impl->slotIndex);
+  }
+
+  double FrameScheduler::GetSourceFrameRate() const {
+    return impl->SourceFrameRate();
+  }
+
+  uint64_t FrameScheduler::GetMissedSlots() const {
+    return impl->missedSlots.load(std::memory_order_relaxed);
+  }
+
+  LatencyHistogram& FrameScheduler::GetCadenceErrorHistogram() {
+    return impl->cadenceError;
+  }
+}
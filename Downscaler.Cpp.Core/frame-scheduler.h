@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "latency-histogram.h"
+
+namespace Downscaler::Cpp::Core::NativeImpls {
+  /**
+   * @brief A source of time for the components that pace their work against the wall clock. Kept
+   * abstract so that the pacing logic can be driven by a virtual clock.
+   */
+  class IClock {
+    public:
+      virtual ~IClock() = default;
+
+      /**
+       * @returns The current time of a monotonic clock, in microseconds.
+       */
+      virtual int64_t NowMicroseconds() = 0;
+
+      /**
+       * @brief Blocks the calling thread until the clock reaches the given time.
+       * @param microseconds The time to wait for, as returned by `NowMicroseconds`.
+       */
+      virtual void SleepUntil(int64_t microseconds) = 0;
+  };
+
+  /**
+   * @returns A clock backed by `std::chrono::steady_clock`. The returned clock lives for the
+   * lifetime of the process.
+   */
+  IClock& GetSteadyClock();
+
+  /**
+   * @brief What should be shown on the output during a refresh slot.
+   */
+  enum class PresentAction : uint8_t {
+    /** The most recently captured frame should be drawn and presented. */
+    PresentNewFrame,
+    /** The previously presented frame should be presented again. */
+    RepeatFrame,
+    /** A black frame should be presented. */
+    BlackFrame
+  };
+
+  /**
+   * @brief Configures how a `FrameScheduler` paces the output.
+   */
+  struct FrameSchedulerOptions {
+    /** The refresh rate, in Hz, that the output is paced against. */
+    double targetRefreshRate = 60.0;
+
+    /**
+     * The frame rate, in Hz, of the source. When zero or less, the frame rate is measured from the
+     * arrival times of the captured frames.
+     */
+    double sourceFrameRate = 0.0;
+
+    /**
+     * Whether to insert black frames between repeated frames. This only takes effect when the
+     * target refresh rate is at least twice the source frame rate.
+     */
+    bool blackFrameInsertion = false;
+
+    /**
+     * The number of refresh slots each source frame is lit for before black frames are inserted
+     * when black frame insertion is enabled.
+     */
+    uint32_t litSlotsPerFrame = 1;
+  };
+
+  /**
+   * @brief Paces presentation of captured frames against a fixed output refresh rate.
+   *
+   * The output is divided into refresh slots of equal length. Source frames are assigned to slots
+   * using an error-diffusion pattern so each frame is held for the same number of slots (or as
+   * close as the ratio allows), which avoids the judder of presenting frames as soon as they
+   * arrive. The lateness of every slot relative to its ideal time is recorded in the cadence error
+   * histogram.
+   *
+   * `OnFrameArrived` may be called from the capture thread while the other members are called from
+   * a single presentation thread.
+   */
+  class FrameScheduler {
+    public:
+      /**
+       * @param options The pacing options.
+       * @param clock The clock to pace against. If null, the steady clock is used.
+       */
+      explicit FrameScheduler(const FrameSchedulerOptions& options, IClock* clock = nullptr);
+      ~FrameScheduler();
+
+      FrameScheduler(const FrameScheduler&)            = delete;
+      FrameScheduler& operator=(const FrameScheduler&) = delete;
+
+      /**
+       * @brief Notifies the scheduler that a new source frame is ready to be presented.
+       */
+      void OnFrameArrived();
+
+      /**
+       * @brief Sleeps until the next refresh slot and decides what to present during it.
+       * @returns The action to take for the slot.
+       */
+      PresentAction WaitForNextSlot();
+
+      /**
+       * @brief Decides what to present during the refresh slot that begins at the given time. Use
+       * this instead of `WaitForNextSlot` when the caller already waits for the vertical blank.
+       * @param now The current time of the scheduler's clock, in microseconds.
+       * @returns The action to take for the slot.
+       */
+      PresentAction OnSlot(int64_t now);
+
+      /**
+       * @brief Checks whether a vertical blank at the given time should service the next refresh
+       * slot, i.e. the slot's ideal time is no more than a quarter of a slot away. Lets a caller
+       * that's woken on every vertical blank pace a target refresh rate below the display's.
+       * @param now The current time of the scheduler's clock, in microseconds.
+       */
+      bool IsSlotDue(int64_t now) const;
+
+      /**
+       * @returns The ideal time of the next refresh slot, in microseconds.
+       */
+      int64_t GetNextSlotTime() const;
+
+      /**
+       * @returns The source frame rate used for the repetition pattern, in Hz.
+       */
+      double GetSourceFrameRate() const;
+
+      /**
+       * @returns The number of refresh slots that passed without being serviced.
+       */
+      uint64_t GetMissedSlots() const;
+
+      /**
+       * @returns The distribution of how far each slot was serviced from its ideal time.
+       */
+      LatencyHistogram& GetCadenceErrorHistogram();
+
+    private:
+      struct Impl;
+      std::unique_ptr<Impl> impl;
+  };
+}
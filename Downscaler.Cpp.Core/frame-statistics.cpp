@@ -0,0 +1,99 @@
+#include "frame-statistics.h"
+
+namespace Downscaler::Cpp::Core::NativeImpls {
+  void FrameStatisticsAccumulator::Begin() {
+    histogram.fill(0);
+    pixelCount = 0;
+  }
+
+  void FrameStatisticsAccumulator::AccumulateRow(const uint8_t* pixels, uint32_t width) {
+    for (uint32_t x = 0; x < width; ++x) {
+      auto pixel = pixels + static_cast<size_t>(x) * 4;
+
+      // BT.709 luma with weights scaled to add up to 256: 0.2126 R + 0.7152 G + 0.0722 B.
+      auto luma = (54u * pixel[2] + 183u * pixel[1] + 19u * pixel[0] + 128u) >> 8;
+      histogram[luma]++;
+    }
+
+    pixelCount += width;
+  }
+
+  void FrameStatisticsAccumulator::AccumulateImage(
+    const uint8_t* pixels,
+    uint32_t width,
+    uint32_t height,
+    size_t stride
+  ) {
+    for (uint32_t y = 0; y < height; ++y) {
+      AccumulateRow(pixels + stride * y, width);
+    }
+  }
+
+  void FrameStatisticsAccumulator::AccumulateImage(const ConstImageView& image) {
+    AccumulateImage(image.pixels, image.width, image.height, image.stride);
+  }
+
+  const FrameStatistics& FrameStatisticsAccumulator::Finish() {
+    statistics.histogram  = histogram;
+    statistics.pixelCount = pixelCount;
+
+    if (pixelCount == 0) {
+      statistics.minLuma  = 0;
+      statistics.maxLuma  = 0;
+      statistics.meanLuma = 0.0;
+      statistics.isBlack  = true;
+      return statistics;
+    }
+
+    // Everything else is derived from the 256 bins rather than tracked per pixel.
+    uint64_t lumaSum = 0;
+    uint64_t darkPixels = 0;
+    int minLuma = -1;
+    int maxLuma = 0;
+    for (int luma = 0; luma < 256; ++luma) {
+      auto count = histogram[luma];
+      if (count == 0) {
+        continue;
+      }
+
+      if (minLuma < 0) {
+        minLuma = luma;
+      }
+      maxLuma = luma;
+      lumaSum += static_cast<uint64_t>(count) * luma;
+
+      if (luma <= blackThreshold) {
+        darkPixels += count;
+      }
+    }
+
+    auto brightPixels = pixelCount - darkPixels;
+
+    statistics.minLuma  = static_cast<uint8_t>(minLuma);
+    statistics.maxLuma  = static_cast<uint8_t>(maxLuma);
+    statistics.meanLuma = static_cast<double>(lumaSum) / static_cast<double>(pixelCount);
+    statistics.isBlack  =
+      static_cast<double>(brightPixels) <= blackTolerance * static_cast<double>(pixelCount);
+    return statistics;
+  }
+
+  BlackScreenTransition BlackScreenDetector::Update(bool isBlack) {
+    if (isBlack == isBlackScreen) {
+      transitionFrames = 0;
+      return BlackScreenTransition::None;
+    }
+
+    if (++transitionFrames < debounceFrames) {
+      return BlackScreenTransition::None;
+    }
+
+    isBlackScreen    = isBlack;
+    transitionFrames = 0;
+    return isBlackScreen ? BlackScreenTransition::Started : BlackScreenTransition::Ended;
+  }
+
+  void BlackScreenDetector::Reset() {
+    isBlackScreen    = false;
+    transitionFrames = 0;
+  }
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "image-view.h"
+
+namespace Downscaler::Cpp::Core::NativeImpls {
+  /**
+   * @brief Luminance statistics of a single frame.
+   */
+  struct FrameStatistics {
+    /** The number of pixels with each 8-bit luma value. */
+    std::array<uint32_t, 256> histogram{};
+
+    /** The number of pixels the statistics were computed over. */
+    uint64_t pixelCount = 0;
+
+    /** The darkest luma value in the frame. */
+    uint8_t minLuma = 0;
+
+    /** The brightest luma value in the frame. */
+    uint8_t maxLuma = 0;
+
+    /** The average luma value of the frame. */
+    double meanLuma = 0.0;
+
+    /** Whether (almost) every pixel of the frame is at or below the black threshold. */
+    bool isBlack = false;
+  };
+
+  /**
+   * @brief Accumulates luminance statistics one row at a time, so that it can piggyback on a pass
+   * that is already writing the frame while the row is still in cache.
+   *
+   * Rows are 32-bit BGRA pixels. Luma is computed with the BT.709 coefficients in 8-bit fixed
+   * point. Only the histogram is updated per pixel; everything else is derived from it when the
+   * frame is finished.
+   */
+  class FrameStatisticsAccumulator {
+    public:
+      /**
+       * @param blackThreshold The brightest luma value that is still considered black.
+       * @param blackTolerance
+       *   The fraction of pixels, between 0 and 1, that may be brighter than the threshold for the
+       *   frame to still be considered black. Allows for e.g. a small loading indicator.
+       */
+      explicit FrameStatisticsAccumulator(uint8_t blackThreshold = 24, double blackTolerance = 0.001)
+        : blackThreshold(blackThreshold), blackTolerance(blackTolerance) {}
+
+      /**
+       * @brief Discards the rows accumulated so far and starts a new frame.
+       */
+      void Begin();
+
+      /**
+       * @brief Adds a row of BGRA pixels to the current frame.
+       * @param pixels The first pixel of the row.
+       * @param width The number of pixels in the row.
+       */
+      void AccumulateRow(const uint8_t* pixels, uint32_t width);
+
+      /**
+       * @brief Adds a whole BGRA image to the current frame.
+       * @param pixels The top-left pixel of the image.
+       * @param width The width of the image in pixels.
+       * @param height The height of the image in pixels.
+       * @param stride The distance between rows of the image in bytes.
+       */
+      void AccumulateImage(const uint8_t* pixels, uint32_t width, uint32_t height, size_t stride);
+
+      /**
+       * @brief Adds a whole BGRA image to the current frame.
+       * @param image The image, which may be a cropped view of a larger frame.
+       */
+      void AccumulateImage(const ConstImageView& image);
+
+      /**
+       * @brief Completes the current frame and derives its statistics.
+       * @returns The statistics of the frame. Remains valid until the next call to `Finish`.
+       */
+      const FrameStatistics& Finish();
+
+      /**
+       * @returns The statistics of the last finished frame.
+       */
+      const FrameStatistics& GetStatistics() const {
+        return statistics;
+      }
+
+    private:
+      uint8_t blackThreshold;
+      double blackTolerance;
+
+      // The histogram of the frame being accumulated.
+      std::array<uint32_t, 256> histogram{};
+      uint64_t pixelCount = 0;
+
+      // The statistics of the last finished frame.
+      FrameStatistics statistics;
+  };
+
+  /**
+   * @brief A change between showing and not showing a black screen.
+   */
+  enum class BlackScreenTransition : uint8_t {
+    /** Nothing changed. */
+    None,
+    /** The window started showing a black screen. */
+    Started,
+    /** The window stopped showing a black screen. */
+    Ended
+  };
+
+  /**
+   * @brief Tracks whether a window is showing a black screen, e.g. while loading, from whether each
+   * of its frames is black.
+   *
+   * A number of consecutive frames must agree before the window is considered to have turned black
+   * or to have come back from black. This keeps single dark frames, such as a flash between
+   * scenes, from being reported.
+   */
+  class BlackScreenDetector {
+    public:
+      /**
+       * @brief The number of consecutive frames that must agree by default.
+       */
+      static constexpr uint32_t DefaultDebounceFrames = 3;
+
+      /**
+       * @param debounceFrames The number of consecutive frames that must agree, at least 1.
+       */
+      explicit BlackScreenDetector(uint32_t debounceFrames = DefaultDebounceFrames)
+        : debounceFrames(debounceFrames < 1 ? 1 : debounceFrames) {}
+
+      /**
+       * @brief Adds a frame.
+       * @param isBlack Whether the frame is black.
+       * @returns Whether the window started or stopped showing a black screen with this frame.
+       */
+      BlackScreenTransition Update(bool isBlack);
+
+      /**
+       * @brief Forgets every frame, so the window is considered not to be showing a black screen.
+       */
+      void Reset();
+
+      /**
+       * @returns Whether the window is currently considered to be showing a black screen.
+       */
+      bool IsBlackScreen() const {
+        return isBlackScreen;
+      }
+
+    private:
+      uint32_t debounceFrames;
+      bool isBlackScreen = false;
+
+      // The number of consecutive frames whose black state differs from `isBlackScreen`.
+      uint32_t transitionFrames = 0;
+  };
+}
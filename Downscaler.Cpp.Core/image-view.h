@@ -0,0 +1,106 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace Downscaler::Cpp::Core::NativeImpls {
+  /**
+   * @brief A rectangle of pixels within a frame, e.g. the client area of a captured window.
+   */
+  struct FrameRegion {
+    uint32_t x = 0;
+    uint32_t y = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+
+    bool operator==(const FrameRegion& other) const {
+      return x == other.x && y == other.y && width == other.width && height == other.height;
+    }
+
+    bool operator!=(const FrameRegion& other) const {
+      return !(*this == other);
+    }
+  };
+
+  /**
+   * @brief A non-owning, strided view of a 32-bit-per-pixel image. Cropping a view only adjusts
+   * its origin and size, so a sub-image such as a window's client area can be processed in place
+   * without being copied out of the full frame.
+   * @tparam TPixel `uint8_t` for a writable view or `const uint8_t` for a read-only one.
+   */
+  template <typename TPixel>
+  struct BasicImageView {
+    /** The number of bytes in a single pixel. */
+    static constexpr size_t BytesPerPixel = 4;
+
+    /** The top-left pixel of the view. */
+    TPixel* pixels = nullptr;
+
+    /** The width of the view in pixels. */
+    uint32_t width = 0;
+
+    /** The height of the view in pixels. */
+    uint32_t height = 0;
+
+    /** The distance between rows of the view in bytes. May be larger than a row of pixels. */
+    size_t stride = 0;
+
+    BasicImageView() = default;
+
+    BasicImageView(TPixel* pixels, uint32_t width, uint32_t height, size_t stride)
+      : pixels(pixels), width(width), height(height), stride(stride) {}
+
+    /**
+     * @brief Allows a writable view to be passed wherever a read-only view is expected.
+     */
+    operator BasicImageView<const TPixel>() const {
+      return {pixels, width, height, stride};
+    }
+
+    /**
+     * @returns Whether the view contains no pixels.
+     */
+    bool IsEmpty() const {
+      return pixels == nullptr || width == 0 || height == 0;
+    }
+
+    /**
+     * @returns The number of bytes of pixel data in a single row, excluding any padding.
+     */
+    size_t GetRowBytes() const {
+      return static_cast<size_t>(width) * BytesPerPixel;
+    }
+
+    /**
+     * @param y The index of the row, which must be less than the height of the view.
+     * @returns The first pixel of the row.
+     */
+    TPixel* GetRow(uint32_t y) const {
+      return pixels + stride * y;
+    }
+
+    /**
+     * @brief Narrows the view to a region of it. The region is clamped to the bounds of the view,
+     * so the result may be smaller than requested, or empty.
+     * @param region The region to crop to, relative to the top-left of this view.
+     * @returns A view of the region that shares this view's pixels and stride.
+     */
+    BasicImageView Crop(const FrameRegion& region) const {
+      auto x = std::min(region.x, width);
+      auto y = std::min(region.y, height);
+      auto croppedWidth = std::min(region.width, width - x);
+      auto croppedHeight = std::min(region.height, height - y);
+
+      return {
+        pixels + stride * y + BytesPerPixel * x,
+        croppedWidth,
+        croppedHeight,
+        stride
+      };
+    }
+  };
+
+  using ImageView      = BasicImageView<uint8_t>;
+  using ConstImageView = BasicImageView<const uint8_t>;
+}
@@ -0,0 +1,266 @@
+#include "input-forwarder.h"
+
+#include <algorithm>
+#include <vector>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+namespace Downscaler::Cpp::Core::NativeImpls {
+  namespace {
+    // The messages that are forwarded. They're spelled out here, rather than taken from the
+    // Windows headers, so the routing builds on every platform.
+    constexpr uint32_t keyDown = 0x0100;
+    constexpr uint32_t character = 0x0102;
+    constexpr uint32_t sysKeyDown = 0x0104;
+    constexpr uint32_t sysKeyUp = 0x0105;
+    constexpr uint32_t sysCharacter = 0x0106;
+    constexpr uint32_t mouseFirstButton = 0x0201;
+    constexpr uint32_t mouseWheel = 0x020A;
+    constexpr uint32_t mouseLastButton = 0x020D;
+    constexpr uint32_t mouseHorizontalWheel = 0x020E;
+
+    // The bit of a key message's `lParam` that's set when the key was already down, i.e. for an
+    // auto-repeat, and the bits that hold the repeat count.
+    constexpr int64_t previousKeyState = int64_t{1} << 30;
+    constexpr int64_t repeatCountMask = 0xFFFF;
+
+    // The maximum number of children the mouse can be within at once that are considered.
+    constexpr size_t maxHits = 16;
+
+    bool IsWheel(uint32_t message) {
+      return message == mouseWheel || message == mouseHorizontalWheel;
+    }
+
+    bool IsButtonDown(uint32_t message) {
+      // Down messages are 3 apart, starting with WM_LBUTTONDOWN, and WM_XBUTTONDOWN is the last.
+      return message >= mouseFirstButton &&
+             message <= mouseLastButton &&
+             (message - mouseFirstButton) % 3 == 0;
+    }
+
+    bool IsKey(uint32_t message) {
+      return message >= keyDown && message <= sysCharacter;
+    }
+
+    bool IsRepeatable(uint32_t message) {
+      return message == keyDown ||
+             message == character ||
+             message == sysKeyDown ||
+             message == sysCharacter;
+    }
+
+    int64_t MakeLParam(int32_t x, int32_t y) {
+      return static_cast<int64_t>(
+        (static_cast<uint32_t>(static_cast<uint16_t>(y)) << 16) | static_cast<uint16_t>(x)
+      );
+    }
+
+    /**
+     * @brief Merges a message into the one before it if together they mean the same as apart.
+     * @returns Whether the message was merged.
+     */
+    bool TryMerge(ForwardedMessage& previous, const ForwardedMessage& next) {
+      if (previous.target != next.target || previous.message != next.message) {
+        return false;
+      }
+
+      // Wheel rotation with the same buttons and modifiers held adds up. The high word of `wParam`
+      // is the signed rotation, the low word the state of the buttons and modifiers.
+      if (IsWheel(next.message)) {
+        if ((previous.wParam & 0xFFFF) != (next.wParam & 0xFFFF)) {
+          return false;
+        }
+
+        auto rotation = static_cast<int16_t>(previous.wParam >> 16) +
+                        static_cast<int16_t>(next.wParam >> 16);
+        if (rotation < INT16_MIN || rotation > INT16_MAX) {
+          return false;
+        }
+
+        previous.wParam = (static_cast<uint64_t>(static_cast<uint16_t>(rotation)) << 16) |
+                          (next.wParam & 0xFFFF);
+        previous.lParam = next.lParam;
+        return true;
+      }
+
+      // Auto-repeats of the same key add up in the repeat count, just like Windows reports them
+      // when the receiving thread falls behind. The initial press is kept apart, since it's the
+      // only one with the previous key state clear.
+      if (IsRepeatable(next.message)) {
+        auto isRepeat = (previous.lParam & next.lParam & previousKeyState) != 0;
+        if (previous.wParam != next.wParam || !isRepeat) {
+          return false;
+        }
+
+        auto repeats = (previous.lParam & repeatCountMask) + (next.lParam & repeatCountMask);
+        if (repeats > repeatCountMask) {
+          return false;
+        }
+
+        previous.lParam = (next.lParam & ~repeatCountMask) | repeats;
+        return true;
+      }
+
+      return false;
+    }
+
+#if defined(_WIN32)
+    /**
+     * @brief Delivers messages with `PostMessage`.
+     */
+    class PostMessageSink final : public IMessageSink {
+      public:
+        bool Post(const ForwardedMessage& message) override {
+          return PostMessageW(
+                   reinterpret_cast<HWND>(static_cast<uintptr_t>(message.target)),
+                   message.message,
+                   static_cast<WPARAM>(message.wParam),
+                   static_cast<LPARAM>(message.lParam)
+                 ) != FALSE;
+        }
+    };
+#else
+    /**
+     * @brief Drops every message, since there are no windows to deliver to.
+     */
+    class PostMessageSink final : public IMessageSink {
+      public:
+        bool Post(const ForwardedMessage&) override {
+          return false;
+        }
+    };
+#endif
+  }
+
+  IMessageSink& GetPostMessageSink() {
+    static PostMessageSink sink;
+    return sink;
+  }
+
+  struct InputForwarder::Impl {
+    IMessageSink* sink;
+    uint64_t sourceWindow = 0;
+
+    // The window that was last clicked, which keyboard input is routed to.
+    uint64_t focusWindow = 0;
+
+    std::vector<ForwardedMessage> queue;
+    uint64_t queuedCount = 0;
+    uint64_t deliveredCount = 0;
+
+    explicit Impl(IMessageSink* sink) : sink(sink != nullptr ? sink : &GetPostMessageSink()) {}
+
+    void Enqueue(const ForwardedMessage& message) {
+      queuedCount++;
+      if (queue.empty() || !TryMerge(queue.back(), message)) {
+        queue.push_back(message);
+      }
+    }
+  };
+
+  InputForwarder::InputForwarder(IMessageSink* sink) : impl(std::make_unique<Impl>(sink)) {}
+
+  InputForwarder::~InputForwarder() = default;
+
+  void InputForwarder::SetSourceWindow(uint64_t window) {
+    if (impl->sourceWindow != window) {
+      impl->sourceWindow = window;
+      impl->focusWindow  = 0;
+    }
+  }
+
+  bool InputForwarder::QueueMouse(
+    uint32_t message,
+    uint64_t wParam,
+    int32_t screenX,
+    int32_t screenY,
+    const CoordinateMapper& mapper,
+    const ChildWindowIndex* children
+  ) {
+    auto& state = *impl;
+    auto isButton = message >= mouseFirstButton && message <= mouseLastButton;
+    if (state.sourceWindow == 0 || !(isButton || IsWheel(message))) {
+      return false;
+    }
+
+    auto point = mapper.Map(screenX, screenY);
+    if (!point.isWithinDownscaledWindow) {
+      return false;
+    }
+
+    // Route to the child under the mouse. Children are enumerated before their own children, so
+    // the last hit is the most deeply nested one, which is the one that would have been clicked.
+    ForwardedMessage forwarded{state.sourceWindow, message, wParam, 0};
+    ChildWindowHit hits[maxHits];
+    size_t hitCount = 0;
+    if (children != nullptr) {
+      hitCount = std::min(children->HitTest(point.sourceX, point.sourceY, hits, maxHits), maxHits);
+    }
+
+    if (hitCount > 0) {
+      const auto& hit  = hits[hitCount - 1];
+      forwarded.target = hit.handle;
+      forwarded.lParam = MakeLParam(hit.x, hit.y);
+    } else {
+      // Match the space that mouse moves are forwarded in, so clicks land where the moves went.
+      forwarded.lParam = MakeLParam(point.sourceWindowX, point.sourceWindowY);
+    }
+
+    // Unlike the other mouse messages, wheel messages carry screen coordinates.
+    if (IsWheel(message)) {
+      const auto& source = mapper.GetSourceGeometry();
+      forwarded.lParam   = MakeLParam(
+        source.clientLeft + point.sourceX,
+        source.clientTop + point.sourceY
+      );
+    }
+
+    if (IsButtonDown(message)) {
+      state.focusWindow = forwarded.target;
+    }
+
+    state.Enqueue(forwarded);
+    return true;
+  }
+
+  bool InputForwarder::QueueKey(uint32_t message, uint64_t wParam, int64_t lParam) {
+    auto& state = *impl;
+    if (state.sourceWindow == 0 || !IsKey(message)) {
+      return false;
+    }
+
+    auto target = state.focusWindow != 0 ? state.focusWindow : state.sourceWindow;
+    state.Enqueue({target, message, wParam, lParam});
+    return true;
+  }
+
+  size_t InputForwarder::Flush() {
+    auto& state = *impl;
+
+    size_t delivered = 0;
+    for (const auto& message : state.queue) {
+      if (state.sink->Post(message)) {
+        delivered++;
+      }
+    }
+
+    state.queue.clear();
+    state.deliveredCount += delivered;
+    return delivered;
+  }
+
+  size_t InputForwarder::GetPendingCount() const {
+    return impl->queue.size();
+  }
+
+  uint64_t InputForwarder::GetQueuedCount() const {
+    return impl->queuedCount;
+  }
+
+  uint64_t InputForwarder::GetDeliveredCount() const {
+    return impl->deliveredCount;
+  }
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "child-window-index.h"
+#include "coordinate-mapper.h"
+
+namespace Downscaler::Cpp::Core::NativeImpls {
+  /**
+   * @brief A window message on its way to the source window or one of its children.
+   */
+  struct ForwardedMessage {
+    /** The window to deliver the message to, e.g. its `HWND`. */
+    uint64_t target = 0;
+    uint32_t message = 0;
+    uint64_t wParam = 0;
+    int64_t lParam = 0;
+  };
+
+  /**
+   * @brief Delivers forwarded messages. Kept abstract so the routing can be checked without a
+   * window to deliver to.
+   */
+  class IMessageSink {
+    public:
+      virtual ~IMessageSink() = default;
+
+      /**
+       * @brief Delivers a message without waiting for it to be processed.
+       * @returns Whether the message was delivered.
+       */
+      virtual bool Post(const ForwardedMessage& message) = 0;
+  };
+
+  /**
+   * @returns A sink that delivers messages with `PostMessage`. The returned sink lives for the
+   * lifetime of the process. On platforms other than Windows, it drops every message.
+   */
+  IMessageSink& GetPostMessageSink();
+
+  /**
+   * @brief Forwards the mouse button, wheel and keyboard input received by the downscaled window
+   * to the source window.
+   *
+   * Mouse input is mapped onto the source window with the cached transform of a `CoordinateMapper`
+   * and routed to the child window under the mouse with a `ChildWindowIndex`, without querying any
+   * window. Keyboard input is routed to the window that was last clicked, much like focus.
+   *
+   * Messages are queued in order and delivered by `Flush`, typically once the message queue of the
+   * downscaled window is empty. While queued, a burst of wheel rotation or of key repeats is merged
+   * into a single message, the way Windows itself reports them, so it costs one `PostMessage`.
+   *
+   * Must be used from a single thread.
+   */
+  class InputForwarder {
+    public:
+      /**
+       * @param sink Where to deliver messages. If null, `GetPostMessageSink` is used.
+       */
+      explicit InputForwarder(IMessageSink* sink = nullptr);
+      ~InputForwarder();
+
+      InputForwarder(const InputForwarder&)            = delete;
+      InputForwarder& operator=(const InputForwarder&) = delete;
+
+      /**
+       * @brief Changes the window that input is forwarded to, forgetting which window was last
+       * clicked.
+       */
+      void SetSourceWindow(uint64_t window);
+
+      /**
+       * @brief Queues a mouse button or wheel message received by the downscaled window.
+       * @param message The message, e.g. `WM_LBUTTONDOWN` or `WM_MOUSEWHEEL`.
+       * @param wParam The message's `wParam`, i.e. the state of the buttons and modifier keys,
+       * along with the wheel rotation or the X button.
+       * @param screenX The x-coordinate of the mouse on the screen.
+       * @param screenY The y-coordinate of the mouse on the screen.
+       * @param mapper Maps the mouse onto the source window.
+       * @param children The child windows of the source window, or null to only forward to the
+       * source window itself.
+       * @returns `false` if the message wasn't queued, e.g. because the mouse is outside of the
+       * downscaled window.
+       */
+      bool QueueMouse(
+        uint32_t message,
+        uint64_t wParam,
+        int32_t screenX,
+        int32_t screenY,
+        const CoordinateMapper& mapper,
+        const ChildWindowIndex* children
+      );
+
+      /**
+       * @brief Queues a keyboard message received by the downscaled window.
+       * @param message The message, e.g. `WM_KEYDOWN` or `WM_CHAR`.
+       * @param wParam The message's `wParam`.
+       * @param lParam The message's `lParam`, including the repeat count.
+       * @returns `false` if the message wasn't queued.
+       */
+      bool QueueKey(uint32_t message, uint64_t wParam, int64_t lParam);
+
+      /**
+       * @brief Delivers every queued message, in order.
+       * @returns The number of messages delivered.
+       */
+      size_t Flush();
+
+      /**
+       * @returns The number of messages waiting to be delivered.
+       */
+      size_t GetPendingCount() const;
+
+      /**
+       * @returns The number of messages queued, before any were merged.
+       */
+      uint64_t GetQueuedCount() const;
+
+      /**
+       * @returns The number of messages delivered.
+       */
+      uint64_t GetDeliveredCount() const;
+
+    private:
+      struct Impl;
+      std::unique_ptr<Impl> impl;
+  };
+}
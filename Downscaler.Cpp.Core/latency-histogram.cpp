@@ -0,0 +1,171 @@
+#include "latency-histogram.h"
+
+#include <array>
+#include <atomic>
+#include <limits>
+
+namespace Downscaler::Cpp::Core::NativeImpls {
+  namespace {
+    // Samples below this value are stored in their own, exact bucket.
+    constexpr int64_t linearLimit = 64;
+
+    // The number of bits used to subdivide each power of two above the linear range.
+    constexpr int subBucketBits = 5;
+    constexpr int subBucketCount = 1 << subBucketBits;
+
+    // The power of two at which the linear range ends.
+    constexpr int firstExponent = 6;
+
+    // The largest power of two that can be represented. Anything above 2^40 µs (~12 days) is
+    // clamped into the last bucket.
+    constexpr int lastExponent = 40;
+
+    constexpr size_t bucketCount =
+      linearLimit + static_cast<size_t>(lastExponent - firstExponent + 1) * subBucketCount;
+
+    /**
+     * @brief Computes the index of the most significant set bit of a positive value.
+     */
+    inline int FloorLog2(uint64_t value) {
+      int result = 0;
+      for (int shift = 32; shift > 0; shift >>= 1) {
+        if (value >= (uint64_t{1} << shift)) {
+          value >>= shift;
+          result += shift;
+        }
+      }
+      return result;
+    }
+
+    /**
+     * @brief Maps a sample onto the index of the bucket it belongs to.
+     */
+    inline size_t BucketFor(uint64_t value) {
+      if (value < linearLimit) {
+        return static_cast<size_t>(value);
+      }
+
+      auto exponent = FloorLog2(value);
+      if (exponent > lastExponent) {
+        return bucketCount - 1;
+      }
+
+      // Take the bits just below the leading one to find the sub-bucket.
+      auto subBucket = (value >> (exponent - subBucketBits)) & (subBucketCount - 1);
+      return linearLimit + static_cast<size_t>(exponent - firstExponent) * subBucketCount +
+             static_cast<size_t>(subBucket);
+    }
+
+    /**
+     * @brief Maps a bucket index back onto the midpoint of the range of values it covers.
+     */
+    inline int64_t ValueFor(size_t bucket) {
+      if (bucket < linearLimit) {
+        return static_cast<int64_t>(bucket);
+      }
+
+      auto offset    = bucket - linearLimit;
+      auto exponent  = firstExponent + static_cast<int>(offset / subBucketCount);
+      auto subBucket = static_cast<uint64_t>(offset % subBucketCount);
+      auto width     = uint64_t{1} << (exponent - subBucketBits);
+      auto lower     = (uint64_t{1} << exponent) + subBucket * width;
+      return static_cast<int64_t>(lower + width / 2);
+    }
+  }
+
+  struct LatencyHistogram::Impl {
+    std::array<std::atomic<uint64_t>, bucketCount> buckets{};
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> sum{0};
+    std::atomic<int64_t> min{std::numeric_limits<int64_t>::max()};
+    std::atomic<int64_t> max{0};
+  };
+
+  LatencyHistogram::LatencyHistogram() : impl(std::make_unique<Impl>()) {}
+
+  LatencyHistogram::~LatencyHistogram() = default;
+
+  void LatencyHistogram::Record(int64_t microseconds) {
+    if (microseconds < 0) {
+      microseconds = -microseconds;
+    }
+
+    impl->buckets[BucketFor(static_cast<uint64_t>(microseconds))].fetch_add(
+      1,
+      std::memory_order_relaxed
+    );
+    impl->count.fetch_add(1, std::memory_order_relaxed);
+    impl->sum.fetch_add(static_cast<uint64_t>(microseconds), std::memory_order_relaxed);
+
+    // Update the extremes. Contention is rare, so a simple compare-exchange loop is sufficient.
+    auto currentMin = impl->min.load(std::memory_order_relaxed);
+    while (microseconds < currentMin &&
+           !impl->min.compare_exchange_weak(currentMin, microseconds, std::memory_order_relaxed)) {}
+
+    auto currentMax = impl->max.load(std::memory_order_relaxed);
+    while (microseconds > currentMax &&
+           !impl->max.compare_exchange_weak(currentMax, microseconds, std::memory_order_relaxed)) {}
+  }
+
+  void LatencyHistogram::Reset() {
+    for (auto& bucket : impl->buckets) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+    impl->count.store(0, std::memory_order_relaxed);
+    impl->sum.store(0, std::memory_order_relaxed);
+    impl->min.store(std::numeric_limits<int64_t>::max(), std::memory_order_relaxed);
+    impl->max.store(0, std::memory_order_relaxed);
+  }
+
+  uint64_t LatencyHistogram::GetCount() const {
+    return impl->count.load(std::memory_order_relaxed);
+  }
+
+  int64_t LatencyHistogram::GetMin() const {
+    return GetCount() == 0 ? 0 : impl->min.load(std::memory_order_relaxed);
+  }
+
+  int64_t LatencyHistogram::GetMax() const {
+    return impl->max.load(std::memory_order_relaxed);
+  }
+
+  double LatencyHistogram::GetMean() const {
+    auto count = GetCount();
+    if (count == 0) {
+      return 0.0;
+    }
+
+    return static_cast<double>(impl->sum.load(std::memory_order_relaxed)) /
+           static_cast<double>(count);
+  }
+
+  int64_t LatencyHistogram::GetPercentile(double percentile) const {
+    auto count = GetCount();
+    if (count == 0) {
+      return 0;
+    }
+
+    if (percentile < 0.0) percentile = 0.0;
+    if (percentile > 100.0) percentile = 100.0;
+
+    // The rank of the sample we're looking for, where a rank of 1 is the smallest sample.
+    auto target = static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(count) + 0.5);
+    if (target == 0) {
+      target = 1;
+    }
+
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < bucketCount; ++bucket) {
+      seen += impl->buckets[bucket].load(std::memory_order_relaxed);
+      if (seen >= target) {
+        // Never report a value outside of what has actually been observed.
+        auto value = ValueFor(bucket);
+        if (value < GetMin()) return GetMin();
+        if (value > GetMax()) return GetMax();
+        return value;
+      }
+    }
+
+    return GetMax();
+  }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+namespace Downscaler::Cpp::Core::NativeImpls {
+  /**
+   * @brief A fixed-size, log-linear histogram of latency samples measured in microseconds.
+   *
+   * Samples below 64 µs are stored exactly. Larger samples are grouped into 32 sub-buckets per
+   * power of two, which bounds the relative error of any reported percentile to roughly 3%.
+   * Recording is wait-free so it can be done from the render thread while another thread reads
+   * the statistics.
+   */
+  class LatencyHistogram {
+    public:
+      LatencyHistogram();
+      ~LatencyHistogram();
+
+      LatencyHistogram(const LatencyHistogram&)            = delete;
+      LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+      /**
+       * @brief Records a single sample. Negative samples are recorded as their absolute value.
+       * @param microseconds The sample to record, in microseconds.
+       */
+      void Record(int64_t microseconds);
+
+      /**
+       * @brief Discards every recorded sample.
+       */
+      void Reset();
+
+      /**
+       * @returns The number of samples recorded since the last reset.
+       */
+      uint64_t GetCount() const;
+
+      /**
+       * @returns The smallest recorded sample in microseconds, or 0 if there are no samples.
+       */
+      int64_t GetMin() const;
+
+      /**
+       * @returns The largest recorded sample in microseconds, or 0 if there are no samples.
+       */
+      int64_t GetMax() const;
+
+      /**
+       * @returns The arithmetic mean of the recorded samples in microseconds.
+       */
+      double GetMean() const;
+
+      /**
+       * @brief Estimates the value below which the given fraction of samples fall.
+       * @param percentile The percentile to compute, in the range [0, 100].
+       * @returns The estimated percentile in microseconds, or 0 if there are no samples.
+       */
+      int64_t GetPercentile(double percentile) const;
+
+    private:
+      struct Impl;
+      std::unique_ptr<Impl> impl;
+  };
+}
@@ -0,0 +1,146 @@
+#include "mouse-move-coalescer.h"
+
+#include <condition_variable>
+#include <mutex>
+
+namespace Downscaler::Cpp::Core::NativeImpls {
+  namespace {
+    /**
+     * @returns The forwarding interval, in microseconds, for the given rate.
+     */
+    int64_t IntervalFor(double rate) {
+      return rate > 0.0 ? static_cast<int64_t>(1'000'000.0 / rate) : 0;
+    }
+  }
+
+  struct MouseMoveCoalescer::Impl {
+    IClock* clock;
+
+    // Everything below is shared between the input and flush threads. Moves arrive at most a few
+    // thousand times a second, so a lock is cheap enough and keeps the edges simple to reason about.
+    mutable std::mutex mutex;
+    std::condition_variable pendingChanged;
+
+    int64_t interval;
+    int64_t lastForwarded = -1;
+    bool isPending = false;
+    bool isStopped = false;
+    int32_t pendingX = 0;
+    int32_t pendingY = 0;
+
+    uint64_t submitted = 0;
+    uint64_t forwarded = 0;
+
+    Impl(double rate, IClock* clock)
+      : clock(clock != nullptr ? clock : &GetSteadyClock()),
+        interval(IntervalFor(rate)) {}
+
+    /**
+     * @returns The time the pending move is due. Must be called with the lock held.
+     */
+    int64_t TrailingEdge() const {
+      return lastForwarded + interval;
+    }
+  };
+
+  MouseMoveCoalescer::MouseMoveCoalescer(double rate, IClock* clock)
+    : impl(std::make_unique<Impl>(rate, clock)) {}
+
+  MouseMoveCoalescer::~MouseMoveCoalescer() {
+    Stop();
+  }
+
+  bool MouseMoveCoalescer::Submit(int32_t x, int32_t y) {
+    auto now = impl->clock->NowMicroseconds();
+
+    {
+      std::lock_guard lock(impl->mutex);
+      impl->submitted++;
+
+      // Leading edge: the interval has elapsed, so the move goes out straight away and replaces
+      // anything that was still pending.
+      if (impl->lastForwarded < 0 || now >= impl->TrailingEdge()) {
+        impl->lastForwarded = now;
+        impl->isPending     = false;
+        impl->forwarded++;
+        return true;
+      }
+
+      impl->pendingX  = x;
+      impl->pendingY  = y;
+      impl->isPending = true;
+    }
+
+    impl->pendingChanged.notify_one();
+    return false;
+  }
+
+  bool MouseMoveCoalescer::TakeTrailingMove(int64_t now, int32_t& x, int32_t& y) {
+    std::lock_guard lock(impl->mutex);
+
+    if (!impl->isPending || now < impl->TrailingEdge()) {
+      return false;
+    }
+
+    x = impl->pendingX;
+    y = impl->pendingY;
+    impl->isPending     = false;
+    impl->lastForwarded = now;
+    impl->forwarded++;
+    return true;
+  }
+
+  bool MouseMoveCoalescer::WaitForTrailingMove(int32_t& x, int32_t& y) {
+    while (true) {
+      int64_t deadline;
+
+      {
+        std::unique_lock lock(impl->mutex);
+        impl->pendingChanged.wait(lock, [this] { return impl->isPending || impl->isStopped; });
+
+        if (impl->isStopped) {
+          return false;
+        }
+
+        deadline = impl->TrailingEdge();
+      }
+
+      // Sleep outside of the lock so the input thread can keep submitting. If a leading edge
+      // forwards the pending move in the meantime, there's nothing to take and we wait again.
+      impl->clock->SleepUntil(deadline);
+
+      if (TakeTrailingMove(impl->clock->NowMicroseconds(), x, y)) {
+        return true;
+      }
+    }
+  }
+
+  void MouseMoveCoalescer::Stop() {
+    {
+      std::lock_guard lock(impl->mutex);
+      impl->isStopped = true;
+    }
+
+    impl->pendingChanged.notify_all();
+  }
+
+  void MouseMoveCoalescer::SetRate(double rate) {
+    std::lock_guard lock(impl->mutex);
+    impl->interval = IntervalFor(rate);
+  }
+
+  double MouseMoveCoalescer::GetRate() const {
+    std::lock_guard lock(impl->mutex);
+    return impl->interval > 0 ? 1'000'000.0 / static_cast<double>(impl->interval) : 0.0;
+  }
+
+  uint64_t MouseMoveCoalescer::GetSubmitted() const {
+    std::lock_guard lock(impl->mutex);
+    return impl->submitted;
+  }
+
+  uint64_t MouseMoveCoalescer::GetForwarded() const {
+    std::lock_guard lock(impl->mutex);
+    return impl->forwarded;
+  }
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "frame-scheduler.h"
+
+namespace Downscaler::Cpp::Core::NativeImpls {
+  /**
+   * @brief Rate-limits forwarded mouse moves without ever losing the latest position.
+   *
+   * A move that arrives after the forwarding interval has elapsed is forwarded straight away (the
+   * leading edge). A move that arrives sooner replaces any other pending move and is forwarded once
+   * the interval elapses (the trailing edge), so the position the mouse comes to rest at is always
+   * delivered, and never more than one interval late.
+   *
+   * `Submit` is called from the input thread, while `WaitForTrailingMove` is called from a
+   * dedicated flush thread. `SetRate` and `Stop` may be called from any thread.
+   */
+  class MouseMoveCoalescer {
+    public:
+      /**
+       * @param rate The maximum number of moves forwarded per second. Zero or less disables
+       * rate-limiting.
+       * @param clock The clock to measure intervals with. If null, the steady clock is used.
+       */
+      explicit MouseMoveCoalescer(double rate, IClock* clock = nullptr);
+      ~MouseMoveCoalescer();
+
+      MouseMoveCoalescer(const MouseMoveCoalescer&)            = delete;
+      MouseMoveCoalescer& operator=(const MouseMoveCoalescer&) = delete;
+
+      /**
+       * @brief Records the latest position of the mouse.
+       * @returns `true` if the move should be forwarded now, `false` if it's held back for the
+       * trailing edge.
+       */
+      bool Submit(int32_t x, int32_t y);
+
+      /**
+       * @brief Takes the held back move if its trailing edge has been reached.
+       * @param now The current time of the coalescer's clock, in microseconds.
+       * @param x Receives the x-coordinate of the move.
+       * @param y Receives the y-coordinate of the move.
+       * @returns Whether a move was taken.
+       */
+      bool TakeTrailingMove(int64_t now, int32_t& x, int32_t& y);
+
+      /**
+       * @brief Blocks until a held back move reaches its trailing edge and takes it.
+       * @param x Receives the x-coordinate of the move.
+       * @param y Receives the y-coordinate of the move.
+       * @returns `true` if a move was taken, `false` if the coalescer was stopped.
+       */
+      bool WaitForTrailingMove(int32_t& x, int32_t& y);
+
+      /**
+       * @brief Wakes up and ends any call to `WaitForTrailingMove`.
+       */
+      void Stop();
+
+      /**
+       * @brief Changes the maximum number of moves forwarded per second, e.g. to follow the
+       * capture frame rate. Zero or less disables rate-limiting.
+       */
+      void SetRate(double rate);
+
+      /**
+       * @returns The maximum number of moves forwarded per second, or 0 if unlimited.
+       */
+      double GetRate() const;
+
+      /**
+       * @returns The number of moves submitted.
+       */
+      uint64_t GetSubmitted() const;
+
+      /**
+       * @returns The number of moves forwarded, on either edge.
+       */
+      uint64_t GetForwarded() const;
+
+    private:
+      struct Impl;
+      std::unique_ptr<Impl> impl;
+  };
+}
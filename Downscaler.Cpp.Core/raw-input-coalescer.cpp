@@ -0,0 +1,46 @@
+#include "raw-input-coalescer.h"
+
+namespace Downscaler::Cpp::Core::NativeImpls {
+  namespace {
+    // `RI_MOUSE_WHEEL` and `RI_MOUSE_HWHEEL`, which mark a rotation rather than a button press.
+    constexpr uint16_t wheelFlags = 0x0400 | 0x0800;
+  }
+
+  void RawInputCoalescer::Add(const MouseInputEvent& event) {
+    batch.eventCount++;
+
+    if (event.isAbsolute) {
+      // Absolute reports replace each other. Only where the pointer ended up matters.
+      batch.hasAbsolutePosition = true;
+      batch.absoluteX           = event.x;
+      batch.absoluteY           = event.y;
+    }
+    else {
+      batch.deltaX += event.x;
+      batch.deltaY += event.y;
+    }
+
+    if (event.buttonFlags == 0 && event.wheelDelta == 0) {
+      return;
+    }
+
+    // Merge a wheel rotation into the previous one if nothing else happened in between, since a
+    // fast spin of the wheel reports every notch on its own.
+    auto& transitions = batch.transitions;
+    if (!transitions.empty() && (event.buttonFlags & ~wheelFlags) == 0) {
+      auto& last = transitions.back();
+      if (last.buttonFlags == event.buttonFlags && last.deltaX == batch.deltaX &&
+          last.deltaY == batch.deltaY) {
+        last.wheelDelta += event.wheelDelta;
+        return;
+      }
+    }
+
+    MouseTransition transition;
+    transition.deltaX      = batch.deltaX;
+    transition.deltaY      = batch.deltaY;
+    transition.buttonFlags = event.buttonFlags;
+    transition.wheelDelta  = event.wheelDelta;
+    transitions.push_back(transition);
+  }
+}
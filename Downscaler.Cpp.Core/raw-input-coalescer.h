@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Downscaler::Cpp::Core::NativeImpls {
+  /**
+   * @brief A single mouse report, independent of the platform it was read on.
+   */
+  struct MouseInputEvent {
+    /** The horizontal motion, or position when `isAbsolute` is set. */
+    int32_t x = 0;
+
+    /** The vertical motion, or position when `isAbsolute` is set. */
+    int32_t y = 0;
+
+    /** Whether `x` and `y` are an absolute position, e.g. from a tablet or remote desktop. */
+    bool isAbsolute = false;
+
+    /** The button transitions in the report, as a bit mask of `RI_MOUSE_*` flags. */
+    uint16_t buttonFlags = 0;
+
+    /** The wheel rotation, in multiples of `WHEEL_DELTA`. */
+    int16_t wheelDelta = 0;
+  };
+
+  /**
+   * @brief A button transition or wheel rotation within a batch, along with the motion that
+   * preceded it.
+   */
+  struct MouseTransition {
+    /** The total relative motion of the batch up to and including the report of the transition. */
+    int64_t deltaX = 0;
+    int64_t deltaY = 0;
+
+    /** The button transitions and wheel rotation, as a bit mask of `RI_MOUSE_*` flags. */
+    uint16_t buttonFlags = 0;
+
+    /** The wheel rotation, in multiples of `WHEEL_DELTA`. */
+    int32_t wheelDelta = 0;
+  };
+
+  /**
+   * @brief The mouse reports of a batch, with the motion coalesced into a single update.
+   */
+  struct CoalescedMouseInput {
+    /** The number of reports that were coalesced. */
+    uint32_t eventCount = 0;
+
+    /** The total relative motion of the batch. */
+    int64_t deltaX = 0;
+    int64_t deltaY = 0;
+
+    /** Whether any report in the batch had an absolute position. */
+    bool hasAbsolutePosition = false;
+
+    /** The last absolute position in the batch. */
+    int32_t absoluteX = 0;
+    int32_t absoluteY = 0;
+
+    /**
+     * The button transitions and wheel rotations of the batch, in the order they were reported.
+     * Consecutive wheel rotations without a button transition or motion in between are merged.
+     */
+    std::vector<MouseTransition> transitions;
+
+    /**
+     * @returns Whether the pointer may have moved during the batch.
+     */
+    bool HasMotion() const {
+      return deltaX != 0 || deltaY != 0 || hasAbsolutePosition;
+    }
+  };
+
+  /**
+   * @brief Folds a stream of mouse reports into one update per batch. High polling rate mice
+   * report up to 8000 times a second, far more often than anything downstream needs, so only the
+   * sum of the motion and the last absolute position are kept. Button transitions are kept in
+   * order, since a press and release within the same batch mean something else than the reverse.
+   */
+  class RawInputCoalescer {
+    public:
+      /**
+       * @brief Starts a new batch.
+       */
+      void Begin() {
+        // Keep the capacity of the transitions, so a steady stream of batches doesn't allocate.
+        auto transitions = std::move(batch.transitions);
+        transitions.clear();
+        batch             = {};
+        batch.transitions = std::move(transitions);
+      }
+
+      /**
+       * @brief Adds a report to the current batch.
+       */
+      void Add(const MouseInputEvent& event);
+
+      /**
+       * @returns The current batch.
+       */
+      const CoalescedMouseInput& GetBatch() const {
+        return batch;
+      }
+
+    private:
+      CoalescedMouseInput batch;
+  };
+}
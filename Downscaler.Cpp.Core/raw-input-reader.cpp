@@ -0,0 +1,121 @@
+#include "raw-input-reader.h"
+
+#define NOMINMAX
+#include <windows.h>
+
+#include "frame-buffer-pool.h"
+
+namespace Downscaler::Cpp::Core::NativeImpls {
+  namespace {
+    // Large enough for a few hundred mouse reports, i.e. tens of milliseconds of an 8000 Hz mouse.
+    constexpr size_t bufferSize = 16 * 1024;
+
+    /**
+     * @returns Whether this is a 32-bit process running on 64-bit Windows. `GetRawInputBuffer`
+     * lays its reports out with the 64-bit header in that case.
+     */
+    bool IsWow64() {
+      BOOL isWow64 = FALSE;
+      return IsWow64Process(GetCurrentProcess(), &isWow64) && isWow64;
+    }
+
+    MouseInputEvent Translate(const RAWMOUSE& mouse) {
+      MouseInputEvent event;
+      event.x           = mouse.lLastX;
+      event.y           = mouse.lLastY;
+      event.isAbsolute  = (mouse.usFlags & MOUSE_MOVE_ABSOLUTE) != 0;
+      event.buttonFlags = mouse.usButtonFlags;
+
+      if (mouse.usButtonFlags & RI_MOUSE_WHEEL) {
+        event.wheelDelta = static_cast<int16_t>(mouse.usButtonData);
+      }
+
+      return event;
+    }
+  }
+
+  struct RawInputReader::Impl {
+    // Reused for every batch. Borrowed from the pool, which also guarantees the pointer alignment
+    // `GetRawInputBuffer` requires.
+    PooledFrameBuffer buffer = GetFrameBufferPool().Acquire(bufferSize);
+
+    // The extra offset of the report data within each block of the buffer.
+    size_t dataOffset = IsWow64() ? 8 : 0;
+
+    RawInputCoalescer coalescer;
+    uint64_t batchCount = 0;
+    uint64_t eventCount = 0;
+  };
+
+  RawInputReader::RawInputReader() : impl(std::make_unique<Impl>()) {}
+
+  RawInputReader::~RawInputReader() = default;
+
+  const CoalescedMouseInput& RawInputReader::Read(void* rawInput) {
+    auto& state = *impl;
+    state.coalescer.Begin();
+
+    // The report of the message being handled has already been taken off the queue, so it has to
+    // be read on its own. A mouse report always fits in a `RAWINPUT`, so there's no need to ask
+    // for the size first.
+    RAWINPUT input;
+    UINT size = sizeof(input);
+    auto read = GetRawInputData(
+      static_cast<HRAWINPUT>(rawInput),
+      RID_INPUT,
+      &input,
+      &size,
+      sizeof(RAWINPUTHEADER)
+    );
+    if (read != static_cast<UINT>(-1) && input.header.dwType == RIM_TYPEMOUSE) {
+      state.coalescer.Add(Translate(input.data.mouse));
+    }
+
+    // Then drain every report that queued up while this message was waiting to be handled.
+    while (state.buffer) {
+      UINT bytes = static_cast<UINT>(state.buffer.GetCapacity());
+      auto block = reinterpret_cast<RAWINPUT*>(state.buffer.GetData());
+      auto count = GetRawInputBuffer(block, &bytes, sizeof(RAWINPUTHEADER));
+      if (count == 0 || count == static_cast<UINT>(-1)) {
+        break;
+      }
+
+      for (UINT i = 0; i < count; ++i) {
+        if (block->header.dwType == RIM_TYPEMOUSE) {
+          auto data = reinterpret_cast<const uint8_t*>(&block->data) + state.dataOffset;
+          state.coalescer.Add(Translate(*reinterpret_cast<const RAWMOUSE*>(data)));
+        }
+
+        block = NEXTRAWINPUTBLOCK(block);
+      }
+    }
+
+    auto& batch = state.coalescer.GetBatch();
+    state.batchCount++;
+    state.eventCount += batch.eventCount;
+    return batch;
+  }
+
+  uint64_t RawInputReader::GetBatchCount() const {
+    return impl->batchCount;
+  }
+
+  uint64_t RawInputReader::GetEventCount() const {
+    return impl->eventCount;
+  }
+
+  double GetPointerPixelsPerCount() {
+    // The multiplier of each of the 20 pointer speeds in the mouse settings, the default being 10.
+    constexpr double multipliers[] = {
+      1.0 / 32, 1.0 / 16, 1.0 / 8, 2.0 / 8, 3.0 / 8, 4.0 / 8, 5.0 / 8, 6.0 / 8, 7.0 / 8, 1.0,
+      1.25, 1.5, 1.75, 2.0, 2.25, 2.5, 2.75, 3.0, 3.25, 3.5
+    };
+
+    int speed = 10;
+    if (!SystemParametersInfoW(SPI_GETMOUSESPEED, 0, &speed, 0) || speed < 1 || speed > 20) {
+      speed = 10;
+    }
+
+    return multipliers[speed - 1];
+  }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "raw-input-coalescer.h"
+
+namespace Downscaler::Cpp::Core::NativeImpls {
+  /**
+   * @brief Reads mouse raw input in batches. Each `WM_INPUT` message drains every report that has
+   * queued up since the last one with `GetRawInputBuffer`, and the reports are coalesced into a
+   * single update, so a high polling rate mouse costs one update per message pump rather than one
+   * per report.
+   *
+   * Must be used from the thread that owns the window registered for raw input.
+   */
+  class RawInputReader {
+    public:
+      RawInputReader();
+      ~RawInputReader();
+
+      RawInputReader(const RawInputReader&)            = delete;
+      RawInputReader& operator=(const RawInputReader&) = delete;
+
+      /**
+       * @brief Reads the report of a `WM_INPUT` message, along with every report still queued.
+       * @param rawInput The `HRAWINPUT` handle from the message's `lParam`.
+       * @returns The mouse reports of the batch, coalesced. Valid until the next call.
+       */
+      const CoalescedMouseInput& Read(void* rawInput);
+
+      /**
+       * @returns The number of batches read.
+       */
+      uint64_t GetBatchCount() const;
+
+      /**
+       * @returns The number of mouse reports read across every batch.
+       */
+      uint64_t GetEventCount() const;
+
+    private:
+      struct Impl;
+      std::unique_ptr<Impl> impl;
+  };
+
+  /**
+   * @returns How many pixels the cursor moves per count of mouse motion at the pointer speed set
+   * in Windows, ignoring pointer acceleration.
+   */
+  double GetPointerPixelsPerCount();
+}
@@ -0,0 +1,73 @@
+#include "region-of-interest.h"
+
+#include <atomic>
+
+namespace Downscaler::Cpp::Core::NativeImpls {
+  struct RegionOfInterest::Impl {
+    // Bumped by `Invalidate`, which may run on a window event thread.
+    std::atomic<uint64_t> generation{1};
+
+    // Owned by the thread that processes the frames. The region is valid while `validGeneration`
+    // matches `generation`. `checkedGeneration` is the generation seen by the last validity check,
+    // which is the newest one the next update can be sure it accounts for.
+    mutable uint64_t checkedGeneration = 0;
+    uint64_t validGeneration = 0;
+    uint32_t frameWidth = 0;
+    uint32_t frameHeight = 0;
+    FrameRegion region;
+    uint64_t updateCount = 0;
+  };
+
+  RegionOfInterest::RegionOfInterest() : impl(std::make_unique<Impl>()) {}
+
+  RegionOfInterest::~RegionOfInterest() = default;
+
+  void RegionOfInterest::Invalidate() {
+    impl->generation.fetch_add(1, std::memory_order_release);
+  }
+
+  bool RegionOfInterest::IsValidFor(uint32_t frameWidth, uint32_t frameHeight) const {
+    impl->checkedGeneration = impl->generation.load(std::memory_order_acquire);
+    return impl->validGeneration == impl->checkedGeneration &&
+           impl->frameWidth == frameWidth &&
+           impl->frameHeight == frameHeight;
+  }
+
+  FrameRegion RegionOfInterest::Update(
+    uint32_t frameWidth,
+    uint32_t frameHeight,
+    const FrameRegion& region
+  ) {
+    // Clamp by cropping an empty view of the frame, so the bounds logic lives in one place.
+    auto clamped = ConstImageView(nullptr, frameWidth, frameHeight, 0).Crop(region);
+
+    impl->frameWidth  = frameWidth;
+    impl->frameHeight = frameHeight;
+    impl->region      = {
+      region.x < frameWidth ? region.x : frameWidth,
+      region.y < frameHeight ? region.y : frameHeight,
+      clamped.width,
+      clamped.height
+    };
+    impl->updateCount++;
+
+    // Only vouch for the generation that was current when the region was found to be stale. If
+    // the window changed again while the caller was querying it, the next frame recomputes it.
+    impl->validGeneration = impl->checkedGeneration != 0
+                              ? impl->checkedGeneration
+                              : impl->generation.load(std::memory_order_acquire);
+    return impl->region;
+  }
+
+  FrameRegion RegionOfInterest::GetRegion() const {
+    return impl->region;
+  }
+
+  ConstImageView RegionOfInterest::GetView(const ConstImageView& frame) const {
+    return frame.Crop(impl->region);
+  }
+
+  uint64_t RegionOfInterest::GetUpdateCount() const {
+    return impl->updateCount;
+  }
+}
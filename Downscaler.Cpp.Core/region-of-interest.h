@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "image-view.h"
+
+namespace Downscaler::Cpp::Core::NativeImpls {
+  /**
+   * @brief Caches the region of the captured frames that should be processed, e.g. the client area
+   * of a window without its title bar and borders.
+   *
+   * Finding the client area means querying the window, which is too slow to do for every frame.
+   * Instead, the region is computed once and reused until the window is moved, resized or changes
+   * DPI, at which point `Invalidate` is called, typically from a window event hook. The next frame
+   * then recomputes the region with `Update`.
+   *
+   * `Invalidate` may be called from any thread. The other members must be called from the thread
+   * that processes the frames.
+   */
+  class RegionOfInterest {
+    public:
+      RegionOfInterest();
+      ~RegionOfInterest();
+
+      RegionOfInterest(const RegionOfInterest&)            = delete;
+      RegionOfInterest& operator=(const RegionOfInterest&) = delete;
+
+      /**
+       * @brief Marks the cached region as stale so it's recomputed for the next frame.
+       */
+      void Invalidate();
+
+      /**
+       * @brief Checks whether the cached region can be used for a frame of the given size.
+       * @param frameWidth The width of the frame in pixels.
+       * @param frameHeight The height of the frame in pixels.
+       * @returns `false` if the region was invalidated or was computed for a different frame size.
+       */
+      bool IsValidFor(uint32_t frameWidth, uint32_t frameHeight) const;
+
+      /**
+       * @brief Caches a newly computed region, clamped to the bounds of the frame.
+       * @param frameWidth The width of the frame the region was computed for, in pixels.
+       * @param frameHeight The height of the frame the region was computed for, in pixels.
+       * @param region The region, relative to the top-left of the frame.
+       * @returns The region as clamped to the frame.
+       */
+      FrameRegion Update(uint32_t frameWidth, uint32_t frameHeight, const FrameRegion& region);
+
+      /**
+       * @returns The cached region. Only meaningful after a call to `Update`.
+       */
+      FrameRegion GetRegion() const;
+
+      /**
+       * @brief Views the cached region of a frame in place.
+       * @param frame The whole frame.
+       * @returns A view of the region that shares the frame's pixels and stride.
+       */
+      ConstImageView GetView(const ConstImageView& frame) const;
+
+      /**
+       * @returns The number of times the region has been recomputed.
+       */
+      uint64_t GetUpdateCount() const;
+
+    private:
+      struct Impl;
+      std::unique_ptr<Impl> impl;
+  };
+}
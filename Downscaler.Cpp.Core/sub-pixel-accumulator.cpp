@@ -0,0 +1,113 @@
+#include "sub-pixel-accumulator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Downscaler::Cpp::Core::NativeImpls {
+  namespace {
+    constexpr int64_t one = int64_t{1} << SubPixelAccumulator::FractionBits;
+
+    // Motion beyond this many counts in a single update spans whole blocks anyway, so it's capped
+    // to keep the fixed point arithmetic well clear of overflow.
+    constexpr int64_t maxDelta = 1 << 15;
+
+    /**
+     * @brief Divides, rounding towards negative infinity, so blocks left of and above the window
+     * are as wide as the ones within it.
+     */
+    inline int64_t FloorDivide(int64_t numerator, int64_t denominator) {
+      auto quotient = numerator / denominator;
+      return (numerator % denominator != 0 && (numerator < 0) != (denominator < 0))
+               ? quotient - 1
+               : quotient;
+    }
+  }
+
+  SubPixelAccumulator::SubPixelAccumulator(double pixelsPerCount) {
+    SetPixelsPerCount(pixelsPerCount);
+  }
+
+  void SubPixelAccumulator::SetPixelsPerCount(double pixelsPerCount) {
+    this->pixelsPerCount = pixelsPerCount > 0.0
+                             ? std::max<int64_t>(1, std::llround(pixelsPerCount * one))
+                             : one;
+  }
+
+  void SubPixelAccumulator::Reset() {
+    horizontal.isAnchored = false;
+    vertical.isAnchored   = false;
+  }
+
+  SubPixelPoint SubPixelAccumulator::Accumulate(
+    const CoordinateMapper& mapper,
+    int32_t downscaledX,
+    int32_t downscaledY,
+    int64_t deltaX,
+    int64_t deltaY
+  ) {
+    const auto& downscaled = mapper.GetDownscaledGeometry();
+    const auto& source     = mapper.GetSourceGeometry();
+
+    SubPixelPoint point;
+    point.fixedX = Step(horizontal, downscaledX, deltaX, downscaled.clientWidth, source.clientWidth);
+    point.fixedY = Step(vertical, downscaledY, deltaY, downscaled.clientHeight, source.clientHeight);
+
+    // An arithmetic shift rounds down, matching `FloorDivide`.
+    point.x = static_cast<int32_t>(point.fixedX >> FractionBits);
+    point.y = static_cast<int32_t>(point.fixedY >> FractionBits);
+
+    if (source.clientWidth > 0) {
+      point.percentX = static_cast<float>(
+        static_cast<double>(point.fixedX) / static_cast<double>(int64_t{source.clientWidth} * one)
+      );
+    }
+    if (source.clientHeight > 0) {
+      point.percentY = static_cast<float>(
+        static_cast<double>(point.fixedY) / static_cast<double>(int64_t{source.clientHeight} * one)
+      );
+    }
+
+    return point;
+  }
+
+  int64_t SubPixelAccumulator::Step(
+    Axis& axis,
+    int32_t cursor,
+    int64_t delta,
+    int32_t downscaledSize,
+    int32_t sourceSize
+  ) const {
+    if (downscaledSize <= 0 || sourceSize <= 0) {
+      axis.isAnchored = false;
+      return int64_t{cursor} * one;
+    }
+
+    // The block of source pixels that the cursor's pixel maps onto, in fixed point. When the
+    // source is smaller than the downscaled window, the block is narrower than a pixel.
+    auto blockStart = FloorDivide(int64_t{cursor} * sourceSize * one, downscaledSize);
+    auto blockEnd   = FloorDivide((int64_t{cursor} + 1) * sourceSize * one, downscaledSize) - 1;
+    blockEnd        = std::max(blockStart, blockEnd);
+
+    // Start from the centre of the block the first time round, after a reset, when either window
+    // was resized, or when the cursor jumped rather than moved, e.g. because it was warped.
+    auto hasJumped = axis.cursor - int64_t{cursor} > 1 || int64_t{cursor} - axis.cursor > 1;
+    if (!axis.isAnchored ||
+        hasJumped ||
+        axis.downscaledSize != downscaledSize ||
+        axis.sourceSize != sourceSize) {
+      axis.position       = blockStart + (blockEnd - blockStart) / 2;
+      axis.isAnchored     = true;
+      axis.downscaledSize = downscaledSize;
+      axis.sourceSize     = sourceSize;
+    } else {
+      // Counts to downscaled pixels, then downscaled pixels to source pixels, all in fixed point.
+      auto counts = std::clamp(delta, -maxDelta, maxDelta);
+      auto moved  = counts * pixelsPerCount * sourceSize / downscaledSize;
+      axis.position += moved;
+    }
+
+    axis.cursor   = cursor;
+    axis.position = std::clamp(axis.position, blockStart, blockEnd);
+    return axis.position;
+  }
+}
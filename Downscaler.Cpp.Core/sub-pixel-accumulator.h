@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+
+#include "coordinate-mapper.h"
+
+namespace Downscaler::Cpp::Core::NativeImpls {
+  /**
+   * @brief A position in the source window's client area with sub-pixel precision.
+   */
+  struct SubPixelPoint {
+    /** The position in fixed point, with `SubPixelAccumulator::FractionBits` fractional bits. */
+    int64_t fixedX = 0;
+    int64_t fixedY = 0;
+
+    /** The position rounded down to whole source pixels. */
+    int32_t x = 0;
+    int32_t y = 0;
+
+    /** The position as a fraction of the source window's client area, 0 to 1 within it. */
+    float percentX = 0.0f;
+    float percentY = 0.0f;
+  };
+
+  /**
+   * @brief Tracks the mouse in the source window at the source's resolution, rather than the
+   * downscaled window's.
+   *
+   * When the downscaled window is 4x smaller than the source, every pixel the cursor moves on it
+   * is 4 pixels in the source, so mapping the cursor position alone can never reach the pixels in
+   * between. Instead, the relative motion reported by the mouse is accumulated in fixed point at
+   * source resolution. The cursor position stays authoritative: the accumulated position is
+   * always clamped to the block of source pixels that the cursor's pixel maps onto, so pointer
+   * acceleration or a mismatched pointer speed can't make the two drift apart.
+   *
+   * All arithmetic is integral, so the same input always produces the same positions.
+   */
+  class SubPixelAccumulator {
+    public:
+      /** The number of fractional bits of the fixed point positions. */
+      static constexpr int FractionBits = 16;
+
+      /**
+       * @param pixelsPerCount How many pixels the cursor moves per count of mouse motion, i.e.
+       * the pointer speed. Windows moves the cursor one pixel per count at its default speed.
+       */
+      explicit SubPixelAccumulator(double pixelsPerCount = 1.0);
+
+      /**
+       * @brief Changes how many pixels the cursor moves per count of mouse motion.
+       */
+      void SetPixelsPerCount(double pixelsPerCount);
+
+      /**
+       * @brief Forgets the accumulated position, so the next one starts from the centre of the
+       * cursor's block of source pixels. Call this when the mouse is moved by an absolute
+       * pointing device or is warped.
+       */
+      void Reset();
+
+      /**
+       * @brief Accumulates the motion of a mouse update.
+       * @param mapper The mapper the cursor position was mapped with.
+       * @param downscaledX The x-coordinate of the cursor relative to the downscaled window.
+       * @param downscaledY The y-coordinate of the cursor relative to the downscaled window.
+       * @param deltaX The relative horizontal motion since the last update, in mouse counts.
+       * @param deltaY The relative vertical motion since the last update, in mouse counts.
+       * @returns The position in the source window.
+       */
+      SubPixelPoint Accumulate(
+        const CoordinateMapper& mapper,
+        int32_t downscaledX,
+        int32_t downscaledY,
+        int64_t deltaX,
+        int64_t deltaY
+      );
+
+    private:
+      /**
+       * @brief The accumulated position along one axis.
+       */
+      struct Axis {
+        int64_t position = 0;
+        int32_t cursor = 0;
+        int32_t downscaledSize = 0;
+        int32_t sourceSize = 0;
+        bool isAnchored = false;
+      };
+
+      int64_t Step(
+        Axis& axis,
+        int32_t cursor,
+        int64_t delta,
+        int32_t downscaledSize,
+        int32_t sourceSize
+      ) const;
+
+      // The pointer speed, in fixed point.
+      int64_t pixelsPerCount;
+
+      Axis horizontal;
+      Axis vertical;
+  };
+}
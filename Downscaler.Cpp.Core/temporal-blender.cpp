@@ -0,0 +1,164 @@
+#include "temporal-blender.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define DOWNSCALER_TEMPORAL_BLEND_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace Downscaler::Cpp::Core::NativeImpls {
+  TemporalBlender::TemporalBlender(uint32_t width, uint32_t height, uint32_t frameCount)
+    : width(width),
+      height(height),
+      frameCount(std::clamp<uint32_t>(frameCount, 1, MaxFrameCount)),
+      rowBytes(static_cast<size_t>(width) * 4) {
+    ring = GetFrameBufferPool().Acquire(rowBytes * height * this->frameCount);
+    if (!ring && rowBytes * height != 0) {
+      throw std::bad_alloc();
+    }
+
+    // Distribute the weight evenly and give any remainder to the newest frames so the weights
+    // always add up to exactly `WeightScale`.
+    weights.assign(this->frameCount, static_cast<uint16_t>(WeightScale / this->frameCount));
+    for (uint32_t i = 0; i < WeightScale % this->frameCount; ++i) {
+      weights[i]++;
+    }
+  }
+
+  bool TemporalBlender::SetWeights(const std::vector<uint16_t>& newWeights) {
+    if (newWeights.size() != frameCount) {
+      return false;
+    }
+
+    uint32_t sum = 0;
+    for (auto weight : newWeights) {
+      sum += weight;
+    }
+
+    if (sum != WeightScale) {
+      return false;
+    }
+
+    weights = newWeights;
+    return true;
+  }
+
+  void TemporalBlender::PushFrame(const uint8_t* pixels, size_t stride) {
+    auto frameBytes = rowBytes * height;
+
+    // On the first frame, fill every slot of the ring so that the blend is well defined.
+    auto copies = isEmpty ? frameCount : 1;
+    for (uint32_t copy = 0; copy < copies; ++copy) {
+      newest = (newest + 1) % frameCount;
+      auto destination = ring.GetData() + frameBytes * newest;
+      for (uint32_t row = 0; row < height; ++row) {
+        std::memcpy(destination + rowBytes * row, pixels + stride * row, rowBytes);
+      }
+    }
+
+    isEmpty = false;
+  }
+
+  bool TemporalBlender::PushFrame(const ConstImageView& frame) {
+    if (frame.width != width || frame.height != height) {
+      return false;
+    }
+
+    PushFrame(frame.pixels, frame.stride);
+    return true;
+  }
+
+  bool TemporalBlender::Blend(
+    const ImageView& output,
+    FrameStatisticsAccumulator* statistics
+  ) const {
+    if (output.width != width || output.height != height) {
+      return false;
+    }
+
+    Blend(output.pixels, output.stride, statistics);
+    return true;
+  }
+
+  void TemporalBlender::Blend(
+    uint8_t* output,
+    size_t stride,
+    FrameStatisticsAccumulator* statistics
+  ) const {
+    if (isEmpty) {
+      return;
+    }
+
+    auto frameBytes = rowBytes * height;
+
+    // Resolve the frames from newest to oldest so they line up with the weights.
+    const uint8_t* frames[MaxFrameCount];
+    for (uint32_t age = 0; age < frameCount; ++age) {
+      auto index = (newest + frameCount - age) % frameCount;
+      frames[age] = ring.GetData() + frameBytes * index;
+    }
+
+    for (uint32_t row = 0; row < height; ++row) {
+      auto rowOffset = rowBytes * row;
+      auto destination = output + stride * row;
+      size_t column = 0;
+
+#ifdef DOWNSCALER_TEMPORAL_BLEND_SSE2
+      // Each channel is widened to 16 bits. Because the weights add up to 256, the weighted sum of
+      // 8-bit values is at most 255 * 256, so the accumulation can never overflow 16 bits, and
+      // neither can adding the rounding bias of 128.
+      const auto zero = _mm_setzero_si128();
+      const auto bias = _mm_set1_epi16(static_cast<short>(WeightScale / 2));
+
+      if (frameCount == 2 && weights[0] == weights[1]) {
+        // An equal blend of two frames is a plain rounded average, which SSE2 does in one
+        // instruction. `(a + b + 1) >> 1` is identical to `(128a + 128b + 128) >> 8`.
+        for (; column + 16 <= rowBytes; column += 16) {
+          auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(frames[0] + rowOffset + column));
+          auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(frames[1] + rowOffset + column));
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + column), _mm_avg_epu8(a, b));
+        }
+      }
+      else {
+        for (; column + 16 <= rowBytes; column += 16) {
+          auto low = bias;
+          auto high = bias;
+          for (uint32_t age = 0; age < frameCount; ++age) {
+            auto weight = _mm_set1_epi16(static_cast<short>(weights[age]));
+            auto pixels = _mm_loadu_si128(
+              reinterpret_cast<const __m128i*>(frames[age] + rowOffset + column)
+            );
+            low  = _mm_add_epi16(low, _mm_mullo_epi16(_mm_unpacklo_epi8(pixels, zero), weight));
+            high = _mm_add_epi16(high, _mm_mullo_epi16(_mm_unpackhi_epi8(pixels, zero), weight));
+          }
+
+          auto result = _mm_packus_epi16(_mm_srli_epi16(low, 8), _mm_srli_epi16(high, 8));
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + column), result);
+        }
+      }
+#endif
+
+      // Handle whatever is left of the row, or the whole row when SIMD isn't available.
+      for (; column < rowBytes; ++column) {
+        uint32_t sum = WeightScale / 2;
+        for (uint32_t age = 0; age < frameCount; ++age) {
+          sum += static_cast<uint32_t>(frames[age][rowOffset + column]) * weights[age];
+        }
+        destination[column] = static_cast<uint8_t>(sum >> 8);
+      }
+
+      // The row is still in cache, so gathering statistics now is nearly free.
+      if (statistics != nullptr) {
+        statistics->AccumulateRow(destination, width);
+      }
+    }
+  }
+
+  void TemporalBlender::Reset() {
+    isEmpty = true;
+    newest = 0;
+  }
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "frame-buffer-pool.h"
+#include "frame-statistics.h"
+
+namespace Downscaler::Cpp::Core::NativeImpls {
+  /**
+   * @brief Blends the most recent downscaled frames together to smooth out frame-rate
+   * down-conversion, e.g. when a 120 fps source is mirrored to a 60 Hz display.
+   *
+   * Frames are 32-bit-per-pixel images (such as BGRA8) and are kept in a ring of `frameCount`
+   * entries. Each output pixel is the weighted sum of the same pixel in every frame of the ring,
+   * with 8-bit fixed-point weights that sum to 256. Results are rounded half-up, and the SIMD and
+   * scalar paths produce bit-identical output.
+   */
+  class TemporalBlender {
+    public:
+      /**
+       * @brief The sum that the blend weights must add up to.
+       */
+      static constexpr uint32_t WeightScale = 256;
+
+      /**
+       * @brief The largest number of frames that can be blended together.
+       */
+      static constexpr uint32_t MaxFrameCount = 16;
+
+      /**
+       * @param width The width of the frames in pixels.
+       * @param height The height of the frames in pixels.
+       * @param frameCount The number of frames to blend together, between 1 and `MaxFrameCount`.
+       */
+      TemporalBlender(uint32_t width, uint32_t height, uint32_t frameCount);
+
+      /**
+       * @brief Replaces the equal weighting of the frames with custom weights.
+       * @param weights
+       *   The weight of each frame, starting with the newest. There must be exactly `frameCount`
+       *   weights and they must add up to `WeightScale`.
+       * @returns `true` if the weights were applied, `false` if they were invalid.
+       */
+      bool SetWeights(const std::vector<uint16_t>& weights);
+
+      /**
+       * @brief Adds a frame to the ring, replacing the oldest frame. The first frame pushed is
+       * used to fill the whole ring so the output starts out unblended.
+       * @param pixels The top-left pixel of the frame.
+       * @param stride The distance between rows of the frame in bytes.
+       */
+      void PushFrame(const uint8_t* pixels, size_t stride);
+
+      /**
+       * @brief Adds a frame to the ring, replacing the oldest frame.
+       * @param frame The frame, which may be a cropped view of a larger image.
+       * @returns `false` if the frame isn't the size the blender was created for.
+       */
+      bool PushFrame(const ConstImageView& frame);
+
+      /**
+       * @brief Writes the weighted blend of the frames in the ring.
+       * @param output The top-left pixel of the image to write to. May be the frame last pushed.
+       * @param stride The distance between rows of the output in bytes.
+       * @param statistics
+       *   If not null, each blended row is added to these statistics as soon as it's written.
+       */
+      void Blend(
+        uint8_t* output,
+        size_t stride,
+        FrameStatisticsAccumulator* statistics = nullptr
+      ) const;
+
+      /**
+       * @brief Writes the weighted blend of the frames in the ring.
+       * @param output The image to write to, which may be a cropped view of a larger image.
+       * @param statistics
+       *   If not null, each blended row is added to these statistics as soon as it's written.
+       * @returns `false` if the output isn't the size the blender was created for.
+       */
+      bool Blend(const ImageView& output, FrameStatisticsAccumulator* statistics = nullptr) const;
+
+      /**
+       * @brief Discards every frame in the ring.
+       */
+      void Reset();
+
+      uint32_t GetWidth() const {
+        return width;
+      }
+
+      uint32_t GetHeight() const {
+        return height;
+      }
+
+      uint32_t GetFrameCount() const {
+        return frameCount;
+      }
+
+    private:
+      uint32_t width;
+      uint32_t height;
+      uint32_t frameCount;
+
+      // The number of bytes in a single row of a frame in the ring.
+      size_t rowBytes;
+
+      // The weight of each frame, starting with the newest.
+      std::vector<uint16_t> weights;
+
+      // The frames, stored back to back in a buffer borrowed from the shared pool so that
+      // recreating the blender at the same size doesn't allocate. `newest` is the index of the most
+      // recent one.
+      PooledFrameBuffer ring;
+      uint32_t newest = 0;
+      bool isEmpty = true;
+  };
+}
@@ -1,14 +1,16 @@
 ﻿using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices.WindowsRuntime;
 using Windows.Foundation;
 using Windows.Graphics.Capture;
 using Core.Models;
 using Core.Utils;
+using Downscaler.Cpp.Core;
 using Microsoft.Graphics.Canvas;
 using Microsoft.UI;
 
 namespace Downscaler.Helpers.Graphics;
 
-public class CanvasFrameProcessor {
+public class CanvasFrameProcessor : IDisposable {
   /// <summary>
   ///   The device used for creating the canvas bitmap.
   /// </summary>
@@ -28,8 +30,87 @@ public class CanvasFrameProcessor {
   /// </summary>
   private CanvasBitmap frameBitmap;
 
+  /// <summary>
+  ///   The client area of the source window within the captured frame. Drawing only this part of
+  ///   the frame crops out the window chrome without copying the frame.
+  /// </summary>
   private Rect srcRect;
 
+  /// <summary>
+  ///   Caches the client area of the source window so it's only queried again after the window
+  ///   moves, is resized or changes DPI, rather than whenever the frame size changes.
+  /// </summary>
+  private readonly RegionOfInterest regionOfInterest = new();
+
+  /// <summary>
+  ///   Stops watching the source window for changes that invalidate <see cref="regionOfInterest" />.
+  /// </summary>
+  private readonly CancellationTokenSource sourceWindowWatch = new();
+
+  /// <summary>
+  ///   Paces presentation of the captured frames against a target refresh rate. If <c>null</c>,
+  ///   frames are presented as soon as they're captured.
+  /// </summary>
+  private readonly FrameScheduler? scheduler;
+
+  /// <summary>
+  ///   Blends the most recent scaled frames together, independently of how they were scaled. If
+  ///   <c>null</c>, frames are shown as they were captured.
+  /// </summary>
+  private readonly TemporalBlender? temporalBlender;
+
+  /// <summary>
+  ///   Receives the luminance statistics of every scaled frame. If <c>null</c>, no statistics are
+  ///   computed.
+  /// </summary>
+  private readonly FrameStatistics? statistics;
+
+  /// <summary>
+  ///   The pixels of the scaled frame, read back so they can be temporally blended or analyzed.
+  ///   Allocated once and reused between frames, so the readback doesn't allocate per frame. It's
+  ///   a managed array rather than a pooled native buffer because Win2D only reads back into a
+  ///   WinRT buffer, and the only one .NET can create is over a managed array.
+  /// </summary>
+  private byte[]? scaledFramePixels;
+
+  /// <summary>
+  ///   When presentation is paced or frames are temporally blended, captured frames are scaled into
+  ///   this render target before being copied to the swap chain.
+  /// </summary>
+  private CanvasRenderTarget? scaledFrame;
+
+  /// <summary>
+  ///   When presentation is paced, the frame that the scheduler last chose to present. It's only
+  ///   replaced when the scheduler starts a new frame, so repeated slots show the same frame even
+  ///   if newer frames were captured in between.
+  /// </summary>
+  private CanvasRenderTarget? presentedFrame;
+
+  /// <summary>
+  ///   Guards <see cref="scaledFrame" /> against being drawn to and presented at the same time.
+  /// </summary>
+  private readonly object scaledFrameLock = new();
+
+  /// <summary>
+  ///   The thread that presents frames when presentation is paced.
+  /// </summary>
+  private Thread? presentThread;
+
+  /// <summary>
+  ///   Whether the presentation thread should keep running.
+  /// </summary>
+  private volatile bool isPresenting;
+
+  /// <summary>
+  ///   The scheduler used to pace presentation, if any. Exposes the achieved cadence error.
+  /// </summary>
+  public FrameScheduler? Scheduler => scheduler;
+
+  /// <summary>
+  ///   The luminance statistics of the most recently processed frame, if they're being computed.
+  /// </summary>
+  public FrameStatistics? Statistics => statistics;
+
 
   /// <summary>
   ///   Instantiates a new <c> CanvasFrameProcessor </c> with the provided <see cref="CanvasDevice" />.
@@ -40,15 +121,97 @@ public class CanvasFrameProcessor {
   ///   The window from which the frame was captured. Used to crop the source rect down to just the
   ///   client area of the window.
   /// </param>
+  /// <param name="scheduler">
+  ///   The scheduler to pace presentation with. If omitted, frames are presented as soon as they're
+  ///   processed.
+  /// </param>
+  /// <param name="temporalBlendFrames">
+  ///   The number of recent frames to blend together after scaling. A value of <c>1</c> disables
+  ///   temporal blending.
+  /// </param>
+  /// <param name="frameStatistics">
+  ///   Whether to compute the luminance statistics of every scaled frame.
+  /// </param>
   public CanvasFrameProcessor(
     CanvasDevice device,
     CanvasSwapChain swapChain,
-    in Win32Window sourceWindow
+    in Win32Window sourceWindow,
+    FrameScheduler? scheduler = null,
+    uint temporalBlendFrames = 1,
+    bool frameStatistics = false
   ) {
     canvasDevice      = device;
     this.swapChain    = swapChain;
     this.sourceWindow = sourceWindow;
+    this.scheduler    = scheduler;
     destRect          = new Rect(0, 0, swapChain.Size.Width, swapChain.Size.Height);
+
+    if (scheduler is not null ||
+        temporalBlendFrames > 1 ||
+        frameStatistics) {
+      scaledFrame = new CanvasRenderTarget(
+        canvasDevice,
+        (float)swapChain.Size.Width,
+        (float)swapChain.Size.Height,
+        swapChain.Dpi
+      );
+    }
+
+    // Blending and analysis happen on the scaled frame, so their cost depends only on the
+    // downscaled size.
+    if (temporalBlendFrames > 1 ||
+        frameStatistics) {
+      var size = scaledFrame!.SizeInPixels;
+      scaledFramePixels = new byte[size.Width * size.Height * 4];
+
+      if (temporalBlendFrames > 1) {
+        temporalBlender = new TemporalBlender(size.Width, size.Height, temporalBlendFrames);
+      }
+
+      if (frameStatistics) {
+        // Anything darker than roughly 10% luma counts as black, with a little room for a loading
+        // spinner or other small, bright elements.
+        statistics = new FrameStatistics(24, 0.001);
+      }
+    }
+
+    WatchSourceWindow();
+
+    if (scheduler is not null) {
+      presentedFrame = new CanvasRenderTarget(
+        canvasDevice,
+        (float)swapChain.Size.Width,
+        (float)swapChain.Size.Height,
+        swapChain.Dpi
+      );
+
+      isPresenting = true;
+      presentThread = new Thread(RunPresentLoop) {
+        IsBackground = true,
+        Priority     = ThreadPriority.Highest,
+        Name         = "Downscaler Present Thread"
+      };
+      presentThread.Start();
+    }
+  }
+
+
+  /// <summary>
+  ///   Stops the presentation thread, if there is one, and releases the native scheduler.
+  /// </summary>
+  public void Dispose() {
+    sourceWindowWatch.Cancel();
+    isPresenting = false;
+    presentThread?.Join();
+    presentThread = null;
+    scheduler?.Dispose();
+    temporalBlender?.Dispose();
+    statistics?.Dispose();
+    scaledFrame?.Dispose();
+    scaledFrame = null;
+    presentedFrame?.Dispose();
+    presentedFrame = null;
+    regionOfInterest.Dispose();
   }
 
 
@@ -60,6 +223,49 @@ public class CanvasFrameProcessor {
   public void ProcessFrame(Direct3D11CaptureFrame frame) {
     // Ensure the bitmap is created and is the correct size.
     EnsureBitmap(frame);
+    EnsureSourceRect(frame);
+
+    if (scaledFrame is not null) {
+      lock (scaledFrameLock) {
+        using (var drawingSession = scaledFrame.CreateDrawingSession()) {
+          drawingSession.Clear(Colors.Black);
+          drawingSession.DrawImage(
+            frameBitmap,
+            destRect,
+            srcRect,
+            1.0f,
+            CanvasImageInterpolation.NearestNeighbor
+          );
+        }
+
+        if (temporalBlender is not null) {
+          // Read the scaled frame back, blend it with the previous frames and upload the result.
+          // The statistics are gathered while the blended rows are written.
+          scaledFrame.GetPixelBytes(scaledFramePixels!.AsBuffer());
+          temporalBlender.PushAndBlend(scaledFramePixels, statistics);
+          scaledFrame.SetPixelBytes(scaledFramePixels);
+        }
+        else if (statistics is not null) {
+          // Nothing is changed on the CPU, so the frame only needs to be read back.
+          var size = scaledFrame.SizeInPixels;
+          scaledFrame.GetPixelBytes(scaledFramePixels!.AsBuffer());
+          statistics.Analyze(scaledFramePixels, size.Width, size.Height);
+        }
+      }
+
+      // When presentation is paced, the presentation thread decides when the frame is shown.
+      if (scheduler is not null) {
+        scheduler.OnFrameArrived();
+        return;
+      }
+
+      using (var drawingSession = swapChain.CreateDrawingSession(Colors.Black)) {
+        drawingSession.DrawImage(scaledFrame);
+      }
+
+      swapChain.Present(0);
+      return;
+    }
 
     // The frame is drawn to the bitmap.
     using (var drawingSession = swapChain.CreateDrawingSession(Colors.Black)) {
@@ -77,6 +283,39 @@ public class CanvasFrameProcessor {
   }
 
 
+  /// <summary>
+  ///   Presents a frame on every refresh slot of the scheduler until the processor is disposed.
+  ///   Slots are serviced on vertical blanks and presented with a sync interval of 1, so every
+  ///   slot lines up with a refresh of the display. The swap chain cycles through its buffers on
+  ///   every present, so repeated frames still need to be drawn again.
+  /// </summary>
+  private void RunPresentLoop() {
+    while (isPresenting) {
+      swapChain.WaitForVerticalBlank();
+      if (!scheduler!.TryTakeSlot(out var action)) {
+        continue;
+      }
+
+      // Only a new frame replaces the presented one. Frames captured while a frame is repeated
+      // stay in the scaled frame until the scheduler starts the next frame.
+      if (action == PresentAction.PresentNewFrame) {
+        lock (scaledFrameLock) {
+          using var copySession = presentedFrame!.CreateDrawingSession();
+          copySession.DrawImage(scaledFrame);
+        }
+      }
+
+      using (var drawingSession = swapChain.CreateDrawingSession(Colors.Black)) {
+        if (action != PresentAction.BlackFrame) {
+          drawingSession.DrawImage(presentedFrame);
+        }
+      }
+
+      swapChain.Present(1);
+    }
+  }
+
+
   /// <summary>
   ///   Ensures that the frame bitmap is created and is the correct size. If the bitmap is not
   ///   created, it is created. If the size of the frame has changed, the bitmap is recreated.
@@ -92,17 +331,52 @@ public class CanvasFrameProcessor {
         Math.Abs(frameBitmap.Size.Height - frame.ContentSize.Height) > 1
        ) {
       frameBitmap = CanvasBitmap.CreateFromDirect3D11Surface(canvasDevice, frame.Surface);
+    }
+  }
 
-      // Get the area to crop to based on the source window's client area relative to the window. We
-      // don't, for example, want to show the window "chrome" (the window's title bar, borders, etc.)
-      var crop = sourceWindow.GetClientRectRelativeToWindow();
 
-      srcRect = new Rect(
-        crop.left,
-        crop.top,
-        crop.Width,
-        crop.Height
-      );
+  /// <summary>
+  ///   Ensures that <see cref="srcRect" /> covers the client area of the source window. The client
+  ///   area is only queried again if the window has changed since it was last queried or the frame
+  ///   size no longer matches.
+  /// </summary>
+  /// <param name="frame"> The frame that is about to be drawn. </param>
+  [MethodImpl(MethodImplOptions.AggressiveInlining)]
+  private void EnsureSourceRect(Direct3D11CaptureFrame frame) {
+    var frameWidth  = (uint)frame.ContentSize.Width;
+    var frameHeight = (uint)frame.ContentSize.Height;
+
+    if (regionOfInterest.IsValidFor(frameWidth, frameHeight)) {
+      return;
     }
+
+    // Get the area to crop to based on the source window's client area relative to the window. We
+    // don't, for example, want to show the window "chrome" (the window's title bar, borders, etc.)
+    var crop = sourceWindow.GetClientRectRelativeToWindow();
+    regionOfInterest.Update(frameWidth, frameHeight, crop.left, crop.top, crop.Width, crop.Height);
+
+    srcRect = new Rect(
+      regionOfInterest.X,
+      regionOfInterest.Y,
+      regionOfInterest.Width,
+      regionOfInterest.Height
+    );
+  }
+
+
+  /// <summary>
+  ///   Invalidates the cached client area whenever the source window moves or is resized, until
+  ///   the processor is disposed. Moving the window to a monitor with a different DPI and DPI
+  ///   changes that resize the window are reported as location changes too.
+  /// </summary>
+  private void WatchSourceWindow() {
+    var hwnd = sourceWindow.Hwnd;
+
+    _ = WinEventAwaiter.WatchEvents(
+      [WinEvent.EVENT_OBJECT_LOCATIONCHANGE],
+      eventHwnd => eventHwnd == hwnd,
+      _ => regionOfInterest.Invalidate(),
+      sourceWindowWatch.Token
+    );
   }
 }
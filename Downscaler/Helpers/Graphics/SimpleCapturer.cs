@@ -6,10 +6,12 @@ using Windows.Win32.Foundation;
 using Core.Models;
 using Core.Utils;
 using Downscaler.Core.Contracts.Models.AppState;
+using Downscaler.Cpp.Core;
 using Microsoft.Graphics.Canvas;
 using Microsoft.Graphics.Canvas.UI.Xaml;
 using Microsoft.UI.Dispatching;
 using Microsoft.UI.Xaml.Controls;
+using static Windows.Win32.PInvoke;
 // For SwapChainPanel in WinUI 3
 // As of my last update, capture APIs might still be under Windows.*
 using DirectXPixelFormat =
@@ -100,6 +102,7 @@ public class SimpleCapturer : ICapturer {
     // Cleanup logic remains the same
     framePool?.Dispose();
     session?.Dispose();
+    frameProcessor?.Dispose();
   }
 
 
@@ -161,8 +164,34 @@ public class SimpleCapturer : ICapturer {
       96
     );
 
+    // If the user asked for a target refresh rate, pace presentation against it rather than
+    // presenting every frame as soon as it arrives.
+    FrameScheduler? scheduler = null;
+    if (AppState.TargetRefreshRate is not null) {
+      scheduler = new FrameScheduler(
+        AppState.TargetRefreshRate.Value,
+        0, // Measure the source frame rate from the captured frames.
+        AppState.BlackFrameInsertion,
+        1
+      );
+    }
+
+    // Large pages must be enabled before the frame processor borrows its buffers.
+    if (AppState.LargePages &&
+        !FrameBufferPool.SetLargePagesEnabled(true) &&
+        AppState.DebugState.Enabled) {
+      Console.WriteLine("Large pages are unavailable, falling back to regular pages.");
+    }
+
     // Initialize the frame processor
-    frameProcessor = new CanvasFrameProcessor(canvasDevice, swapChain, in windowToScale);
+    frameProcessor = new CanvasFrameProcessor(
+      canvasDevice,
+      swapChain,
+      in windowToScale,
+      scheduler,
+      AppState.TemporalBlendFrames,
+      AppState.FrameStatistics
+    );
 
     // Create a CanvasSwapChainPanel and assign the swap chain to it.
     var swapChainPanelControl = new CanvasSwapChainPanel {
@@ -189,6 +218,8 @@ public class SimpleCapturer : ICapturer {
       frameProcessor.ProcessFrame(frame);
     }
 
+    UpdateBlackScreen();
+
     // Increment the frame count and don't check for overflow.
     unchecked {
       frameCount++;
@@ -199,6 +230,31 @@ public class SimpleCapturer : ICapturer {
   }
 
 
+  /// <summary>
+  ///   Checks whether the window has turned black, or come back from black, and if so raises the
+  ///   matching <see cref="DownscalerWinEvent" /> on the window being scaled.
+  /// </summary>
+  [MethodImpl(MethodImplOptions.AggressiveInlining)]
+  private void UpdateBlackScreen() {
+    // Single dark frames, such as a flash between scenes, are debounced by the statistics.
+    var transition = frameProcessor.Statistics?.UpdateBlackScreen() ?? BlackScreenTransition.None;
+    if (transition == BlackScreenTransition.None) {
+      return;
+    }
+
+    // The event is raised on the window being scaled so that listeners can filter by the window
+    // they already know about.
+    NotifyWinEvent(
+      transition == BlackScreenTransition.Started
+        ? DownscalerWinEvent.EVENT_DOWNSCALER_BLACKSCREENSTART
+        : DownscalerWinEvent.EVENT_DOWNSCALER_BLACKSCREENEND,
+      windowToScale.Hwnd,
+      0, // OBJID_WINDOW
+      0  // CHILDID_SELF
+    );
+  }
+
+
   [MethodImpl(MethodImplOptions.AggressiveInlining)]
   private void UpdateFps() {
     // If the stopwatch has been running for at least a 750 ms, calculate the new FPS.
@@ -212,6 +268,29 @@ public class SimpleCapturer : ICapturer {
         frameCount    = 0;
         lastFpsReport = stopwatch.Elapsed.TotalSeconds;
 
+        // If presentation is paced, report how closely the refresh slots were hit since the last
+        // report.
+        var scheduler = frameProcessor.Scheduler;
+        if (scheduler is not null &&
+            AppState.DebugState.Enabled) {
+          var cadenceError = scheduler.CadenceError;
+          Console.WriteLine(
+            $"Cadence error: p50 {cadenceError.GetPercentile(50)} µs, p99 {
+              cadenceError.GetPercentile(99)
+            } µs, max {cadenceError.Max} µs, source {scheduler.SourceFrameRate:0.00} Hz, missed slots {
+              scheduler.MissedSlots
+            }"
+          );
+          cadenceError.Reset();
+        }
+
+        if (AppState.DebugState.Enabled) {
+          Console.WriteLine(
+            $"Frame buffer pool: {FrameBufferPool.Hits} hits, {FrameBufferPool.Misses} misses, {
+              FrameBufferPool.BytesAllocated / 1024} KiB allocated"
+          );
+        }
+
         // Round the FPS to the nearest integer and check if it has changed. If it has, raise the event.
         if ((int)newFPS != (int)fps) {
           fps = newFPS;
@@ -270,6 +270,7 @@ public partial class MainViewModel : INotifyPropertyChanged {
     // CaptureService.PickAndCaptureWindow(swapChainPanel);
     CaptureService.StartCapture(swapChainPanel, dispatcherQueue);
     CaptureService.FrameRateChanged += (_, args) => {
+      MouseEventService.SetCaptureFrameRate(args.newFrameRate);
       swapChainPanel.DispatcherQueue.TryEnqueue(
         () => {
           FrameRate = args.newFrameRate;
@@ -1,5 +1,6 @@
 ﻿using System.ComponentModel;
 using GameLauncher.Script;
+using GameLauncher.TypeScript;
 using Microsoft.ClearScript.V8;
 using Spectre.Console;
 using Spectre.Console.Cli;
@@ -21,8 +22,25 @@ public class RunCommand : AsyncCommand<RunCommand.Settings> {
                  : GetFullPath(settings.ScriptPath);
 
 
-    var scriptRunner = new ScriptRunner(path);
+    var scriptRunner = new ScriptRunner(path, measureStartup: settings.DebugMode);
     await scriptRunner.RunScript();
+
+    if (settings.DebugMode) {
+      if (scriptRunner.TimeToEvaluation is { } startup) {
+        AnsiConsole.MarkupLine(
+          $"[grey]Script started running {startup.TotalMilliseconds:F0} ms after launch " +
+          $"(code cache {scriptRunner.CodeCacheResult})[/]"
+        );
+      }
+
+      if (CachedCompiler.Cache is { } cache) {
+        AnsiConsole.MarkupLine(
+          $"[grey]Compile cache: {cache.Hits} hits, {cache.Misses} misses " +
+          $"({cache.Rejected} corrupt), {cache.Count} entries[/]"
+        );
+      }
+    }
+
     return 0;
   }
 
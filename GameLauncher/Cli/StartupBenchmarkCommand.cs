@@ -0,0 +1,114 @@
+﻿using System.ComponentModel;
+using System.Diagnostics;
+using System.Globalization;
+using System.Text.RegularExpressions;
+using GameLauncher.Script;
+using GameLauncher.TypeScript;
+using Spectre.Console;
+using Spectre.Console.Cli;
+using static System.IO.Path;
+
+namespace GameLauncher.Cli;
+
+/// <summary>
+///   Compares how long a script takes to start with cold and warm caches. Each start is a separate
+///   process running the script with <c>--debug</c>, which reports when V8 began running it.
+/// </summary>
+/// <remarks>
+///   The compile and code caches are cleared before every cold start, so the script should be one
+///   that's safe to run repeatedly.
+/// </remarks>
+public partial class StartupBenchmarkCommand : AsyncCommand<StartupBenchmarkCommand.Settings> {
+  public override async Task<int> ExecuteAsync(CommandContext context, Settings settings) {
+    if (settings.ScriptPath is null) {
+      AnsiConsole.MarkupLine("[red]Error: No script path provided.[/]");
+      return 1;
+    }
+
+    var path = IsPathRooted(settings.ScriptPath)
+                 ? settings.ScriptPath
+                 : GetFullPath(settings.ScriptPath);
+
+    var cold = new List<double>();
+    var warm = new List<double>();
+    for (var run = 0; run < settings.Runs; run++) {
+      ClearCaches();
+      var coldStart = await MeasureStartup(path);
+      var warmStart = await MeasureStartup(path);
+      if (coldStart is null || warmStart is null) {
+        AnsiConsole.MarkupLine("[red]Error: The script didn't report when it started.[/]");
+        return 1;
+      }
+
+      cold.Add(coldStart.Value);
+      warm.Add(warmStart.Value);
+    }
+
+    Report("Cold", cold);
+    Report("Warm", warm);
+    return 0;
+  }
+
+
+  /// <summary>
+  ///   Removes the compiled TypeScript and V8 code caches, so the next start compiles everything.
+  /// </summary>
+  private static void ClearCaches() {
+    foreach (var directory in new[] { CachedCompiler.CacheDirectory, CodeCache.CacheDirectory }) {
+      if (Directory.Exists(directory)) {
+        Directory.Delete(directory, true);
+      }
+    }
+  }
+
+
+  /// <summary>
+  ///   Runs the script in a new process.
+  /// </summary>
+  /// <returns>
+  ///   How many milliseconds after launch the script started running, or <see langword="null" />
+  ///   if the process didn't report it.
+  /// </returns>
+  private static async Task<double?> MeasureStartup(string path) {
+    using var process = Process.Start(
+      new ProcessStartInfo {
+        FileName               = Environment.ProcessPath!,
+        ArgumentList           = { path, "--debug" },
+        UseShellExecute        = false,
+        RedirectStandardOutput = true
+      }
+    )!;
+
+    var output = await process.StandardOutput.ReadToEndAsync();
+    await process.WaitForExitAsync();
+
+    var match = StartupRegex().Match(output);
+    return match.Success ? double.Parse(match.Groups[1].Value, CultureInfo.InvariantCulture) : null;
+  }
+
+
+  private static void Report(string label, List<double> samples) {
+    samples.Sort();
+    AnsiConsole.MarkupLine(
+      $"{label}: min {samples[0]:F0} ms, median {samples[samples.Count / 2]:F0} ms, " +
+      $"max {samples[^1]:F0} ms over {samples.Count} runs"
+    );
+  }
+
+
+  // Matches the startup time that `run --debug` reports, e.g. "Script started running 412 ms".
+  [GeneratedRegex(@"Script started running (\d+) ms")]
+  private static partial Regex StartupRegex();
+
+
+  public sealed class Settings : CommandSettings {
+    [Description("The path to the script file to start.")]
+    [CommandArgument(0, "<path-to-script>")]
+    public string ScriptPath { get; init; }
+
+    [Description("How many cold and warm starts to measure.")]
+    [CommandOption("-n|--runs")]
+    [DefaultValue(5)]
+    public int Runs { get; init; }
+  }
+}
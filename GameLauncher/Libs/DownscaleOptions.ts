@@ -41,6 +41,13 @@ export interface DownscaleOptions {
      *
      */
     scaleHeight?: number | null;
+    /**
+     * Whether the downscaler should compute luminance statistics for every frame.
+     * This enables the `blackScreenStarted` and `blackScreenEnded` events of the
+     * source window, which are useful for reacting to loading screens.
+     *
+     */
+    frameStatistics?: boolean | null;
     /**
      * A namespace where debug configurations can be specified.
      *
@@ -161,6 +161,19 @@ export interface Window {
      *
      */
     readonly boundsChanged: Promise<void>;
+    /**
+     * Resolves the next time the window turns black, e.g. when a loading screen
+     * is shown. Only raised while the window is being downscaled with
+     * `frameStatistics` enabled.
+     *
+     */
+    readonly blackScreenStarted: Promise<void>;
+    /**
+     * Resolves the next time the window stops being black. Only raised while the
+     * window is being downscaled with `frameStatistics` enabled.
+     *
+     */
+    readonly blackScreenEnded: Promise<void>;
     /**
      * Resolves once when the window is closed.
      *
@@ -172,7 +185,7 @@ export interface Window {
      * @param eventName The name of the event to bind the callback to.
      * @param callback The callback to execute when the event occurs.
      */
-    on(eventName: "shown" | "hidden" | "minimized" | "maximized" | "restored" | "focused" | "boundsChanged" | "closed", callback: WindowEventCallback): void;
+    on(eventName: "shown" | "hidden" | "minimized" | "maximized" | "restored" | "focused" | "boundsChanged" | "blackScreenStarted" | "blackScreenEnded" | "closed", callback: WindowEventCallback): void;
     /**
      * Requests that the window be closed. This sends a close message to the
      * window, which may or may not result in the window being closed. The window
@@ -8,4 +8,25 @@
 export interface WindowSearchCriteria {
     title?: string | null;
     className?: string | null;
+    /**
+     * The file name of the process that owns the window, e.g. `game.exe`.
+     *
+     */
+    processName?: string | null;
+    /**
+     * How the title, class name and process name are compared. The mode can be
+     * one of the following: `exact`: The whole string must equal the pattern.
+     * This is the default. `glob`: The whole string must match the pattern,
+     * where `*` matches any run of characters and `?` matches any single
+     * character. `regex`: The pattern is a regular expression that must match
+     * part of the string.
+     *
+     */
+    matchMode?: "exact" | "glob" | "regex" | null | undefined;
+    /**
+     * Whether the title, class name and process name are compared
+     * case-insensitively.
+     *
+     */
+    ignoreCase?: boolean | null;
 }
@@ -28,4 +28,8 @@ AppDomain.CurrentDomain.ProcessExit += (sender, e) => {
 };
 
 var app = new CommandApp<RunCommand>();
+app.Configure(
+  config => config.AddCommand<StartupBenchmarkCommand>("benchmark-startup")
+                  .WithDescription("Compares cold and warm starts of a script.")
+);
 return await app.RunAsync(args);
@@ -1,15 +1,27 @@
-﻿using Microsoft.ClearScript.V8;
+﻿using System.Runtime.InteropServices;
+using Cpp.Core;
+using Microsoft.ClearScript.V8;
 
 namespace GameLauncher.Script.Async;
 
 /// <summary>
 ///   The host event loop that drives asynchronous callbacks (including promise continuations).
 /// </summary>
+/// <remarks>
+///   Callbacks are queued as <see cref="GCHandle" />s in a native lock-free queue, so scheduling
+///   one never takes a lock, and the loop runs every callback that's ready each time it wakes up.
+///   The loop only parks its thread once it runs out of callbacks. It frees the queue itself once
+///   it stops, after releasing every callback that was still scheduled.
+/// </remarks>
 public class EventLoop : IDisposable {
+  // The most callbacks taken from the queue per wakeup.
+  private const int drainBatchSize = 256;
+
   private readonly V8ScriptEngine          engine;
-  private readonly AsyncQueue<Func<Task>>  taskQueue = new();
-  private readonly CancellationTokenSource cts       = new();
-  private          bool                    isDone;
+  private readonly RunQueue                runQueue = new();
+  private readonly CancellationTokenSource cts      = new();
+  private          Task?                   loopTask;
+  private volatile bool                    isDone;
 
 
   public EventLoop(V8ScriptEngine engine) {
@@ -19,31 +31,30 @@ public class EventLoop : IDisposable {
 
   public void Dispose() {
     SignalDone();
+
+    // A running loop frees the queue once it has drained it.
+    if (loopTask == null) {
+      runQueue.Dispose();
+    }
+
     cts.Dispose();
     engine.Dispose();
   }
 
 
   /// <summary>
-  ///   Runs the event loop until SignalDone is called or cancellation is requested.
+  ///   Runs the event loop until SignalDone is called. The loop runs on a dedicated thread, since
+  ///   it parks the thread whenever it runs out of callbacks.
   /// </summary>
-  public async Task RunAsync() {
-    try {
-      while (!cts.Token.IsCancellationRequested &&
-             !isDone) {
-        // Wait for the next scheduled callback.
-        var callback = await taskQueue.DequeueAsync(cts.Token).ConfigureAwait(false);
-        try {
-          await callback().ConfigureAwait(false);
-        }
-        catch (Exception ex) {
-          Console.Error.WriteLine("Error executing scheduled event: " + ex);
-        }
-      }
-    }
-    catch (OperationCanceledException) {
-      // Expected when cancellation occurs.
-    }
+  /// <returns>A task that completes once the loop stops.</returns>
+  public Task RunAsync() {
+    loopTask = Task.Factory.StartNew(
+      RunLoop,
+      CancellationToken.None,
+      TaskCreationOptions.LongRunning,
+      TaskScheduler.Default
+    );
+    return loopTask;
   }
 
 
@@ -52,7 +63,12 @@ public class EventLoop : IDisposable {
   /// </summary>
   public void ScheduleEvent(Func<Task> callback) {
     if (callback == null) throw new ArgumentNullException(nameof(callback));
-    taskQueue.Enqueue(callback);
+
+    var handle = GCHandle.Alloc(callback);
+    if (!runQueue.Push(GCHandle.ToIntPtr(handle).ToInt64())) {
+      // The loop was stopped, so the callback would never run.
+      handle.Free();
+    }
   }
 
 
@@ -78,6 +94,53 @@ public class EventLoop : IDisposable {
   /// </summary>
   public void SignalDone() {
     isDone = true;
+    runQueue.Close();
     cts.Cancel();
   }
+
+
+  /// <summary>
+  ///   Runs the callbacks in the order they were scheduled, each once the previous one's task
+  ///   completes, until the queue is closed. Once stopped, the callbacks that are still scheduled
+  ///   are released without running.
+  /// </summary>
+  /// <remarks>
+  ///   The loop is synchronous, so it never leaves its thread. Awaiting a callback would resume
+  ///   the loop on a thread-pool thread, which would then stay parked in <c>Drain</c>. The thread
+  ///   waits for a callback's task instead, while the callback's own continuations run on the
+  ///   thread pool as they would otherwise.
+  /// </remarks>
+  private void RunLoop() {
+    var handles = new long[drainBatchSize];
+
+    // Without a timeout, the queue only runs dry once it's closed and every callback that was
+    // accepted has been taken.
+    int count;
+    while ((count = runQueue.Drain(handles, Timeout.Infinite)) > 0) {
+      for (var i = 0; i < count; i++) {
+        var callback = TakeCallback(handles[i]);
+        if (isDone) {
+          continue;
+        }
+
+        try {
+          callback().GetAwaiter().GetResult();
+        }
+        catch (Exception ex) {
+          Console.Error.WriteLine("Error executing scheduled event: " + ex);
+        }
+      }
+    }
+
+    // Nothing else can be scheduled now, so pushes racing this simply fail.
+    runQueue.Dispose();
+  }
+
+
+  private static Func<Task> TakeCallback(long value) {
+    var handle   = GCHandle.FromIntPtr(new IntPtr(value));
+    var callback = (Func<Task>)handle.Target!;
+    handle.Free();
+    return callback;
+  }
 }
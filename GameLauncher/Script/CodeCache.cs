@@ -0,0 +1,92 @@
+﻿using System.Text;
+using Microsoft.ClearScript;
+using Microsoft.ClearScript.V8;
+using CompileCache = Cpp.Core.CompileCache;
+
+namespace GameLauncher.Script;
+
+/// <summary>
+///   Persists the V8 code caches of compiled scripts, so that a script that ran before is
+///   deserialized rather than parsed and compiled again.
+/// </summary>
+/// <remarks>
+///   Code caches are keyed by a hash of the script's code, seeded with a fingerprint of
+///   ClearScript, which bundles V8. V8 also checks a code cache against its own version, flags and
+///   the source, and a cache it rejects is replaced.
+/// </remarks>
+public static class CodeCache {
+  private static readonly string cacheDirectory = Path.Combine(
+    Environment.GetFolderPath(Environment.SpecialFolder.LocalApplicationData),
+    "GameLauncher",
+    "CodeCache"
+  );
+
+  // The cache, or null if it couldn't be opened, in which case scripts are compiled without one.
+  private static readonly Lazy<CompileCache?> cache = new(OpenCache);
+
+  // A hash of the V8 build the code caches were made by.
+  private static readonly Lazy<ulong> fingerprint = new(GetFingerprint);
+
+
+  /// <summary>
+  ///   The cache, or <see langword="null" /> if it couldn't be opened. Exposes the hit and miss
+  ///   counts.
+  /// </summary>
+  public static CompileCache? Cache => cache.Value;
+
+  /// <summary>
+  ///   The directory the code caches are stored in.
+  /// </summary>
+  public static string CacheDirectory => cacheDirectory;
+
+
+  /// <summary>
+  ///   Compiles a script, consuming its code cache if there is one and storing a new one if V8
+  ///   made one.
+  /// </summary>
+  /// <param name="engine">The engine to compile the script for.</param>
+  /// <param name="documentInfo">Describes the script.</param>
+  /// <param name="code">The script's code.</param>
+  /// <param name="cacheResult">Receives what became of the code cache.</param>
+  /// <returns>The compiled script.</returns>
+  public static V8Script Compile(
+    V8ScriptEngine engine,
+    DocumentInfo documentInfo,
+    string code,
+    out V8CacheResult cacheResult
+  ) {
+    var key        = Encoding.UTF8.GetBytes(code);
+    var cacheBytes = cache.Value?.LookupBytes(key, fingerprint.Value);
+
+    var script = engine.Compile(
+      documentInfo,
+      code,
+      V8CacheKind.Code,
+      ref cacheBytes,
+      out cacheResult
+    );
+    if (cacheResult == V8CacheResult.Updated &&
+        cacheBytes is { Length: > 0 }) {
+      cache.Value?.StoreBytes(key, fingerprint.Value, cacheBytes);
+    }
+
+    return script;
+  }
+
+
+  private static ulong GetFingerprint() {
+    var build = typeof(V8ScriptEngine).Assembly.ManifestModule.ModuleVersionId.ToByteArray();
+    return BitConverter.ToUInt64(build, 0) ^ BitConverter.ToUInt64(build, 8);
+  }
+
+
+  private static CompileCache? OpenCache() {
+    try {
+      return new CompileCache(cacheDirectory);
+    }
+    catch (Exception exception) when (exception is IOException or UnauthorizedAccessException) {
+      Console.Error.WriteLine($"The code cache is unavailable: {exception.Message}");
+      return null;
+    }
+  }
+}
@@ -1,33 +1,71 @@
-﻿using Microsoft.ClearScript;
+﻿using GameLauncher.Script.Async;
+using Microsoft.ClearScript;
 using Microsoft.ClearScript.V8;
-using Timer = System.Threading.Timer;
+using TimerService = Cpp.Core.TimerService;
 
 namespace GameLauncher.Script.Globals;
 
+/// <summary>
+///   The script's <c>setTimeout</c> and <c>setInterval</c>. Timers are kept in a native timing
+///   wheel driven by a single thread, and each expiration is posted to the script's event loop in
+///   the order the timers expired, so callbacks never run concurrently.
+/// </summary>
 internal class Timers {
-  private static readonly Dictionary<int, Timer> timeoutMap  = new();
-  private static readonly Dictionary<int, Timer> intervalMap = new();
-  private static          int                    timeoutIdCounter;
-  private static          int                    intervalIdCounter;
+  // The most expirations read from the timer service at once.
+  private const int readBatchSize = 256;
+
+  // Keeps the pending timers and queues the ones that expire.
+  private static readonly TimerService service = new();
+
+  // A dedicated thread that reads the expirations and posts them to the event loop.
+  private static readonly Thread dispatchThread;
+
+  // Lock for protecting the pending timers and the event loop.
+  private static readonly object @lock = new();
+
+  // The pending timers, by their identifiers in the timer service. Timeouts and intervals share
+  // identifiers, so either can be cleared with either function.
+  private static readonly Dictionary<uint, ScriptTimer> timers = new();
+
+  // The event loop the callbacks of the current engine run on.
+  private static EventLoop? eventLoop;
+
+
+  // In the static constructor we start the dispatch thread.
+  static Timers() {
+    dispatchThread = new Thread(DispatchExpirations) {
+      IsBackground = true
+    };
+    dispatchThread.Start();
+  }
 
 
   public static void ClearInterval(int id) {
-    if (intervalMap.TryGetValue(id, out var timer)) {
-      timer.Dispose();
-      intervalMap.Remove(id);
-    }
+    Clear(id);
   }
 
 
   public static void ClearTimeout(int id) {
-    if (timeoutMap.TryGetValue(id, out var timer)) {
-      timer.Dispose();
-      timeoutMap.Remove(id);
-    }
+    Clear(id);
   }
 
 
   public static void InjectIntoEngine(V8ScriptEngine engine) {
+    // The timers of a previous engine never run on the new one.
+    lock (@lock) {
+      foreach (var id in timers.Keys) {
+        service.Cancel(id);
+      }
+
+      timers.Clear();
+
+      // Only signalled, since disposing the event loop would dispose its engine too. Once stopped,
+      // the loop releases the callbacks still scheduled on it and frees its queue by itself.
+      eventLoop?.SignalDone();
+      eventLoop = new EventLoop(engine);
+      _         = eventLoop.RunAsync();
+    }
+
     engine.Script.__setTimeout    = new Func<ScriptObject, int, int>(SetTimeout);
     engine.Script.__clearTimeout  = new Action<int>(ClearTimeout);
     engine.Script.__setInterval   = new Func<ScriptObject, int, int>(SetInterval);
@@ -60,25 +98,101 @@ internal class Timers {
 
 
   public static int SetInterval(ScriptObject func, int interval) {
-    var id    = Interlocked.Increment(ref intervalIdCounter);
-    var timer = new Timer(_ => func.Invoke(false), state: null, interval, interval);
-    intervalMap[id] = timer;
-    return id;
+    // Like browsers, an interval repeats at most once per millisecond.
+    var period = (uint)Math.Max(interval, 1);
+    return Schedule(func, period, period);
   }
 
 
   public static int SetTimeout(ScriptObject func, int delay) {
-    var id = Interlocked.Increment(ref timeoutIdCounter);
-    var timer = new Timer(
-      _ => {
-        func.Invoke(false);
-        timeoutMap.Remove(id);
-      },
-      state: null,
-      delay,
-      Timeout.Infinite
-    );
-    timeoutMap[id] = timer;
-    return id;
+    return Schedule(func, (uint)Math.Max(delay, 0), 0);
+  }
+
+
+  private static void Clear(int id) {
+    lock (@lock) {
+      if (timers.Remove((uint)id)) {
+        service.Cancel((uint)id);
+      }
+    }
+  }
+
+
+  /// <summary>
+  ///   Reads the timers that expired and posts their callbacks to the event loop, until the timer
+  ///   service is stopped.
+  /// </summary>
+  private static void DispatchExpirations() {
+    var ids = new uint[readBatchSize];
+
+    while (true) {
+      // Without a timeout, nothing is read only once the service was stopped, and every later read
+      // would return at once.
+      var count = service.Read(ids, Timeout.Infinite);
+      if (count == 0) {
+        return;
+      }
+
+      lock (@lock) {
+        for (var i = 0; i < count; i++) {
+          // Timers that were cleared after they expired are skipped here, and timers cleared after
+          // they're posted are skipped when the callback runs.
+          if (timers.TryGetValue(ids[i], out var timer)) {
+            var id = ids[i];
+            eventLoop?.ScheduleEvent(() => Run(id, timer));
+          }
+        }
+      }
+    }
+  }
+
+
+  /// <summary>
+  ///   Runs the callback of a timer that expired, on the event loop.
+  /// </summary>
+  private static Task Run(uint id, ScriptTimer timer) {
+    lock (@lock) {
+      if (!timers.TryGetValue(id, out var pending) ||
+          pending != timer) {
+        return Task.CompletedTask;
+      }
+
+      if (!timer.Repeat) {
+        timers.Remove(id);
+      }
+    }
+
+    timer.Func.Invoke(false);
+    return Task.CompletedTask;
+  }
+
+
+  private static int Schedule(ScriptObject func, uint delay, uint interval) {
+    // The timer is registered before the lock is released, so the dispatch thread can't read its
+    // expiration before it knows about it.
+    lock (@lock) {
+      var id = service.Schedule(delay, interval);
+      timers[id] = new ScriptTimer(func, interval != 0);
+      return (int)id;
+    }
+  }
+
+
+  /// <summary>
+  ///   A pending timer and the script callback it runs.
+  /// </summary>
+  private class ScriptTimer {
+    public ScriptObject Func { get; }
+
+    /// <summary>
+    ///   Whether the timer is an interval, which stays pending after it expires.
+    /// </summary>
+    public bool Repeat { get; }
+
+
+    public ScriptTimer(ScriptObject func, bool repeat) {
+      Func   = func;
+      Repeat = repeat;
+    }
   }
 }
@@ -2,10 +2,13 @@
 using Microsoft.Extensions.FileSystemGlobbing;
 using Microsoft.Extensions.FileSystemGlobbing.Abstractions;
 using File = GameLauncher.Script.Objects.File;
+using GlobWalker = Cpp.Core.GlobWalker;
 
 namespace GameLauncher.Script;
 
 public static partial class Tasks {
+  private const int globReadBatchSize = 256;
+
   /// <summary>
   ///   Searches for files matching the specified glob pattern in the given directory (and
   ///   potentially its subdirectories). This allows for finding files based on patterns
@@ -64,15 +67,59 @@ public static partial class Tasks {
     }
 
     return Task.Run(() => {
-        var matcher = new Matcher(StringComparison.OrdinalIgnoreCase);
-        matcher.AddInclude(globPattern);
-        if (excludePattern != null) matcher.AddExclude(excludePattern);
+        var canWalkNatively = GlobWalker.IsSupported(globPattern) &&
+                              (excludePattern == null || GlobWalker.IsSupported(excludePattern));
+        var paths = canWalkNatively
+          ? GlobNative(searchDir, globPattern, excludePattern)
+          : GlobWithMatcher(searchDir, globPattern, excludePattern);
 
-        var result = matcher.Execute(new DirectoryInfoWrapper(new DirectoryInfo(searchDir)));
         return JSArray<File>.FromIEnumerable(
-          result.Files.Select(file => new File(Path.Combine(searchDir, file.Path)))
+          paths.Select(path => new File(Path.Combine(searchDir, path)))
         );
       }
     );
   }
+
+  /// <summary>
+  ///   Walks the directory on native threads, which skip the subdirectories that can't hold a
+  ///   match. The matches arrive in no particular order, so they're sorted to keep the results
+  ///   stable between runs.
+  /// </summary>
+  private static List<string> GlobNative(
+    string searchDir,
+    string globPattern,
+    string? excludePattern
+  ) {
+    var excludes = excludePattern != null ? new[] { excludePattern } : null;
+    using var walker = new GlobWalker(searchDir, globPattern, excludes, ignoreCase: true);
+
+    var paths = new List<string>();
+    var batch = new string[globReadBatchSize];
+    int count;
+    while ((count = walker.Read(batch, Timeout.Infinite)) > 0) {
+      for (var i = 0; i < count; i++) {
+        paths.Add(batch[i]);
+      }
+    }
+
+    paths.Sort(StringComparer.OrdinalIgnoreCase);
+    return paths;
+  }
+
+  /// <summary>
+  ///   Walks the directory with <see cref="Matcher" />, for patterns that the native walker
+  ///   doesn't support, such as ones that refer to a parent directory.
+  /// </summary>
+  private static IEnumerable<string> GlobWithMatcher(
+    string searchDir,
+    string globPattern,
+    string? excludePattern
+  ) {
+    var matcher = new Matcher(StringComparison.OrdinalIgnoreCase);
+    matcher.AddInclude(globPattern);
+    if (excludePattern != null) matcher.AddExclude(excludePattern);
+
+    var result = matcher.Execute(new DirectoryInfoWrapper(new DirectoryInfo(searchDir)));
+    return result.Files.Select(file => file.Path);
+  }
 }
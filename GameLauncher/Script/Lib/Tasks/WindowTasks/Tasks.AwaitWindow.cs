@@ -1,4 +1,5 @@
-﻿using Core.Models;
+﻿using Windows.Win32.Foundation;
+using Core.Models;
 using Core.Utils;
 using GameLauncher.Script.Objects;
 using GameLauncher.Script.Utils.CodeGenAttributes;
@@ -29,28 +30,30 @@ public static partial class Tasks {
   ///   indefinitely.
   /// </param>
   /// <returns> The window that was created, or <see langword="null" /> if the timeout elapsed. </returns>
-  public static async Task<Window?> AwaitWindow(
+  public static Task<Window?> AwaitWindow(
     WindowSearchCriteria searchCriteria,
     int timeout = 0
   ) {
-    return await AwaitWindow(
-             hwnd => {
-               var windowMatches = true;
+    return AwaitWindow(searchCriteria, timeout, CancellationToken.None);
+  }
 
-               // If a title was provided to match against, check if the window's title matches.
-               if (searchCriteria.Title is not null) {
-                 windowMatches &= hwnd.GetWindowText() == searchCriteria.Title;
-               }
 
-               // If a class name was provided to match against, check if the window's class name matches.
-               if (searchCriteria.ClassName is not null) {
-                 windowMatches &= hwnd.GetClassName() == searchCriteria.ClassName;
-               }
+  private static async Task<Window?> AwaitWindow(
+    WindowSearchCriteria searchCriteria,
+    int timeout,
+    CancellationToken cancellationToken
+  ) {
+    // The criteria are compiled and indexed natively alongside every other pending wait, so each
+    // new window is only queried once for the fields that any of them compare.
+    using var matcher = searchCriteria.CreateMatcher();
 
-               return windowMatches;
-             },
-             timeout
-           );
+    var hwnd = await WinEventAwaiter.AwaitEvent(
+                 [WinEvent.EVENT_OBJECT_CREATE],
+                 matcher,
+                 ToAwaitTimeout(timeout),
+                 cancellationToken
+               );
+    return hwnd is not null ? ToWindow(hwnd.Value) : null;
   }
 
 
@@ -67,11 +70,20 @@ public static partial class Tasks {
   ///   indefinitely.
   /// </param>
   /// <returns> The window that was created, or <see langword="null" /> if the timeout elapsed. </returns>
-  public static async Task<Window?> AwaitWindow(
+  public static Task<Window?> AwaitWindow(
     WindowCriteriaCallback searchCriteria,
     int timeout = 0
   ) {
-    return await AwaitWindow(
+    return AwaitWindow(searchCriteria, timeout, CancellationToken.None);
+  }
+
+
+  private static Task<Window?> AwaitWindow(
+    WindowCriteriaCallback searchCriteria,
+    int timeout,
+    CancellationToken cancellationToken
+  ) {
+    return AwaitWindow(
              hwnd => {
                // Because this runs across threads, we need to check if the window is still valid.
                // If the window is closed, we can't use it, so we continue our search.
@@ -95,7 +107,8 @@ public static partial class Tasks {
 
                return searchCriteria(window, process);
              },
-             timeout
+             timeout,
+             cancellationToken
            );
   }
 
@@ -129,21 +142,32 @@ public static partial class Tasks {
 
   private static async Task<Window?> AwaitWindow(
     WindowCriteria criteria,
-    int timeout = 0
+    int timeout,
+    CancellationToken cancellationToken
   ) {
     var hwnd = await WinEventAwaiter.AwaitEvent(
                  [WinEvent.EVENT_OBJECT_CREATE],
                  criteria,
-                 timeout == 0 ? Timeout.InfiniteTimeSpan : TimeSpan.FromMilliseconds(timeout)
+                 ToAwaitTimeout(timeout),
+                 cancellationToken
                );
-    if (hwnd is null) return null;
+    return hwnd is not null ? ToWindow(hwnd.Value) : null;
+  }
+
+
+  private static TimeSpan ToAwaitTimeout(int timeout) {
+    return timeout == 0 ? Timeout.InfiniteTimeSpan : TimeSpan.FromMilliseconds(timeout);
+  }
+
+
+  private static Window ToWindow(HWND hwnd) {
     return new Window(
       new Win32Window {
-        Hwnd        = hwnd.Value,
-        ClassName   = hwnd.Value.GetClassName(),
-        Title       = hwnd.Value.GetWindowText(),
-        ProcessID   = hwnd.Value.GetProcessID(),
-        ProcessName = hwnd.Value.GetProcessName()
+        Hwnd        = hwnd,
+        ClassName   = hwnd.GetClassName(),
+        Title       = hwnd.GetWindowText(),
+        ProcessID   = hwnd.GetProcessID(),
+        ProcessName = hwnd.GetProcessName()
       }
     );
   }
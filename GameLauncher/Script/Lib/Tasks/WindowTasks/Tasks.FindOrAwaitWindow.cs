@@ -1,4 +1,6 @@
-﻿using GameLauncher.Script.Objects;
+﻿using Core.Models;
+using Core.Utils;
+using GameLauncher.Script.Objects;
 using GameLauncher.Script.Utils;
 using GameLauncher.Script.Utils.CodeGenAttributes;
 using Microsoft.ClearScript;
@@ -28,18 +30,20 @@ public partial class Tasks {
     WindowSearchCriteria searchCriteria,
     int timeout = 0
   ) {
-    // Try to find any matching windows that already exist.
-    var existingWindows = FindWindows(searchCriteria);
-
-    // If any matching windows were found, return them.
-    if (existingWindows.Any()) {
-      return JSArray<Window>.FromIEnumerable(existingWindows);
+    // Start waiting before looking, so a window created in between is caught by one or the other.
+    using var cancellation  = new CancellationTokenSource();
+    var       awaitedWindow = AwaitWindow(searchCriteria, timeout, cancellation.Token);
+
+    // Try to find any matching windows that already exist. The registry learns of new windows
+    // asynchronously, so on a miss, enumerate the windows directly in case one was created just
+    // before the wait started.
+    IEnumerable<Window> existingWindows = FindWindows(searchCriteria);
+    if (!existingWindows.Any()) {
+      using var matcher = searchCriteria.CreateMatcher();
+      existingWindows = EnumerateWindows(window => matcher.Matches(window.Hwnd));
     }
 
-    var                 awaitedWindow = await AwaitWindow(searchCriteria, timeout);
-    IEnumerable<Window> windowList    = awaitedWindow is not null ? [awaitedWindow] : [];
-
-    return JSArray<Window>.FromIEnumerable(windowList);
+    return await FindOrAwaitWindow(existingWindows, awaitedWindow, cancellation);
   }
 
 
@@ -67,21 +71,53 @@ public partial class Tasks {
   ) {
     ArgumentNullException.ThrowIfNull(searchCriteria);
 
-    // Try to find any matching windows that already exist.
-    var existingWindows = FindWindows(searchCriteria);
+    // Start waiting before looking, so a window created in between is caught by one or the other.
+    using var cancellation  = new CancellationTokenSource();
+    var       awaitedWindow = AwaitWindow(searchCriteria, timeout, cancellation.Token);
+
+    // The windows are enumerated directly rather than looked up in the registry, since every one
+    // of them is passed to the callback anyway, and the registry may not know the newest ones yet.
+    var existingWindows = EnumerateWindows(
+      window => searchCriteria(new Window(window), Process.FromID((int)window.ProcessID))
+    );
+
+    return await FindOrAwaitWindow(existingWindows, awaitedWindow, cancellation);
+  }
 
+
+  /// <summary>
+  ///   Returns the windows that already existed if there are any, and stops waiting for a new one.
+  ///   Otherwise, waits for the new window.
+  /// </summary>
+  private static async Task<JSArray<Window>> FindOrAwaitWindow(
+    IEnumerable<Window> existingWindows,
+    Task<Window?> awaitedWindow,
+    CancellationTokenSource cancellation
+  ) {
     // If any matching windows were found, return them.
     if (existingWindows.Any()) {
+      cancellation.Cancel();
       return JSArray<Window>.FromIEnumerable(existingWindows);
     }
 
-    var                 awaitedWindow = await AwaitWindow(searchCriteria, timeout);
-    IEnumerable<Window> windowList    = awaitedWindow is not null ? [awaitedWindow] : [];
+    var                 window     = await awaitedWindow;
+    IEnumerable<Window> windowList = window is not null ? [window] : [];
 
     return JSArray<Window>.FromIEnumerable(windowList);
   }
 
 
+  /// <summary>
+  ///   Enumerates the top-level windows directly, bypassing the registry.
+  /// </summary>
+  private static List<Window> EnumerateWindows(Func<Win32Window, bool> predicate) {
+    return NativeUtils.EnumerateWindows()
+      .Where(predicate)
+      .Select(win32Window => new Window(win32Window))
+      .ToList();
+  }
+
+
   [HideFromTypeScript]
   public static async Task<JSArray<Window>> FindOrAwaitWindow(
     ScriptObject searchCriteria,
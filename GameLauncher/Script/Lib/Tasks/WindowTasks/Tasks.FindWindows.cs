@@ -44,25 +44,13 @@ public partial class Tasks {
   public static JSArray<Window> FindWindows(
     WindowSearchCriteria searchCriteria
   ) {
-    return JSArray<Window>.FromIEnumerable(
-      GetAllWindows()
-        .Where(
-          window => {
-            var windowMatches = true;
-
-            // If a title was provided to match against, check if the window's title matches.
-            if (searchCriteria.Title is not null) {
-              windowMatches &= window.Title == searchCriteria.Title;
-            }
+    // The criteria are compiled once and compared natively against the registry's windows, after
+    // narrowing them down using its indexes.
+    using var matcher = searchCriteria.CreateMatcher();
 
-            // If a class name was provided to match against, check if the window's class name matches.
-            if (searchCriteria.ClassName is not null) {
-              windowMatches &= window.ClassName == searchCriteria.ClassName;
-            }
-
-            return windowMatches;
-          }
-        )
+    return JSArray<Window>.FromIEnumerable(
+      WindowRegistry.Find(matcher, topLevelOnly: true)
+        .Select(win32Window => new Window(win32Window))
     );
   }
 
@@ -13,7 +13,7 @@ public partial class Tasks {
   [ScriptMember("getAllWindows")]
   public static IList<Window> GetAllWindows() {
     return JSArray<Window>.FromIEnumerable(
-      NativeUtils.EnumerateWindows().Select(win32Window => new Window(win32Window))
+      WindowRegistry.Find(topLevelOnly: true).Select(win32Window => new Window(win32Window))
     );
   }
 }
@@ -46,6 +46,14 @@ public class DownscaleOptions : ObjectBase {
   [ScriptMember("scaleHeight")]
   public int? ScaleHeight { get; set; }
 
+  /// <summary>
+  ///   Whether the downscaler should compute luminance statistics for every frame. This enables
+  ///   the <c>blackScreenStarted</c> and <c>blackScreenEnded</c> events of the source window, which
+  ///   are useful for reacting to loading screens.
+  /// </summary>
+  [ScriptMember("frameStatistics")]
+  public bool? FrameStatistics { get; set; }
+
   /// <summary>
   ///   A namespace where debug configurations can be specified.
   /// </summary>
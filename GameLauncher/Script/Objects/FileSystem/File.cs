@@ -1,7 +1,9 @@
 ﻿using GameLauncher.Script.Utils.CodeGenAttributes;
 using Microsoft.ClearScript;
+using Microsoft.ClearScript.JavaScript;
 using static GameLauncher.Script.Utils.JSTypeConverter;
 using static GameLauncher.Script.Utils.JSInteropUtils;
+using FileReader = Cpp.Core.FileReader;
 
 namespace GameLauncher.Script.Objects;
 
@@ -18,6 +20,8 @@ public delegate void ReadBytesCallback([TsTypeOverride("number")] byte @byte);
 
 [TypeScriptExport]
 public class File : DirectoryEntry {
+  private const long readChunkSize = 16 * 1024 * 1024;
+
   public File(string path) : base(path) {}
 
 
@@ -31,31 +35,44 @@ public class File : DirectoryEntry {
   [TsReturnTypeOverride("Promise<Uint8Array>")]
   [ScriptMember("readAllBytes")]
   public async Task<ScriptObject> ReadAllBytes() {
-    var fileInfo = new FileInfo(Path);
-    var result   = new byte[fileInfo.Length]; // preallocate exact size
-
-    await using var stream = new FileStream(
-      Path,
-      FileMode.Open,
-      FileAccess.Read,
-      FileShare.Read,
-      128 * 1024, // larger buffer reduces syscalls
-      FileOptions.Asynchronous | FileOptions.SequentialScan
-    );
+    var length = new FileInfo(Path).Length;
+    if (length > uint.MaxValue) {
+      throw new IOException($"\"{Path}\" is too large to read into a Uint8Array.");
+    }
 
-    var offset = 0;
-    while (offset < result.Length) {
-      var read = await stream.ReadAsync(result.AsMemory(offset)).ConfigureAwait(false);
-      if (read == 0) break; // truncated file edge case
-      offset += read;
+    // The file is read natively straight into the array's backing store, so its bytes are only
+    // copied once, and never through a managed array or element by element through the engine.
+    // The engine is locked while the backing store is accessed, so it's read in chunks to let
+    // other script work run in between.
+    var array = (ITypedArray<byte>)CreateUInt8Array((uint)length);
+    var read  = 0L;
+    if (length > 0) {
+      await Task.Run(
+          () => {
+            using var reader = new FileReader(Path);
+            while (read < length) {
+              var offset = read;
+              var count  = Math.Min(readChunkSize, length - offset);
+              var chunk  = array.InvokeWithDirectAccess(
+                pointer => reader.Read(pointer + (nint)offset, count)
+              );
+
+              read += chunk;
+              if (chunk < count) {
+                break;
+              }
+            }
+          }
+        )
+        .ConfigureAwait(false);
     }
 
-    if (offset != result.Length) {
-      // File shrank while reading; trim to the actual bytes read.
-      Array.Resize(ref result, offset);
+    if (read != length) {
+      // File shrank while reading; only expose the bytes that were read.
+      return (ScriptObject)((ScriptObject)array).InvokeMethod("subarray", 0, read);
     }
 
-    return CreateUInt8Array(result);
+    return (ScriptObject)array;
   }
 
 
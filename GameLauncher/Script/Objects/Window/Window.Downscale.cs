@@ -150,6 +150,7 @@ public partial class Window {
       DownscaleFactor = obj.GetProperty<double?>("downscaleFactor"),
       ScaleWidth = obj.GetProperty<int?>("scaleWidth"),
       ScaleHeight = obj.GetProperty<int?>("scaleHeight"),
+      FrameStatistics = obj.GetProperty<bool?>("frameStatistics"),
       Debug = downscaleDebugOptions
     };
 
@@ -246,6 +247,7 @@ public partial class Window {
       {{(options.ScaleHeight is not null
            ? $"scale-height: {options.ScaleHeight}"
            : string.Empty)}}
+      {{(options.FrameStatistics is true ? "frame-statistics: true" : string.Empty)}}
       {{(!string.IsNullOrEmpty(debugOptionsYaml) ? debugOptionsYaml : string.Empty)}}
       """,
       includeWhitespaceBetweenNewlines: true
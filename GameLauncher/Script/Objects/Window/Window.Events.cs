@@ -22,6 +22,8 @@ public partial class Window {
   private WindowEvent restoreEvent;
   private WindowEvent focusEvent;
   private WindowEvent boundsChangeEvent;
+  private WindowEvent blackScreenStartEvent;
+  private WindowEvent blackScreenEndEvent;
 
   /// <summary>
   ///   A callback function that is called when a window event occurs. It is passed the window that
@@ -92,6 +94,20 @@ public partial class Window {
   [ScriptMember("boundsChanged")]
   public Task BoundsChanged => boundsChangeEvent.Signal;
 
+  /// <summary>
+  ///   Resolves the next time the window turns black, e.g. when a loading screen is shown. Only
+  ///   raised while the window is being downscaled with <c>frameStatistics</c> enabled.
+  /// </summary>
+  [ScriptMember("blackScreenStarted")]
+  public Task BlackScreenStarted => blackScreenStartEvent.Signal;
+
+  /// <summary>
+  ///   Resolves the next time the window stops being black. Only raised while the window is being
+  ///   downscaled with <c>frameStatistics</c> enabled.
+  /// </summary>
+  [ScriptMember("blackScreenEnded")]
+  public Task BlackScreenEnded => blackScreenEndEvent.Signal;
+
   /// <summary>
   ///   Resolves once when the window is closed.
   /// </summary>
@@ -137,7 +153,7 @@ public partial class Window {
   [ScriptMember("on")]
   public void On(
     [TsTypeOverride(
-      """ "shown" | "hidden" | "minimized" | "maximized" | "restored" | "focused" | "boundsChanged" | "closed" """
+      """ "shown" | "hidden" | "minimized" | "maximized" | "restored" | "focused" | "boundsChanged" | "blackScreenStarted" | "blackScreenEnded" | "closed" """
     )]
     string eventName,
     WindowEventCallback callback
@@ -150,6 +166,8 @@ public partial class Window {
       case "restored":
       case "focused":
       case "boundsChanged":
+      case "blackScreenStarted":
+      case "blackScreenEnded":
         BindEvent(eventName, callback);
         break;
       case "closed":
@@ -230,15 +248,17 @@ public partial class Window {
   /// <exception cref="ArgumentException"> Thrown when the signal name is not the name of a known signal. </exception>
   private Task GetSignalByName(string signalName) {
     return signalName switch {
-      "shown"         => Shown,
-      "hidden"        => Hidden,
-      "closed"        => Closed,
-      "minimized"     => Minimized,
-      "maximized"     => Maximized,
-      "restored"      => Restored,
-      "focused"       => Focused,
-      "boundsChanged" => BoundsChanged,
-      _               => throw new ArgumentException($"Unknown signal name: {signalName}")
+      "shown"              => Shown,
+      "hidden"             => Hidden,
+      "closed"             => Closed,
+      "minimized"          => Minimized,
+      "maximized"          => Maximized,
+      "restored"           => Restored,
+      "focused"            => Focused,
+      "boundsChanged"      => BoundsChanged,
+      "blackScreenStarted" => BlackScreenStarted,
+      "blackScreenEnded"   => BlackScreenEnded,
+      _                    => throw new ArgumentException($"Unknown signal name: {signalName}")
     };
   }
 
@@ -284,6 +304,20 @@ public partial class Window {
       cancellationToken.Token
     );
 
+    blackScreenStartEvent = new WindowEvent(
+      hwnd,
+      DownscalerWinEvent.EVENT_DOWNSCALER_BLACKSCREENSTART,
+      allowMultiple: true,
+      cancellationToken.Token
+    );
+
+    blackScreenEndEvent = new WindowEvent(
+      hwnd,
+      DownscalerWinEvent.EVENT_DOWNSCALER_BLACKSCREENEND,
+      allowMultiple: true,
+      cancellationToken.Token
+    );
+
     showEvent = new WindowEvent(
       hwnd,
       WinEvent.EVENT_OBJECT_SHOW,
@@ -15,6 +15,63 @@ public class WindowSearchCriteria : ObjectBase {
 
   [ScriptMember("className")] public string? ClassName { get; set; }
 
+  /// <summary>
+  ///   The file name of the process that owns the window, e.g. <c>game.exe</c>.
+  /// </summary>
+  [ScriptMember("processName")] public string? ProcessName { get; set; }
+
+  /// <summary>
+  ///   How the title, class name and process name are compared. The mode can be one of the
+  ///   following:
+  ///   <ul>
+  ///     <li>
+  ///       <c>exact</c>: The whole string must equal the pattern. This is the default.
+  ///     </li>
+  ///     <li>
+  ///       <c>glob</c>: The whole string must match the pattern, where <c>*</c> matches any run of
+  ///       characters and <c>?</c> matches any single character.
+  ///     </li>
+  ///     <li>
+  ///       <c>regex</c>: The pattern is a regular expression that must match part of the string.
+  ///     </li>
+  ///   </ul>
+  /// </summary>
+  [ScriptMember("matchMode")]
+  [TsTypeOverride(""" "exact" | "glob" | "regex" | null | undefined """)]
+  public string? MatchMode { get; set; }
+
+  /// <summary>
+  ///   Whether the title, class name and process name are compared case-insensitively.
+  /// </summary>
+  [ScriptMember("ignoreCase")] public bool? IgnoreCase { get; set; }
+
+
+  /// <summary>
+  ///   Compiles the criteria so they can be compared against many windows.
+  /// </summary>
+  /// <exception cref="ArgumentException">
+  ///   The match mode is unknown, or a pattern is an invalid regular expression.
+  /// </exception>
+  internal Cpp.Core.WindowMatcher CreateMatcher() {
+    var mode = MatchMode switch {
+      null or "exact" => Cpp.Core.WindowMatchMode.Exact,
+      "glob"          => Cpp.Core.WindowMatchMode.Glob,
+      "regex"         => Cpp.Core.WindowMatchMode.Regex,
+      _ => throw new ArgumentException(
+             $"Invalid match mode \"{MatchMode}\". Expected \"exact\", \"glob\" or \"regex\"."
+           )
+    };
+
+    return new Cpp.Core.WindowMatcher(
+      Title,
+      ClassName,
+      ProcessName,
+      null,
+      mode,
+      IgnoreCase ?? false
+    );
+  }
+
 
   public static implicit operator WindowSearchCriteria(ScriptObject obj) {
     if (JSTypeConverter.MatchesShape<WindowSearchCriteria>(obj, out var errors)) {
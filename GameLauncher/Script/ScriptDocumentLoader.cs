@@ -16,21 +16,19 @@ public class ScriptDocumentLoader : DocumentLoader {
       // Get the path for the library file.
       var libraryPath = Path.Combine(AppContext.BaseDirectory, "Libs", specifier[9..]);
 
-      // First, we'll check if there's a compiled JS version of the library.
+      // The TypeScript version is compiled through the compile cache, so it's only compiled again
+      // once it changes. Libraries that only ship as JS are loaded as they are.
       var jsLibraryPath = Path.ChangeExtension(libraryPath, ".js");
-      if (!File.Exists(jsLibraryPath)) {
-        Console.WriteLine($"Compiling {libraryPath}...");
-        // If there isn't, we'll compile the TypeScript version.
-        var compiler      = new Compiler();
-        var tsLibraryPath = Path.ChangeExtension(libraryPath, ".ts");
-        var tsContent     = await File.ReadAllTextAsync(tsLibraryPath).ConfigureAwait(false);
-        var jsContent     = compiler.Compile(tsLibraryPath);
-        // Store the compiled JS version for future use.
-        await File.WriteAllTextAsync(jsLibraryPath, jsContent).ConfigureAwait(false);
+      var tsLibraryPath = Path.ChangeExtension(libraryPath, ".ts");
+      string? content = null;
+      if (File.Exists(tsLibraryPath)) {
+        content = CachedCompiler.Compile(tsLibraryPath);
+      }
+      else if (File.Exists(jsLibraryPath)) {
+        content = await File.ReadAllTextAsync(jsLibraryPath).ConfigureAwait(false);
       }
 
-      if (File.Exists(jsLibraryPath)) {
-        var content = await File.ReadAllTextAsync(jsLibraryPath).ConfigureAwait(false);
+      if (content != null) {
         return new StringDocument(
           new DocumentInfo(new Uri(jsLibraryPath)) {
             Category = ModuleCategory.Standard
@@ -1,11 +1,12 @@
-﻿using GameLauncher.Script.Globals;
+﻿using System.Diagnostics;
+using GameLauncher.Script.Globals;
 using GameLauncher.Script.Objects;
+using GameLauncher.TypeScript;
 using GameLauncher.Utils;
 using Microsoft.ClearScript;
 using Microsoft.ClearScript.JavaScript;
 using Microsoft.ClearScript.V8;
 using Task = System.Threading.Tasks.Task;
-using TypeScriptCompiler = GameLauncher.TypeScript.Compiler;
 using static GameLauncher.Script.Utils.ErrorUtils;
 using File = System.IO.File;
 
@@ -22,9 +23,28 @@ public class ScriptRunner {
   /// </summary>
   private string jsScriptContent;
 
+  /// <summary>
+  ///   Whether to measure how long the script took to start.
+  /// </summary>
+  private readonly bool measureStartup;
 
-  public ScriptRunner(string scriptPath) {
-    this.scriptPath = scriptPath;
+
+  /// <summary>
+  ///   How long after the process started V8 began running the compiled script, if startup was
+  ///   measured. This covers compiling the script, with or without its code cache. What's left
+  ///   before its first statement runs is linking and evaluating its imports.
+  /// </summary>
+  public TimeSpan? TimeToEvaluation { get; private set; }
+
+  /// <summary>
+  ///   What became of the script's V8 code cache.
+  /// </summary>
+  public V8CacheResult CodeCacheResult { get; private set; }
+
+
+  public ScriptRunner(string scriptPath, bool measureStartup = false) {
+    this.scriptPath     = scriptPath;
+    this.measureStartup = measureStartup;
     AppState.ScriptEngine = new V8ScriptEngine(
       V8ScriptEngineFlags.EnableTaskPromiseConversion |
       V8ScriptEngineFlags.EnableDebugging /* |
@@ -44,12 +64,23 @@ public class ScriptRunner {
     InjectGlobals(AppState.ScriptEngine);
 
     try {
-      var obj = AppState.ScriptEngine.Evaluate(
+      var script = CodeCache.Compile(
+        AppState.ScriptEngine,
         new DocumentInfo(new Uri(scriptPath)) {
           Category = ModuleCategory.Standard
         },
-        jsScriptContent
+        jsScriptContent,
+        out var cacheResult
       );
+      CodeCacheResult = cacheResult;
+
+      // Measured from the host rather than from within the script, so that the script, and with
+      // it the key of its code cache, is the same as in a normal run.
+      if (measureStartup) {
+        TimeToEvaluation = DateTime.Now - Process.GetCurrentProcess().StartTime;
+      }
+
+      var obj = AppState.ScriptEngine.Evaluate(script);
 
       // If the script uses top-level await, we need to wait for the promise to resolve before
       // continuing.
@@ -94,7 +125,7 @@ public class ScriptRunner {
   ///   Gets and stores the JavaScript code from a TypeScript source file.
   /// </summary>
   private void GetJSFromTypeScript() {
-    jsScriptContent = new TypeScriptCompiler().Compile(scriptPath);
+    jsScriptContent = CachedCompiler.Compile(scriptPath);
   }
 
 
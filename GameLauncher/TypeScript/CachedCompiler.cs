@@ -0,0 +1,79 @@
+﻿using CompileCache = Cpp.Core.CompileCache;
+
+namespace GameLauncher.TypeScript;
+
+/// <summary>
+///   Compiles TypeScript files through a persistent cache of compiled output, so a file that
+///   hasn't changed since it was last compiled isn't compiled again.
+/// </summary>
+/// <remarks>
+///   Outputs are keyed by a hash of the source, seeded with a fingerprint of the TypeScript
+///   compiler, <c>tsconfig.json</c> and the launcher build, so changing any of them invalidates
+///   every output. A warm start doesn't even set up the compiler.
+/// </remarks>
+public static class CachedCompiler {
+  private static readonly string cacheDirectory = Path.Combine(
+    Environment.GetFolderPath(Environment.SpecialFolder.LocalApplicationData),
+    "GameLauncher",
+    "CompileCache"
+  );
+
+  // The cache, or null if it couldn't be opened, in which case every file is compiled.
+  private static readonly Lazy<CompileCache?> cache = new(OpenCache);
+
+  // A hash of everything besides the source that affects the compiled output.
+  private static readonly Lazy<ulong> fingerprint = new(GetFingerprint);
+
+
+  /// <summary>
+  ///   The cache, or <see langword="null" /> if it couldn't be opened. Exposes the hit and miss
+  ///   counts.
+  /// </summary>
+  public static CompileCache? Cache => cache.Value;
+
+  /// <summary>
+  ///   The directory the compiled outputs are stored in.
+  /// </summary>
+  public static string CacheDirectory => cacheDirectory;
+
+
+  /// <summary>
+  ///   Compiles a TypeScript file, or gets its output from the cache if it was compiled before.
+  /// </summary>
+  /// <param name="scriptPath">The path to the TypeScript file.</param>
+  /// <returns>The compiled JavaScript.</returns>
+  public static string Compile(string scriptPath) {
+    var source = File.ReadAllBytes(scriptPath);
+    var output = cache.Value?.Lookup(source, fingerprint.Value);
+    if (output != null) {
+      return output;
+    }
+
+    Console.WriteLine($"Compiling {scriptPath}...");
+    output = new Compiler().Compile(scriptPath);
+    cache.Value?.Store(source, fingerprint.Value, output);
+    return output;
+  }
+
+
+  private static ulong GetFingerprint() {
+    var build = typeof(Compiler).Assembly.ManifestModule.ModuleVersionId.ToByteArray();
+    var seed  = BitConverter.ToUInt64(build, 0) ^ BitConverter.ToUInt64(build, 8);
+    seed = CompileCache.HashFile(
+      Path.Combine(AppContext.BaseDirectory, "TypeScript", "typescript.js"),
+      seed
+    );
+    return CompileCache.HashFile(Path.Combine(AppContext.BaseDirectory, "tsconfig.json"), seed);
+  }
+
+
+  private static CompileCache? OpenCache() {
+    try {
+      return new CompileCache(cacheDirectory);
+    }
+    catch (Exception exception) when (exception is IOException or UnauthorizedAccessException) {
+      Console.Error.WriteLine($"The compile cache is unavailable: {exception.Message}");
+      return null;
+    }
+  }
+}
@@ -98,6 +98,74 @@ export interface IDownscalerYamlSchema {
      */
     'scale-height'?: number;
 
+    /**
+     * The refresh rate, in Hz, to pace the output of the downscaler window against. When set,
+     * captured frames are presented on a fixed cadence rather than as soon as they arrive, with
+     * each frame being repeated for an equal number of refreshes. This is useful when the source
+     * runs at a lower frame rate than the monitor the downscaler window is shown on.
+     */
+    'target-refresh-rate'?: number;
+
+    /**
+     * Whether to insert black frames between repeated frames for improved motion clarity. Only
+     * takes effect when "target-refresh-rate" is set and is at least twice the frame rate of the
+     * source.
+     * @default false
+     */
+    'black-frame-insertion'?: boolean;
+
+    /**
+     * The number of recent frames to blend together after scaling. Blending smooths out motion
+     * when the source runs at a higher frame rate than the display, e.g. a 120 fps game mirrored
+     * to a 60 Hz monitor, instead of dropping frames. A value of `1` disables blending. This is
+     * independent of how the frames are scaled.
+     * @type integer
+     * @minimum 1
+     * @maximum 16
+     * @default 1
+     */
+    'temporal-blend-frames'?: number;
+
+    /**
+     * Whether to compute luminance statistics for every scaled frame. When enabled, the
+     * downscaler detects when the source goes to black, e.g. during a loading screen, and raises
+     * a window event on the source window that GameLauncher scripts can listen for.
+     * @default false
+     */
+    'frame-statistics'?: boolean;
+
+    /**
+     * Whether to back large frame buffers with large pages, which reduces the cost of streaming
+     * whole frames through the CPU. Requires the "Lock pages in memory" privilege; without it,
+     * regular pages are used.
+     * @default false
+     */
+    'large-pages'?: boolean;
+
+    /**
+     * The maximum number of mouse moves, per second, forwarded to the source window. Moves in
+     * between are coalesced, and the position the mouse comes to rest at is always forwarded. If
+     * not set, moves are forwarded at the capture frame rate. A value of `0` forwards every move.
+     * @minimum 0
+     */
+    'mouse-forward-rate'?: number;
+
+    /**
+     * Whether to forward clicks, the mouse wheel and the keyboard from the downscaled window to
+     * the source window, so the source can be used without switching to it. Input goes to the
+     * child window under the mouse, and keyboard input to the window that was last clicked.
+     * @default false
+     */
+    'forward-input'?: boolean;
+
+    /**
+     * Whether to forward the mouse to where it's predicted to be one capture frame from now,
+     * rather than where it is. Games that draw their own cursor then show it closer to the mouse,
+     * since the captured frame reaches the screen about a frame after the game receives the move.
+     * @default false
+     */
+    'cursor-prediction'?: boolean;
+
     /**
      * A namespace where debug configurations can be specified.
      */
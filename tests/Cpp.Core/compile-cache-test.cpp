@@ -0,0 +1,276 @@
+#include "compile-cache.h"
+
+#include <fstream>
+#include <random>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <gtest/gtest.h>
+
+#include "content-hash.h"
+
+using namespace Cpp::Core::NativeImpls;
+
+namespace {
+  /**
+   * @brief A compiler whose output depends on the source and its version, and which counts how
+   * often it runs.
+   */
+  struct StubCompiler {
+    uint64_t version = 1;
+    int calls        = 0;
+
+    std::string Compile(const std::string& source) {
+      calls++;
+      std::string output = "// compiled by v" + std::to_string(version) + "\n";
+      for (char character : source) {
+        output += character >= 'a' && character <= 'z' ? static_cast<char>(character - 32)
+                                                       : character;
+      }
+      return output;
+    }
+  };
+
+  class CompileCacheTest : public testing::Test {
+    protected:
+      std::filesystem::path directory;
+      std::vector<std::string> scripts;
+      StubCompiler compiler;
+      uint64_t fingerprint = HashContent("typescript 5.6", 14, HashContent("{tsconfig}", 10));
+
+      void SetUp() override {
+        directory = std::filesystem::temp_directory_path() /
+                    ("compile-cache-test-" +
+                     std::string(testing::UnitTest::GetInstance()->current_test_info()->name()));
+        std::filesystem::remove_all(directory);
+
+        std::mt19937 random(47);
+        for (int i = 0; i < 200; i++) {
+          std::string script = "export const value" + std::to_string(i) + " = ";
+          for (int length = 200 + random() % 20000; length > 0; length--) {
+            script += static_cast<char>('a' + random() % 26);
+          }
+          scripts.push_back(std::move(script));
+        }
+      }
+
+      void TearDown() override {
+        std::error_code error;
+        std::filesystem::remove_all(directory, error);
+      }
+
+      /**
+       * @brief Compiles every script through a freshly opened cache, like a launch of the
+       * launcher does, and checks the outputs.
+       * @returns The statistics of the cache.
+       */
+      CompileCacheStats CompileAll(uint64_t scriptFingerprint) {
+        CompileCache cache;
+        std::string error;
+        EXPECT_TRUE(cache.Open(directory, error)) << error;
+
+        compiler.calls = 0;
+        for (const auto& script : scripts) {
+          std::string output;
+          if (!cache.Lookup(script.data(), script.size(), scriptFingerprint, output)) {
+            output = compiler.Compile(script);
+            cache.Store(script.data(), script.size(), scriptFingerprint, output);
+          }
+
+          auto calls = compiler.calls;
+          EXPECT_EQ(output, compiler.Compile(script));
+          compiler.calls = calls;
+        }
+        return cache.GetStats();
+      }
+  };
+}
+
+TEST_F(CompileCacheTest, HitsOnTheNextLaunch) {
+  auto stats = CompileAll(fingerprint);
+  EXPECT_EQ(stats.misses, 200u);
+  EXPECT_EQ(stats.hits, 0u);
+  EXPECT_EQ(stats.stores, 200u);
+  EXPECT_EQ(compiler.calls, 200);
+
+  stats = CompileAll(fingerprint);
+  EXPECT_EQ(stats.hits, 200u);
+  EXPECT_EQ(stats.misses, 0u);
+  EXPECT_EQ(compiler.calls, 0);
+}
+
+TEST_F(CompileCacheTest, MissesOnlyEditedScripts) {
+  CompileAll(fingerprint);
+  for (int i = 0; i < 10; i++) {
+    scripts[i * 7] += " // edited";
+  }
+
+  auto stats = CompileAll(fingerprint);
+  EXPECT_EQ(stats.hits, 190u);
+  EXPECT_EQ(stats.misses, 10u);
+  EXPECT_EQ(compiler.calls, 10);
+}
+
+TEST_F(CompileCacheTest, MissesEverythingForANewCompiler) {
+  CompileAll(fingerprint);
+
+  compiler.version = 2;
+  auto stats = CompileAll(HashContent("typescript 5.7", 14, HashContent("{tsconfig}", 10)));
+  EXPECT_EQ(stats.misses, 200u);
+  EXPECT_EQ(compiler.calls, 200);
+
+  compiler.version = 1;
+  EXPECT_EQ(CompileAll(fingerprint).hits, 200u);
+}
+
+TEST_F(CompileCacheTest, RejectsCorruptOutputs) {
+  CompileAll(fingerprint);
+
+  int corrupted = 0;
+  for (const auto& file : std::filesystem::directory_iterator(directory)) {
+    if (file.path().extension() == ".out" && corrupted < 3) {
+      std::fstream stream(file.path(), std::ios::in | std::ios::out | std::ios::binary);
+      stream.seekp(20);
+      stream.put('#');
+      corrupted++;
+    }
+  }
+
+  auto stats = CompileAll(fingerprint);
+  EXPECT_GE(stats.rejected, 1u);
+  EXPECT_EQ(stats.rejected, stats.misses);
+  EXPECT_EQ(stats.hits + stats.misses, 200u);
+  EXPECT_EQ(CompileAll(fingerprint).hits, 200u);
+}
+
+TEST_F(CompileCacheTest, ReplacesATruncatedIndex) {
+  CompileAll(fingerprint);
+  std::filesystem::resize_file(directory / "index.bin", 100);
+
+  EXPECT_EQ(CompileAll(fingerprint).misses, 200u);
+  EXPECT_EQ(CompileAll(fingerprint).hits, 200u);
+}
+
+TEST_F(CompileCacheTest, MissesSourcesTooLongToIndex) {
+  if (sizeof(size_t) <= sizeof(uint32_t)) {
+    GTEST_SKIP() << "Sources can't be longer than 4 GiB";
+  }
+
+  CompileCache cache;
+  std::string error;
+  ASSERT_TRUE(cache.Open(directory, error)) << error;
+
+  // The length is checked before the source is read, so it doesn't need to be that long.
+  auto size = static_cast<size_t>(UINT32_MAX) + 1 + scripts[0].size();
+  std::string output;
+  EXPECT_FALSE(cache.Store(scripts[0].data(), size, fingerprint, "output"));
+  EXPECT_FALSE(cache.Lookup(scripts[0].data(), size, fingerprint, output));
+  EXPECT_EQ(cache.GetStats().misses, 1u);
+  EXPECT_EQ(cache.GetStats().stores, 0u);
+}
+
+TEST_F(CompileCacheTest, StartsOverPastMaxEntries) {
+  CompileCache cache;
+  std::string error;
+  ASSERT_TRUE(cache.Open(directory, error)) << error;
+
+  for (uint32_t i = 0; i < CompileCache::MaxEntries; i++) {
+    auto key = "x" + std::to_string(i);
+    ASSERT_TRUE(cache.Store(key.data(), key.size(), 1, key));
+  }
+  ASSERT_EQ(cache.GetCount(), CompileCache::MaxEntries);
+
+  std::string output;
+  for (uint32_t i = 0; i < CompileCache::MaxEntries; i += 97) {
+    auto key = "x" + std::to_string(i);
+    ASSERT_TRUE(cache.Lookup(key.data(), key.size(), 1, output));
+    EXPECT_EQ(output, key);
+  }
+
+  ASSERT_TRUE(cache.Store("y", 1, 1, "y"));
+  EXPECT_EQ(cache.GetCount(), 1u);
+
+  size_t outputs = 0;
+  for (const auto& file : std::filesystem::directory_iterator(directory)) {
+    outputs += file.path().extension() == ".out";
+  }
+  EXPECT_EQ(outputs, 1u);
+}
+
+#if !defined(_WIN32)
+TEST_F(CompileCacheTest, IsSharedBetweenProcesses) {
+  CompileCache cache;
+  std::string error;
+  ASSERT_TRUE(cache.Open(directory, error)) << error;
+
+  // Several processes store at once, growing the index under each other, while this one keeps
+  // looking up, which must never fault on an index that was replaced.
+  const int children = 4;
+  const int perChild = 400;
+  auto getKey        = [](int child, int i) {
+    return "p" + std::to_string(child) + "-" + std::to_string(i);
+  };
+  std::vector<pid_t> processes;
+  for (int child = 0; child < children; child++) {
+    auto process = fork();
+    if (process == 0) {
+      CompileCache own;
+      std::string childError;
+      if (!own.Open(directory, childError)) {
+        _exit(2);
+      }
+      for (int i = 0; i < perChild; i++) {
+        auto key = getKey(child, i);
+        if (!own.Store(key.data(), key.size(), 9, key)) {
+          _exit(3);
+        }
+      }
+      _exit(0);
+    }
+    ASSERT_GT(process, 0);
+    processes.push_back(process);
+  }
+
+  std::string output;
+  for (int i = 0; i < 2000; i++) {
+    auto key = getKey(0, i % perChild);
+    cache.Lookup(key.data(), key.size(), 9, output);
+  }
+  for (auto process : processes) {
+    int status = 0;
+    waitpid(process, &status, 0);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+  }
+
+  ASSERT_EQ(cache.GetCount(), static_cast<size_t>(children * perChild));
+  for (int child = 0; child < children; child++) {
+    for (int i = 0; i < perChild; i++) {
+      auto key = getKey(child, i);
+      ASSERT_TRUE(cache.Lookup(key.data(), key.size(), 9, output)) << key;
+      ASSERT_EQ(output, key);
+    }
+  }
+
+  // Another process clearing the cache is seen by this one.
+  auto process = fork();
+  if (process == 0) {
+    CompileCache own;
+    std::string childError;
+    own.Open(directory, childError);
+    own.Clear();
+    _exit(0);
+  }
+  int status = 0;
+  waitpid(process, &status, 0);
+
+  EXPECT_EQ(cache.GetCount(), 0u);
+  EXPECT_FALSE(cache.Lookup("p0-1", 4, 9, output));
+  EXPECT_TRUE(cache.Store("z", 1, 1, "z"));
+  EXPECT_EQ(cache.GetCount(), 1u);
+}
+#endif
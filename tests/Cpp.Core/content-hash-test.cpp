@@ -0,0 +1,67 @@
+#include "content-hash.h"
+
+#include <cstring>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace Cpp::Core::NativeImpls;
+
+TEST(ContentHash, ChangesWithEveryBitAndTheSeed) {
+  std::mt19937_64 random(1);
+  std::vector<uint8_t> data(300);
+  for (auto& byte : data) {
+    byte = static_cast<uint8_t>(random());
+  }
+
+  // Every length exercises a different mix of the block, word and tail paths.
+  for (size_t size = 0; size <= data.size(); size++) {
+    auto hash = HashContent(data.data(), size, 7);
+    ASSERT_EQ(HashContent(data.data(), size, 7), hash);
+    ASSERT_NE(HashContent(data.data(), size, 8), hash) << size << " bytes";
+
+    for (size_t bit = 0; bit < size * 8; bit += 7) {
+      data[bit / 8] ^= static_cast<uint8_t>(1 << (bit % 8));
+      ASSERT_NE(HashContent(data.data(), size, 7), hash) << size << " bytes, bit " << bit;
+      data[bit / 8] ^= static_cast<uint8_t>(1 << (bit % 8));
+    }
+  }
+}
+
+TEST(ContentHash, HasNoCollisionsAmongSequentialKeys) {
+  std::unordered_set<uint64_t> hashes;
+  hashes.reserve(1000000);
+  for (uint64_t key = 0; key < 1000000; key++) {
+    ASSERT_TRUE(hashes.insert(HashContent(&key, sizeof(key))).second) << "key " << key;
+  }
+}
+
+TEST(ContentHash, MatchesThePersistedValues) {
+  // Compile caches on disk are keyed by these hashes, so any change to them, on any platform,
+  // silently invalidates every cache. The inputs cover every length path, up to several rounds.
+  struct KnownAnswer {
+    const char* data;
+    uint64_t seed;
+    uint64_t hash;
+  };
+  const KnownAnswer answers[] = {
+    {"", 0, 0x0409638ee2bde459},
+    {"a", 1, 0xa8412d091b5fe0a9},
+    {"abc", 2, 0x32dd92e4b2915153},
+    {"message digest", 3, 0x8619124089a3a16b},
+    {"abcdefghijklmnopqrstuvwxyz", 4, 0x7a43afb61d7f5f40},
+    {"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789", 5, 0xff42329b90e50d58},
+    {
+      "12345678901234567890123456789012345678901234567890123456789012345678901234567890",
+      6,
+      0xc39cab13b115aad3
+    },
+  };
+
+  for (const auto& answer : answers) {
+    EXPECT_EQ(HashContent(answer.data, std::strlen(answer.data), answer.seed), answer.hash)
+      << '"' << answer.data << '"';
+  }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "window-matcher.h"
+
+namespace Cpp::Core::NativeImpls {
+  struct FakeWindow {
+    uint32_t processId = 0;
+    std::u16string className;
+    std::u16string title;
+  };
+
+  /**
+   * @brief A simulated desktop that live windows query their fields from. Counts the process
+   * queries, which are by far the most expensive on Windows, and can be made to burn time on
+   * each to simulate opening the process.
+   */
+  class FakeWindowFieldSource : public IWindowFieldSource {
+    public:
+      std::map<uint64_t, FakeWindow> windows;
+      std::map<uint32_t, std::u16string> processNames;
+      size_t processQueries = 0;
+      int processQueryCost  = 0;
+
+      bool GetProcessId(uint64_t hwnd, uint32_t& processId) override {
+        auto window = windows.find(hwnd);
+        if (window == windows.end()) {
+          return false;
+        }
+        processId = window->second.processId;
+        return true;
+      }
+
+      bool GetClassName(uint64_t hwnd, std::u16string& className) override {
+        auto window = windows.find(hwnd);
+        if (window == windows.end()) {
+          return false;
+        }
+        className = window->second.className;
+        return true;
+      }
+
+      bool GetTitle(uint64_t hwnd, std::u16string& title) override {
+        auto window = windows.find(hwnd);
+        if (window == windows.end()) {
+          return false;
+        }
+        title = window->second.title;
+        return true;
+      }
+
+      bool GetProcessName(uint32_t processId, std::u16string& processName) override {
+        processQueries++;
+        volatile int work = 0;
+        for (int i = 0; i < processQueryCost; i++) {
+          work = work + i;
+        }
+
+        auto name = processNames.find(processId);
+        if (name == processNames.end()) {
+          return false;
+        }
+        processName = name->second;
+        return true;
+      }
+  };
+}
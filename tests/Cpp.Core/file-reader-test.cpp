@@ -0,0 +1,149 @@
+#include "file-reader.h"
+
+#include <fstream>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace Cpp::Core::NativeImpls;
+
+namespace {
+  // The chunk size `File.readAllBytes` reads with, scaled down so the tests stay fast.
+  constexpr size_t chunkSize = 64 * 1024;
+
+  class FileReaderTest : public testing::Test {
+    protected:
+      std::filesystem::path directory;
+
+      void SetUp() override {
+        directory = std::filesystem::temp_directory_path() /
+                    ("file-reader-test-" +
+                     std::string(testing::UnitTest::GetInstance()->current_test_info()->name()));
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+      }
+
+      void TearDown() override {
+        std::error_code error;
+        std::filesystem::remove_all(directory, error);
+      }
+
+      std::filesystem::path Write(const std::string& name, const std::vector<char>& bytes) {
+        auto path = directory / name;
+        std::ofstream(path, std::ios::binary).write(bytes.data(), bytes.size());
+        return path;
+      }
+
+      static std::vector<char> Random(size_t size) {
+        std::mt19937 random(static_cast<uint32_t>(size));
+        std::vector<char> bytes(size);
+        for (auto& byte : bytes) {
+          byte = static_cast<char>(random());
+        }
+        return bytes;
+      }
+
+      /**
+       * @brief Reads a file the way `File.readAllBytes` does, a chunk at a time until a short read.
+       */
+      static std::vector<char> ReadAll(const std::filesystem::path& path, size_t expectedSize) {
+        FileReader reader;
+        std::string error;
+        EXPECT_TRUE(reader.Open(path, error)) << error;
+
+        std::vector<char> bytes(expectedSize + chunkSize);
+        size_t offset = 0;
+        while (true) {
+          size_t size = 0;
+          EXPECT_TRUE(reader.Read(bytes.data() + offset, chunkSize, size, error)) << error;
+          offset += size;
+          if (size < chunkSize) {
+            break;
+          }
+        }
+
+        bytes.resize(offset);
+        return bytes;
+      }
+  };
+}
+
+TEST_F(FileReaderTest, ReadsAnEmptyFile) {
+  auto path = Write("empty", {});
+  EXPECT_TRUE(ReadAll(path, 0).empty());
+}
+
+TEST_F(FileReaderTest, ReadsAFileShorterThanAChunk) {
+  auto bytes = Random(1000);
+  EXPECT_EQ(ReadAll(Write("short", bytes), bytes.size()), bytes);
+}
+
+TEST_F(FileReaderTest, ReadsFilesAtChunkBoundaries) {
+  for (size_t size : {chunkSize - 1, chunkSize, chunkSize + 1, 3 * chunkSize}) {
+    auto bytes = Random(size);
+    EXPECT_EQ(ReadAll(Write("boundary", bytes), bytes.size()), bytes) << size;
+  }
+}
+
+TEST_F(FileReaderTest, ReadsNothingMoreAtTheEnd) {
+  auto path = Write("exact", Random(chunkSize));
+
+  FileReader reader;
+  std::string error;
+  ASSERT_TRUE(reader.Open(path, error));
+
+  std::vector<char> bytes(chunkSize);
+  size_t size = 0;
+  ASSERT_TRUE(reader.Read(bytes.data(), chunkSize, size, error));
+  EXPECT_EQ(size, chunkSize);
+  ASSERT_TRUE(reader.Read(bytes.data(), chunkSize, size, error));
+  EXPECT_EQ(size, 0u);
+  ASSERT_TRUE(reader.Read(bytes.data(), 0, size, error));
+  EXPECT_EQ(size, 0u);
+}
+
+TEST_F(FileReaderTest, ReopeningStartsFromTheBeginning) {
+  auto first  = Random(100);
+  auto second = Random(200);
+  auto firstPath  = Write("first", first);
+  auto secondPath = Write("second", second);
+
+  FileReader reader;
+  std::string error;
+  std::vector<char> bytes(300);
+  size_t size = 0;
+  ASSERT_TRUE(reader.Open(firstPath, error));
+  ASSERT_TRUE(reader.Read(bytes.data(), 50, size, error));
+  ASSERT_TRUE(reader.Open(secondPath, error));
+  ASSERT_TRUE(reader.Read(bytes.data(), bytes.size(), size, error));
+  EXPECT_EQ(std::vector<char>(bytes.begin(), bytes.begin() + size), second);
+}
+
+TEST_F(FileReaderTest, ReportsAMissingFile) {
+  FileReader reader;
+  std::string error;
+  EXPECT_FALSE(reader.Open(directory / "missing", error));
+  EXPECT_NE(error.find("missing"), std::string::npos);
+
+  // Reading without an open file fails rather than reading from anywhere.
+  char byte;
+  size_t size = 1;
+  error.clear();
+  EXPECT_FALSE(reader.Read(&byte, 1, size, error));
+  EXPECT_EQ(size, 0u);
+  EXPECT_FALSE(error.empty());
+}
+
+TEST_F(FileReaderTest, FailsOnceClosed) {
+  auto path = Write("closed", Random(10));
+
+  FileReader reader;
+  std::string error;
+  ASSERT_TRUE(reader.Open(path, error));
+  reader.Close();
+
+  char bytes[10];
+  size_t size = 0;
+  EXPECT_FALSE(reader.Read(bytes, sizeof(bytes), size, error));
+}
@@ -0,0 +1,223 @@
+#include "glob-walker.h"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <set>
+
+#include <gtest/gtest.h>
+
+using namespace Cpp::Core::NativeImpls;
+
+namespace {
+  using Segments = std::vector<std::string>;
+
+  Segments Split(const std::string& path) {
+    Segments segments;
+    std::string segment;
+    for (char character : path) {
+      if (character != '/') {
+        segment += character;
+      } else if (!segment.empty()) {
+        segments.push_back(std::move(segment));
+        segment.clear();
+      }
+    }
+    if (!segment.empty()) {
+      segments.push_back(std::move(segment));
+    }
+
+    // A trailing `**` matches everything below, like `**/*`.
+    if (!segments.empty() && segments.back() == "**") {
+      segments.push_back("*");
+    }
+    return segments;
+  }
+
+  bool MatchName(const char* pattern, const char* name) {
+    if (!*pattern) {
+      return !*name;
+    }
+    if (*pattern == '*') {
+      return MatchName(pattern + 1, name) || (*name && MatchName(pattern, name + 1));
+    }
+    if (!*name) {
+      return false;
+    }
+    bool matches = *pattern == '?' || std::tolower(*pattern) == std::tolower(*name);
+    return matches && MatchName(pattern + 1, name + 1);
+  }
+
+  /**
+   * @brief Matches a path against a glob by backtracking, as a reference for the walker.
+   */
+  bool MatchPath(const Segments& pattern, size_t i, const Segments& path, size_t j) {
+    if (i == pattern.size()) {
+      return j == path.size();
+    }
+    if (pattern[i] == "**") {
+      return MatchPath(pattern, i + 1, path, j) ||
+             (j < path.size() && MatchPath(pattern, i, path, j + 1));
+    }
+    return j < path.size() && MatchName(pattern[i].c_str(), path[j].c_str()) &&
+           MatchPath(pattern, i + 1, path, j + 1);
+  }
+
+  /**
+   * @returns Whether the path or any directory above it matches an exclude.
+   */
+  bool IsExcluded(const std::string& path, const std::vector<std::string>& excludes) {
+    auto segments = Split(path);
+    for (const auto& exclude : excludes) {
+      auto pattern = Split(exclude);
+      for (size_t length = 1; length <= segments.size(); length++) {
+        Segments prefix(segments.begin(), segments.begin() + length);
+        if (MatchPath(pattern, 0, prefix, 0)) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  GlobPattern Compile(const std::string& pattern) {
+    GlobPattern compiled;
+    std::string error;
+    EXPECT_TRUE(compiled.Compile(std::u16string(pattern.begin(), pattern.end()), true, error))
+      << error;
+    return compiled;
+  }
+
+  /**
+   * @returns The sorted paths found by the walker, relative to the root and separated by `/`.
+   */
+  std::vector<std::string> Walk(
+    const std::filesystem::path& root,
+    const std::string& include,
+    const std::vector<std::string>& excludes,
+    size_t threadCount
+  ) {
+    std::vector<GlobPattern> compiledExcludes;
+    for (const auto& exclude : excludes) {
+      compiledExcludes.push_back(Compile(exclude));
+    }
+
+    GlobWalker walker;
+    walker.Start(root, Compile(include), std::move(compiledExcludes), threadCount);
+
+    std::vector<std::string> paths;
+    std::u16string buffer[256];
+    for (size_t count; (count = walker.Read(buffer, 256, -1)) > 0 || !walker.IsFinished();) {
+      for (size_t i = 0; i < count; i++) {
+        std::string path(buffer[i].begin(), buffer[i].end());
+        std::replace(path.begin(), path.end(), '\\', '/');
+        paths.push_back(std::move(path));
+      }
+    }
+    std::sort(paths.begin(), paths.end());
+    return paths;
+  }
+
+  class GlobWalkerTest : public testing::Test {
+    protected:
+      std::filesystem::path root;
+      std::vector<std::string> files;
+
+      void SetUp() override {
+        root = std::filesystem::temp_directory_path() /
+               ("glob-walker-test-" +
+                std::string(testing::UnitTest::GetInstance()->current_test_info()->name()));
+        std::filesystem::remove_all(root);
+
+        std::mt19937 random(7);
+        const char* names[] = {
+          "a", "b", "Ab", "src", "obj", "x.ts", "y.js", "z.TS", "bin", "ab.ts",
+        };
+        std::function<void(const std::filesystem::path&, const std::string&, int)> create =
+          [&](const std::filesystem::path& directory, const std::string& relative, int depth) {
+            std::filesystem::create_directories(directory);
+            std::set<std::string> used;
+            for (int count = random() % 9 + 3; count > 0; count--) {
+              std::string name = names[random() % 10];
+              if (!used.insert(name).second) {
+                continue;
+              }
+
+              auto path = relative.empty() ? name : relative + "/" + name;
+              if (depth == 0 || (depth < 5 && random() % 2)) {
+                create(directory / name, path, depth + 1);
+              } else {
+                std::ofstream(directory / name) << "x";
+                files.push_back(path);
+              }
+            }
+          };
+        create(root, "", 0);
+
+        // Links aren't followed, so this loop must not be walked. Creating it needs a privilege
+        // on Windows, so it's best-effort.
+        std::error_code error;
+        std::filesystem::create_directory_symlink(root, root / "loop", error);
+      }
+
+      void TearDown() override {
+        std::error_code error;
+        std::filesystem::remove_all(root, error);
+      }
+  };
+}
+
+TEST_F(GlobWalkerTest, MatchesTheReferenceWithAnyNumberOfThreads) {
+  const char* includes[] = {
+    "**/*.ts", "**/*", "a/**", "*/b/*", "**/a/**/*.js", "src/**/x.ts", "?b/**", "*", "**/obj/*",
+    "a/*/*/*",
+  };
+  const std::vector<std::string> excludeSets[] = {
+    {}, {"**/obj"}, {"a"}, {"**/*.js"}, {"b/**", "**/src"},
+  };
+
+  for (auto include : includes) {
+    for (const auto& excludes : excludeSets) {
+      std::vector<std::string> expected;
+      auto pattern = Split(include);
+      for (const auto& file : files) {
+        if (MatchPath(pattern, 0, Split(file), 0) && !IsExcluded(file, excludes)) {
+          expected.push_back(file);
+        }
+      }
+      std::sort(expected.begin(), expected.end());
+
+      for (size_t threadCount : {1, 3, 8}) {
+        ASSERT_EQ(Walk(root, include, excludes, threadCount), expected)
+          << include << " excluding " << excludes.size() << " patterns with " << threadCount
+          << " threads";
+      }
+    }
+  }
+}
+
+TEST_F(GlobWalkerTest, StopsWithUnreadResults) {
+  GlobWalker walker;
+  walker.Start(root, Compile("**/*"), {}, 4);
+
+  std::u16string path;
+  walker.Read(&path, 1, -1);
+  walker.Stop();
+}
+
+TEST(GlobWalker, FindsNothingUnderAMissingRoot) {
+  auto root = std::filesystem::temp_directory_path() /
+              ("glob-walker-test-" +
+               std::string(testing::UnitTest::GetInstance()->current_test_info()->name()));
+  std::filesystem::remove_all(root);
+  EXPECT_TRUE(Walk(root, "**/*", {}, 2).empty());
+}
+
+TEST(GlobPattern, RejectsParentAndEmptySegments) {
+  GlobPattern pattern;
+  std::string error;
+  EXPECT_FALSE(pattern.Compile(u"a/../b", false, error));
+  EXPECT_FALSE(pattern.Compile(u"//", false, error));
+}
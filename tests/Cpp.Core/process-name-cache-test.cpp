@@ -0,0 +1,85 @@
+#include "process-name-cache.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace Cpp::Core::NativeImpls;
+
+namespace {
+  // The cache only closes the handles, which is a no-op away from Windows, so any value will do.
+  void* GetFakeHandle(uint32_t processId) {
+    return reinterpret_cast<void*>(static_cast<uintptr_t>(processId));
+  }
+
+  std::wstring GetName(uint32_t processId) {
+    return L"C:\\x" + std::to_wstring(processId % 50) + L".exe";
+  }
+}
+
+TEST(ProcessNameCache, FindsInsertedProcesses) {
+  ProcessNameCache cache;
+  std::wstring name;
+  EXPECT_FALSE(cache.TryGet(4, name));
+
+  cache.Insert(4, GetFakeHandle(4), L"C:\\a.exe");
+  ASSERT_TRUE(cache.TryGet(4, name));
+  EXPECT_EQ(name, L"C:\\a.exe");
+  EXPECT_EQ(cache.GetHits(), 1u);
+  EXPECT_EQ(cache.GetMisses(), 1u);
+
+  cache.Clear();
+  EXPECT_FALSE(cache.TryGet(4, name));
+}
+
+TEST(ProcessNameCache, StaysWithinItsCapacity) {
+  ProcessNameCache cache;
+  for (uint32_t processId = 8; processId < 8 + 4 * 2000; processId += 4) {
+    cache.Insert(processId, GetFakeHandle(processId), GetName(processId));
+  }
+
+  size_t present = 0;
+  std::wstring name;
+  for (uint32_t processId = 8; processId < 8 + 4 * 2000; processId += 4) {
+    if (cache.TryGet(processId, name)) {
+      EXPECT_EQ(name, GetName(processId));
+      present++;
+    }
+  }
+  EXPECT_GT(present, 0u);
+  EXPECT_LE(present, ProcessNameCache::SetCount * ProcessNameCache::WaysPerSet);
+}
+
+TEST(ProcessNameCache, ReadersNeverSeeAnotherProcesssName) {
+  ProcessNameCache cache;
+  std::atomic<bool> stop{false};
+  std::atomic<uint64_t> mismatches{0};
+
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; i++) {
+    readers.emplace_back([&] {
+      std::wstring name;
+      while (!stop) {
+        for (uint32_t processId = 8; processId < 8 + 4 * 600; processId += 4) {
+          if (cache.TryGet(processId, name) && name != GetName(processId)) {
+            mismatches++;
+          }
+        }
+      }
+    });
+  }
+
+  for (int round = 0; round < 200; round++) {
+    for (uint32_t processId = 8; processId < 8 + 4 * 600; processId += 4) {
+      cache.Insert(processId, GetFakeHandle(processId), GetName(processId));
+    }
+  }
+  stop = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+
+  EXPECT_EQ(mismatches, 0u);
+}
@@ -0,0 +1,109 @@
+#include "run-queue.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace Cpp::Core::NativeImpls;
+
+TEST(RunQueue, KeepsEachProducersOrder) {
+  const int producers   = 8;
+  const int perProducer = 20000;
+
+  for (bool paced : {false, true}) {
+    RunQueue queue;
+    std::atomic<int> rejected{0};
+    std::vector<std::thread> threads;
+    for (int producer = 0; producer < producers; producer++) {
+      threads.emplace_back([&, producer] {
+        for (int i = 0; i < perProducer; i++) {
+          if (!queue.Push((static_cast<uint64_t>(producer) << 32) | static_cast<uint32_t>(i))) {
+            rejected++;
+          }
+
+          // Pausing now and then lets the consumer run dry and park.
+          if (paced && i % 64 == 63) {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+          }
+        }
+      });
+    }
+
+    std::vector<uint32_t> expected(producers, 0);
+    uint64_t items[256];
+    for (uint64_t drained = 0; drained < uint64_t{producers} * perProducer;) {
+      size_t count = queue.Drain(items, 256, -1);
+      for (size_t i = 0; i < count; i++) {
+        auto producer = items[i] >> 32;
+        ASSERT_EQ(static_cast<uint32_t>(items[i]), expected[producer]) << "producer " << producer;
+        expected[producer]++;
+      }
+      drained += count;
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    EXPECT_EQ(rejected, 0);
+    EXPECT_EQ(queue.Drain(items, 256, 0), 0u);
+  }
+}
+
+TEST(RunQueue, DrainTimesOut) {
+  RunQueue queue;
+  uint64_t items[4];
+
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_EQ(queue.Drain(items, 4, 20000), 0u);
+  EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(19));
+}
+
+TEST(RunQueue, DrainsWhatWasPushedBeforeClosing) {
+  RunQueue queue;
+  std::thread closer([&] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.Push(7);
+    queue.Close();
+  });
+
+  uint64_t items[4];
+  ASSERT_EQ(queue.Drain(items, 4, -1), 1u);
+  EXPECT_EQ(items[0], 7u);
+  EXPECT_EQ(queue.Drain(items, 4, -1), 0u);
+  closer.join();
+
+  EXPECT_FALSE(queue.Push(8));
+}
+
+TEST(RunQueue, DrainsEveryPushAcceptedWhileClosing) {
+  for (int round = 0; round < 200; round++) {
+    RunQueue queue;
+    std::atomic<uint64_t> accepted{0};
+    std::vector<std::thread> threads;
+    for (int producer = 0; producer < 4; producer++) {
+      threads.emplace_back([&] {
+        for (int i = 0; i < 2000; i++) {
+          if (queue.Push(i)) {
+            accepted++;
+          }
+        }
+      });
+    }
+
+    std::this_thread::sleep_for(std::chrono::microseconds(round * 5));
+    queue.Close();
+
+    uint64_t drained = 0;
+    uint64_t items[256];
+    while (size_t count = queue.Drain(items, 256, -1)) {
+      drained += count;
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    ASSERT_EQ(drained, accepted.load()) << "round " << round;
+  }
+}
@@ -0,0 +1,233 @@
+#include "timer-wheel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <optional>
+#include <random>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using namespace Cpp::Core::NativeImpls;
+
+namespace {
+  /**
+   * @brief A brute-force model of the wheel: timers fire in deadline order, ties in the order
+   * they were scheduled, and an interval timer that fell behind resumes after the target time
+   * rather than firing for every missed interval.
+   */
+  class TimerModel {
+    public:
+      uint64_t now;
+
+      explicit TimerModel(uint64_t now) : now(now) {}
+
+      void Schedule(uint32_t id, uint64_t deadline, uint64_t interval) {
+        timers[id] = {std::max(deadline, now + 1), interval, nextSequence++};
+      }
+
+      bool Cancel(uint32_t id) {
+        return timers.erase(id) > 0;
+      }
+
+      std::optional<uint64_t> GetEarliestDeadline() const {
+        if (timers.empty()) {
+          return std::nullopt;
+        }
+
+        uint64_t earliest = UINT64_MAX;
+        for (const auto& [id, timer] : timers) {
+          earliest = std::min(earliest, timer.deadline);
+        }
+        return earliest;
+      }
+
+      void Advance(uint64_t target, std::vector<uint32_t>& expired) {
+        for (auto deadline = GetEarliestDeadline(); deadline && *deadline <= target;
+             deadline = GetEarliestDeadline()) {
+          now = *deadline;
+
+          std::vector<std::pair<uint64_t, uint32_t>> due;
+          for (const auto& [id, timer] : timers) {
+            if (timer.deadline == now) {
+              due.emplace_back(timer.sequence, id);
+            }
+          }
+          std::sort(due.begin(), due.end());
+
+          for (auto [sequence, id] : due) {
+            expired.push_back(id);
+            auto& timer = timers[id];
+            if (timer.interval == 0) {
+              timers.erase(id);
+            } else {
+              timer.deadline = std::max(timer.deadline + timer.interval, target + 1);
+              timer.sequence = nextSequence++;
+            }
+          }
+        }
+        now = std::max(now, target);
+      }
+
+      size_t GetCount() const {
+        return timers.size();
+      }
+
+    private:
+      struct Timer {
+        uint64_t deadline;
+        uint64_t interval;
+        uint64_t sequence;
+      };
+
+      std::map<uint32_t, Timer> timers;
+      uint64_t nextSequence = 0;
+  };
+
+  uint64_t PickDelay(std::mt19937_64& random) {
+    switch (random() % 5) {
+      case 0: return random() % 4;
+      case 1: return random() % 300;
+      case 2: return random() % 70000;
+      case 3: return random() % 20000000;
+      default: return random() % (uint64_t{1} << 34);
+    }
+  }
+
+  uint64_t PickStep(std::mt19937_64& random) {
+    switch (random() % 4) {
+      case 0: return random() % 5;
+      case 1: return random() % 1000;
+      case 2: return random() % 200000;
+      default: return random() % (uint64_t{1} << 33);
+    }
+  }
+}
+
+TEST(TimerWheel, FiresInDeadlineThenScheduleOrder) {
+  TimerWheel wheel;
+  auto late  = wheel.Schedule(30);
+  auto first = wheel.Schedule(10);
+  auto tied  = wheel.Schedule(10);
+
+  std::vector<uint32_t> expired;
+  wheel.Advance(9, expired);
+  EXPECT_TRUE(expired.empty());
+
+  wheel.Advance(30, expired);
+  EXPECT_EQ(expired, (std::vector<uint32_t>{first, tied, late}));
+  EXPECT_EQ(wheel.GetCount(), 0u);
+}
+
+TEST(TimerWheel, IntervalsSkipMissedFirings) {
+  TimerWheel wheel;
+  auto id = wheel.Schedule(5, 5);
+
+  std::vector<uint32_t> expired;
+  wheel.Advance(100, expired);
+  EXPECT_EQ(expired, std::vector<uint32_t>{id});
+  EXPECT_TRUE(wheel.IsPending(id));
+  auto next = wheel.GetNextTick();
+  ASSERT_TRUE(next);
+  EXPECT_LE(*next, 101u);
+
+  EXPECT_TRUE(wheel.Cancel(id));
+  EXPECT_FALSE(wheel.Cancel(id));
+  EXPECT_FALSE(wheel.GetNextTick());
+}
+
+TEST(TimerWheel, MatchesABruteForceModel) {
+  std::mt19937_64 random(45);
+  for (int round = 0; round < 40; round++) {
+    // Some rounds start just before the lowest levels of the wheel roll over into the next.
+    uint64_t start = random() % 3 == 0 ? (uint64_t{1} << 32) - 300 + random() % 600
+                                       : random() % 100000;
+    TimerWheel wheel(start);
+    TimerModel model(start);
+    std::vector<uint32_t> ids;
+
+    for (int step = 0; step < 4000; step++) {
+      int operation = random() % 10;
+      if (operation < 5) {
+        uint64_t deadline = wheel.GetNow() + PickDelay(random);
+        uint64_t interval = random() % 4 == 0 ? 1 + random() % 500 : 0;
+        auto id           = wheel.Schedule(deadline, interval);
+        model.Schedule(id, deadline, interval);
+        ids.push_back(id);
+      } else if (operation < 7 && !ids.empty()) {
+        auto id = ids[random() % ids.size()];
+        ASSERT_EQ(wheel.Cancel(id), model.Cancel(id));
+      } else {
+        // The next tick may be early, e.g. where a timer moves down a level, but never late.
+        auto next     = wheel.GetNextTick();
+        auto earliest = model.GetEarliestDeadline();
+        ASSERT_EQ(next.has_value(), earliest.has_value());
+        if (next) {
+          ASSERT_LE(*next, *earliest);
+          ASSERT_GT(*next, wheel.GetNow());
+        }
+
+        uint64_t by = PickStep(random);
+        std::vector<uint32_t> expired, expected;
+        wheel.Advance(wheel.GetNow() + by, expired);
+        model.Advance(model.now + by, expected);
+        ASSERT_EQ(expired, expected) << "round " << round << ", step " << step;
+        ASSERT_EQ(wheel.GetNow(), model.now);
+      }
+      ASSERT_EQ(wheel.GetCount(), model.GetCount());
+    }
+  }
+}
+
+TEST(TimerWheel, ChurnLeavesNoTimersBehind) {
+  TimerWheel wheel;
+  std::vector<uint32_t> expired;
+  for (int i = 0; i < 1000000; i++) {
+    wheel.Schedule(wheel.GetNow() + 1 + i % 1000);
+    if (i % 1000 == 999) {
+      expired.clear();
+      wheel.Advance(wheel.GetNow() + 1000, expired);
+      ASSERT_EQ(expired.size(), 1000u);
+    }
+  }
+  EXPECT_EQ(wheel.GetCount(), 0u);
+}
+
+TEST(TimerService, DeliversTimersInOrder) {
+  TimerService service;
+  ASSERT_TRUE(service.Start());
+  // The timers expire far enough apart that a busy machine stalling the test between two calls
+  // doesn't reorder them.
+  auto last     = service.Schedule(150, 0);
+  auto first    = service.Schedule(50, 0);
+  auto second   = service.Schedule(100, 0);
+  auto interval = service.Schedule(5, 5);
+  EXPECT_TRUE(service.Cancel(service.Schedule(75, 0)));
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(250));
+  std::vector<uint32_t> delivered, once;
+  uint32_t ids[16];
+  while (size_t count = service.Read(ids, 16, 0)) {
+    delivered.insert(delivered.end(), ids, ids + count);
+  }
+  for (auto id : delivered) {
+    if (id != interval) {
+      once.push_back(id);
+    }
+  }
+  EXPECT_EQ(once, (std::vector<uint32_t>{first, second, last}));
+
+  // An interval timer that wasn't read in time is delivered once, not once per interval.
+  auto repeats = std::count(delivered.begin(), delivered.end(), interval);
+  EXPECT_GE(repeats, 1);
+  EXPECT_LE(repeats, 3);
+
+  ASSERT_EQ(service.Read(ids, 16, -1), 1u);
+  EXPECT_EQ(ids[0], interval);
+  EXPECT_TRUE(service.Cancel(interval));
+  EXPECT_EQ(service.GetCount(), 0u);
+
+  service.Stop();
+  EXPECT_EQ(service.Read(ids, 16, -1), 0u);
+}
@@ -0,0 +1,135 @@
+#include "win-event-dispatcher.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using namespace Cpp::Core::NativeImpls;
+
+namespace {
+  constexpr uint32_t eventCreate         = 0x8000;
+  constexpr uint32_t eventShow           = 0x8002;
+  constexpr uint32_t eventLocationChange = 0x800B;
+  constexpr uint32_t eventNameChange     = 0x800C;
+  constexpr uint32_t eventForeground     = 0x0003;
+  constexpr uint32_t eventCloaked        = 0x8017;
+  constexpr int32_t objectWindow         = 0;
+  constexpr int32_t objectCaret          = -8;
+}
+
+TEST(WinEventFilter, ContainsOnlyTheEvents) {
+  WinEventFilter filter(
+    {
+      eventCreate, 0x8001, eventShow, eventLocationChange, eventForeground, eventCreate,
+      eventCloaked,
+    },
+    8
+  );
+
+  EXPECT_TRUE(filter.Contains(eventCreate));
+  EXPECT_TRUE(filter.Contains(eventLocationChange));
+  EXPECT_TRUE(filter.Contains(eventForeground));
+  EXPECT_FALSE(filter.Contains(0x8003));
+  EXPECT_FALSE(filter.Contains(0x10003));
+  EXPECT_FALSE(filter.Contains(0x7FFFFFFF));
+  EXPECT_EQ(filter.GetRanges().size(), 4u);
+}
+
+TEST(WinEventFilter, MergesTheClosestRangesDownToTheLimit) {
+  WinEventFilter filter(
+    {eventCreate, 0x8001, eventShow, eventLocationChange, eventForeground, eventCloaked},
+    2
+  );
+
+  const auto& ranges = filter.GetRanges();
+  ASSERT_EQ(ranges.size(), 2u);
+  EXPECT_EQ(ranges[0], (WinEventRange{eventForeground, eventForeground}));
+  EXPECT_EQ(ranges[1], (WinEventRange{eventCreate, eventCloaked}));
+  EXPECT_FALSE(filter.Contains(0x8005));
+
+  EXPECT_EQ(WinEventFilter({5, 6}, 1).GetRanges().size(), 1u);
+}
+
+TEST(WinEventFilter, EmptyContainsNothing) {
+  WinEventFilter filter;
+  EXPECT_FALSE(filter.Contains(0));
+  EXPECT_TRUE(filter.GetRanges().empty());
+}
+
+TEST(WinEventDispatcher, AcceptsSubscribedWindowEventsOnceRefreshed) {
+  WinEventDispatcherOptions options;
+  options.queueCapacity = 4;
+  WinEventDispatcher dispatcher(options);
+
+  const uint32_t events[] = {eventLocationChange, eventCreate};
+  std::string error;
+  EXPECT_TRUE(dispatcher.Subscribe(events, 2, error));
+  EXPECT_TRUE(dispatcher.Subscribe(events, 1, error));
+  EXPECT_FALSE(dispatcher.OnEvent(eventLocationChange, 1, objectWindow, 0, 1));
+
+  EXPECT_TRUE(dispatcher.Refresh());
+  EXPECT_FALSE(dispatcher.Refresh());
+  EXPECT_TRUE(dispatcher.OnEvent(eventLocationChange, 1, objectWindow, 0, 1));
+  EXPECT_FALSE(dispatcher.OnEvent(eventLocationChange, 0, objectWindow, 0, 1));
+  EXPECT_FALSE(dispatcher.OnEvent(eventLocationChange, 1, objectCaret, 0, 1));
+  EXPECT_FALSE(dispatcher.OnEvent(eventNameChange, 1, objectWindow, 0, 1));
+
+  EXPECT_TRUE(dispatcher.OnEvent(eventCreate, 2, objectWindow, 0, 2));
+  EXPECT_TRUE(dispatcher.OnEvent(eventCreate, 3, objectWindow, 0, 3));
+  EXPECT_TRUE(dispatcher.OnEvent(eventCreate, 4, objectWindow, 0, 4));
+  EXPECT_FALSE(dispatcher.OnEvent(eventCreate, 5, objectWindow, 0, 5));
+  EXPECT_EQ(dispatcher.GetDroppedCount(), 1u);
+  EXPECT_EQ(dispatcher.GetAcceptedCount(), 4u);
+  EXPECT_EQ(dispatcher.GetReceivedCount(), 9u);
+
+  WinEventRecord records[8];
+  ASSERT_EQ(dispatcher.Read(records, 8, 0), 4u);
+  EXPECT_EQ(records[0].hwnd, 1u);
+  EXPECT_EQ(records[3].hwnd, 4u);
+  EXPECT_EQ(records[3].time, 4u);
+  EXPECT_EQ(dispatcher.Read(records, 8, 1000), 0u);
+}
+
+TEST(WinEventDispatcher, KeepsEventsUntilTheLastUnsubscribe) {
+  WinEventDispatcher dispatcher;
+  const uint32_t events[] = {eventLocationChange, eventCreate};
+  std::string error;
+  EXPECT_TRUE(dispatcher.Subscribe(events, 2, error));
+  EXPECT_TRUE(dispatcher.Subscribe(events, 1, error));
+  dispatcher.Refresh();
+
+  dispatcher.Unsubscribe(events, 2);
+  EXPECT_TRUE(dispatcher.Refresh());
+
+  auto ranges = dispatcher.GetRanges();
+  ASSERT_EQ(ranges.size(), 1u);
+  EXPECT_EQ(ranges[0].min, eventLocationChange);
+  EXPECT_FALSE(dispatcher.OnEvent(eventCreate, 1, objectWindow, 0, 1));
+  EXPECT_TRUE(dispatcher.OnEvent(eventLocationChange, 1, objectWindow, 0, 1));
+}
+
+TEST(WinEventDispatcher, ReadWaitsForEventsAndStop) {
+  WinEventDispatcher dispatcher;
+  const uint32_t events[] = {eventLocationChange};
+  std::string error;
+  EXPECT_TRUE(dispatcher.Subscribe(events, 1, error));
+  dispatcher.Refresh();
+
+  std::thread producer([&] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    dispatcher.OnEvent(eventLocationChange, 7, objectWindow, 0, 0);
+  });
+  WinEventRecord records[8];
+  ASSERT_EQ(dispatcher.Read(records, 8, -1), 1u);
+  EXPECT_EQ(records[0].hwnd, 7u);
+  producer.join();
+
+  std::thread stopper([&] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    dispatcher.Stop();
+  });
+  EXPECT_EQ(dispatcher.Read(records, 8, -1), 0u);
+  stopper.join();
+}
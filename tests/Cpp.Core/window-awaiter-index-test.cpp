@@ -0,0 +1,140 @@
+#include "window-awaiter-index.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "fake-window-field-source.h"
+
+using namespace Cpp::Core::NativeImpls;
+
+namespace {
+  constexpr uint32_t eventCreate     = 0x8000;
+  constexpr uint32_t eventDestroy    = 0x8001;
+  constexpr uint32_t eventShow       = 0x8002;
+  constexpr uint32_t eventNameChange = 0x800C;
+
+  WindowMatcher MatchClassName(std::u16string_view className) {
+    WindowMatcher matcher;
+    matcher.SetClassName(std::u16string(className), MatchMode::Exact, false);
+    return matcher;
+  }
+}
+
+TEST(WindowAwaiterIndex, MatchesOnlyAwaitersOfTheEvent) {
+  FakeWindowFieldSource desktop;
+  desktop.windows[1] = {7, u"Notepad", u"Untitled"};
+
+  WindowAwaiterIndex index;
+  auto onCreate = index.Add(&eventCreate, 1, MatchClassName(u"Notepad"));
+  auto onShow   = index.Add(&eventShow, 1, MatchClassName(u"Notepad"));
+  index.Add(&eventCreate, 1, MatchClassName(u"Other"));
+
+  std::vector<uint32_t> ids;
+  LiveWindow created(1, desktop);
+  index.Match(eventCreate, created, ids);
+  EXPECT_EQ(ids, std::vector<uint32_t>{onCreate});
+
+  LiveWindow shown(1, desktop);
+  index.Match(eventShow, shown, ids);
+  EXPECT_EQ(ids, std::vector<uint32_t>{onShow});
+}
+
+TEST(WindowAwaiterIndex, RemovesAwaitersOnce) {
+  WindowAwaiterIndex index;
+  auto id = index.Add(&eventCreate, 1, WindowMatcher());
+  EXPECT_EQ(index.GetCount(), 1u);
+
+  EXPECT_TRUE(index.Remove(id));
+  EXPECT_FALSE(index.Remove(id));
+  EXPECT_EQ(index.GetCount(), 0u);
+}
+
+TEST(WindowAwaiterIndex, MatchesLikeEveryAwaiterInTurn) {
+  const char16_t* classes[] = {u"Notepad", u"UnityWndClass", u"SDL_app", u"#32770",
+                               u"Chrome_WidgetWin_1"};
+  const uint32_t events[]   = {eventCreate, eventDestroy, eventNameChange, eventShow};
+
+  std::mt19937 random(3);
+  FakeWindowFieldSource desktop;
+  for (uint32_t processId = 1; processId <= 40; processId++) {
+    desktop.processNames[processId] =
+      u"C:\\Games\\game" + std::u16string(1, static_cast<char16_t>(u'a' + processId % 8)) +
+      u".exe";
+  }
+  for (uint64_t hwnd = 1; hwnd <= 500; hwnd++) {
+    desktop.windows[hwnd] = {
+      static_cast<uint32_t>(random() % 45 + 1),
+      classes[random() % 5],
+      u"Title " + std::u16string(1, static_cast<char16_t>(u'a' + random() % 10)),
+    };
+  }
+
+  WindowAwaiterIndex index;
+  std::map<uint32_t, std::pair<std::vector<uint32_t>, WindowMatcher>> awaiters;
+  for (int step = 0; step < 30000; step++) {
+    int operation = random() % 10;
+    if (operation < 3 || awaiters.empty()) {
+      WindowMatcher matcher;
+      switch (random() % 6) {
+        case 0: matcher.SetProcessId(random() % 45 + 1); break;
+        case 1: matcher.SetClassName(classes[random() % 5], MatchMode::Exact, random() % 2); break;
+        case 2:
+          matcher.SetClassName(classes[random() % 5], MatchMode::Exact, random() % 2);
+          if (random() % 2) {
+            matcher.SetClassName(u"*app", MatchMode::Glob, true);
+          }
+          break;
+        case 3: matcher.SetTitle(u"Title [a-e]", MatchMode::Regex, false); break;
+        case 4:
+          matcher.SetProcessName(
+            u"game" + std::u16string(1, static_cast<char16_t>(u'a' + random() % 8)) + u".exe",
+            MatchMode::Exact,
+            true
+          );
+          break;
+      }
+      if (random() % 3 == 0) {
+        matcher.SetTitle(
+          u"Title " + std::u16string(1, static_cast<char16_t>(u'a' + random() % 10)),
+          MatchMode::Exact,
+          false
+        );
+      }
+
+      std::vector<uint32_t> awaited;
+      for (int count = random() % 3 + 1; count > 0; count--) {
+        awaited.push_back(events[random() % 4]);
+      }
+      auto id      = index.Add(awaited.data(), awaited.size(), matcher);
+      awaiters[id] = {awaited, matcher};
+    } else if (operation < 5) {
+      auto awaiter = std::next(awaiters.begin(), random() % awaiters.size());
+      ASSERT_TRUE(index.Remove(awaiter->first));
+      awaiters.erase(awaiter);
+    } else {
+      uint32_t event = events[random() % 4];
+      uint64_t hwnd  = random() % 520 + 1;
+
+      std::vector<uint32_t> expected;
+      for (const auto& [id, awaiter] : awaiters) {
+        const auto& [awaited, matcher] = awaiter;
+        LiveWindow window(hwnd, desktop);
+        if (std::find(awaited.begin(), awaited.end(), event) != awaited.end() &&
+            matcher.Matches(window)) {
+          expected.push_back(id);
+        }
+      }
+
+      // However many awaiters there are, each field of the window is queried at most once.
+      LiveWindow window(hwnd, desktop);
+      std::vector<uint32_t> ids;
+      index.Match(event, window, ids);
+      ASSERT_EQ(ids, expected) << "step " << step;
+      ASSERT_LE(window.GetQueryCount(), 5u);
+    }
+    ASSERT_EQ(index.GetCount(), awaiters.size());
+  }
+}
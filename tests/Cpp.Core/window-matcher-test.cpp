@@ -0,0 +1,289 @@
+#include "window-matcher.h"
+
+#include <random>
+#include <set>
+
+#include <gtest/gtest.h>
+
+using namespace Cpp::Core::NativeImpls;
+
+namespace {
+  StringPattern Compile(std::u16string_view pattern, MatchMode mode, bool ignoreCase) {
+    StringPattern compiled;
+    std::string error;
+    EXPECT_TRUE(compiled.Compile(std::u16string(pattern), mode, ignoreCase, error)) << error;
+    return compiled;
+  }
+
+  char16_t Fold(char16_t character) {
+    bool isUpper = (character >= u'A' && character <= u'Z') ||
+                   (character >= 0xC0 && character <= 0xDE && character != 0xD7);
+    return isUpper ? character + 32 : character;
+  }
+
+  /**
+   * @brief Matches a glob by backtracking, as a reference for the compiled matcher.
+   */
+  bool MatchGlob(std::u16string_view pattern, std::u16string_view value, bool ignoreCase) {
+    if (pattern.empty()) {
+      return value.empty();
+    }
+
+    if (pattern[0] == u'*') {
+      for (size_t skipped = 0; skipped <= value.size(); skipped++) {
+        if (MatchGlob(pattern.substr(1), value.substr(skipped), ignoreCase)) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    if (value.empty()) {
+      return false;
+    }
+
+    bool matches = pattern[0] == u'?' ||
+                   (ignoreCase ? Fold(pattern[0]) == Fold(value[0]) : pattern[0] == value[0]);
+    return matches && MatchGlob(pattern.substr(1), value.substr(1), ignoreCase);
+  }
+
+  WindowView GetView(const WindowRecord& window) {
+    WindowView view;
+    view.hwnd        = window.hwnd;
+    view.processId   = window.processId;
+    view.title       = window.title;
+    view.className   = window.className;
+    view.processName = window.processName;
+    return view;
+  }
+
+  /**
+   * @brief A desktop of 3000 windows, with class names in mixed case and some outside ASCII.
+   */
+  struct Desktop {
+    static constexpr const char16_t* classes[] = {
+      u"Notepad", u"CabinetWClass", u"UnityWndClass",
+      u"SDL_app", u"Chrome_WidgetWin_1", u"\u00C9dit",
+    };
+
+    std::vector<WindowRecord> windows;
+
+    explicit Desktop(std::mt19937& random) {
+      for (uint64_t i = 0; i < 3000; i++) {
+        WindowRecord window;
+        window.hwnd        = i + 1;
+        window.parent      = i < 600 ? 0 : random() % 600 + 1;
+        window.processId   = random() % 50;
+        window.processName = u"C:\\Games\\game" +
+                             std::u16string(1, static_cast<char16_t>(u'A' + window.processId % 5)) +
+                             u".exe";
+        window.className = classes[random() % 6];
+        if (random() % 3 == 0) {
+          for (auto& character : window.className) {
+            if (character >= u'a' && character <= u'z') {
+              character -= 32;
+            }
+          }
+        }
+        window.title = u"Window " + std::u16string(1, static_cast<char16_t>(u'a' + random() % 26)) +
+                       u" v" + std::u16string(1, static_cast<char16_t>(u'0' + random() % 10));
+        windows.push_back(window);
+      }
+    }
+  };
+
+  WindowMatcher CreateRandomMatcher(std::mt19937& random) {
+    WindowMatcher matcher;
+    if (random() % 2) {
+      int index              = random() % 6;
+      std::u16string pattern = index == 5 ? u"\u00E9dit" : Desktop::classes[index];
+      matcher.SetClassName(pattern, MatchMode::Exact, random() % 2);
+    }
+
+    if (random() % 3 == 0) {
+      bool exact = random() % 2;
+      matcher.SetProcessName(
+        random() % 2 ? u"GAMEB.EXE" : u"game?.exe",
+        exact ? MatchMode::Exact : MatchMode::Glob,
+        true
+      );
+    }
+
+    if (random() % 2) {
+      auto letter = std::u16string(1, static_cast<char16_t>(u'a' + random() % 26));
+      bool ignoreCase = random() % 2;
+      switch (random() % 3) {
+        case 0: matcher.SetTitle(u"Window " + letter + u" v3", MatchMode::Exact, ignoreCase); break;
+        case 1: matcher.SetTitle(u"*" + letter + u" v?", MatchMode::Glob, ignoreCase); break;
+        case 2: matcher.SetTitle(u"v[0-4]$", MatchMode::Regex, ignoreCase); break;
+      }
+    }
+
+    if (random() % 5 == 0) {
+      matcher.SetProcessId(random() % 50);
+    }
+    return matcher;
+  }
+}
+
+TEST(StringPattern, MatchesExactlyWithOrWithoutCase) {
+  EXPECT_TRUE(Compile(u"Notepad", MatchMode::Exact, false).Matches(u"Notepad"));
+  EXPECT_FALSE(Compile(u"Notepad", MatchMode::Exact, false).Matches(u"notepad"));
+  EXPECT_TRUE(Compile(u"Notepad", MatchMode::Exact, true).Matches(u"NOTEPAD"));
+
+  auto accented = Compile(u"\u00C9T\u00C9 \u0416", MatchMode::Exact, true);
+  EXPECT_TRUE(accented.Matches(u"\u00E9t\u00E9 \u0436"));
+  EXPECT_TRUE(accented.IsLiteral());
+}
+
+TEST(StringPattern, MatchesGlobs) {
+  EXPECT_TRUE(Compile(u"*Notepad", MatchMode::Glob, false).Matches(u"Untitled - Notepad"));
+  EXPECT_TRUE(Compile(u"Un*d - N*", MatchMode::Glob, false).Matches(u"Untitled - Notepad"));
+  EXPECT_FALSE(Compile(u"Un*x*", MatchMode::Glob, false).Matches(u"Untitled - Notepad"));
+  EXPECT_TRUE(Compile(u"a?c", MatchMode::Glob, false).Matches(u"abc"));
+  EXPECT_FALSE(Compile(u"a?c", MatchMode::Glob, false).Matches(u"abcc"));
+  EXPECT_FALSE(Compile(u"a?c", MatchMode::Glob, false).Matches(u"abcxc"));
+  EXPECT_TRUE(Compile(u"*", MatchMode::Glob, false).Matches(u""));
+  EXPECT_TRUE(Compile(u"**a**", MatchMode::Glob, false).Matches(u"bab"));
+  EXPECT_FALSE(Compile(u"aba*aba", MatchMode::Glob, false).Matches(u"ababa"));
+  EXPECT_FALSE(Compile(u"ab*ba", MatchMode::Glob, false).Matches(u"aba"));
+  EXPECT_TRUE(Compile(u"plain", MatchMode::Glob, true).IsLiteral());
+}
+
+TEST(StringPattern, MatchesGlobsLikeBacktracking) {
+  std::mt19937 random(7);
+  const char16_t alphabet[] = u"aAbB*?";
+
+  for (int i = 0; i < 200000; i++) {
+    std::u16string pattern, value;
+    for (int length = random() % 7; length > 0; length--) {
+      pattern += alphabet[random() % 6];
+    }
+    for (int length = random() % 9; length > 0; length--) {
+      value += alphabet[random() % 4];
+    }
+    bool ignoreCase = random() % 2;
+
+    StringPattern compiled;
+    std::string error;
+    compiled.Compile(pattern, MatchMode::Glob, ignoreCase, error);
+    ASSERT_EQ(compiled.Matches(value), MatchGlob(pattern, value, ignoreCase))
+      << "pattern of " << pattern.size() << ", value of " << value.size() << ", ignoring case "
+      << ignoreCase;
+  }
+}
+
+TEST(StringPattern, MatchesRegexes) {
+  EXPECT_TRUE(Compile(u"^Game v\\d+", MatchMode::Regex, false).Matches(u"Game v12 (x64)"));
+  EXPECT_FALSE(Compile(u"^Game v\\d+", MatchMode::Regex, false).Matches(u"game v12"));
+  EXPECT_TRUE(Compile(u"^Game v\\d+", MatchMode::Regex, true).Matches(u"game v12"));
+}
+
+TEST(StringPattern, ReportsInvalidRegexes) {
+  StringPattern pattern;
+  std::string error;
+  EXPECT_FALSE(pattern.Compile(u"([a-", MatchMode::Regex, false, error));
+  EXPECT_FALSE(error.empty());
+
+  WindowMatcher matcher;
+  EXPECT_FALSE(matcher.SetTitle(u"(", MatchMode::Regex, false));
+  EXPECT_FALSE(matcher.GetError().empty());
+}
+
+TEST(WindowMatcher, MatchesEveryCriterion) {
+  WindowMatcher matcher;
+  matcher.SetClassName(u"notepad", MatchMode::Exact, true);
+  matcher.SetTitle(u"Window ? v*", MatchMode::Glob, false);
+  matcher.SetProcessName(u"game[A-C]\\.exe", MatchMode::Regex, true);
+
+  WindowRecord window;
+  window.className   = u"NOTEPAD";
+  window.title       = u"Window q v9";
+  window.processName = u"C:\\x\\GAMEB.exe";
+  EXPECT_TRUE(matcher.Matches(GetView(window)));
+
+  window.processName = u"C:\\x\\gamed.exe";
+  EXPECT_FALSE(matcher.Matches(GetView(window)));
+  EXPECT_EQ(matcher.GetFields(), WindowSnapshotAll);
+}
+
+TEST(WindowMatcher, OnlyNarrowsRegistryQueriesByLiterals) {
+  WindowMatcher matcher;
+  matcher.SetClassName(u"notepad", MatchMode::Exact, true);
+  matcher.SetTitle(u"Window ? v*", MatchMode::Glob, false);
+  matcher.SetProcessName(u"game[A-C]\\.exe", MatchMode::Regex, true);
+
+  auto query = matcher.ToWindowQuery();
+  EXPECT_TRUE(query.className);
+  EXPECT_FALSE(query.title);
+  EXPECT_FALSE(query.processName);
+}
+
+TEST(WindowMatcher, FindsTheSameWindowsInSnapshotsAndTheRegistry) {
+  std::mt19937 random(7);
+  Desktop desktop(random);
+
+  auto snapshot = ToWindowSnapshot(desktop.windows);
+  WindowSnapshotReader reader;
+  ASSERT_TRUE(reader.Open(snapshot.data(), snapshot.size()));
+  WindowRegistry registry;
+  registry.Load(reader);
+
+  for (int i = 0; i < 60; i++) {
+    auto matcher = CreateRandomMatcher(random);
+
+    std::vector<uint32_t> expected;
+    size_t expectedTopLevel = 0;
+    for (uint32_t index = 0; index < desktop.windows.size(); index++) {
+      if (matcher.Matches(GetView(desktop.windows[index]))) {
+        expected.push_back(index);
+        expectedTopLevel += desktop.windows[index].parent == 0;
+      }
+    }
+    ASSERT_EQ(matcher.Filter(reader), expected);
+
+    // The registry query may find more windows than match, but never fewer.
+    std::set<uint64_t> queried;
+    for (const auto& window : registry.Find(matcher.ToWindowQuery())) {
+      queried.insert(window.hwnd);
+    }
+    for (auto index : expected) {
+      ASSERT_TRUE(queried.count(desktop.windows[index].hwnd)) << "the query dropped a match";
+    }
+
+    EXPECT_EQ(FindWindows(registry, matcher, false).size(), expected.size());
+    EXPECT_EQ(FindWindows(registry, matcher, true).size(), expectedTopLevel);
+  }
+}
+
+TEST(WindowMatcherSet, MatchesLikeEachMatcher) {
+  std::mt19937 random(11);
+  Desktop desktop(random);
+
+  std::vector<WindowMatcher> matchers;
+  std::vector<uint32_t> ids;
+  WindowMatcherSet set;
+  for (int i = 0; i < 60; i++) {
+    matchers.push_back(CreateRandomMatcher(random));
+    ids.push_back(set.Add(matchers.back()));
+  }
+
+  const size_t removed = 10;
+  EXPECT_TRUE(set.Remove(ids[removed]));
+  EXPECT_FALSE(set.Remove(ids[removed]));
+  EXPECT_EQ(set.GetCount(), matchers.size() - 1);
+
+  std::vector<uint32_t> matched;
+  for (const auto& window : desktop.windows) {
+    auto view = GetView(window);
+    std::vector<uint32_t> expected;
+    for (size_t i = 0; i < matchers.size(); i++) {
+      if (i != removed && matchers[i].Matches(view)) {
+        expected.push_back(ids[i]);
+      }
+    }
+
+    set.Match(view, matched);
+    ASSERT_EQ(matched, expected) << "window " << window.hwnd;
+  }
+}
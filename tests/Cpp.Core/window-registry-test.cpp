@@ -0,0 +1,331 @@
+#include "window-registry.h"
+
+#include <map>
+#include <random>
+#include <set>
+
+#include <gtest/gtest.h>
+
+using namespace Cpp::Core::NativeImpls;
+
+namespace {
+  constexpr uint32_t eventCreate         = 0x8000;
+  constexpr uint32_t eventDestroy        = 0x8001;
+  constexpr uint32_t eventLocationChange = 0x800B;
+  constexpr uint32_t eventNameChange     = 0x800C;
+  constexpr uint32_t eventParentChange   = 0x800F;
+
+  /**
+   * @brief A simulated desktop that the registry describes windows from.
+   */
+  class Desktop : public IWindowSource {
+    public:
+      std::map<uint64_t, WindowRecord> windows;
+
+      bool Describe(uint64_t hwnd, WindowRecord& record) override {
+        auto window = windows.find(hwnd);
+        if (window == windows.end()) {
+          return false;
+        }
+        record = window->second;
+        return true;
+      }
+
+      bool GetTitle(uint64_t hwnd, std::u16string& title) override {
+        auto window = windows.find(hwnd);
+        if (window == windows.end()) {
+          return false;
+        }
+        title = window->second.title;
+        return true;
+      }
+
+      bool GetParent(uint64_t hwnd, uint64_t& parent) override {
+        auto window = windows.find(hwnd);
+        if (window == windows.end()) {
+          return false;
+        }
+        parent = window->second.parent;
+        return true;
+      }
+
+      uint64_t Pick(std::mt19937& random) const {
+        return std::next(windows.begin(), random() % windows.size())->first;
+      }
+
+      bool IsAncestor(uint64_t ancestor, uint64_t hwnd) const {
+        for (auto parent = windows.at(hwnd).parent; parent != 0;) {
+          if (parent == ancestor) {
+            return true;
+          }
+          auto window = windows.find(parent);
+          if (window == windows.end()) {
+            return false;
+          }
+          parent = window->second.parent;
+        }
+        return false;
+      }
+  };
+
+  std::u16string Fold(std::u16string value) {
+    for (auto& character : value) {
+      if (character >= u'A' && character <= u'Z') {
+        character += u'a' - u'A';
+      }
+    }
+    return value;
+  }
+
+  std::u16string GetFileName(const std::u16string& path) {
+    auto separator = path.find_last_of(u'\\');
+    return separator == std::u16string::npos ? path : path.substr(separator + 1);
+  }
+
+  /**
+   * @brief Answers a query by checking every window of the desktop.
+   */
+  std::set<uint64_t> FindLinearly(const Desktop& desktop, const WindowQuery& query) {
+    std::set<uint64_t> found;
+    for (const auto& [hwnd, window] : desktop.windows) {
+      if ((query.hwnd && hwnd != *query.hwnd) ||
+          (query.processId && window.processId != *query.processId) ||
+          (query.processName &&
+           Fold(GetFileName(window.processName)) != Fold(*query.processName)) ||
+          (query.className && Fold(window.className) != Fold(*query.className)) ||
+          (query.title && window.title != *query.title) ||
+          (query.topLevelOnly && window.parent != 0) ||
+          (query.ancestor && !desktop.IsAncestor(*query.ancestor, hwnd))) {
+        continue;
+      }
+      found.insert(hwnd);
+    }
+    return found;
+  }
+
+  void LoadSnapshot(WindowRegistry& registry, const Desktop& desktop) {
+    WindowSnapshotBuilder builder(WindowSnapshotAll);
+    for (const auto& [hwnd, window] : desktop.windows) {
+      builder.Add(
+        hwnd,
+        window.parent,
+        window.processId,
+        0,
+        window.title,
+        window.className,
+        window.processName
+      );
+    }
+
+    auto snapshot = builder.Finish();
+    WindowSnapshotReader reader;
+    ASSERT_TRUE(reader.Open(snapshot.data(), snapshot.size()));
+    registry.Load(reader);
+  }
+
+  WindowRecord MakeWindow(
+    uint64_t hwnd,
+    uint64_t parent,
+    std::u16string title,
+    std::u16string className = u"Class",
+    std::u16string processName = u"C:\\Games\\Game.exe"
+  ) {
+    WindowRecord window;
+    window.hwnd        = hwnd;
+    window.parent      = parent;
+    window.processId   = 100;
+    window.title       = std::move(title);
+    window.className   = std::move(className);
+    window.processName = std::move(processName);
+    return window;
+  }
+}
+
+TEST(WindowRegistry, FindsByFileNameAndClassIgnoringCase) {
+  WindowRegistry registry;
+  registry.Upsert(MakeWindow(1, 0, u"Game", u"UnityWndClass"));
+  registry.Upsert(MakeWindow(2, 0, u"Shell", u"Shell_TrayWnd", u"C:\\Windows\\explorer.exe"));
+
+  WindowQuery query;
+  query.processName = u"GAME.EXE";
+  auto found        = registry.Find(query);
+  ASSERT_EQ(found.size(), 1u);
+  EXPECT_EQ(found[0].hwnd, 1u);
+
+  query           = {};
+  query.className = u"shell_traywnd";
+  found           = registry.Find(query);
+  ASSERT_EQ(found.size(), 1u);
+  EXPECT_EQ(found[0].hwnd, 2u);
+}
+
+TEST(WindowRegistry, ListsTopLevelWindowsFirst) {
+  WindowRegistry registry;
+  registry.Upsert(MakeWindow(1, 0, u"Parent"));
+  registry.Upsert(MakeWindow(2, 1, u"Child"));
+  registry.Upsert(MakeWindow(3, 2, u"Grandchild"));
+  registry.Upsert(MakeWindow(4, 0, u"Other"));
+
+  auto found = registry.Find({});
+  ASSERT_EQ(found.size(), 4u);
+  EXPECT_EQ(found[0].depth, 0u);
+  EXPECT_EQ(found[1].depth, 0u);
+  EXPECT_EQ(found[2].depth, 1u);
+  EXPECT_EQ(found[3].depth, 2u);
+}
+
+TEST(WindowRegistry, DestroyingAWindowRemovesItsDescendants) {
+  Desktop desktop;
+  for (auto window : {MakeWindow(1, 0, u"Parent"), MakeWindow(2, 1, u"Child"),
+                      MakeWindow(3, 2, u"Grandchild"), MakeWindow(4, 0, u"Other")}) {
+    desktop.windows[window.hwnd] = window;
+  }
+
+  WindowRegistry registry;
+  LoadSnapshot(registry, desktop);
+  ASSERT_EQ(registry.GetCount(), 4u);
+
+  desktop.windows.erase(1);
+  desktop.windows.erase(2);
+  desktop.windows.erase(3);
+  registry.ApplyEvent(eventDestroy, 1, desktop);
+  EXPECT_EQ(registry.GetCount(), 1u);
+}
+
+TEST(WindowRegistry, EventsKeepItConsistentWithTheDesktop) {
+  const char16_t* titles[]    = {u"", u"Game", u"Launcher", u"Settings", u"Untitled - Notepad"};
+  const char16_t* classes[]   = {u"UnityWndClass", u"Chrome_WidgetWin_1", u"Button", u"EDIT"};
+  const char16_t* processes[] = {
+    u"C:\\Games\\Game.exe",
+    u"C:\\Windows\\explorer.exe",
+    u"C:\\x\\LAUNCHER.EXE",
+  };
+
+  std::mt19937 random(7);
+  Desktop desktop;
+  uint64_t nextHwnd = 0x1000;
+  auto createWindow = [&](uint64_t parent) {
+    WindowRecord window;
+    window.hwnd        = nextHwnd++;
+    window.parent      = parent;
+    window.processId   = random() % 3 + 100;
+    window.processName = processes[window.processId - 100];
+    window.className   = classes[random() % 4];
+    window.title       = titles[random() % 5];
+    desktop.windows[window.hwnd] = window;
+    return window.hwnd;
+  };
+
+  for (int i = 0; i < 50; i++) {
+    createWindow(0);
+  }
+  for (int i = 0; i < 100; i++) {
+    createWindow(desktop.Pick(random));
+  }
+
+  WindowRegistry registry;
+  LoadSnapshot(registry, desktop);
+  ASSERT_EQ(registry.GetCount(), desktop.windows.size());
+
+  // Events are queued and applied in batches, like the reader of the WinEvent queue does. Some
+  // arrive twice, and only some of the descendants of a destroyed window report their own
+  // destruction.
+  std::vector<std::pair<uint32_t, uint64_t>> backlog;
+  auto emit = [&](uint32_t event, uint64_t hwnd) {
+    backlog.emplace_back(event, hwnd);
+    if (random() % 10 == 0) {
+      backlog.emplace_back(event, hwnd);
+    }
+  };
+
+  size_t checks = 0;
+  for (int step = 0; step < 20000; step++) {
+    int operation = random() % 8;
+    if (operation >= 5) {
+      operation = operation == 7 ? 4 : 0;
+    }
+
+    if (operation == 0 || desktop.windows.empty()) {
+      emit(eventCreate, createWindow(random() % 2 ? desktop.Pick(random) : 0));
+    } else if (operation == 1) {
+      auto destroyed = desktop.Pick(random);
+      std::vector<uint64_t> pending{destroyed};
+      while (!pending.empty()) {
+        auto hwnd = pending.back();
+        pending.pop_back();
+        for (const auto& [child, window] : desktop.windows) {
+          if (window.parent == hwnd) {
+            pending.push_back(child);
+          }
+        }
+        desktop.windows.erase(hwnd);
+        if (hwnd == destroyed || random() % 2) {
+          emit(eventDestroy, hwnd);
+        }
+      }
+    } else if (operation == 2) {
+      auto& window = desktop.windows[desktop.Pick(random)];
+      window.title = titles[random() % 5];
+      emit(eventNameChange, window.hwnd);
+    } else if (operation == 3) {
+      auto& window = desktop.windows[desktop.Pick(random)];
+      uint64_t parent = 0;
+      if (random() % 2) {
+        auto candidate = desktop.Pick(random);
+        if (candidate != window.hwnd && !desktop.IsAncestor(window.hwnd, candidate)) {
+          parent = candidate;
+        }
+      }
+      window.parent = parent;
+      emit(eventParentChange, window.hwnd);
+    } else {
+      emit(eventLocationChange, nextHwnd - 1);
+    }
+
+    if (random() % 4 != 0) {
+      continue;
+    }
+
+    for (const auto& [event, hwnd] : backlog) {
+      registry.ApplyEvent(event, hwnd, desktop);
+    }
+    backlog.clear();
+    ASSERT_EQ(registry.GetCount(), desktop.windows.size()) << "step " << step;
+
+    WindowQuery query;
+    switch (random() % 8) {
+      case 0: query.processName = random() % 2 ? u"game.exe" : u"LAUNCHER.exe"; break;
+      case 1: query.className = random() % 2 ? u"button" : u"UnityWndClass"; break;
+      case 2: query.title = titles[random() % 5]; break;
+      case 3: query.processId = random() % 3 + 100; break;
+      case 4: query.ancestor = desktop.Pick(random); break;
+      case 5:
+        query.processName  = u"game.exe";
+        query.className    = u"button";
+        query.topLevelOnly = random() % 2;
+        break;
+      case 6: query.hwnd = desktop.Pick(random); break;
+    }
+
+    std::set<uint64_t> found;
+    bool childSeen = false;
+    for (const auto& window : registry.Find(query)) {
+      const auto& expected = desktop.windows.at(window.hwnd);
+      ASSERT_EQ(window.title, expected.title);
+      ASSERT_EQ(window.parent, expected.parent);
+      ASSERT_EQ(window.className, expected.className);
+      ASSERT_EQ(window.parent == 0, window.depth == 0);
+      ASSERT_TRUE(window.parent != 0 || !childSeen) << "top-level window after a child";
+      childSeen |= window.parent != 0;
+      ASSERT_TRUE(found.insert(window.hwnd).second) << "window found twice";
+    }
+    ASSERT_EQ(found, FindLinearly(desktop, query)) << "step " << step;
+    checks++;
+  }
+  EXPECT_GT(checks, 0u);
+
+  auto snapshot = ToWindowSnapshot(registry.Find({}));
+  WindowSnapshotReader reader;
+  ASSERT_TRUE(reader.Open(snapshot.data(), snapshot.size()));
+  EXPECT_EQ(reader.GetCount(), registry.GetCount());
+}
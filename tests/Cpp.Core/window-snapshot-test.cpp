@@ -0,0 +1,93 @@
+#include "window-snapshot.h"
+
+#include <cstddef>
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+using namespace Cpp::Core::NativeImpls;
+
+namespace {
+  std::vector<uint8_t> BuildSnapshot() {
+    WindowSnapshotBuilder builder(WindowSnapshotTitle | WindowSnapshotProcessName);
+    builder.Add(1, 0, 10, 0, u"Hello", u"Class", u"C:\\a.exe");
+    builder.Add(2, 1, 10, 1, u"", u"Class", u"C:\\a.exe");
+    builder.Add(3, 0, 11, 0, u"Hello", u"Other", u"C:\\b.exe");
+    return builder.Finish();
+  }
+}
+
+TEST(WindowSnapshot, ReadsWhatWasBuilt) {
+  auto snapshot = BuildSnapshot();
+  WindowSnapshotReader reader;
+  ASSERT_TRUE(reader.Open(snapshot.data(), snapshot.size()));
+  ASSERT_EQ(reader.GetCount(), 3u);
+  EXPECT_EQ(reader.GetFields(), WindowSnapshotTitle | WindowSnapshotProcessName);
+
+  auto child = reader.GetRecord(1);
+  EXPECT_EQ(child.hwnd, 2u);
+  EXPECT_EQ(child.parent, 1u);
+  EXPECT_EQ(child.depth, 1u);
+  EXPECT_EQ(child.processId, 10u);
+  EXPECT_EQ(reader.GetString(reader.GetRecord(0).title), u"Hello");
+  EXPECT_EQ(reader.GetString(reader.GetRecord(2).processName), u"C:\\b.exe");
+}
+
+TEST(WindowSnapshot, TellsEmptyStringsFromOnesNotGathered) {
+  auto snapshot = BuildSnapshot();
+  WindowSnapshotReader reader;
+  ASSERT_TRUE(reader.Open(snapshot.data(), snapshot.size()));
+
+  auto record = reader.GetRecord(0);
+  EXPECT_EQ(record.className.offset, WindowSnapshotString::NotGathered);
+  EXPECT_TRUE(reader.GetString(record.className).empty());
+
+  auto untitled = reader.GetRecord(1);
+  EXPECT_NE(untitled.title.offset, WindowSnapshotString::NotGathered);
+  EXPECT_TRUE(reader.GetString(untitled.title).empty());
+}
+
+TEST(WindowSnapshot, SharesRepeatedStrings) {
+  auto snapshot = BuildSnapshot();
+  WindowSnapshotReader reader;
+  ASSERT_TRUE(reader.Open(snapshot.data(), snapshot.size()));
+
+  EXPECT_EQ(reader.GetRecord(0).title.offset, reader.GetRecord(2).title.offset);
+  EXPECT_EQ(reader.GetRecord(0).processName.offset, reader.GetRecord(1).processName.offset);
+}
+
+TEST(WindowSnapshot, RejectsMalformedSnapshots) {
+  auto snapshot = BuildSnapshot();
+  WindowSnapshotReader reader;
+
+  auto badMagic = snapshot;
+  badMagic[0] ^= 1;
+  EXPECT_FALSE(reader.Open(badMagic.data(), badMagic.size()));
+
+  auto truncated = snapshot;
+  truncated.pop_back();
+  EXPECT_FALSE(reader.Open(truncated.data(), truncated.size()));
+
+  auto outOfPool  = snapshot;
+  uint32_t offset = 1000;
+  std::memcpy(
+    outOfPool.data() + sizeof(WindowSnapshotHeader) + offsetof(WindowSnapshotRecord, title),
+    &offset,
+    sizeof(offset)
+  );
+  EXPECT_FALSE(reader.Open(outOfPool.data(), outOfPool.size()));
+
+  EXPECT_FALSE(reader.Open(snapshot.data(), 10));
+  EXPECT_FALSE(reader.Open(nullptr, 0));
+}
+
+TEST(WindowSnapshot, SnapshotsOfTheDesktopAreWellFormed) {
+  auto snapshot = SnapshotWindows(WindowSnapshotAll, 0, true);
+  WindowSnapshotReader reader;
+  ASSERT_TRUE(reader.Open(snapshot.data(), snapshot.size()));
+  EXPECT_EQ(reader.GetFields(), WindowSnapshotAll);
+#if !defined(_WIN32)
+  // There are no windows to enumerate away from Windows.
+  EXPECT_EQ(reader.GetCount(), 0u);
+#endif
+}
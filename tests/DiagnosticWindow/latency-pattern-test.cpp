@@ -0,0 +1,119 @@
+#include "latency-pattern.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace DiagnosticWindow;
+
+namespace {
+  constexpr int32_t width  = 300;
+  constexpr int32_t height = 260;
+
+  using Image = std::vector<uint8_t>;
+
+  /**
+   * @brief Downscales a tightly packed BGRA image by an integer factor with a box filter, the way
+   * the downscaler's simplest scaling mode does.
+   */
+  Image Downscale(const Image& source, int32_t factor) {
+    int32_t downscaledWidth  = width / factor;
+    int32_t downscaledHeight = height / factor;
+    Image downscaled(static_cast<size_t>(downscaledWidth) * downscaledHeight * 4);
+    for (int32_t y = 0; y < downscaledHeight; y++) {
+      for (int32_t x = 0; x < downscaledWidth; x++) {
+        for (int32_t channel = 0; channel < 4; channel++) {
+          int32_t sum = 0;
+          for (int32_t j = 0; j < factor; j++) {
+            for (int32_t i = 0; i < factor; i++) {
+              sum += source[((y * factor + j) * width + x * factor + i) * 4 + channel];
+            }
+          }
+          downscaled[(y * downscaledWidth + x) * 4 + channel] =
+            static_cast<uint8_t>(sum / (factor * factor));
+        }
+      }
+    }
+    return downscaled;
+  }
+
+  LatencyPatternRegion GetRegion(int32_t cellSize, int32_t factor = 1) {
+    return {
+      0.0,
+      0.0,
+      static_cast<double>(LatencyPattern::Columns) * cellSize / factor,
+      static_cast<double>(LatencyPattern::Rows) * cellSize / factor,
+    };
+  }
+}
+
+TEST(LatencyPattern, DecodesWhatWasRenderedAtAnyScale) {
+  std::mt19937 random(1);
+  Image image(width * height * 4);
+
+  for (int iteration = 0; iteration < 500; iteration++) {
+    LatencyPatternPayload payload{static_cast<uint32_t>(random()),
+                                  static_cast<uint32_t>(random())};
+    int32_t cellSize = 16 + iteration % 8;
+    std::fill(image.begin(), image.end(), static_cast<uint8_t>(random() % 256));
+    LatencyPattern::Render(image.data(), width, height, width * 4, cellSize, payload);
+
+    LatencyPatternPayload decoded;
+    ASSERT_TRUE(LatencyPattern::Decode(
+      image.data(), width, height, width * 4, GetRegion(cellSize), decoded
+    ));
+    ASSERT_EQ(decoded, payload);
+
+    for (int32_t factor : {2, 3, 4}) {
+      auto downscaled = Downscale(image, factor);
+      decoded         = {};
+      ASSERT_TRUE(LatencyPattern::Decode(
+        downscaled.data(),
+        width / factor,
+        height / factor,
+        (width / factor) * 4,
+        GetRegion(cellSize, factor),
+        decoded
+      )) << "downscaled by " << factor;
+      ASSERT_EQ(decoded, payload) << "downscaled by " << factor;
+    }
+  }
+}
+
+TEST(LatencyPattern, DoesNotMistakeABlendOfTwoFramesForAThird) {
+  std::mt19937 random(2);
+  Image first(width * height * 4, 128);
+  Image second(first);
+
+  for (int iteration = 0; iteration < 500; iteration++) {
+    LatencyPatternPayload payload{static_cast<uint32_t>(random()),
+                                  static_cast<uint32_t>(random())};
+    LatencyPatternPayload next{payload.frame + 1, payload.inputCount + 3};
+    int32_t cellSize = 16 + iteration % 8;
+    LatencyPattern::Render(first.data(), width, height, width * 4, cellSize, payload);
+    LatencyPattern::Render(second.data(), width, height, width * 4, cellSize, next);
+
+    Image blended(first.size());
+    for (size_t i = 0; i < blended.size(); i++) {
+      blended[i] = static_cast<uint8_t>((first[i] + second[i]) / 2);
+    }
+
+    LatencyPatternPayload decoded;
+    if (LatencyPattern::Decode(
+          blended.data(), width, height, width * 4, GetRegion(cellSize), decoded
+        )) {
+      ASSERT_TRUE(decoded == payload || decoded == next);
+    }
+  }
+}
+
+TEST(LatencyPattern, FindsNothingInAUniformImage) {
+  Image image(width * height * 4, 200);
+
+  LatencyPatternPayload decoded;
+  EXPECT_FALSE(
+    LatencyPattern::Decode(image.data(), width, height, width * 4, GetRegion(16), decoded)
+  );
+}
@@ -0,0 +1,29 @@
+#include "latency-probe.h"
+
+#include <gtest/gtest.h>
+
+using namespace DiagnosticWindow;
+
+TEST(LatencyProbe, MeasuresFromRenderAndInputToTheFirstObservation) {
+  const int64_t frameInterval = 16667;
+  LatencyProbe probe;
+  for (uint32_t frame = 0; frame < 100; frame++) {
+    probe.OnFrameRendered(frame, frame * frameInterval);
+  }
+  probe.OnInputInjected(5, 100000);
+
+  // Every other frame is observed, twice each, and the input first shows up in frame 20.
+  for (uint32_t frame = 0; frame < 100; frame += 2) {
+    LatencyPatternPayload payload{frame, frame < 20 ? 5u : 6u};
+    probe.OnFrameObserved(payload, frame * frameInterval + 30000);
+    probe.OnFrameObserved(payload, frame * frameInterval + 31000);
+  }
+
+  EXPECT_EQ(probe.GetObservedFrames(), 50u);
+  EXPECT_EQ(probe.GetSkippedFrames(), 49u);
+  EXPECT_EQ(probe.GetRenderToDisplay().GetCount(), 50u);
+  EXPECT_EQ(probe.GetRenderToDisplay().GetMin(), 30000);
+  EXPECT_EQ(probe.GetInputToDisplay().GetCount(), 1u);
+  EXPECT_EQ(probe.GetInputToDisplay().GetMax(), 20 * frameInterval + 30000 - 100000);
+  EXPECT_FALSE(probe.IsInputPending());
+}
@@ -0,0 +1,85 @@
+#include "child-window-index.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace Downscaler::Cpp::Core::NativeImpls;
+
+namespace {
+  std::vector<ChildWindowRect> CreateChildren(std::mt19937& random, size_t count) {
+    std::vector<ChildWindowRect> children(count);
+    for (size_t i = 0; i < count; i++) {
+      int32_t x = random() % 4000;
+      int32_t y = random() % 3000;
+      children[i] = {i + 100, x, y, x + static_cast<int32_t>(random() % 300),
+                     y + static_cast<int32_t>(random() % 200)};
+    }
+    return children;
+  }
+
+  std::vector<ChildWindowHit> HitTestLinearly(
+    const std::vector<ChildWindowRect>& children,
+    int32_t x,
+    int32_t y
+  ) {
+    std::vector<ChildWindowHit> hits;
+    for (const auto& child : children) {
+      if (x >= child.left && x < child.right && y >= child.top && y < child.bottom) {
+        hits.push_back({child.handle, x - child.left, y - child.top});
+      }
+    }
+    return hits;
+  }
+}
+
+TEST(ChildWindowIndex, IsValidOnlyBetweenUpdateAndInvalidate) {
+  ChildWindowIndex index;
+  EXPECT_FALSE(index.IsValid());
+
+  ChildWindowRect child{1, 0, 0, 10, 10};
+  index.Update(&child, 1);
+  EXPECT_TRUE(index.IsValid());
+  EXPECT_EQ(index.GetChildCount(), 1u);
+
+  index.Invalidate();
+  EXPECT_FALSE(index.IsValid());
+}
+
+TEST(ChildWindowIndex, LeavesOutEmptyChildren) {
+  ChildWindowRect children[] = {{1, 5, 5, 5, 20}, {2, 0, 0, 10, 10}};
+  ChildWindowIndex index;
+  index.Update(children, 2);
+
+  ChildWindowHit hit;
+  ASSERT_EQ(index.HitTest(5, 5, &hit, 1), 1u);
+  EXPECT_EQ(hit.handle, 2u);
+}
+
+TEST(ChildWindowIndex, MatchesALinearSearch) {
+  std::mt19937 random(42);
+  for (size_t count : {0, 1, 5, 16, 17, 300, 5000}) {
+    auto children = CreateChildren(random, count);
+    ChildWindowIndex index;
+    index.Update(children.data(), children.size());
+
+    for (int query = 0; query < 20000; query++) {
+      int32_t x     = random() % 4300 - 100;
+      int32_t y     = random() % 3300 - 100;
+      auto expected = HitTestLinearly(children, x, y);
+
+      // Also check that hits past the capacity are counted but not written.
+      ChildWindowHit hits[8];
+      size_t capacity = query % 3 == 0 ? 2 : 8;
+      size_t found    = index.HitTest(x, y, hits, capacity);
+      ASSERT_EQ(found, expected.size()) << count << " children at " << x << ", " << y;
+      for (size_t i = 0; i < std::min(found, capacity); i++) {
+        EXPECT_EQ(hits[i].handle, expected[i].handle);
+        EXPECT_EQ(hits[i].x, expected[i].x);
+        EXPECT_EQ(hits[i].y, expected[i].y);
+      }
+    }
+  }
+}
@@ -0,0 +1,159 @@
+#include "coordinate-mapper.h"
+
+#include <gtest/gtest.h>
+
+using namespace Downscaler::Cpp::Core::NativeImpls;
+
+namespace {
+  WindowGeometry Geometry(
+    int32_t left,
+    int32_t top,
+    int32_t width,
+    int32_t height,
+    int32_t insetLeft = 0,
+    int32_t insetTop  = 0
+  ) {
+    return {left, top, width, height, insetLeft, insetTop};
+  }
+}
+
+TEST(CoordinateMapper, ScalesAcrossMonitorsWithDifferentDpi) {
+  // The downscaled window is on a 100% monitor, while the source fills a 150% monitor to the left
+  // of it. Both are in physical pixels, so the DPI difference is part of the 3x scale.
+  CoordinateMapper mapper;
+  mapper.Update(Geometry(100, 50, 960, 540), Geometry(-2880, 0, 2880, 1620, 12, 45));
+
+  auto point = mapper.Map(100 + 480, 50 + 270);
+  EXPECT_EQ(point.downscaledX, 480);
+  EXPECT_EQ(point.downscaledY, 270);
+  EXPECT_EQ(point.sourceX, 1440);
+  EXPECT_EQ(point.sourceY, 810);
+  EXPECT_EQ(point.sourceWindowX, 1452);
+  EXPECT_EQ(point.sourceWindowY, 855);
+  EXPECT_FLOAT_EQ(point.downscaledPercentX, 0.5f);
+  EXPECT_FLOAT_EQ(point.sourcePercentY, 0.5f);
+  EXPECT_TRUE(point.isWithinDownscaledWindow);
+  EXPECT_FALSE(point.isWithinSourceWindow);
+
+  // At 125% against 175%, the scale isn't a whole number and the source position is truncated.
+  mapper.Update(Geometry(0, 0, 1000, 600), Geometry(0, 0, 1400, 840));
+  point = mapper.Map(333, 599);
+  EXPECT_EQ(point.sourceX, 466);
+  EXPECT_EQ(point.sourceY, 838);
+}
+
+TEST(CoordinateMapper, MapsRelativeToOffsetOrigins) {
+  // The downscaled window is on a monitor above and to the left of the primary one.
+  CoordinateMapper mapper;
+  mapper.Update(Geometry(-1500, -900, 640, 360), Geometry(200, 100, 1280, 720, 8, 31));
+
+  auto point = mapper.Map(-1500, -900);
+  EXPECT_EQ(point.downscaledX, 0);
+  EXPECT_EQ(point.downscaledY, 0);
+  EXPECT_EQ(point.sourceX, 0);
+  EXPECT_EQ(point.sourceWindowX, 8);
+  EXPECT_EQ(point.sourceWindowY, 31);
+  EXPECT_TRUE(point.isWithinDownscaledWindow);
+
+  point = mapper.Map(-1500 + 639, -900 + 359);
+  EXPECT_EQ(point.sourceX, 1278);
+  EXPECT_EQ(point.sourceY, 718);
+
+  // The source window's own client area is checked on screen.
+  EXPECT_TRUE(mapper.Map(200 + 1280, 100 + 720).isWithinSourceWindow);
+  EXPECT_FALSE(mapper.Map(199, 100).isWithinSourceWindow);
+}
+
+TEST(CoordinateMapper, ReportsPointsOutsideTheDownscaledWindow) {
+  CoordinateMapper mapper;
+  mapper.Update(Geometry(100, 100, 400, 300), Geometry(0, 0, 800, 600));
+
+  auto before = mapper.Map(90, 95);
+  EXPECT_FALSE(before.isWithinDownscaledWindow);
+  EXPECT_EQ(before.downscaledX, -10);
+  EXPECT_EQ(before.sourceX, -20);
+  EXPECT_EQ(before.sourceY, -10);
+  EXPECT_LT(before.downscaledPercentX, 0.0f);
+
+  // The right and bottom edges are inclusive, like `RectExtensions.Contains`.
+  EXPECT_TRUE(mapper.Map(500, 400).isWithinDownscaledWindow);
+  EXPECT_FALSE(mapper.Map(501, 400).isWithinDownscaledWindow);
+  EXPECT_FALSE(mapper.Map(500, 401).isWithinDownscaledWindow);
+
+  auto after = mapper.Map(600, 450);
+  EXPECT_EQ(after.sourceX, 1000);
+  EXPECT_GT(after.sourcePercentX, 1.0f);
+}
+
+TEST(CoordinateMapper, MapsSourcePointsBackOntoTheirDownscaledPoint) {
+  const int32_t sizes[][2] = {{640, 1280}, {1280, 1920}, {1366, 2560}, {960, 2880}, {700, 700}};
+  for (const auto& [downscaledSize, sourceSize] : sizes) {
+    CoordinateMapper mapper;
+    mapper.Update(
+      Geometry(-300, 40, downscaledSize, downscaledSize / 2),
+      Geometry(500, 0, sourceSize, sourceSize / 2)
+    );
+
+    for (int32_t x = -20; x < downscaledSize + 20; x++) {
+      auto point = mapper.Map(-300 + x, 40 + x / 2);
+
+      int32_t screenX, screenY;
+      mapper.MapSourceToScreen(point.sourceX, point.sourceY, screenX, screenY);
+      ASSERT_EQ(screenX, -300 + x) << downscaledSize << " to " << sourceSize;
+      ASSERT_EQ(screenY, 40 + x / 2) << downscaledSize << " to " << sourceSize;
+    }
+  }
+}
+
+TEST(CoordinateMapper, MapsSourcePointsBetweenDownscaledPixelsAwayFromTheOrigin) {
+  CoordinateMapper mapper;
+  mapper.Update(Geometry(10, 20, 400, 300), Geometry(0, 0, 1200, 900));
+
+  int32_t screenX, screenY;
+  mapper.MapSourceToScreen(300, 0, screenX, screenY);
+  EXPECT_EQ(screenX, 110);
+  EXPECT_EQ(screenY, 20);
+  for (int32_t sourceX : {301, 302, 303}) {
+    mapper.MapSourceToScreen(sourceX, 0, screenX, screenY);
+    EXPECT_EQ(screenX, 111);
+  }
+
+  // `Map` truncates negative offsets towards zero too, so these round down.
+  mapper.MapSourceToScreen(-1, -3, screenX, screenY);
+  EXPECT_EQ(screenX, 9);
+  EXPECT_EQ(screenY, 19);
+  mapper.MapSourceToScreen(-4, 1203, screenX, screenY);
+  EXPECT_EQ(screenX, 8);
+  EXPECT_EQ(screenY, 421);
+}
+
+TEST(CoordinateMapper, ToleratesEmptyClientAreas) {
+  CoordinateMapper mapper;
+  mapper.Update(Geometry(0, 0, 0, 0), Geometry(0, 0, 0, 0));
+
+  auto point = mapper.Map(5, 5);
+  EXPECT_EQ(point.sourceX, 0);
+  EXPECT_EQ(point.downscaledPercentX, 0.0f);
+
+  int32_t screenX, screenY;
+  mapper.MapSourceToScreen(5, 5, screenX, screenY);
+  EXPECT_EQ(screenX, 0);
+  EXPECT_EQ(screenY, 0);
+}
+
+TEST(CoordinateMapper, StaysStaleWhenInvalidatedDuringAnUpdate) {
+  CoordinateMapper mapper;
+  EXPECT_FALSE(mapper.IsValid());
+  mapper.Update(Geometry(0, 0, 10, 10), Geometry(0, 0, 20, 20));
+  EXPECT_TRUE(mapper.IsValid());
+
+  mapper.Invalidate();
+  EXPECT_FALSE(mapper.IsValid());
+
+  // A window moves again while the caller is querying the geometry.
+  mapper.Invalidate();
+  mapper.Update(Geometry(0, 0, 10, 10), Geometry(0, 0, 20, 20));
+  EXPECT_FALSE(mapper.IsValid());
+  mapper.Update(Geometry(0, 0, 10, 10), Geometry(0, 0, 20, 20));
+  EXPECT_TRUE(mapper.IsValid());
+}
@@ -0,0 +1,120 @@
+#include "cursor-predictor.h"
+
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+using namespace Downscaler::Cpp::Core::NativeImpls;
+
+namespace {
+  /** @brief One capture frame at 60 Hz, the horizon the forwarded moves are predicted over. */
+  const int64_t FrameTime = 16'700;
+
+  /**
+   * @brief Feeds the predictor a cursor moving at a constant velocity, polled every `interval`
+   * microseconds, until `end`.
+   * @param quantize Whether to round positions down to whole pixels, as the mouse reports them.
+   */
+  void MoveAtConstantVelocity(
+    CursorPredictor& predictor,
+    double velocityX,
+    double velocityY,
+    int64_t interval,
+    int64_t end,
+    bool quantize
+  ) {
+    for (int64_t time = 0; time <= end; time += interval) {
+      auto x = 100.0 + velocityX * time / 1'000'000.0;
+      auto y = 200.0 + velocityY * time / 1'000'000.0;
+      predictor.AddSample(time, quantize ? std::floor(x) : x, quantize ? std::floor(y) : y);
+    }
+  }
+}
+
+TEST(CursorPredictor, PredictsAConstantVelocityPathExactly) {
+  CursorPredictor predictor;
+  MoveAtConstantVelocity(predictor, 1'200.0, -450.0, 1'000, 100'000, false);
+
+  EXPECT_NEAR(predictor.GetVelocityX(), 1'200.0, 1e-6);
+  EXPECT_NEAR(predictor.GetVelocityY(), -450.0, 1e-6);
+
+  // Half a millisecond after the last sample, one frame ahead.
+  auto now       = 100'500;
+  auto predicted = predictor.Predict(now, FrameTime);
+  EXPECT_TRUE(predicted.isExtrapolated);
+  EXPECT_NEAR(predicted.x, 100.0 + 1'200.0 * (now + FrameTime) / 1'000'000.0, 1e-6);
+  EXPECT_NEAR(predicted.y, 200.0 - 450.0 * (now + FrameTime) / 1'000'000.0, 1e-6);
+}
+
+TEST(CursorPredictor, KeepsTheErrorOfAQuantizedConstantVelocityPathWithinTwoPixels) {
+  for (int64_t interval : {1'000, 4'000, 8'000}) {
+    CursorPredictor predictor;
+    MoveAtConstantVelocity(predictor, 700.0, 300.0, interval, 200'000, true);
+
+    auto last      = 200'000 / interval * interval;
+    auto predicted = predictor.Predict(last, FrameTime);
+    auto error     = std::hypot(
+      predicted.x - (100.0 + 700.0 * (last + FrameTime) / 1'000'000.0),
+      predicted.y - (200.0 + 300.0 * (last + FrameTime) / 1'000'000.0)
+    );
+    // Rounding down to whole pixels alone is off by up to a pixel on each axis, while forwarding
+    // the last position would lag a frame, about 12 pixels, behind.
+    EXPECT_LT(error, 2.0) << "polled every " << interval << " us";
+  }
+}
+
+TEST(CursorPredictor, DoesNotExtrapolatePastTheMaximumHorizon) {
+  CursorPredictorOptions options;
+  options.maxHorizon = 10'000;
+  CursorPredictor predictor(options);
+  MoveAtConstantVelocity(predictor, 1'000.0, 0.0, 1'000, 50'000, false);
+
+  auto predicted = predictor.Predict(50'000, FrameTime);
+  EXPECT_NEAR(predicted.x, 100.0 + 1'000.0 * 60'000 / 1'000'000.0, 1e-6);
+}
+
+TEST(CursorPredictor, FallsBackToTheLastSampleAfterASuddenStop) {
+  CursorPredictor predictor;
+  MoveAtConstantVelocity(predictor, 2'000.0, 1'000.0, 1'000, 100'000, false);
+
+  // The mouse stops reporting motion at 100 ms. Until it has been quiet for the idle timeout,
+  // the cursor is still assumed to be moving.
+  auto moving = predictor.Predict(110'000, FrameTime);
+  EXPECT_TRUE(moving.isExtrapolated);
+  EXPECT_GT(moving.x, 300.0);
+
+  // After that, it's at rest where it was last reported, and stays there.
+  for (int64_t now : {120'001, 150'000, 1'000'000, 60'000'000}) {
+    auto resting = predictor.Predict(now, FrameTime);
+    EXPECT_FALSE(resting.isExtrapolated);
+    EXPECT_DOUBLE_EQ(resting.x, 300.0);
+    EXPECT_DOUBLE_EQ(resting.y, 300.0);
+  }
+}
+
+TEST(CursorPredictor, StartsOverFromRestWithoutTheOldVelocity) {
+  CursorPredictor predictor;
+  MoveAtConstantVelocity(predictor, 2'000.0, 0.0, 1'000, 100'000, false);
+
+  // A new motion after a pause begins from its first sample, not from the stroke before it.
+  predictor.AddSample(200'000, 300.0, 300.0);
+  EXPECT_EQ(predictor.GetVelocityX(), 0.0);
+  EXPECT_FALSE(predictor.Predict(200'000, FrameTime).isExtrapolated);
+
+  predictor.AddSample(201'000, 299.0, 301.0);
+  EXPECT_NEAR(predictor.GetVelocityX(), -1'000.0, 1e-6);
+  EXPECT_NEAR(predictor.GetVelocityY(), 1'000.0, 1e-6);
+}
+
+TEST(CursorPredictor, ReturnsTheOriginWithoutSamples) {
+  CursorPredictor predictor;
+  auto predicted = predictor.Predict(0, FrameTime);
+  EXPECT_EQ(predicted.x, 0.0);
+  EXPECT_EQ(predicted.y, 0.0);
+  EXPECT_FALSE(predicted.isExtrapolated);
+
+  predictor.AddSample(0, 10.0, 10.0);
+  predictor.AddSample(1'000, 20.0, 10.0);
+  predictor.Reset();
+  EXPECT_FALSE(predictor.Predict(1'000, FrameTime).isExtrapolated);
+}
@@ -0,0 +1,159 @@
+#include "frame-buffer-pool.h"
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace Downscaler::Cpp::Core::NativeImpls;
+
+namespace {
+  /** @brief The size of a 1080p BGRA frame, which rounds up to the 8 MiB size class. */
+  const size_t FrameBytes = 1920 * 1080 * 4;
+  const size_t FrameClass = size_t{8} * 1024 * 1024;
+}
+
+TEST(FrameBufferPool, StopsAllocatingAtASteadyFrameSize) {
+  FrameBufferPool pool;
+  for (int frame = 0; frame < 10; frame++) {
+    // A frame, a blend target and scratch space, all borrowed at once.
+    auto first  = pool.Acquire(FrameBytes);
+    auto second = pool.Acquire(FrameBytes);
+    auto third  = pool.Acquire(FrameBytes);
+    ASSERT_TRUE(first && second && third);
+    EXPECT_EQ(first.GetCapacity(), FrameClass);
+  }
+
+  EXPECT_EQ(pool.GetMisses(), 3u);
+  EXPECT_EQ(pool.GetHits(), 27u);
+  EXPECT_EQ(pool.GetBytesAllocated(), 3 * FrameClass);
+}
+
+TEST(FrameBufferPool, AlignsEveryBuffer) {
+  FrameBufferPool pool;
+  std::vector<PooledFrameBuffer> buffers;
+  for (size_t bytes : {size_t{1}, size_t{100}, size_t{4'097}, size_t{65'537}, FrameBytes}) {
+    auto buffer = pool.Acquire(bytes);
+    ASSERT_TRUE(buffer);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(buffer.GetData()) % FrameBufferPool::Alignment, 0u);
+    EXPECT_GE(buffer.GetCapacity(), bytes);
+    std::memset(buffer.GetData(), 0xAB, buffer.GetCapacity());
+    buffers.push_back(std::move(buffer));
+  }
+}
+
+TEST(FrameBufferPool, RoundsRequestsUpToASizeClass) {
+  FrameBufferPool pool;
+  EXPECT_FALSE(pool.Acquire(0));
+  EXPECT_EQ(pool.Acquire(1).GetCapacity(), FrameBufferPool::MinBufferSize);
+  EXPECT_EQ(pool.Acquire(4'096).GetCapacity(), 4'096u);
+  EXPECT_EQ(pool.Acquire(4'097).GetCapacity(), 8'192u);
+
+  // Every request of the smallest class was served by the same buffer.
+  EXPECT_EQ(pool.GetMisses(), 2u);
+  EXPECT_EQ(pool.GetHits(), 1u);
+}
+
+TEST(FrameBufferPool, FreesBuffersBeyondWhatEachClassKeeps) {
+  FrameBufferPool pool;
+  const size_t count = FrameBufferPool::BuffersPerClass + 4;
+  {
+    std::vector<PooledFrameBuffer> buffers;
+    for (size_t i = 0; i < count; i++) {
+      buffers.push_back(pool.Acquire(FrameBytes));
+    }
+    EXPECT_EQ(pool.GetBytesAllocated(), count * FrameClass);
+  }
+
+  EXPECT_EQ(pool.GetBytesAllocated(), FrameBufferPool::BuffersPerClass * FrameClass);
+
+  // The kept buffers are handed out again, and the next one is a fresh allocation.
+  std::vector<PooledFrameBuffer> buffers;
+  for (size_t i = 0; i < FrameBufferPool::BuffersPerClass + 1; i++) {
+    buffers.push_back(pool.Acquire(FrameBytes));
+  }
+  EXPECT_EQ(pool.GetHits(), FrameBufferPool::BuffersPerClass);
+  EXPECT_EQ(pool.GetMisses(), count + 1);
+}
+
+TEST(FrameBufferPool, TrimFreesOnlyPooledBuffers) {
+  FrameBufferPool pool;
+  auto borrowed = pool.Acquire(FrameBytes);
+  pool.Acquire(FrameBytes);
+  pool.Acquire(100);
+  EXPECT_EQ(pool.GetBytesAllocated(), 2 * FrameClass + FrameBufferPool::MinBufferSize);
+
+  pool.Trim();
+  EXPECT_EQ(pool.GetBytesAllocated(), FrameClass);
+
+  borrowed.Reset();
+  EXPECT_EQ(pool.GetBytesAllocated(), FrameClass);
+  pool.Trim();
+  EXPECT_EQ(pool.GetBytesAllocated(), 0u);
+
+  auto misses = pool.GetMisses();
+  pool.Acquire(FrameBytes);
+  EXPECT_EQ(pool.GetMisses(), misses + 1);
+}
+
+TEST(FrameBufferPool, ReturnsAMovedBufferOnce) {
+  FrameBufferPool pool;
+  auto buffer = pool.Acquire(100);
+  auto data   = buffer.GetData();
+
+  PooledFrameBuffer moved(std::move(buffer));
+  EXPECT_FALSE(buffer);
+  EXPECT_EQ(moved.GetData(), data);
+
+  PooledFrameBuffer assigned;
+  assigned = std::move(moved);
+  EXPECT_FALSE(moved);
+  assigned.Reset();
+  EXPECT_FALSE(assigned);
+
+  // Only one copy went back to the pool, so only one request is served from it.
+  auto first  = pool.Acquire(100);
+  auto second = pool.Acquire(100);
+  EXPECT_EQ(first.GetData(), data);
+  EXPECT_NE(second.GetData(), data);
+  EXPECT_EQ(pool.GetHits(), 1u);
+}
+
+TEST(FrameBufferPool, NeverHandsTheSameBufferToTwoThreads) {
+  FrameBufferPool pool;
+  const int threadCount = 8;
+  const int iterations  = 20'000;
+
+  std::vector<std::thread> threads;
+  std::vector<int> collisions(threadCount);
+  for (int thread = 0; thread < threadCount; thread++) {
+    threads.emplace_back([&, thread] {
+      auto mark = static_cast<uint8_t>(thread + 1);
+      for (int i = 0; i < iterations; i++) {
+        // Hold one or two buffers of two size classes at a time.
+        auto first  = pool.Acquire(4'096);
+        auto second = pool.Acquire(i % 2 ? 8'192 : 100);
+        first.GetData()[0]  = mark;
+        second.GetData()[0] = mark;
+        std::this_thread::yield();
+        if (first.GetData()[0] != mark || second.GetData()[0] != mark) {
+          collisions[thread]++;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (int thread = 0; thread < threadCount; thread++) {
+    EXPECT_EQ(collisions[thread], 0) << "thread " << thread;
+  }
+  EXPECT_EQ(pool.GetHits() + pool.GetMisses(), uint64_t{2} * threadCount * iterations);
+
+  // Every buffer came back, and no more than each class keeps stayed allocated.
+  EXPECT_LE(pool.GetBytesAllocated(), FrameBufferPool::BuffersPerClass * (4'096 + 8'192));
+  pool.Trim();
+  EXPECT_EQ(pool.GetBytesAllocated(), 0u);
+}
@@ -0,0 +1,209 @@
+#include "frame-scheduler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace Downscaler::Cpp::Core::NativeImpls;
+
+namespace {
+  /**
+   * @brief A clock that only moves when it's told to, or when something sleeps on it.
+   */
+  class FakeClock : public IClock {
+    public:
+      int64_t now = 0;
+
+      int64_t NowMicroseconds() override {
+        return now;
+      }
+
+      void SleepUntil(int64_t microseconds) override {
+        if (microseconds > now) {
+          now = microseconds;
+        }
+      }
+  };
+
+  /**
+   * @brief Runs a scheduler for a number of slots while a source delivers frames at a fixed rate,
+   * and writes down what it presented: `N` for a new frame, `R` for a repeat and `B` for black.
+   */
+  std::string Present(FrameScheduler& scheduler, FakeClock& clock, double sourceRate, int slots) {
+    std::string actions;
+    int64_t frame = 0;
+    for (int slot = 0; slot < slots; slot++) {
+      // Deliver every frame that arrives by the time the slot begins.
+      auto slotTime = scheduler.GetNextSlotTime();
+      int64_t arrival;
+      while ((arrival = std::llround(static_cast<double>(frame) * 1'000'000.0 / sourceRate)) <=
+             slotTime) {
+        clock.now = std::max(clock.now, arrival);
+        scheduler.OnFrameArrived();
+        frame++;
+      }
+
+      switch (scheduler.WaitForNextSlot()) {
+        case PresentAction::PresentNewFrame:
+          actions += 'N';
+          break;
+        case PresentAction::RepeatFrame:
+          actions += 'R';
+          break;
+        case PresentAction::BlackFrame:
+          actions += 'B';
+          break;
+      }
+    }
+    return actions;
+  }
+
+  FrameSchedulerOptions Options(double targetRate, double sourceRate, bool blackFrames = false) {
+    FrameSchedulerOptions options;
+    options.targetRefreshRate   = targetRate;
+    options.sourceFrameRate     = sourceRate;
+    options.blackFrameInsertion = blackFrames;
+    return options;
+  }
+
+  /**
+   * @returns How many slots each presented frame was held for, leaving out the last one.
+   */
+  std::vector<int> HoldLengths(const std::string& actions) {
+    std::vector<int> lengths;
+    for (auto action : actions) {
+      if (action == 'N') {
+        lengths.push_back(1);
+      } else if (!lengths.empty()) {
+        lengths.back()++;
+      }
+    }
+    if (!lengths.empty()) {
+      lengths.pop_back();
+    }
+    return lengths;
+  }
+}
+
+TEST(FrameScheduler, HoldsEverySixtyHertzFrameForTwoSlotsAtOneHundredTwenty) {
+  FakeClock clock;
+  FrameScheduler scheduler(Options(120, 60), &clock);
+
+  auto actions = Present(scheduler, clock, 60, 240);
+  EXPECT_EQ(actions.substr(0, 8), "NRNRNRNR");
+  for (auto length : HoldLengths(actions)) {
+    EXPECT_EQ(length, 2);
+  }
+  EXPECT_EQ(scheduler.GetMissedSlots(), 0u);
+  EXPECT_LE(scheduler.GetCadenceErrorHistogram().GetMax(), 0);
+}
+
+TEST(FrameScheduler, AlternatesTwoAndThreeSlotsAtOneHundredFortyFour) {
+  FakeClock clock;
+  FrameScheduler scheduler(Options(144, 60), &clock);
+
+  // 144 / 60 = 2.4, so every five frames take two three-slot holds and three two-slot ones.
+  auto actions = Present(scheduler, clock, 60, 144 * 2);
+  EXPECT_EQ(std::count(actions.begin(), actions.end(), 'N'), 120);
+
+  auto lengths = HoldLengths(actions);
+  for (size_t i = 0; i + 5 <= lengths.size(); i += 5) {
+    int total = 0;
+    for (size_t j = i; j < i + 5; j++) {
+      EXPECT_TRUE(lengths[j] == 2 || lengths[j] == 3);
+      total += lengths[j];
+    }
+    EXPECT_EQ(total, 12);
+  }
+}
+
+TEST(FrameScheduler, SnapsAMeasuredFrameRateToADivisorOfTheRefreshRate) {
+  FakeClock clock;
+  FrameScheduler scheduler(Options(120, 0), &clock);
+  EXPECT_DOUBLE_EQ(scheduler.GetSourceFrameRate(), 120);
+
+  // About 59.9 Hz, with the frames arriving up to 200 µs early or late.
+  for (int frame = 0; frame < 60; frame++) {
+    clock.now = frame * 16'694 + (frame % 2 ? 200 : -200);
+    scheduler.OnFrameArrived();
+  }
+  EXPECT_DOUBLE_EQ(scheduler.GetSourceFrameRate(), 60);
+
+  // A frame rate between divisors is kept as measured.
+  FakeClock otherClock;
+  FrameScheduler other(Options(120, 0), &otherClock);
+  for (int frame = 0; frame < 60; frame++) {
+    otherClock.now = frame * 20'000;
+    other.OnFrameArrived();
+  }
+  EXPECT_NEAR(other.GetSourceFrameRate(), 50, 0.01);
+}
+
+TEST(FrameScheduler, InsertsBlackFramesBetweenLitSlots) {
+  FakeClock clock;
+  FrameScheduler scheduler(Options(120, 60, true), &clock);
+  EXPECT_EQ(Present(scheduler, clock, 60, 8), "NBNBNBNB");
+
+  FakeClock slowClock;
+  FrameScheduler slow(Options(144, 60, true), &slowClock);
+  auto actions = Present(slow, slowClock, 60, 144);
+  EXPECT_EQ(std::count(actions.begin(), actions.end(), 'R'), 0);
+  EXPECT_EQ(std::count(actions.begin(), actions.end(), 'N'), 60);
+
+  FrameSchedulerOptions twoLit = Options(240, 60, true);
+  twoLit.litSlotsPerFrame      = 2;
+  FakeClock fastClock;
+  FrameScheduler fast(twoLit, &fastClock);
+  EXPECT_EQ(Present(fast, fastClock, 60, 8), "NRBBNRBB");
+}
+
+TEST(FrameScheduler, OnlyInsertsBlackFramesWhenEveryFrameIsHeldTwice) {
+  FakeClock clock;
+  FrameScheduler scheduler(Options(90, 60, true), &clock);
+  auto actions = Present(scheduler, clock, 60, 90);
+  EXPECT_EQ(actions.find('B'), std::string::npos);
+}
+
+TEST(FrameScheduler, PresentsBlackUntilTheFirstFrame) {
+  FakeClock clock;
+  FrameScheduler scheduler(Options(120, 60), &clock);
+  EXPECT_EQ(scheduler.OnSlot(0), PresentAction::BlackFrame);
+  EXPECT_EQ(scheduler.OnSlot(8'333), PresentAction::BlackFrame);
+
+  clock.now = 10'000;
+  scheduler.OnFrameArrived();
+  EXPECT_EQ(scheduler.OnSlot(16'667), PresentAction::PresentNewFrame);
+}
+
+TEST(FrameScheduler, SkipsMissedSlotsInsteadOfCatchingUp) {
+  FakeClock clock;
+  FrameScheduler scheduler(Options(120, 60), &clock);
+  scheduler.OnFrameArrived();
+  EXPECT_EQ(scheduler.OnSlot(0), PresentAction::PresentNewFrame);
+
+  // Four slots pass before the next one is serviced, 2 µs late.
+  scheduler.OnSlot(41'669);
+  EXPECT_EQ(scheduler.GetMissedSlots(), 4u);
+  EXPECT_EQ(scheduler.GetNextSlotTime(), 50'000);
+  EXPECT_EQ(scheduler.GetCadenceErrorHistogram().GetMax(), 2);
+
+  // Late frames are presented on the next slot rather than waiting for the pattern.
+  clock.now = 45'000;
+  scheduler.OnFrameArrived();
+  EXPECT_EQ(scheduler.OnSlot(50'000), PresentAction::PresentNewFrame);
+  EXPECT_EQ(scheduler.OnSlot(58'333), PresentAction::RepeatFrame);
+}
+
+TEST(FrameScheduler, IsOnlyDueWithinAQuarterSlotOfTheIdealTime) {
+  FakeClock clock;
+  FrameScheduler scheduler(Options(60, 60), &clock);
+  scheduler.OnSlot(0);
+
+  // Vertical blanks at 144 Hz, pacing 60 Hz.
+  EXPECT_FALSE(scheduler.IsSlotDue(6'944));
+  EXPECT_FALSE(scheduler.IsSlotDue(12'499));
+  EXPECT_TRUE(scheduler.IsSlotDue(13'889));
+}
@@ -0,0 +1,169 @@
+#include "frame-statistics.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace Downscaler::Cpp::Core::NativeImpls;
+
+namespace {
+  /**
+   * @brief A tightly packed BGRA frame of a single gray level, whose luma is that level.
+   */
+  struct GrayFrame {
+    uint32_t width;
+    uint32_t height;
+    std::vector<uint8_t> pixels;
+
+    GrayFrame(uint32_t width, uint32_t height, uint8_t luma)
+      : width(width), height(height), pixels(static_cast<size_t>(width) * height * 4, luma) {}
+
+    /** @brief Sets the first `count` pixels to a gray level. */
+    void Fill(size_t count, uint8_t luma) {
+      std::fill(pixels.begin(), pixels.begin() + count * 4, luma);
+    }
+
+    ConstImageView GetView() const {
+      return {pixels.data(), width, height, static_cast<size_t>(width) * 4};
+    }
+  };
+
+  const FrameStatistics& Analyze(FrameStatisticsAccumulator& accumulator, const GrayFrame& frame) {
+    accumulator.Begin();
+    accumulator.AccumulateImage(frame.GetView());
+    return accumulator.Finish();
+  }
+
+  /**
+   * @brief Feeds the detector a sequence of frames, `B` for black and `.` for not black.
+   * @returns The transitions, `S` where a black screen started, `E` where it ended and `.`
+   * elsewhere.
+   */
+  std::string Detect(BlackScreenDetector& detector, const std::string& frames) {
+    std::string transitions;
+    for (auto frame : frames) {
+      switch (detector.Update(frame == 'B')) {
+        case BlackScreenTransition::Started:
+          transitions += 'S';
+          break;
+        case BlackScreenTransition::Ended:
+          transitions += 'E';
+          break;
+        default:
+          transitions += '.';
+          break;
+      }
+    }
+    return transitions;
+  }
+}
+
+TEST(FrameStatistics, ComputesLumaOfEachChannel) {
+  FrameStatisticsAccumulator accumulator;
+  uint8_t pixels[] = {
+    255, 0, 0, 255, // Blue
+    0, 255, 0, 255, // Green
+    0, 0, 255, 255  // Red
+  };
+  accumulator.Begin();
+  accumulator.AccumulateRow(pixels, 3);
+  auto& statistics = accumulator.Finish();
+
+  EXPECT_EQ(statistics.pixelCount, 3u);
+  EXPECT_EQ(statistics.minLuma, 19);
+  EXPECT_EQ(statistics.maxLuma, 182);
+  EXPECT_EQ(statistics.histogram[19], 1u);
+  EXPECT_EQ(statistics.histogram[54], 1u);
+  EXPECT_EQ(statistics.histogram[182], 1u);
+  EXPECT_DOUBLE_EQ(statistics.meanLuma, (19.0 + 54.0 + 182.0) / 3.0);
+}
+
+TEST(FrameStatistics, TreatsLumaUpToTheThresholdAsBlack) {
+  FrameStatisticsAccumulator accumulator(24, 0.0);
+  EXPECT_TRUE(Analyze(accumulator, GrayFrame(16, 16, 0)).isBlack);
+  EXPECT_TRUE(Analyze(accumulator, GrayFrame(16, 16, 24)).isBlack);
+  EXPECT_FALSE(Analyze(accumulator, GrayFrame(16, 16, 25)).isBlack);
+}
+
+TEST(FrameStatistics, AllowsUpToTheToleratedFractionOfBrightPixels) {
+  // 0.1% of a 100 x 100 frame is 10 pixels.
+  FrameStatisticsAccumulator accumulator(24, 0.001);
+  GrayFrame frame(100, 100, 0);
+
+  frame.Fill(10, 255);
+  EXPECT_TRUE(Analyze(accumulator, frame).isBlack);
+
+  frame.Fill(11, 255);
+  EXPECT_FALSE(Analyze(accumulator, frame).isBlack);
+}
+
+TEST(FrameStatistics, TreatsAnEmptyFrameAsBlack) {
+  FrameStatisticsAccumulator accumulator;
+  accumulator.Begin();
+  auto& statistics = accumulator.Finish();
+  EXPECT_TRUE(statistics.isBlack);
+  EXPECT_EQ(statistics.pixelCount, 0u);
+  EXPECT_EQ(statistics.meanLuma, 0.0);
+}
+
+TEST(FrameStatistics, BeginResetsTheCounters) {
+  FrameStatisticsAccumulator accumulator;
+  Analyze(accumulator, GrayFrame(8, 8, 200));
+
+  auto& statistics = Analyze(accumulator, GrayFrame(4, 2, 10));
+  EXPECT_EQ(statistics.pixelCount, 8u);
+  EXPECT_EQ(statistics.histogram[200], 0u);
+  EXPECT_EQ(statistics.histogram[10], 8u);
+  EXPECT_EQ(statistics.minLuma, 10);
+  EXPECT_EQ(statistics.maxLuma, 10);
+  EXPECT_TRUE(statistics.isBlack);
+
+  // The last finished frame stays available while the next one is accumulated.
+  accumulator.Begin();
+  accumulator.AccumulateImage(GrayFrame(8, 8, 200).GetView());
+  EXPECT_EQ(accumulator.GetStatistics().pixelCount, 8u);
+}
+
+TEST(BlackScreenDetector, StartsAndEndsAfterTheDebounceFrames) {
+  BlackScreenDetector detector;
+  EXPECT_EQ(Detect(detector, "..BBBBB...."), "....S....E.");
+  EXPECT_FALSE(detector.IsBlackScreen());
+}
+
+TEST(BlackScreenDetector, ResetsTheCountWhenAFrameDisagrees) {
+  BlackScreenDetector detector;
+
+  // Single dark frames, and pairs of them, never start a black screen.
+  EXPECT_EQ(Detect(detector, ".B.BB.B.BB."), "...........");
+  EXPECT_FALSE(detector.IsBlackScreen());
+
+  EXPECT_EQ(Detect(detector, "BBB"), "..S");
+  EXPECT_TRUE(detector.IsBlackScreen());
+
+  // Nor do bright frames in between black ones end it.
+  EXPECT_EQ(Detect(detector, "B.B..B..B"), ".........");
+  EXPECT_TRUE(detector.IsBlackScreen());
+  EXPECT_EQ(Detect(detector, "..."), "..E");
+}
+
+TEST(BlackScreenDetector, ReportsEveryChangeWithoutDebouncing) {
+  BlackScreenDetector detector(1);
+  EXPECT_EQ(Detect(detector, "BB.B.."), "S.ESE.");
+
+  // Fewer than one frame means no debouncing too.
+  BlackScreenDetector immediate(0);
+  EXPECT_EQ(Detect(immediate, "B."), "SE");
+}
+
+TEST(BlackScreenDetector, ResetForgetsTheBlackScreen) {
+  BlackScreenDetector detector;
+  Detect(detector, "BBBB..");
+  detector.Reset();
+  EXPECT_FALSE(detector.IsBlackScreen());
+
+  // The frames counted before the reset don't count towards ending it.
+  EXPECT_EQ(Detect(detector, ".BB"), "...");
+  EXPECT_EQ(Detect(detector, "B"), "S");
+}
@@ -0,0 +1,84 @@
+#include "image-view.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace Downscaler::Cpp::Core::NativeImpls;
+
+namespace {
+  /**
+   * @brief A frame whose rows are padded to an odd stride, with every byte of a pixel set to
+   * `16 * y + x`, so a pixel read through a view identifies where it came from.
+   */
+  struct PaddedFrame {
+    static constexpr uint32_t width  = 7;
+    static constexpr uint32_t height = 5;
+    static constexpr size_t stride   = width * ConstImageView::BytesPerPixel + 3;
+
+    std::vector<uint8_t> pixels = std::vector<uint8_t>(stride * height);
+
+    PaddedFrame() {
+      for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+          for (size_t channel = 0; channel < ConstImageView::BytesPerPixel; channel++) {
+            pixels[stride * y + ConstImageView::BytesPerPixel * x + channel] = Value(x, y);
+          }
+        }
+      }
+    }
+
+    ConstImageView GetView() const {
+      return {pixels.data(), width, height, stride};
+    }
+
+    static uint8_t Value(uint32_t x, uint32_t y) {
+      return static_cast<uint8_t>(16 * y + x);
+    }
+  };
+
+  uint8_t GetPixel(const ConstImageView& view, uint32_t x, uint32_t y) {
+    return view.GetRow(y)[ConstImageView::BytesPerPixel * x];
+  }
+}
+
+TEST(ImageView, CropKeepsAnOddStride) {
+  PaddedFrame frame;
+  auto view = frame.GetView().Crop({1, 1, 5, 3});
+
+  ASSERT_EQ(view.width, 5u);
+  ASSERT_EQ(view.height, 3u);
+  EXPECT_EQ(view.stride, PaddedFrame::stride);
+  for (uint32_t y = 0; y < view.height; y++) {
+    for (uint32_t x = 0; x < view.width; x++) {
+      EXPECT_EQ(GetPixel(view, x, y), PaddedFrame::Value(x + 1, y + 1));
+    }
+  }
+}
+
+TEST(ImageView, CropClampsToTheBorder) {
+  PaddedFrame frame;
+
+  auto corner = frame.GetView().Crop({6, 4, 10, 10});
+  ASSERT_EQ(corner.width, 1u);
+  ASSERT_EQ(corner.height, 1u);
+  EXPECT_EQ(GetPixel(corner, 0, 0), PaddedFrame::Value(6, 4));
+
+  auto bottomRow = frame.GetView().Crop({0, 4, 7, 2});
+  ASSERT_EQ(bottomRow.width, 7u);
+  ASSERT_EQ(bottomRow.height, 1u);
+  EXPECT_EQ(GetPixel(bottomRow, 6, 0), PaddedFrame::Value(6, 4));
+
+  EXPECT_TRUE(frame.GetView().Crop({9, 9, 3, 3}).IsEmpty());
+  EXPECT_TRUE(frame.GetView().Crop({7, 0, 1, 5}).IsEmpty());
+}
+
+TEST(ImageView, CropOfACropIsRelativeToIt) {
+  PaddedFrame frame;
+  auto view = frame.GetView().Crop({1, 1, 6, 4}).Crop({2, 1, 10, 10});
+
+  ASSERT_EQ(view.width, 4u);
+  ASSERT_EQ(view.height, 3u);
+  EXPECT_EQ(GetPixel(view, 0, 0), PaddedFrame::Value(3, 2));
+  EXPECT_EQ(GetPixel(view, 3, 2), PaddedFrame::Value(6, 4));
+}
@@ -0,0 +1,101 @@
+#include "input-forwarder.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace Downscaler::Cpp::Core::NativeImpls;
+
+namespace {
+  constexpr uint32_t wmKeyDown        = 0x0100;
+  constexpr uint32_t wmLButtonDown    = 0x0201;
+  constexpr uint32_t wmLButtonUp      = 0x0202;
+  constexpr uint32_t wmMouseWheel     = 0x020A;
+  constexpr uint64_t sourceWindow     = 1;
+  constexpr int64_t previousKeyState  = 1 << 30;
+
+  class RecordingSink : public IMessageSink {
+    public:
+      std::vector<ForwardedMessage> messages;
+
+      bool Post(const ForwardedMessage& message) override {
+        messages.push_back(message);
+        return true;
+      }
+  };
+
+  /**
+   * @brief Forwards from a 100x100 downscaled window at (100, 100) to a 400x400 source window at
+   * (1000, 0), which has a child covering it and a grandchild in the middle.
+   */
+  struct InputForwarderTest : testing::Test {
+    RecordingSink sink;
+    InputForwarder forwarder{&sink};
+    CoordinateMapper mapper;
+    ChildWindowIndex children;
+
+    InputForwarderTest() {
+      mapper.Update({100, 100, 100, 100, 0, 0}, {1000, 0, 400, 400, 0, 0});
+
+      ChildWindowRect rects[] = {{10, 0, 0, 200, 200}, {11, 50, 50, 150, 150}};
+      children.Update(rects, 2);
+    }
+
+    static int64_t MakePoint(int32_t x, int32_t y) {
+      return (static_cast<int64_t>(y) << 16) | x;
+    }
+  };
+}
+
+TEST_F(InputForwarderTest, DropsInputWithoutASourceWindow) {
+  EXPECT_FALSE(forwarder.QueueKey(wmKeyDown, 'A', 1));
+  EXPECT_EQ(forwarder.GetPendingCount(), 0u);
+}
+
+TEST_F(InputForwarderTest, DropsClicksOutsideTheSourceWindow) {
+  forwarder.SetSourceWindow(sourceWindow);
+  EXPECT_FALSE(forwarder.QueueMouse(wmLButtonDown, 1, 50, 50, mapper, &children));
+}
+
+TEST_F(InputForwarderTest, SendsClicksToTheDeepestChild) {
+  forwarder.SetSourceWindow(sourceWindow);
+
+  // (130, 130) is (30, 30) in the downscaled window, so (120, 120) in the source window.
+  ASSERT_TRUE(forwarder.QueueMouse(wmLButtonDown, 1, 130, 130, mapper, &children));
+  ASSERT_TRUE(forwarder.QueueMouse(wmLButtonUp, 0, 130, 130, mapper, &children));
+  ASSERT_EQ(forwarder.Flush(), 2u);
+
+  ASSERT_EQ(sink.messages.size(), 2u);
+  EXPECT_EQ(sink.messages[0].target, 11u);
+  EXPECT_EQ(sink.messages[0].message, wmLButtonDown);
+  EXPECT_EQ(sink.messages[0].lParam, MakePoint(70, 70));
+  EXPECT_EQ(sink.messages[1].message, wmLButtonUp);
+}
+
+TEST_F(InputForwarderTest, BatchesRepeatsAndWheelRotations) {
+  forwarder.SetSourceWindow(sourceWindow);
+  ASSERT_TRUE(forwarder.QueueMouse(wmLButtonDown, 1, 130, 130, mapper, &children));
+  for (int i = 0; i < 5; i++) {
+    ASSERT_TRUE(forwarder.QueueKey(wmKeyDown, 'A', (i ? previousKeyState : 0) | 1));
+  }
+  for (int i = 0; i < 3; i++) {
+    ASSERT_TRUE(forwarder.QueueMouse(wmMouseWheel, 120 << 16, 130, 130, mapper, nullptr));
+  }
+  ASSERT_EQ(forwarder.Flush(), 4u);
+
+  const auto& messages = sink.messages;
+  ASSERT_EQ(messages.size(), 4u);
+
+  // Keys go to the child that was clicked last, with the auto-repeats merged into one message.
+  EXPECT_EQ(messages[1].target, 11u);
+  EXPECT_EQ(messages[1].lParam, 1);
+  EXPECT_EQ(messages[2].target, 11u);
+  EXPECT_EQ(messages[2].lParam & 0xFFFF, 4);
+
+  // Wheel messages go to the source window in screen coordinates, with the rotations summed.
+  EXPECT_EQ(messages[3].target, sourceWindow);
+  EXPECT_EQ(messages[3].wParam >> 16, 360u);
+  EXPECT_EQ(messages[3].lParam, MakePoint(1120, 120));
+
+  EXPECT_EQ(forwarder.GetPendingCount(), 0u);
+}
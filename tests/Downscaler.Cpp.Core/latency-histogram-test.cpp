@@ -0,0 +1,92 @@
+#include "latency-histogram.h"
+
+#include <cstdlib>
+#include <random>
+
+#include <gtest/gtest.h>
+
+using namespace Downscaler::Cpp::Core::NativeImpls;
+
+TEST(LatencyHistogram, IsEmptyUntilASampleIsRecorded) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.GetCount(), 0u);
+  EXPECT_EQ(histogram.GetMin(), 0);
+  EXPECT_EQ(histogram.GetMax(), 0);
+  EXPECT_EQ(histogram.GetMean(), 0.0);
+  EXPECT_EQ(histogram.GetPercentile(50), 0);
+}
+
+TEST(LatencyHistogram, KeepsSmallSamplesExact) {
+  LatencyHistogram histogram;
+  for (int sample = 1; sample <= 50; sample++) {
+    histogram.Record(sample);
+  }
+
+  EXPECT_EQ(histogram.GetCount(), 50u);
+  EXPECT_EQ(histogram.GetMin(), 1);
+  EXPECT_EQ(histogram.GetMax(), 50);
+  EXPECT_DOUBLE_EQ(histogram.GetMean(), 25.5);
+  EXPECT_EQ(histogram.GetPercentile(0), 1);
+  EXPECT_EQ(histogram.GetPercentile(50), 25);
+  EXPECT_EQ(histogram.GetPercentile(90), 45);
+  EXPECT_EQ(histogram.GetPercentile(100), 50);
+}
+
+TEST(LatencyHistogram, RecordsNegativeSamplesAsTheirMagnitude) {
+  LatencyHistogram histogram;
+  histogram.Record(-40);
+  histogram.Record(40);
+  EXPECT_EQ(histogram.GetMin(), 40);
+  EXPECT_EQ(histogram.GetPercentile(100), 40);
+}
+
+TEST(LatencyHistogram, BoundsThePercentileErrorForLargeSamples) {
+  LatencyHistogram histogram;
+  for (int64_t sample = 1; sample <= 100'000; sample++) {
+    histogram.Record(sample);
+  }
+
+  for (double percentile : {1.0, 10.0, 50.0, 90.0, 99.0, 99.9, 100.0}) {
+    auto expected = percentile * 1'000;
+    auto actual   = static_cast<double>(histogram.GetPercentile(percentile));
+    EXPECT_LE(std::abs(actual - expected) / expected, 0.032) << percentile;
+  }
+
+  EXPECT_EQ(histogram.GetMax(), 100'000);
+  EXPECT_DOUBLE_EQ(histogram.GetMean(), 50'000.5);
+}
+
+TEST(LatencyHistogram, ClampsSamplesBeyondTheLastBucket) {
+  LatencyHistogram histogram;
+  constexpr int64_t lastBucket = int64_t{1} << 40;
+  constexpr int64_t huge       = int64_t{1} << 50;
+
+  histogram.Record(10);
+  histogram.Record(int64_t{1} << 45);
+  histogram.Record(huge);
+
+  // The extremes are exact, while the samples beyond 2^40 µs share the last bucket.
+  EXPECT_EQ(histogram.GetMax(), huge);
+  EXPECT_EQ(histogram.GetPercentile(0), 10);
+  auto last = histogram.GetPercentile(100);
+  EXPECT_GT(last, lastBucket);
+  EXPECT_LT(last, 2 * lastBucket);
+  EXPECT_EQ(histogram.GetPercentile(60), last);
+}
+
+TEST(LatencyHistogram, ResetDiscardsEverySample) {
+  LatencyHistogram histogram;
+  std::mt19937 random(26);
+  for (int i = 0; i < 1000; i++) {
+    histogram.Record(random() % 100'000);
+  }
+
+  histogram.Reset();
+  EXPECT_EQ(histogram.GetCount(), 0u);
+  EXPECT_EQ(histogram.GetMax(), 0);
+  EXPECT_EQ(histogram.GetPercentile(99), 0);
+
+  histogram.Record(7);
+  EXPECT_EQ(histogram.GetMin(), 7);
+  EXPECT_EQ(histogram.GetPercentile(50), 7);
+}
@@ -0,0 +1,102 @@
+#include "mouse-move-coalescer.h"
+
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using namespace Downscaler::Cpp::Core::NativeImpls;
+
+namespace {
+  /**
+   * @brief A clock that only moves when it's told to, or when something sleeps on it.
+   */
+  class FakeClock : public IClock {
+    public:
+      int64_t now = 0;
+
+      int64_t NowMicroseconds() override {
+        return now;
+      }
+
+      void SleepUntil(int64_t microseconds) override {
+        if (microseconds > now) {
+          now = microseconds;
+        }
+      }
+  };
+}
+
+TEST(MouseMoveCoalescer, ForwardsTheLeadingMoveAndHoldsBackTheRest) {
+  FakeClock clock;
+  MouseMoveCoalescer coalescer(100, &clock);
+  int32_t x, y;
+
+  EXPECT_TRUE(coalescer.Submit(1, 1));
+  clock.now = 1000;
+  EXPECT_FALSE(coalescer.Submit(2, 2));
+  clock.now = 5000;
+  EXPECT_FALSE(coalescer.Submit(3, 3));
+
+  EXPECT_FALSE(coalescer.TakeTrailingMove(9999, x, y));
+  ASSERT_TRUE(coalescer.TakeTrailingMove(10000, x, y));
+  EXPECT_EQ(x, 3);
+  EXPECT_EQ(y, 3);
+  EXPECT_FALSE(coalescer.TakeTrailingMove(30000, x, y));
+
+  EXPECT_EQ(coalescer.GetSubmitted(), 3u);
+  EXPECT_EQ(coalescer.GetForwarded(), 2u);
+}
+
+TEST(MouseMoveCoalescer, LeadingMoveReplacesAHeldBackOne) {
+  FakeClock clock;
+  MouseMoveCoalescer coalescer(100, &clock);
+  int32_t x, y;
+
+  clock.now = 30000;
+  EXPECT_TRUE(coalescer.Submit(4, 4));
+  clock.now = 30001;
+  EXPECT_FALSE(coalescer.Submit(5, 5));
+  clock.now = 40001;
+  EXPECT_TRUE(coalescer.Submit(6, 6));
+  EXPECT_FALSE(coalescer.TakeTrailingMove(50000, x, y));
+}
+
+TEST(MouseMoveCoalescer, WaitSleepsUntilTheTrailingEdge) {
+  FakeClock clock;
+  MouseMoveCoalescer coalescer(100, &clock);
+  int32_t x, y;
+
+  clock.now = 40001;
+  EXPECT_TRUE(coalescer.Submit(6, 6));
+  clock.now = 40002;
+  EXPECT_FALSE(coalescer.Submit(7, 7));
+
+  ASSERT_TRUE(coalescer.WaitForTrailingMove(x, y));
+  EXPECT_EQ(x, 7);
+  EXPECT_EQ(clock.now, 50001);
+}
+
+TEST(MouseMoveCoalescer, ZeroRateForwardsEveryMove) {
+  FakeClock clock;
+  MouseMoveCoalescer coalescer(100, &clock);
+
+  coalescer.SetRate(0);
+  EXPECT_TRUE(coalescer.Submit(1, 1));
+  EXPECT_TRUE(coalescer.Submit(1, 1));
+}
+
+TEST(MouseMoveCoalescer, StopWakesTheWaiter) {
+  MouseMoveCoalescer coalescer(60);
+
+  bool taken = true;
+  std::thread waiter([&] {
+    int32_t x, y;
+    taken = coalescer.WaitForTrailingMove(x, y);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  coalescer.Stop();
+  waiter.join();
+
+  EXPECT_FALSE(taken);
+}
@@ -0,0 +1,103 @@
+#include "raw-input-coalescer.h"
+
+#include <gtest/gtest.h>
+
+using namespace Downscaler::Cpp::Core::NativeImpls;
+
+namespace {
+  constexpr uint16_t leftButtonDown = 0x0001;
+  constexpr uint16_t leftButtonUp   = 0x0002;
+  constexpr uint16_t wheel          = 0x0400;
+
+  MouseInputEvent Move(int32_t x, int32_t y) {
+    MouseInputEvent event;
+    event.x = x;
+    event.y = y;
+    return event;
+  }
+
+  MouseInputEvent Buttons(uint16_t buttonFlags, int16_t wheelDelta = 0) {
+    MouseInputEvent event;
+    event.buttonFlags = buttonFlags;
+    event.wheelDelta  = wheelDelta;
+    return event;
+  }
+}
+
+TEST(RawInputCoalescer, SumsRelativeMotion) {
+  RawInputCoalescer coalescer;
+  coalescer.Begin();
+  coalescer.Add(Move(5, -1));
+  coalescer.Add(Move(3, 2));
+
+  const auto& batch = coalescer.GetBatch();
+  EXPECT_EQ(batch.eventCount, 2u);
+  EXPECT_EQ(batch.deltaX, 8);
+  EXPECT_EQ(batch.deltaY, 1);
+  EXPECT_TRUE(batch.HasMotion());
+  EXPECT_TRUE(batch.transitions.empty());
+}
+
+TEST(RawInputCoalescer, KeepsTheLastAbsolutePosition) {
+  RawInputCoalescer coalescer;
+  coalescer.Begin();
+
+  auto event       = Move(100, 200);
+  event.isAbsolute = true;
+  coalescer.Add(event);
+  event.x = 300;
+  coalescer.Add(event);
+
+  const auto& batch = coalescer.GetBatch();
+  EXPECT_TRUE(batch.hasAbsolutePosition);
+  EXPECT_EQ(batch.absoluteX, 300);
+  EXPECT_EQ(batch.absoluteY, 200);
+  EXPECT_EQ(batch.deltaX, 0);
+}
+
+TEST(RawInputCoalescer, KeepsButtonTransitionsInOrderWithTheirMotion) {
+  RawInputCoalescer coalescer;
+  coalescer.Begin();
+  coalescer.Add(Buttons(leftButtonUp));
+  coalescer.Add(Move(5, 0));
+  coalescer.Add(Buttons(leftButtonDown));
+
+  const auto& transitions = coalescer.GetBatch().transitions;
+  ASSERT_EQ(transitions.size(), 2u);
+  EXPECT_EQ(transitions[0].buttonFlags, leftButtonUp);
+  EXPECT_EQ(transitions[0].deltaX, 0);
+  EXPECT_EQ(transitions[1].buttonFlags, leftButtonDown);
+  EXPECT_EQ(transitions[1].deltaX, 5);
+}
+
+TEST(RawInputCoalescer, MergesWheelRotationsOnlyWithoutMotionInBetween) {
+  RawInputCoalescer coalescer;
+  coalescer.Begin();
+  coalescer.Add(Buttons(leftButtonDown));
+  coalescer.Add(Buttons(wheel, -120));
+  coalescer.Add(Buttons(wheel, -120));
+  coalescer.Add(Move(5, 0));
+  coalescer.Add(Buttons(wheel, -120));
+
+  const auto& batch = coalescer.GetBatch();
+  ASSERT_EQ(batch.transitions.size(), 3u);
+  EXPECT_EQ(batch.transitions[0].buttonFlags, leftButtonDown);
+  EXPECT_EQ(batch.transitions[1].wheelDelta, -240);
+  EXPECT_EQ(batch.transitions[2].wheelDelta, -120);
+  EXPECT_EQ(batch.transitions[2].deltaX, 5);
+  EXPECT_EQ(batch.deltaX, 5);
+}
+
+TEST(RawInputCoalescer, BeginKeepsTheTransitionsCapacity) {
+  RawInputCoalescer coalescer;
+  coalescer.Begin();
+  for (int i = 0; i < 4; i++) {
+    coalescer.Add(Buttons(i % 2 ? leftButtonUp : leftButtonDown));
+  }
+
+  coalescer.Begin();
+  const auto& batch = coalescer.GetBatch();
+  EXPECT_EQ(batch.eventCount, 0u);
+  EXPECT_TRUE(batch.transitions.empty());
+  EXPECT_GE(batch.transitions.capacity(), 4u);
+}
@@ -0,0 +1,56 @@
+#include "region-of-interest.h"
+
+#include <gtest/gtest.h>
+
+using namespace Downscaler::Cpp::Core::NativeImpls;
+
+TEST(RegionOfInterest, IsValidOnlyForTheFrameSizeItWasUpdatedFor) {
+  RegionOfInterest region;
+  EXPECT_FALSE(region.IsValidFor(7, 5));
+
+  auto clamped = region.Update(7, 5, {2, 1, 100, 100});
+  EXPECT_EQ(clamped, (FrameRegion{2, 1, 5, 4}));
+  EXPECT_EQ(region.GetRegion(), clamped);
+  EXPECT_TRUE(region.IsValidFor(7, 5));
+  EXPECT_FALSE(region.IsValidFor(8, 5));
+  EXPECT_EQ(region.GetUpdateCount(), 1u);
+}
+
+TEST(RegionOfInterest, InvalidateMakesItStale) {
+  RegionOfInterest region;
+  region.Update(7, 5, {0, 0, 7, 5});
+
+  region.Invalidate();
+  EXPECT_FALSE(region.IsValidFor(7, 5));
+  region.Update(7, 5, {0, 0, 7, 5});
+  EXPECT_TRUE(region.IsValidFor(7, 5));
+}
+
+TEST(RegionOfInterest, UpdateDoesNotVouchForAnInvalidationDuringIt) {
+  RegionOfInterest region;
+  region.Update(7, 5, {0, 0, 7, 5});
+
+  region.Invalidate();
+  EXPECT_FALSE(region.IsValidFor(7, 5));
+  region.Invalidate();
+  region.Update(7, 5, {0, 0, 1, 1});
+  EXPECT_FALSE(region.IsValidFor(7, 5));
+
+  region.Update(7, 5, {0, 0, 1, 1});
+  EXPECT_TRUE(region.IsValidFor(7, 5));
+}
+
+TEST(RegionOfInterest, ViewsTheRegionOfAFrame) {
+  const size_t stride = 8 * ConstImageView::BytesPerPixel + 4;
+  uint8_t pixels[stride * 8] = {};
+  ConstImageView frame(pixels, 8, 8, stride);
+
+  RegionOfInterest region;
+  region.Update(8, 8, {6, 3, 4, 2});
+
+  auto view = region.GetView(frame);
+  EXPECT_EQ(view.pixels, frame.GetRow(3) + 6 * ConstImageView::BytesPerPixel);
+  EXPECT_EQ(view.width, 2u);
+  EXPECT_EQ(view.height, 2u);
+  EXPECT_EQ(view.stride, frame.stride);
+}
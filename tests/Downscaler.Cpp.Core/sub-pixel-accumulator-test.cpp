@@ -0,0 +1,110 @@
+#include "sub-pixel-accumulator.h"
+
+#include <set>
+
+#include <gtest/gtest.h>
+
+using namespace Downscaler::Cpp::Core::NativeImpls;
+
+namespace {
+  /**
+   * @brief Maps a downscaled window at the origin onto a source window with a title bar and
+   * borders.
+   */
+  struct Mapper : CoordinateMapper {
+    Mapper(
+      int32_t downscaledWidth,
+      int32_t downscaledHeight,
+      int32_t sourceWidth,
+      int32_t sourceHeight
+    ) {
+      Update(
+        {0, 0, downscaledWidth, downscaledHeight, 0, 0},
+        {0, 0, sourceWidth, sourceHeight, 8, 31}
+      );
+    }
+  };
+}
+
+TEST(SubPixelAccumulator, ReachesEverySourcePixelWithinTheCursorsBlock) {
+  for (int ratio : {1, 2, 3, 4, 8}) {
+    Mapper mapper(400, 300, 400 * ratio, 300 * ratio);
+    SubPixelAccumulator accumulator(1.0 / ratio);
+
+    // The cursor moves one pixel every `ratio` counts, while each count is one source pixel.
+    int32_t cursor = 100;
+    accumulator.Accumulate(mapper, cursor, 50, 0, 0);
+
+    std::set<int32_t> reached;
+    const int counts = 40 * ratio;
+    for (int count = 1; count <= counts; count++) {
+      if (count % ratio == 0) {
+        cursor++;
+      }
+
+      auto point = accumulator.Accumulate(mapper, cursor, 50, 1, 0);
+      ASSERT_GE(point.x, cursor * ratio) << "ratio " << ratio;
+      ASSERT_LT(point.x, (cursor + 1) * ratio) << "ratio " << ratio;
+      reached.insert(point.x);
+    }
+    EXPECT_GE(static_cast<int>(reached.size()), counts - ratio) << "ratio " << ratio;
+  }
+}
+
+TEST(SubPixelAccumulator, StaysWithinTheBlockForANonIntegerRatio) {
+  Mapper mapper(400, 300, 1000, 750);
+  SubPixelAccumulator accumulator(1.0);
+
+  for (int32_t cursor = 0; cursor < 50; cursor++) {
+    auto point = accumulator.Accumulate(mapper, cursor, 0, cursor ? 1 : 0, 0);
+    EXPECT_GE(point.x, cursor * 1000 / 400);
+    EXPECT_LT(point.x, ((cursor + 1) * 1000 + 399) / 400);
+  }
+}
+
+TEST(SubPixelAccumulator, FollowsTheCursorWhenTheSourceIsSmaller) {
+  Mapper mapper(800, 600, 400, 300);
+  SubPixelAccumulator accumulator(1.0);
+
+  for (int32_t cursor = 0; cursor < 50; cursor++) {
+    EXPECT_EQ(accumulator.Accumulate(mapper, cursor, 0, 1, 0).x, cursor / 2);
+  }
+}
+
+TEST(SubPixelAccumulator, IsDeterministic) {
+  Mapper mapper(400, 300, 1600, 1200);
+  SubPixelAccumulator first(0.25), second(0.25);
+
+  for (int i = 0; i < 1000; i++) {
+    int32_t cursor = (i * 7) % 400;
+    auto a         = first.Accumulate(mapper, cursor, cursor / 2, i % 5 - 2, i % 3 - 1);
+    auto b         = second.Accumulate(mapper, cursor, cursor / 2, i % 5 - 2, i % 3 - 1);
+    ASSERT_EQ(a.fixedX, b.fixedX);
+    ASSERT_EQ(a.fixedY, b.fixedY);
+  }
+}
+
+TEST(SubPixelAccumulator, StartsFromTheCentreOfTheBlockAfterAResetOrAJump) {
+  Mapper mapper(400, 300, 1600, 1200);
+  SubPixelAccumulator accumulator(0.25);
+
+  accumulator.Reset();
+  auto point = accumulator.Accumulate(mapper, 10, 10, 0, 0);
+  EXPECT_EQ(point.fixedX, (40 << SubPixelAccumulator::FractionBits) +
+                            ((4 << SubPixelAccumulator::FractionBits) - 1) / 2);
+  EXPECT_EQ(point.x, 41);
+
+  EXPECT_EQ(accumulator.Accumulate(mapper, 200, 10, 0, 0).x, 801);
+}
+
+TEST(SubPixelAccumulator, HandlesANegativeCursorAndNoGeometry) {
+  Mapper mapper(400, 300, 1600, 1200);
+  SubPixelAccumulator accumulator(0.25);
+
+  auto point = accumulator.Accumulate(mapper, -1, 0, 0, 0);
+  EXPECT_GE(point.x, -4);
+  EXPECT_LT(point.x, 0);
+
+  Mapper empty(0, 0, 0, 0);
+  EXPECT_EQ(accumulator.Accumulate(empty, 5, 5, 3, 3).x, 5);
+}
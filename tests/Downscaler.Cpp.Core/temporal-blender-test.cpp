@@ -0,0 +1,175 @@
+#include "temporal-blender.h"
+
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace Downscaler::Cpp::Core::NativeImpls;
+
+namespace {
+  /** @brief Padding after each row, so rows of the frames never start 16-byte aligned. */
+  const size_t RowPadding = 12;
+
+  /**
+   * @brief A frame of random pixels, with padded rows.
+   */
+  struct Frame {
+    uint32_t width;
+    uint32_t height;
+    size_t stride;
+    std::vector<uint8_t> pixels;
+
+    Frame(uint32_t width, uint32_t height, std::mt19937& random)
+      : width(width),
+        height(height),
+        stride(width * ConstImageView::BytesPerPixel + RowPadding),
+        pixels(stride * height) {
+      std::uniform_int_distribution<int> bytes(0, 255);
+      for (auto& byte : pixels) {
+        byte = static_cast<uint8_t>(bytes(random));
+      }
+    }
+
+    ImageView GetView() {
+      return {pixels.data(), width, height, stride};
+    }
+  };
+
+  /**
+   * @brief Blends one byte at a time, exactly as the blender documents it: the weighted sum of the
+   * frames, newest first, rounded half-up.
+   */
+  std::vector<uint8_t> BlendBytes(
+    const std::deque<Frame>& frames,
+    const std::vector<uint16_t>& weights
+  ) {
+    auto& newest  = frames.front();
+    auto rowBytes = newest.width * ConstImageView::BytesPerPixel;
+    std::vector<uint8_t> blended(rowBytes * newest.height);
+    for (uint32_t row = 0; row < newest.height; row++) {
+      for (size_t column = 0; column < rowBytes; column++) {
+        uint32_t sum = TemporalBlender::WeightScale / 2;
+        for (size_t age = 0; age < weights.size(); age++) {
+          sum += frames[age].pixels[frames[age].stride * row + column] * weights[age];
+        }
+        blended[rowBytes * row + column] = static_cast<uint8_t>(sum >> 8);
+      }
+    }
+    return blended;
+  }
+
+  /**
+   * @brief Splits `WeightScale` into `count` random weights.
+   */
+  std::vector<uint16_t> RandomWeights(uint32_t count, std::mt19937& random) {
+    std::uniform_int_distribution<uint32_t> cuts(0, TemporalBlender::WeightScale);
+    std::vector<uint32_t> bounds = {0, TemporalBlender::WeightScale};
+    for (uint32_t i = 1; i < count; i++) {
+      bounds.push_back(cuts(random));
+    }
+    std::sort(bounds.begin(), bounds.end());
+
+    std::vector<uint16_t> weights;
+    for (uint32_t i = 0; i < count; i++) {
+      weights.push_back(static_cast<uint16_t>(bounds[i + 1] - bounds[i]));
+    }
+    return weights;
+  }
+
+  /**
+   * @brief Pushes random frames through a blender with the given weights, and expects each blend
+   * to match `BlendBytes` byte for byte, without touching the padding of the output.
+   */
+  void ExpectBlendsMatch(uint32_t width, const std::vector<uint16_t>& weights, unsigned seed) {
+    std::mt19937 random(seed);
+    const uint32_t height = 3;
+    auto frameCount       = static_cast<uint32_t>(weights.size());
+
+    TemporalBlender blender(width, height, frameCount);
+    ASSERT_TRUE(blender.SetWeights(weights));
+
+    // The first frame fills the whole ring.
+    std::deque<Frame> frames(frameCount, Frame(width, height, random));
+    ASSERT_TRUE(blender.PushFrame(frames.front().GetView()));
+
+    for (uint32_t push = 0; push < frameCount + 2; push++) {
+      frames.emplace_front(width, height, random);
+      frames.pop_back();
+      ASSERT_TRUE(blender.PushFrame(frames.front().GetView()));
+
+      Frame output(width, height, random);
+      auto padding = output.pixels;
+      ASSERT_TRUE(blender.Blend(output.GetView()));
+
+      auto expected = BlendBytes(frames, weights);
+      auto rowBytes = width * ConstImageView::BytesPerPixel;
+      for (uint32_t row = 0; row < height; row++) {
+        auto written = output.pixels.begin() + output.stride * row;
+        ASSERT_TRUE(std::equal(written, written + rowBytes, expected.begin() + rowBytes * row))
+          << "width " << width << ", " << frameCount << " frames, push " << push << ", row " << row;
+        ASSERT_TRUE(std::equal(
+          written + rowBytes,
+          written + output.stride,
+          padding.begin() + output.stride * row + rowBytes
+        ));
+      }
+    }
+  }
+}
+
+TEST(TemporalBlender, MatchesTheReferenceForRandomFramesAndWeights) {
+  std::mt19937 random(27);
+  for (uint32_t width : {1, 3, 4, 5, 7, 13, 16, 17, 33, 64}) {
+    for (uint32_t frameCount : {1u, 2u, 3u, 4u, 7u, TemporalBlender::MaxFrameCount}) {
+      ExpectBlendsMatch(width, RandomWeights(frameCount, random), random());
+    }
+  }
+}
+
+TEST(TemporalBlender, MatchesTheReferenceWithWeightsOf0And256) {
+  for (uint32_t width : {3, 4, 9, 21}) {
+    ExpectBlendsMatch(width, {256}, width);
+    ExpectBlendsMatch(width, {256, 0}, width);
+    ExpectBlendsMatch(width, {0, 256}, width);
+    ExpectBlendsMatch(width, {0, 256, 0, 0}, width);
+    ExpectBlendsMatch(width, {0, 0, 0, 256}, width);
+  }
+}
+
+TEST(TemporalBlender, MatchesTheReferenceForAnEqualBlendOfTwoFrames) {
+  // Equal weights on two frames take the rounded-average shortcut.
+  for (uint32_t width : {1, 4, 5, 11, 16, 31}) {
+    ExpectBlendsMatch(width, {128, 128}, width);
+  }
+}
+
+TEST(TemporalBlender, MatchesTheReferenceWithUnevenlySplitWeights) {
+  // 256 doesn't split evenly into 3, 5 or 7 frames, so the newest frames get the remainder, as
+  // they do by default.
+  for (uint32_t frameCount : {2, 3, 5, 7}) {
+    std::vector<uint16_t> weights(frameCount, static_cast<uint16_t>(256 / frameCount));
+    for (uint32_t i = 0; i < 256 % frameCount; i++) {
+      weights[i]++;
+    }
+    ExpectBlendsMatch(13, weights, frameCount);
+  }
+}
+
+TEST(TemporalBlender, RejectsWeightsThatDontAddUpTo256) {
+  TemporalBlender blender(4, 4, 3);
+  EXPECT_FALSE(blender.SetWeights({128, 128}));
+  EXPECT_FALSE(blender.SetWeights({100, 100, 100}));
+  EXPECT_FALSE(blender.SetWeights({0, 0, 255}));
+  EXPECT_TRUE(blender.SetWeights({0, 0, 256}));
+}
+
+TEST(TemporalBlender, RejectsFramesOfTheWrongSize) {
+  std::mt19937 random(0);
+  TemporalBlender blender(8, 4, 2);
+  Frame frame(8, 5, random);
+  EXPECT_FALSE(blender.PushFrame(frame.GetView()));
+  EXPECT_FALSE(blender.Blend(frame.GetView()));
+}
@@ -0,0 +1,69 @@
+#include "child-window-index.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace Downscaler::Cpp::Core::NativeImpls;
+
+namespace {
+  double ElapsedSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start)
+      .count();
+  }
+}
+
+/**
+ * @brief Compares building and querying the index with testing every child, for a range of
+ * child counts.
+ */
+int main() {
+  std::mt19937 random(42);
+  for (int count : {100, 1000, 5000, 20000}) {
+    std::vector<ChildWindowRect> children(count);
+    for (int i = 0; i < count; i++) {
+      int32_t x   = random() % 8000;
+      int32_t y   = random() % 8000;
+      children[i] = {static_cast<uint64_t>(i), x, y, x + 20 + static_cast<int32_t>(random() % 100),
+                     y + 20 + static_cast<int32_t>(random() % 100)};
+    }
+
+    std::vector<std::pair<int32_t, int32_t>> points(200000);
+    for (auto& point : points) {
+      point = {random() % 8100, random() % 8100};
+    }
+
+    ChildWindowIndex index;
+    auto start = std::chrono::steady_clock::now();
+    index.Update(children.data(), children.size());
+    double build = ElapsedSince(start);
+
+    ChildWindowHit hits[16];
+    size_t indexed = 0;
+    start          = std::chrono::steady_clock::now();
+    for (const auto& [x, y] : points) {
+      indexed += index.HitTest(x, y, hits, 16);
+    }
+    double query = ElapsedSince(start) / points.size();
+
+    size_t linear = 0;
+    start         = std::chrono::steady_clock::now();
+    for (const auto& [x, y] : points) {
+      for (const auto& child : children) {
+        linear += x >= child.left && x < child.right && y >= child.top && y < child.bottom;
+      }
+    }
+    double scan = ElapsedSince(start) / points.size();
+
+    printf(
+      "%5d children: build %8.1f us, index %6.1f ns per query, linear %8.1f ns per query%s\n",
+      count,
+      build / 1000,
+      query,
+      scan,
+      indexed == linear ? "" : " (MISMATCH)"
+    );
+  }
+}
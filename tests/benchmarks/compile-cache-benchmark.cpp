@@ -0,0 +1,86 @@
+#include "compile-cache.h"
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+#include "content-hash.h"
+
+using namespace Cpp::Core::NativeImpls;
+
+namespace {
+  double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+}
+
+/**
+ * @brief Measures the content hash against a plain sum and `std::hash` over 64 MiB, and a warm
+ * lookup of a 20 KB script.
+ */
+int main() {
+  const int repeats = 10;
+  std::vector<uint8_t> data(64 << 20, 1);
+  double gigabytes = static_cast<double>(repeats) * data.size() / 1e9;
+
+  uint64_t hash = 0;
+  auto start    = std::chrono::steady_clock::now();
+  for (int i = 0; i < repeats; i++) {
+    hash ^= HashContent(data.data(), data.size(), i);
+  }
+  printf(
+    "content hash: %.1f GB/s (%llx)\n",
+    gigabytes / SecondsSince(start),
+    static_cast<unsigned long long>(hash)
+  );
+
+  uint64_t sum = 0;
+  start        = std::chrono::steady_clock::now();
+  for (int i = 0; i < repeats; i++) {
+    auto words = reinterpret_cast<const uint64_t*>(data.data());
+    for (size_t j = 0; j < data.size() / sizeof(uint64_t); j++) {
+      sum += words[j] ^ i;
+    }
+  }
+  printf(
+    "plain 64-bit sum: %.1f GB/s (%llx)\n",
+    gigabytes / SecondsSince(start),
+    static_cast<unsigned long long>(sum)
+  );
+
+  size_t standardHash = 0;
+  start               = std::chrono::steady_clock::now();
+  for (int i = 0; i < repeats; i++) {
+    std::string_view view(reinterpret_cast<const char*>(data.data()), data.size());
+    standardHash ^= std::hash<std::string_view>()(view);
+  }
+  printf(
+    "std::hash<std::string_view>: %.1f GB/s (%zx)\n",
+    gigabytes / SecondsSince(start),
+    standardHash
+  );
+
+  auto directory = std::filesystem::temp_directory_path() / "compile-cache-benchmark";
+  std::filesystem::remove_all(directory);
+  {
+    CompileCache cache;
+    std::string error;
+    if (!cache.Open(directory, error)) {
+      printf("%s\n", error.c_str());
+      return 1;
+    }
+
+    std::string source(20000, 'a'), output;
+    cache.Store(source.data(), source.size(), 3, source);
+
+    const int lookups = 10000;
+    start             = std::chrono::steady_clock::now();
+    for (int i = 0; i < lookups; i++) {
+      cache.Lookup(source.data(), source.size(), 3, output);
+    }
+    printf("warm lookup of a 20 KB script: %.2f us\n", SecondsSince(start) * 1e6 / lookups);
+  }
+  std::filesystem::remove_all(directory);
+}
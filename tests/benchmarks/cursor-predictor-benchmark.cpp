@@ -0,0 +1,227 @@
+#include "cursor-predictor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace Downscaler::Cpp::Core::NativeImpls;
+
+namespace {
+  /** @brief How far apart the positions of a trace are, in microseconds. */
+  const int64_t TraceResolution = 100;
+
+  /** @brief One capture frame at 60 Hz, the horizon and interval of the forwarded moves. */
+  const int64_t FrameTime = 16'700;
+
+  struct Position {
+    double x;
+    double y;
+  };
+
+  /**
+   * @brief The true position of the cursor every `TraceResolution` microseconds.
+   */
+  using Trace = std::vector<Position>;
+
+  /**
+   * @brief Builds a synthetic trace of strokes that accelerate and decelerate like a hand does,
+   * circles, and pauses, with a little tremor on the strokes.
+   */
+  Trace MakeTrace(unsigned seed) {
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    Trace trace;
+    double x = 500.0;
+    double y = 500.0;
+    for (int segment = 0; segment < 200; segment++) {
+      auto kind = uniform(random);
+      if (kind < 0.7) {
+        // A minimum-jerk stroke to a random target.
+        auto targetX  = std::clamp(x + (uniform(random) - 0.5) * 1'200.0, 0.0, 2'000.0);
+        auto targetY  = std::clamp(y + (uniform(random) - 0.5) * 800.0, 0.0, 1'200.0);
+        auto duration = 150'000 + static_cast<int64_t>(uniform(random) * 450'000);
+        for (int64_t k = 0; k < duration; k += TraceResolution) {
+          auto s      = static_cast<double>(k) / duration;
+          auto eased  = s * s * s * (10.0 - 15.0 * s + 6.0 * s * s);
+          auto time   = static_cast<double>(trace.size() * TraceResolution);
+          trace.push_back({
+            x + (targetX - x) * eased + std::sin(time * 0.00006) * 0.6,
+            y + (targetY - y) * eased + std::cos(time * 0.00005) * 0.6
+          });
+        }
+        x = targetX;
+        y = targetY;
+      } else if (kind < 0.85) {
+        auto radius   = 50.0 + uniform(random) * 150.0;
+        auto duration = 500'000 + static_cast<int64_t>(uniform(random) * 700'000);
+        auto speed    = 2.0 * M_PI * (1.0 + uniform(random)) / 1'000'000.0;
+        auto centerX  = x - radius;
+        for (int64_t k = 0; k < duration; k += TraceResolution) {
+          trace.push_back({
+            centerX + radius * std::cos(speed * k),
+            y + radius * std::sin(speed * k)
+          });
+        }
+        x = centerX + radius * std::cos(speed * duration);
+        y = y + radius * std::sin(speed * duration);
+      }
+
+      auto pause = 50'000 + static_cast<int64_t>(uniform(random) * 350'000);
+      for (int64_t k = 0; k < pause; k += TraceResolution) {
+        trace.push_back({x, y});
+      }
+    }
+    return trace;
+  }
+
+  /**
+   * @brief Reads a recorded trace, one "<microseconds> <x> <y>" line per mouse report, and
+   * resamples it to `TraceResolution`.
+   */
+  bool ReadTrace(const char* path, Trace& trace) {
+    auto file = fopen(path, "r");
+    if (!file) {
+      return false;
+    }
+
+    long long time;
+    double x;
+    double y;
+    int64_t start = -1;
+    while (fscanf(file, "%lld %lf %lf", &time, &x, &y) == 3) {
+      if (start < 0) {
+        start = time;
+      }
+      auto index = static_cast<size_t>((time - start) / TraceResolution);
+      Position last = trace.empty() ? Position{x, y} : trace.back();
+      while (trace.size() < index) {
+        trace.push_back(last);
+      }
+      trace.push_back({x, y});
+    }
+    fclose(file);
+    return !trace.empty();
+  }
+
+  Position At(const Trace& trace, int64_t time) {
+    return trace[std::min<size_t>(time / TraceResolution, trace.size() - 1)];
+  }
+
+  struct Error {
+    double rms;
+    double p95;
+    double jitter;
+  };
+
+  /**
+   * @brief Replays the traces into a predictor the way the input forwarder does: the mouse reports
+   * whole-pixel positions every `pollInterval`, and a move is forwarded every frame.
+   * @param predict Whether to forward the prediction one frame ahead, or the last reported
+   * position.
+   * @returns How far the forwarded position is from where the cursor really is a frame later, and
+   * the RMS of its second difference beyond that of the true path.
+   */
+  Error Replay(
+    const std::vector<Trace>& traces,
+    const CursorPredictorOptions& options,
+    int64_t pollInterval,
+    bool predict
+  ) {
+    std::vector<double> errors;
+    double jitter      = 0.0;
+    size_t jitterCount = 0;
+    for (auto& trace : traces) {
+      CursorPredictor predictor(options);
+      std::vector<Position> forwarded;
+      std::vector<Position> truths;
+      Position reported{-1.0, -1.0};
+      auto end = static_cast<int64_t>(trace.size()) * TraceResolution - FrameTime;
+      for (int64_t time = 0; time < end; time += TraceResolution) {
+        if (time % pollInterval == 0) {
+          auto position = At(trace, time);
+          Position quantized{std::floor(position.x), std::floor(position.y)};
+          if (quantized.x != reported.x || quantized.y != reported.y) {
+            predictor.AddSample(time, quantized.x, quantized.y);
+            reported = quantized;
+          }
+        }
+
+        if (time % FrameTime == 0 && time > 0) {
+          Position point = reported;
+          if (predict) {
+            auto predicted = predictor.Predict(time, FrameTime);
+            point          = {predicted.x, predicted.y};
+          }
+          auto truth = At(trace, time + FrameTime);
+          errors.push_back(std::hypot(point.x - truth.x, point.y - truth.y));
+          forwarded.push_back(point);
+          truths.push_back(truth);
+        }
+      }
+
+      for (size_t i = 2; i < forwarded.size(); i++) {
+        auto ax = forwarded[i].x - 2.0 * forwarded[i - 1].x + forwarded[i - 2].x
+                - (truths[i].x - 2.0 * truths[i - 1].x + truths[i - 2].x);
+        auto ay = forwarded[i].y - 2.0 * forwarded[i - 1].y + forwarded[i - 2].y
+                - (truths[i].y - 2.0 * truths[i - 1].y + truths[i - 2].y);
+        jitter += ax * ax + ay * ay;
+        jitterCount++;
+      }
+    }
+
+    double sumOfSquares = 0.0;
+    for (auto error : errors) {
+      sumOfSquares += error * error;
+    }
+    std::sort(errors.begin(), errors.end());
+    return {
+      std::sqrt(sumOfSquares / errors.size()),
+      errors[errors.size() * 95 / 100],
+      std::sqrt(jitter / std::max<size_t>(jitterCount, 1))
+    };
+  }
+}
+
+/**
+ * @brief Replays cursor traces through the predictor and compares the forwarded positions with
+ * where the cursor really is a frame later, against forwarding the last reported position. Takes
+ * the path of a recorded trace, or replays synthetic ones.
+ */
+int main(int argc, char** argv) {
+  std::vector<Trace> traces;
+  if (argc > 1) {
+    Trace trace;
+    if (!ReadTrace(argv[1], trace)) {
+      printf("Couldn't read a trace from %s\n", argv[1]);
+      return 1;
+    }
+    traces.push_back(std::move(trace));
+  } else {
+    for (unsigned seed = 1; seed <= 6; seed++) {
+      traces.push_back(MakeTrace(seed));
+    }
+  }
+
+  for (int64_t pollInterval : {1'000, 8'000}) {
+    printf("Polled every %lld us\n", static_cast<long long>(pollInterval));
+
+    auto last = Replay(traces, {}, pollInterval, false);
+    printf("  last position: rms %.2f, p95 %.2f, jitter %.2f\n", last.rms, last.p95, last.jitter);
+
+    for (int64_t timeConstant : {3'000, 6'000, 12'000}) {
+      CursorPredictorOptions options;
+      options.velocityTimeConstant = timeConstant;
+      auto predicted = Replay(traces, options, pollInterval, true);
+      printf(
+        "  predicted, %2lld ms filter: rms %.2f, p95 %.2f, jitter %.2f\n",
+        static_cast<long long>(timeConstant / 1'000),
+        predicted.rms,
+        predicted.p95,
+        predicted.jitter
+      );
+    }
+  }
+}
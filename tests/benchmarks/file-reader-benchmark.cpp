@@ -0,0 +1,131 @@
+#include "file-reader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Cpp::Core::NativeImpls;
+
+namespace {
+  // The chunk size `File.readAllBytes` reads with.
+  constexpr size_t chunkSize = 16 * 1024 * 1024;
+
+  double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+      .count();
+  }
+
+  void CreateFile(const std::filesystem::path& path, size_t size) {
+    std::vector<char> block(1024 * 1024);
+    for (size_t i = 0; i < block.size(); i++) {
+      block[i] = static_cast<char>(i * 131);
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    for (size_t written = 0; written < size; written += block.size()) {
+      auto length = std::min(block.size(), size - written);
+      file.write(block.data(), static_cast<std::streamsize>(length));
+    }
+  }
+
+  /**
+   * @brief What `File.ReadAllBytes` did before: a buffered read into a scratch array, which is
+   * then copied into the script's buffer.
+   */
+  size_t ReadThroughScratch(const std::filesystem::path& path, char* destination) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    auto size = static_cast<size_t>(file.tellg());
+    file.seekg(0);
+
+    std::unique_ptr<char[]> scratch(new char[size]);
+    file.read(scratch.get(), static_cast<std::streamsize>(size));
+    std::memcpy(destination, scratch.get(), size);
+    return size;
+  }
+
+  /**
+   * @brief What `File.readAllBytes` does now: reads straight into the script's buffer in chunks.
+   */
+  size_t ReadInChunks(const std::filesystem::path& path, char* destination) {
+    FileReader reader;
+    std::string error;
+    if (!reader.Open(path, error)) {
+      printf("%s\n", error.c_str());
+      return 0;
+    }
+
+    size_t total = 0;
+    while (true) {
+      size_t size = 0;
+      if (!reader.Read(destination + total, chunkSize, size, error)) {
+        printf("%s\n", error.c_str());
+        return total;
+      }
+
+      total += size;
+      if (size < chunkSize) {
+        return total;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Compares reading 1 MB, 100 MB and 1 GB files through a scratch array with reading them
+ * straight into the destination in 16 MiB chunks, with a warm page cache.
+ * @param argv The directory to create the files in, which defaults to the temporary directory.
+ */
+int main(int argc, char** argv) {
+  auto directory = argc > 1 ? std::filesystem::path(argv[1])
+                            : std::filesystem::temp_directory_path() / "file-reader-benchmark";
+  std::filesystem::create_directories(directory);
+
+  const struct {
+    const char* label;
+    size_t size;
+    int repeats;
+  } files[] = {
+    {"1 MB", 1'000'000, 50},
+    {"100 MB", 100'000'000, 10},
+    {"1 GB", 1'000'000'000, 3},
+  };
+
+  for (const auto& file : files) {
+    auto path = directory / file.label;
+    CreateFile(path, file.size);
+
+    // The destination stands in for the script's `ArrayBuffer`. The extra chunk lets the last
+    // read come up short, as it does in `File.readAllBytes`.
+    std::unique_ptr<char[]> destination(new char[file.size + chunkSize]);
+    std::memset(destination.get(), 0, file.size + chunkSize);
+
+    double scratchBest = 1e12, chunkedBest = 1e12;
+    for (int repeat = 0; repeat < file.repeats; repeat++) {
+      auto start  = std::chrono::steady_clock::now();
+      auto read   = ReadThroughScratch(path, destination.get());
+      scratchBest = std::min(scratchBest, MillisecondsSince(start));
+
+      start       = std::chrono::steady_clock::now();
+      read       += ReadInChunks(path, destination.get());
+      chunkedBest = std::min(chunkedBest, MillisecondsSince(start));
+
+      if (read != 2 * file.size) {
+        printf("%s: read %zu bytes\n", file.label, read);
+        return 1;
+      }
+    }
+
+    printf(
+      "%6s: scratch array and copy %8.2f ms, chunked reads %8.2f ms\n",
+      file.label,
+      scratchBest,
+      chunkedBest
+    );
+    std::filesystem::remove(path);
+  }
+}
@@ -0,0 +1,136 @@
+#include "glob-walker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+using namespace Cpp::Core::NativeImpls;
+
+namespace {
+  GlobPattern Compile(const char16_t* pattern) {
+    GlobPattern compiled;
+    std::string error;
+    compiled.Compile(pattern, true, error);
+    return compiled;
+  }
+
+  double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+      .count();
+  }
+
+  /**
+   * @brief Creates 50 packages, each with 10 directories of 200 scripts in `src` and in
+   * `node_modules`, i.e. 200000 files.
+   */
+  void CreateTree(const std::filesystem::path& root) {
+    if (std::filesystem::exists(root / "done")) {
+      return;
+    }
+
+    for (int package = 0; package < 50; package++) {
+      for (auto part : {"src", "node_modules"}) {
+        for (int directory = 0; directory < 10; directory++) {
+          auto path = root / ("pkg" + std::to_string(package)) / part /
+                      ("dir" + std::to_string(directory));
+          std::filesystem::create_directories(path);
+          for (int file = 0; file < 200; file++) {
+            std::ofstream(path / ("file" + std::to_string(file) + (file % 2 ? ".ts" : ".js")));
+          }
+        }
+      }
+    }
+    std::ofstream(root / "done");
+  }
+
+  void Run(
+    const std::filesystem::path& root,
+    const char* label,
+    const char16_t* include,
+    const std::vector<GlobPattern>& excludes,
+    size_t threadCount
+  ) {
+    double best    = 1e9;
+    size_t matches = 0;
+    uint64_t directories = 0, stolen = 0;
+    for (int repeat = 0; repeat < 5; repeat++) {
+      auto start = std::chrono::steady_clock::now();
+      GlobWalker walker;
+      walker.Start(root, Compile(include), excludes, threadCount);
+
+      std::u16string paths[256];
+      matches = 0;
+      for (size_t count; (count = walker.Read(paths, 256, -1)) > 0 || !walker.IsFinished();) {
+        matches += count;
+      }
+
+      best        = std::min(best, MillisecondsSince(start));
+      directories = walker.GetDirectoryCount();
+      stolen      = walker.GetStolenCount();
+    }
+
+    printf(
+      "%-40s %zu threads %7.1f ms, %zu matches, %llu directories, %llu stolen\n",
+      label,
+      threadCount,
+      best,
+      matches,
+      static_cast<unsigned long long>(directories),
+      static_cast<unsigned long long>(stolen)
+    );
+  }
+}
+
+/**
+ * @brief Compares a single-threaded recursive listing that tests every file, which is what the
+ * managed glob did, with the walker on a tree of 200000 files.
+ * @param argv The directory to create the tree in, which is kept for the next run.
+ */
+int main(int argc, char** argv) {
+  std::filesystem::path root = argc > 1 ? std::filesystem::path(argv[1])
+                                        : std::filesystem::temp_directory_path() /
+                                            "glob-walker-benchmark";
+  CreateTree(root);
+
+  auto pattern = Compile(u"**/*.ts");
+  auto rootLength = root.u16string().size() + 1;
+  double best     = 1e9;
+  size_t matches  = 0;
+  for (int repeat = 0; repeat < 5; repeat++) {
+    auto start = std::chrono::steady_clock::now();
+    matches    = 0;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(root)) {
+      if (!entry.is_regular_file()) {
+        continue;
+      }
+
+      auto path   = entry.path().u16string().substr(rootLength);
+      auto states = pattern.GetStart();
+      for (size_t start = 0;;) {
+        auto end = path.find(std::filesystem::path::preferred_separator, start);
+        states   = pattern.Step(states, std::u16string_view(path).substr(start, end - start));
+        if (end == std::u16string::npos) {
+          break;
+        }
+        start = end + 1;
+      }
+      matches += pattern.IsMatch(states);
+    }
+    best = std::min(best, MillisecondsSince(start));
+  }
+  printf("%-40s           %7.1f ms, %zu matches\n", "recursive_directory_iterator", best, matches);
+
+  std::vector<GlobPattern> excludeNodeModules;
+  excludeNodeModules.push_back(Compile(u"**/node_modules"));
+  for (size_t threadCount : {1, 4, 8}) {
+    Run(root, "**/*.ts", u"**/*.ts", {}, threadCount);
+  }
+  for (size_t threadCount : {1, 4, 8}) {
+    Run(root, "*/src/**/*.ts", u"*/src/**/*.ts", {}, threadCount);
+  }
+  for (size_t threadCount : {1, 4, 8}) {
+    Run(root, "**/*.ts excluding **/node_modules", u"**/*.ts", excludeNodeModules, threadCount);
+  }
+}
@@ -0,0 +1,44 @@
+#include "process-name-cache.h"
+
+#include <chrono>
+#include <cstdio>
+
+using namespace Cpp::Core::NativeImpls;
+
+/**
+ * @brief Measures enumerating 600 windows owned by 60 processes once the cache is warm, which is
+ * what a busy desktop looks like to `getWindows`.
+ */
+int main() {
+  ProcessNameCache cache;
+  for (uint32_t i = 0; i < 60; i++) {
+    cache.Insert(
+      1000 + i * 4,
+      nullptr,
+      L"C:\\Program Files\\Some Vendor\\App" + std::to_wstring(i) + L"\\app.exe"
+    );
+  }
+
+  const int enumerations = 2000;
+  const int windows      = 600;
+  std::wstring name;
+  size_t characters = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (int enumeration = 0; enumeration < enumerations; enumeration++) {
+    for (int window = 0; window < windows; window++) {
+      cache.TryGet(1000 + (window % 60) * 4, name);
+      characters += name.size();
+    }
+  }
+  std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+
+  double perEnumeration = elapsed.count() / enumerations;
+  printf(
+    "%d windows: %.1f us per enumeration, %.1f ns per lookup (%zu characters)\n",
+    windows,
+    perEnumeration,
+    perEnumeration * 1000 / windows,
+    characters
+  );
+}
@@ -0,0 +1,132 @@
+#include "run-queue.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+using namespace Cpp::Core::NativeImpls;
+
+namespace {
+  constexpr int producers = 8;
+
+  /**
+   * @brief A replica of GameLauncher's former `AsyncQueue`: a lock around a queue, and a fresh
+   * completion source, here a promise, for every wait on an empty queue.
+   */
+  class AsyncQueueReplica {
+    public:
+      uint64_t waits = 0;
+
+      void Enqueue(uint64_t item) {
+        std::lock_guard guard(lock);
+        if (waiters.empty()) {
+          items.push(item);
+          return;
+        }
+
+        auto waiter = waiters.front();
+        waiters.pop();
+        waiter->set_value(item);
+      }
+
+      uint64_t Dequeue() {
+        std::future<uint64_t> future;
+        {
+          std::lock_guard guard(lock);
+          if (!items.empty()) {
+            auto item = items.front();
+            items.pop();
+            return item;
+          }
+
+          waits++;
+          auto waiter = std::make_shared<std::promise<uint64_t>>();
+          future      = waiter->get_future();
+          waiters.push(waiter);
+        }
+        return future.get();
+      }
+
+    private:
+      std::mutex lock;
+      std::queue<uint64_t> items;
+      std::queue<std::shared_ptr<std::promise<uint64_t>>> waiters;
+  };
+
+  template <typename TPush, typename TConsume>
+  double Run(int perProducer, bool paced, TPush push, TConsume consume) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int producer = 0; producer < producers; producer++) {
+      threads.emplace_back([&, producer] {
+        for (int i = 0; i < perProducer; i++) {
+          push((static_cast<uint64_t>(producer) << 32) | static_cast<uint32_t>(i));
+          if (paced && i % 64 == 63) {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+          }
+        }
+      });
+    }
+
+    consume(static_cast<uint64_t>(producers) * perProducer);
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start)
+      .count();
+  }
+}
+
+/**
+ * @brief Compares the run queue with the lock-and-promise queue it replaced, with 8 producers
+ * either flooding the consumer or pacing themselves so that it keeps running dry.
+ * @param argv The number of items per producer, 200000 by default.
+ */
+int main(int argc, char** argv) {
+  int perProducer = argc > 1 ? std::atoi(argv[1]) : 200000;
+
+  for (bool paced : {false, true}) {
+    RunQueue queue;
+    double runQueueTime = Run(
+      perProducer,
+      paced,
+      [&](uint64_t item) { queue.Push(item); },
+      [&](uint64_t total) {
+        uint64_t items[256];
+        for (uint64_t drained = 0; drained < total;) {
+          drained += queue.Drain(items, 256, -1);
+        }
+      }
+    );
+
+    AsyncQueueReplica replica;
+    double replicaTime = Run(
+      perProducer,
+      paced,
+      [&](uint64_t item) { replica.Enqueue(item); },
+      [&](uint64_t total) {
+        for (uint64_t dequeued = 0; dequeued < total; dequeued++) {
+          replica.Dequeue();
+        }
+      }
+    );
+
+    double count = static_cast<double>(producers) * perProducer;
+    printf(
+      "%s: run queue %.1f ns per item (%llu parks, %llu wakes), "
+      "AsyncQueue replica %.1f ns per item (%llu waits)\n",
+      paced ? "paced" : "flood",
+      runQueueTime / count,
+      static_cast<unsigned long long>(queue.GetParkCount()),
+      static_cast<unsigned long long>(queue.GetWakeCount()),
+      replicaTime / count,
+      static_cast<unsigned long long>(replica.waits)
+    );
+  }
+}
@@ -0,0 +1,81 @@
+#include "timer-wheel.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+using namespace Cpp::Core::NativeImpls;
+
+namespace {
+  double NanosecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start)
+      .count();
+  }
+}
+
+/**
+ * @brief Measures the wheel with 50000 concurrent timers of up to a minute, a tenth of them
+ * repeating and a quarter cancelled, advanced a millisecond at a time; then how quickly the
+ * service delivers 10000 timers spread over 200 ms.
+ */
+int main() {
+  {
+    const int count = 50000;
+    std::mt19937 random(1);
+    TimerWheel wheel;
+    std::vector<uint32_t> ids, expired;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; i++) {
+      ids.push_back(wheel.Schedule(1 + random() % 60000, i % 10 == 0 ? 1000 : 0));
+    }
+    double scheduleTime = NanosecondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; i += 4) {
+      wheel.Cancel(ids[i]);
+    }
+    double cancelTime = NanosecondsSince(start);
+
+    size_t expirations = 0;
+    start              = std::chrono::steady_clock::now();
+    for (uint64_t millisecond = 1; millisecond <= 60000; millisecond++) {
+      expired.clear();
+      wheel.Advance(millisecond, expired);
+      expirations += expired.size();
+    }
+    double advanceTime = NanosecondsSince(start);
+
+    printf(
+      "wheel: schedule %.1f ns, cancel %.1f ns, 60000 ticks %.1f ms for %zu expirations "
+      "(%.1f ns each)\n",
+      scheduleTime / count,
+      cancelTime / (count / 4),
+      advanceTime / 1e6,
+      expirations,
+      advanceTime / expirations
+    );
+  }
+
+  {
+    const int count = 10000;
+    TimerService service;
+    service.Start();
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; i++) {
+      service.Schedule(1 + i % 200, 0);
+    }
+
+    uint32_t ids[16];
+    for (int delivered = 0; delivered < count;) {
+      delivered += static_cast<int>(service.Read(ids, 16, -1));
+    }
+    printf(
+      "service: %d timers over 200 ms delivered in %.1f ms\n",
+      count,
+      NanosecondsSince(start) / 1e6
+    );
+    service.Stop();
+  }
+}
@@ -0,0 +1,116 @@
+#include "win-event-dispatcher.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iterator>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Cpp::Core::NativeImpls;
+
+namespace {
+  struct Event {
+    uint32_t event;
+    uint64_t hwnd;
+    int32_t idObject;
+    int32_t idChild;
+  };
+
+  double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+}
+
+/**
+ * @brief Compares the dispatcher's filter and queue with what the managed WinEvent proc did per
+ * event, taking a lock and scanning every awaiter's event list, on a mix resembling a busy desktop.
+ */
+int main() {
+  std::mt19937 random(1);
+  const uint32_t ids[] = {
+    0x800B, 0x800B, 0x800B, 0x800B, 0x800C, 0x800E, 0x8005, 0x8004, 0x8006,
+    0x8007, 0x8002, 0x8001, 0x0003, 0x8000, 0x8003, 0x4001, 0x7500, 0x0016,
+  };
+  const int32_t objects[] = {0, 0, -8, -9, -4, -1, -3};
+
+  const size_t count = 1 << 22;
+  std::vector<Event> stream(count);
+  for (auto& event : stream) {
+    event = {
+      ids[random() % std::size(ids)],
+      random() % 50 + 1,
+      objects[random() % std::size(objects)],
+      static_cast<int32_t>(random() % 4 == 0),
+    };
+  }
+
+  const uint32_t subscribed[] = {0x800B, 0x8000, 0x8001, 0x8002, 0x8003, 0x8017};
+  WinEventDispatcher dispatcher;
+  std::string error;
+  dispatcher.Subscribe(subscribed, std::size(subscribed), error);
+  dispatcher.Refresh();
+
+  std::atomic<uint64_t> read{0};
+  std::thread reader([&] {
+    WinEventRecord records[256];
+    while (size_t n = dispatcher.Read(records, 256, -1)) {
+      read += n;
+    }
+  });
+
+  const int repeats = 4;
+  auto start = std::chrono::steady_clock::now();
+  for (int repeat = 0; repeat < repeats; repeat++) {
+    for (const auto& event : stream) {
+      dispatcher.OnEvent(event.event, event.hwnd, event.idObject, event.idChild, 0);
+    }
+  }
+  double seconds = SecondsSince(start);
+
+  while (read < dispatcher.GetAcceptedCount()) {
+    std::this_thread::yield();
+  }
+  dispatcher.Stop();
+  reader.join();
+
+  printf(
+    "dispatcher: %.1f M events/s received, %.1f%% accepted, %llu dropped\n",
+    repeats * count / seconds / 1e6,
+    100.0 * dispatcher.GetAcceptedCount() / (repeats * count),
+    static_cast<unsigned long long>(dispatcher.GetDroppedCount())
+  );
+
+  for (int awaiters : {4, 64}) {
+    std::mutex mutex;
+    std::vector<std::vector<uint32_t>> lists(awaiters, {0x800B, 0x8000});
+    uint64_t hits = 0;
+
+    start = std::chrono::steady_clock::now();
+    for (const auto& event : stream) {
+      if (event.hwnd == 0 || event.idObject != 0 || event.idChild != 0) {
+        continue;
+      }
+
+      std::lock_guard lock(mutex);
+      for (int i = awaiters - 1; i >= 0; i--) {
+        const auto& list = lists[i];
+        if (std::find(list.begin(), list.end(), event.event) != list.end()) {
+          hits++;
+        }
+      }
+    }
+    seconds = SecondsSince(start);
+
+    printf(
+      "lock and scan, %d awaiters: %.1f M events/s (%llu hits)\n",
+      awaiters,
+      count / seconds / 1e6,
+      static_cast<unsigned long long>(hits)
+    );
+  }
+}
@@ -0,0 +1,115 @@
+#include "window-awaiter-index.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+#include "../Cpp.Core/fake-window-field-source.h"
+
+using namespace Cpp::Core::NativeImpls;
+
+namespace {
+  std::u16string Letter(char16_t first, uint32_t offset) {
+    return std::u16string(1, static_cast<char16_t>(first + offset));
+  }
+
+  double MicrosecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start)
+      .count();
+  }
+}
+
+/**
+ * @brief Compares matching every awaiter against each WinEvent with looking them up in the index,
+ * for 1000 awaiters on a desktop where querying a process name is expensive.
+ */
+int main() {
+  std::mt19937 random(5);
+  FakeWindowFieldSource desktop;
+  desktop.processQueryCost = 400;
+  for (uint32_t processId = 1; processId <= 300; processId++) {
+    desktop.processNames[processId] =
+      u"C:\\Program Files\\Vendor\\app" + Letter(u'a', processId % 26) + u".exe";
+  }
+  for (uint64_t hwnd = 1; hwnd <= 5000; hwnd++) {
+    desktop.windows[hwnd] = {
+      static_cast<uint32_t>(random() % 300 + 1),
+      u"Class_" + Letter(u'A', random() % 40),
+      u"Window " + Letter(u'a', random() % 26),
+    };
+  }
+
+  WindowAwaiterIndex index;
+  std::vector<std::pair<std::vector<uint32_t>, WindowMatcher>> awaiters;
+  for (int i = 0; i < 1000; i++) {
+    auto processName = u"app" + Letter(u'a', random() % 26) + u".exe";
+
+    WindowMatcher matcher;
+    switch (i % 4) {
+      case 0: matcher.SetProcessId(random() % 300 + 1); break;
+      case 1:
+        matcher.SetClassName(u"class_" + Letter(u'A', random() % 40), MatchMode::Exact, true);
+        matcher.SetTitle(u"Window ?", MatchMode::Glob, false);
+        break;
+      case 2:
+        matcher.SetClassName(u"Class_" + Letter(u'A', random() % 40), MatchMode::Exact, false);
+        matcher.SetProcessName(processName, MatchMode::Exact, true);
+        break;
+      default:
+        matcher.SetProcessName(processName, MatchMode::Exact, true);
+        break;
+    }
+
+    std::vector<uint32_t> events{0x8000};
+    if (i % 2) {
+      events.push_back(0x800C);
+    }
+    index.Add(events.data(), events.size(), matcher);
+    awaiters.emplace_back(events, matcher);
+  }
+
+  const int count = 20000;
+  std::vector<std::pair<uint32_t, uint64_t>> stream;
+  for (int i = 0; i < count; i++) {
+    uint32_t event = random() % 3 == 0 ? 0x800C : (random() % 3 == 0 ? 0x8002 : 0x8000);
+    stream.emplace_back(event, random() % 5000 + 1);
+  }
+
+  size_t scanned = 0;
+  auto start     = std::chrono::steady_clock::now();
+  for (const auto& [event, hwnd] : stream) {
+    for (const auto& [events, matcher] : awaiters) {
+      if (std::find(events.begin(), events.end(), event) != events.end()) {
+        LiveWindow window(hwnd, desktop);
+        scanned += matcher.Matches(window);
+      }
+    }
+  }
+  double scanTime        = MicrosecondsSince(start);
+  auto scanQueries       = desktop.processQueries;
+  desktop.processQueries = 0;
+
+  std::vector<uint32_t> ids;
+  size_t indexed = 0;
+  start          = std::chrono::steady_clock::now();
+  for (const auto& [event, hwnd] : stream) {
+    LiveWindow window(hwnd, desktop);
+    index.Match(event, window, ids);
+    indexed += ids.size();
+  }
+  double indexTime = MicrosecondsSince(start);
+
+  printf(
+    "1000 awaiters, %d events: every awaiter %.2f us per event (%.1f process queries), "
+    "index %.3f us per event (%.2f process queries, %.1f comparisons); %zu and %zu completions\n",
+    count,
+    scanTime / count,
+    static_cast<double>(scanQueries) / count,
+    indexTime / count,
+    static_cast<double>(desktop.processQueries) / count,
+    static_cast<double>(index.GetComparedCount()) / count,
+    scanned,
+    indexed
+  );
+}
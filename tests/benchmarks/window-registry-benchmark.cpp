@@ -0,0 +1,45 @@
+#include "window-registry.h"
+
+#include <chrono>
+#include <cstdio>
+
+using namespace Cpp::Core::NativeImpls;
+
+/**
+ * @brief Measures looking windows up by process name on a desktop with 5000 windows, which used
+ * to enumerate every window and query each one's process.
+ */
+int main() {
+  WindowRegistry registry;
+  for (uint64_t i = 0; i < 5000; i++) {
+    char16_t first  = static_cast<char16_t>(u'a' + i % 26);
+    char16_t second = static_cast<char16_t>(u'a' + (i / 26) % 5);
+
+    WindowRecord window;
+    window.hwnd        = i + 1;
+    window.parent      = i < 500 ? 0 : i % 500 + 1;
+    window.processId   = static_cast<uint32_t>(i % 120);
+    window.processName = u"C:\\Apps\\app" + std::u16string{first, second} + u".exe";
+    window.className   = u"Class" + std::u16string(1, static_cast<char16_t>(u'a' + i % 20));
+    window.title       = u"Title " + std::u16string{first, static_cast<char16_t>(u'a' + i % 7)};
+    registry.Upsert(window);
+  }
+
+  WindowQuery query;
+  query.processName = u"APPBC.exe";
+
+  const int lookups = 100000;
+  size_t found      = 0;
+  auto start        = std::chrono::steady_clock::now();
+  for (int i = 0; i < lookups; i++) {
+    found += registry.Find(query).size();
+  }
+  std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+
+  printf(
+    "%zu windows, %zu matches, %.2f us per lookup\n",
+    registry.GetCount(),
+    found / lookups,
+    elapsed.count() / lookups
+  );
+}